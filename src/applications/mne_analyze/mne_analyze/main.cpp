@@ -39,6 +39,7 @@
 
 #include <stdio.h>
 #include <utils/generics/mne_logger.h>
+#include <fiff/fiff_stream.h>
 
 #include "info.h"
 #include "analyzecore.h"
@@ -52,6 +53,7 @@
 #include <QtPlugin>
 #include <QSurfaceFormat>
 #include <QScopedPointer>
+#include <QStandardPaths>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -116,6 +118,12 @@ int main(int argc, char *argv[])
     QCoreApplication::setApplicationName(CInfo::AppNameShort());
     QCoreApplication::setOrganizationDomain("www.mne-cpp.org");
 
+    // Raw files without a tag directory are scanned once; reopening them reads the cached directory
+    const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if(!cacheRoot.isEmpty()) {
+        FIFFLIB::FiffStream::set_dir_cache_directory(cacheRoot + QStringLiteral("/fiff"));
+    }
+
     QSurfaceFormat fmt;
     fmt.setSamples(4);
     QSurfaceFormat::setDefaultFormat(fmt);
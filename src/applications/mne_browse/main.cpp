@@ -41,6 +41,8 @@
 #include "Windows/mainwindow.h"
 #include "Utils/info.h"
 
+#include <fiff/fiff_stream.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -54,6 +56,7 @@
 #include <QDateTime>
 #include <QDir>
 #include <QSplashScreen>
+#include <QStandardPaths>
 #include <QThread>
 #include <QTimer>
 
@@ -142,6 +145,12 @@ int main(int argc, char *argv[])
     QCoreApplication::setApplicationName(CInfo::AppNameShort());
     QCoreApplication::setApplicationVersion(CInfo::AppVersion());
 
+    // Raw files without a tag directory are scanned once; reopening them reads the cached directory
+    const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if(!cacheRoot.isEmpty()) {
+        FIFFLIB::FiffStream::set_dir_cache_directory(cacheRoot + QStringLiteral("/fiff"));
+    }
+
     // -------------------------------------------------------------------------
     // Command-line argument parsing
     // -------------------------------------------------------------------------
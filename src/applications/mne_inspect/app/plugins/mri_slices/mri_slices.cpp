@@ -16,6 +16,7 @@
 
 #include <disp3D/scene/multimodalscene.h>
 
+#include <mri/mri_inflate_stream.h>
 #include <mri/mri_slicer.h>
 
 //=============================================================================================================
@@ -25,6 +26,7 @@
 #include <QDebug>
 #include <QFileInfo>
 #include <QImage>
+#include <QStandardPaths>
 
 #include <cmath>
 #include <limits>
@@ -72,6 +74,14 @@ DISP3DLIB::SliceOrientation toDispOrientation(MRILIB::SliceOrientation o)
 MriSlicesPlugin::MriSlicesPlugin(QObject* parent)
     : QObject(parent)
 {
+    // Re-opening a .mgz / .nii.gz reads the decoded copy instead of inflating it again. The least recently used
+    // copies are evicted once the cache exceeds MriInflateStream::cacheSizeLimit().
+    if (MriInflateStream::cacheDirectory().isEmpty()) {
+        const QString cacheRoot = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+        if (!cacheRoot.isEmpty()) {
+            MriInflateStream::setCacheDirectory(cacheRoot + QStringLiteral("/mri"));
+        }
+    }
 }
 
 //=============================================================================================================
@@ -189,20 +199,12 @@ float MriSlicesPlugin::intensityAt(const QVector3D& worldPosition) const
     const int ix = static_cast<int>(std::lround(voxF.x()));
     const int iy = static_cast<int>(std::lround(voxF.y()));
     const int iz = static_cast<int>(std::lround(voxF.z()));
-    const int nx = m_volume->dimX();
-    const int ny = m_volume->dimY();
-    const int nz = m_volume->dimZ();
-    if (ix < 0 || iy < 0 || iz < 0 || ix >= nx || iy >= ny || iz >= nz) {
-        return std::numeric_limits<float>::quiet_NaN();
-    }
-    const QVector<float> data = m_volume->voxelDataAsFloat();
-    const qsizetype idx = static_cast<qsizetype>(iz) * ny * nx
-                        + static_cast<qsizetype>(iy) * nx
-                        + ix;
-    if (idx < 0 || idx >= data.size()) {
+    if (ix < 0 || iy < 0 || iz < 0
+        || ix >= m_volume->dimX() || iy >= m_volume->dimY() || iz >= m_volume->dimZ()
+        || iz >= m_volume->slices.size()) {
         return std::numeric_limits<float>::quiet_NaN();
     }
-    return data[idx];
+    return m_volume->voxel(ix, iy, iz);
 }
 
 //=============================================================================================================
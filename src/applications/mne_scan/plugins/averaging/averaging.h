@@ -43,7 +43,7 @@
 #include "averaging_global.h"
 
 #include <scShared/Plugins/abstractalgorithm.h>
-#include <utils/generics/circularbuffer.h>
+#include <utils/generics/spscringbuffer.h>
 
 #include <fiff/fiff_evoked_set.h>
 
@@ -225,7 +225,7 @@ private:
     SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr     m_pAveragingInput;      /**< The RealTimeSampleArray of the Averaging input.*/
     SCSHAREDLIB::PluginOutputData<SCMEASLIB::RealTimeEvokedSet>::SPtr           m_pAveragingOutput;     /**< The RealTimeEvoked of the Averaging output.*/
 
-    UTILSLIB::CircularBuffer<FIFFLIB::FiffEvokedSet>::SPtr                      m_pCircularBuffer;      /**< Holds incoming fiff evoked sets. */
+    UTILSLIB::SpscRingBuffer<FIFFLIB::FiffEvokedSet>::SPtr                      m_pCircularBuffer;      /**< Holds incoming fiff evoked sets. */
 
     QMutex                                          m_qMutex;                           /**< Provides access serialization between threads. */
 
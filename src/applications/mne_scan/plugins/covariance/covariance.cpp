@@ -81,6 +81,9 @@ using namespace Eigen;
 
 Covariance::Covariance()
 : m_iEstimationSamples(2000)
+, m_sEstimationMode("block")
+, m_dForgettingFactor(0.999)
+, m_iWindowSamples(0)
 , m_pCircularBuffer(CircularBuffer_Matrix_double::SPtr::create(40))
 {
 }
@@ -109,6 +112,16 @@ void Covariance::init()
     QSettings settings("MNECPP");
     m_iEstimationSamples = settings.value(QString("MNESCAN/%1/estimationSamples").arg(this->getName()), 5000).toInt();
 
+    // Stored estimation settings go through the same validation as the attributes
+    QVariantMap estimationSettings;
+    for(const QString& sKey : {QStringLiteral("estimationMode"), QStringLiteral("forgettingFactor"), QStringLiteral("windowSamples")}) {
+        const QString sSettingsKey = QString("MNESCAN/%1/%2").arg(this->getName(), sKey);
+        if(settings.contains(sSettingsKey)) {
+            estimationSettings[sKey] = settings.value(sSettingsKey);
+        }
+    }
+    setAttributes(estimationSettings);
+
     // Input
     m_pCovarianceInput = PluginInputData<RealTimeMultiSampleArray>::create(this, "CovarianceIn", "Covariance input data");
     connect(m_pCovarianceInput.data(), &PluginInputConnector::notify,
@@ -151,6 +164,9 @@ void Covariance::unload()
     // Save Settings
     QSettings settings("MNECPP");
     settings.setValue(QString("MNESCAN/%1/estimationSamples").arg(this->getName()), m_iEstimationSamples);
+    settings.setValue(QString("MNESCAN/%1/estimationMode").arg(this->getName()), m_sEstimationMode);
+    settings.setValue(QString("MNESCAN/%1/forgettingFactor").arg(this->getName()), m_dForgettingFactor);
+    settings.setValue(QString("MNESCAN/%1/windowSamples").arg(this->getName()), m_iWindowSamples);
 }
 
 //=============================================================================================================
@@ -265,8 +281,21 @@ void Covariance::run()
         if(m_pCircularBuffer->pop(matData)) {
             m_mutex.lock();
             iEstimationSamples = m_iEstimationSamples;
+            RtCov::Mode mode = RtCov::Mode::Block;
+            if(m_sEstimationMode == QLatin1String("exponential")) {
+                mode = RtCov::Mode::Exponential;
+            } else if(m_sEstimationMode == QLatin1String("window")) {
+                mode = RtCov::Mode::SlidingWindow;
+            }
+            rtCov.setForgettingFactor(m_dForgettingFactor);
+            rtCov.setWindowSamples(m_iWindowSamples);
             m_mutex.unlock();
 
+            // Switching the mode restarts the estimate
+            if(mode != rtCov.mode()) {
+                rtCov.setMode(mode);
+            }
+
             fiffCov = rtCov.estimateCovariance(matData, iEstimationSamples);
             if(!fiffCov.names.isEmpty()) {
                 m_pCovarianceOutput->measurementData()->setValue(fiffCov);
@@ -288,6 +317,9 @@ QVariantMap Covariance::getAttributes() const
 {
     QVariantMap attrs;
     attrs[QStringLiteral("estimationSamples")] = m_iEstimationSamples;
+    attrs[QStringLiteral("estimationMode")] = m_sEstimationMode;
+    attrs[QStringLiteral("forgettingFactor")] = m_dForgettingFactor;
+    attrs[QStringLiteral("windowSamples")] = m_iWindowSamples;
     return attrs;
 }
 
@@ -295,6 +327,37 @@ QVariantMap Covariance::getAttributes() const
 
 void Covariance::setAttributes(const QVariantMap& attributes)
 {
+    QMutexLocker locker(&m_mutex);
+
     if (attributes.contains(QStringLiteral("estimationSamples")))
         m_iEstimationSamples = attributes[QStringLiteral("estimationSamples")].toInt();
+
+    // Invalid values are rejected and the previous ones kept
+    if (attributes.contains(QStringLiteral("estimationMode"))) {
+        const QString sMode = attributes[QStringLiteral("estimationMode")].toString().toLower();
+        if (sMode == QLatin1String("block") || sMode == QLatin1String("exponential") || sMode == QLatin1String("window")) {
+            m_sEstimationMode = sMode;
+        } else {
+            qWarning() << "[Covariance::setAttributes] Unknown estimationMode" << sMode
+                       << "(expected block, exponential or window). Keeping" << m_sEstimationMode;
+        }
+    }
+    if (attributes.contains(QStringLiteral("forgettingFactor"))) {
+        bool bOk = false;
+        const double dFactor = attributes[QStringLiteral("forgettingFactor")].toDouble(&bOk);
+        if (bOk && dFactor > 0.0 && dFactor <= 1.0) {
+            m_dForgettingFactor = dFactor;
+        } else {
+            qWarning() << "[Covariance::setAttributes] forgettingFactor must be in (0, 1]. Keeping" << m_dForgettingFactor;
+        }
+    }
+    if (attributes.contains(QStringLiteral("windowSamples"))) {
+        bool bOk = false;
+        const int iSamples = attributes[QStringLiteral("windowSamples")].toInt(&bOk);
+        if (bOk && iSamples >= 0) {
+            m_iWindowSamples = iSamples;
+        } else {
+            qWarning() << "[Covariance::setAttributes] windowSamples must be 0 or positive. Keeping" << m_iWindowSamples;
+        }
+    }
 }
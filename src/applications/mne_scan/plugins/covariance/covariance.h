@@ -158,6 +158,9 @@ protected:
 private:
     QMutex      m_mutex;
     qint32      m_iEstimationSamples;
+    QString     m_sEstimationMode;          /**< "block", "exponential" or "window", see RTPROCESSINGLIB::RtCov::Mode. */
+    double      m_dForgettingFactor;        /**< Per-sample forgetting factor of the exponential mode. */
+    qint32      m_iWindowSamples;           /**< Window length of the window mode, 0 for the estimation samples. */
 
     UTILSLIB::CircularBuffer_Matrix_double::SPtr        m_pCircularBuffer;              /**< Matrix data circular buffer. */
 
@@ -70,7 +70,8 @@ LSLAdapterProducer::LSLAdapterProducer(QSharedPointer<PluginOutputData<RealTimeM
 , m_bHasStreamInfo(false)
 , m_bIsRunning(false)
 , m_iOutputBlockSize(iOutputBlockSize)
-, m_vBufferedSamples()
+, m_matBufferedSamples()
+, m_iNumBufferedSamples(0)
 , m_pRTMSA(pRTMSA)
 {
 }
@@ -101,7 +102,12 @@ void LSLAdapterProducer::readStream()
         qDebug() << "[LSLAdapterProducer::readStream] Something went wrong when trying to open LSL stream inlet: " << e.what();
     }
 
-    m_bIsRunning = true;
+    // samples are pulled straight into the column-major output block
+    const int iNumChannels = m_StreamInlet->channel_count();
+    m_matBufferedSamples.resize(iNumChannels, m_iOutputBlockSize);
+    m_iNumBufferedSamples = 0;
+
+    m_bIsRunning = (iNumChannels > 0 && m_iOutputBlockSize > 0);
     while(m_bIsRunning) {
         try {
             if(m_StreamInlet->samples_available() == false) {
@@ -109,30 +115,23 @@ void LSLAdapterProducer::readStream()
                 QThread::msleep(5);
                 continue;
             }
-            std::vector<std::vector<float>> chunk = m_StreamInlet->pull_chunk<float>();
-
-            // append chunk to buffer
-            m_vBufferedSamples.insert(std::end(m_vBufferedSamples), std::begin(chunk), std::end(chunk));
 
-            // check if we can output another block
-            if(m_vBufferedSamples.size() >= m_iOutputBlockSize) {
-                Eigen::MatrixXd matOutput(m_StreamInfo.channel_count(), m_iOutputBlockSize);
-
-                // copy samples
-                for(int iSampleIdx = 0; iSampleIdx < m_iOutputBlockSize; ++iSampleIdx) {
-                    for(int iChannelIdx = 0; iChannelIdx < m_StreamInfo.channel_count(); ++iChannelIdx) {
-                        matOutput(iChannelIdx, iSampleIdx) = static_cast<double>(m_vBufferedSamples[iSampleIdx][iChannelIdx]);
-                    }
+            std::size_t iNumPulled = 0;
+            do {
+                const std::size_t iNumFree = static_cast<std::size_t>(m_iOutputBlockSize - m_iNumBufferedSamples) * iNumChannels;
+                iNumPulled = m_StreamInlet->pull_chunk_multiplexed(m_matBufferedSamples.col(m_iNumBufferedSamples).data(),
+                                                                   nullptr,
+                                                                   iNumFree,
+                                                                   0);
+                m_iNumBufferedSamples += static_cast<int>(iNumPulled / iNumChannels);
+
+                // check if we can output another block
+                if(m_iNumBufferedSamples == m_iOutputBlockSize) {
+                    // publish new block
+                    m_pRTMSA->measurementData()->setValue(m_matBufferedSamples.cast<double>());
+                    m_iNumBufferedSamples = 0;
                 }
-
-                // remove copied samples
-                for(int i = 0; i < m_iOutputBlockSize; ++i) {
-                    m_vBufferedSamples.erase(m_vBufferedSamples.begin());
-                }
-
-                // publish new block
-                m_pRTMSA->measurementData()->setValue(matOutput);
-            }
+            } while(iNumPulled > 0);
         }
         catch (std::exception& e) {
             qDebug() << "[LSLAdapterProducer::readStream] Something went wrong while streaming data: " << e.what();
@@ -174,7 +173,7 @@ void LSLAdapterProducer::reset()
     m_bIsRunning = false;
     m_bHasStreamInfo = false;
     // clear buffer
-    m_vBufferedSamples.clear();
+    m_iNumBufferedSamples = 0;
     // reset lsl members
     m_StreamInfo = LSLLIB::stream_info();
     delete m_StreamInlet;
@@ -150,7 +150,8 @@ private:
 
     // buffering and output parameters
     int                             m_iOutputBlockSize;
-    std::vector<std::vector<float>> m_vBufferedSamples;
+    Eigen::MatrixXf                 m_matBufferedSamples;
+    int                             m_iNumBufferedSamples;
     QSharedPointer<SCSHAREDLIB::PluginOutputData<SCMEASLIB::RealTimeMultiSampleArray> > m_pRTMSA;
 
 signals:
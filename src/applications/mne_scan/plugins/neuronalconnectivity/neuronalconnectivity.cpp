@@ -92,7 +92,7 @@ NeuronalConnectivity::NeuronalConnectivity()
 , m_fFreqBandHigh(13.0f)
 , m_iBlockSize(1)
 , m_sAvrType("1")
-, m_pCircularBuffer(CircularBuffer<CONNECTIVITYLIB::Network>::SPtr::create(40))
+, m_pCircularBuffer(SpscRingBuffer<CONNECTIVITYLIB::Network>::SPtr::create(40))
 , m_pRtConnectivity(RtConnectivity::SPtr::create())
 , m_pActionShowYourWidget(Q_NULLPTR)
 {
@@ -100,6 +100,8 @@ NeuronalConnectivity::NeuronalConnectivity()
     AbstractMetric::m_iNumberBinStart = 0;
     AbstractMetric::m_iNumberBinAmount = 100;
 
+    m_connectivitySettings.setDenseNetworkActive(true);
+
     //Init rt connectivity worker
     connect(m_pRtConnectivity.data(), &RtConnectivity::newConnectivityResultAvailable,
             this, &NeuronalConnectivity::onNewConnectivityResultAvailable);
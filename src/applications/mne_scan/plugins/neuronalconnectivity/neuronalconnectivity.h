@@ -44,7 +44,7 @@
 
 #include <scShared/Plugins/abstractalgorithm.h>
 
-#include <utils/generics/circularbuffer.h>
+#include <utils/generics/spscringbuffer.h>
 
 #include <connectivity/connectivitysettings.h>
 #include <connectivity/network/network.h>
@@ -253,7 +253,7 @@ private:
 
     CONNECTIVITYLIB::ConnectivitySettings                                           m_connectivitySettings;         /**< The connectivity settings.*/
 
-    QSharedPointer<UTILSLIB::CircularBuffer<CONNECTIVITYLIB::Network> >             m_pCircularBuffer;              /**< The circular buffer holding the connectivity estimates.*/
+    QSharedPointer<UTILSLIB::SpscRingBuffer<CONNECTIVITYLIB::Network> >             m_pCircularBuffer;              /**< The circular buffer holding the connectivity estimates.*/
     QSharedPointer<RTPROCESSINGLIB::RtConnectivity>                                 m_pRtConnectivity;              /**< The real-time connectivity estimation object.*/
     QSharedPointer<FIFFLIB::FiffInfo>                                               m_pFiffInfo;                    /**< Fiff measurement info.*/
     QSharedPointer<DISPLIB::ConnectivitySettingsView>                               m_pConnectivitySettingsView;    /**< The connectivity settings widget which will be added to the Quick Control view. The QuickControlView will not take ownership. Ownership will be managed by the QSharedPointer.*/
@@ -24,6 +24,7 @@ WriteToFileStatusWidget::WriteToFileStatusWidget(WriteToFile* pPlugin, QWidget*
 : QWidget(parent)
 , m_pDot(new QLabel(this))
 , m_pText(new QLabel(this))
+, m_pQueue(new QLabel(this))
 , m_bActive(false)
 {
     auto* pLayout = new QHBoxLayout(this);
@@ -37,14 +38,20 @@ WriteToFileStatusWidget::WriteToFileStatusWidget(WriteToFile* pPlugin, QWidget*
 
     m_pText->setText(tr("Not recording"));
 
+    // Write queue fill level; hidden until the recorder reports it.
+    m_pQueue->setVisible(false);
+
     pLayout->addWidget(m_pDot);
     pLayout->addWidget(m_pText);
+    pLayout->addWidget(m_pQueue);
 
     if (pPlugin) {
         connect(pPlugin, &WriteToFile::recordingStatus,
                 this, &WriteToFileStatusWidget::onRecordingStatus);
         connect(pPlugin, &WriteToFile::recordingActiveChanged,
                 this, &WriteToFileStatusWidget::onRecordingActiveChanged);
+        connect(pPlugin, &WriteToFile::recorderStatus,
+                this, &WriteToFileStatusWidget::onRecorderStatus);
     }
 }
 
@@ -58,6 +65,11 @@ bool WriteToFileStatusWidget::isActive() const
     return m_bActive;
 }
 
+QString WriteToFileStatusWidget::queueText() const
+{
+    return m_pQueue ? m_pQueue->text() : QString();
+}
+
 void WriteToFileStatusWidget::onRecordingStatus(const QString& sSummary)
 {
     if (m_pText) {
@@ -74,4 +86,28 @@ void WriteToFileStatusWidget::onRecordingActiveChanged(bool bActive)
     if (!bActive && m_pText) {
         m_pText->setText(tr("Not recording"));
     }
+    if (!bActive && m_pQueue) {
+        m_pQueue->clear();
+        m_pQueue->setVisible(false);
+    }
+}
+
+void WriteToFileStatusWidget::onRecorderStatus(int iQueueDepth, int iQueueCapacity, qint64 iLateBlocks, qint64 iLostBlocks)
+{
+    if (!m_pQueue) {
+        return;
+    }
+
+    m_pQueue->setText(tr("queue %1/%2").arg(iQueueDepth).arg(iQueueCapacity));
+    m_pQueue->setToolTip(tr("Late blocks: %1\nLost blocks: %2").arg(iLateBlocks).arg(iLostBlocks));
+
+    // Amber once the disk could not keep up, red once data was lost.
+    if (iLostBlocks > 0) {
+        m_pQueue->setStyleSheet(QStringLiteral("color: #e11d48; font-weight: bold;"));
+    } else if (iLateBlocks > 0) {
+        m_pQueue->setStyleSheet(QStringLiteral("color: #d97706;"));
+    } else {
+        m_pQueue->setStyleSheet(QString());
+    }
+    m_pQueue->setVisible(true);
 }
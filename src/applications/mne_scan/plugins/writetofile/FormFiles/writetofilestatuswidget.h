@@ -68,12 +68,20 @@ public:
      */
     bool isActive() const;
 
+    //=========================================================================================================
+    /**
+     * Current displayed write queue summary ("queue 3/64"). Useful for tests.
+     */
+    QString queueText() const;
+
 private:
     void onRecordingStatus(const QString& sSummary);
     void onRecordingActiveChanged(bool bActive);
+    void onRecorderStatus(int iQueueDepth, int iQueueCapacity, qint64 iLateBlocks, qint64 iLostBlocks);
 
     QPointer<QLabel> m_pDot;
     QPointer<QLabel> m_pText;
+    QPointer<QLabel> m_pQueue;
     bool             m_bActive;
 };
 
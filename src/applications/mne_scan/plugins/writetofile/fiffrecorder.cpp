@@ -0,0 +1,485 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     fiffrecorder.cpp
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    FiffRecorder class definition.
+ *
+ * push() runs on the acquisition thread and does the per-sample work:
+ * it scales each channel by its inverse calibration, converts to float
+ * straight into the payload of a reused FIFF_DATA_BUFFER tag and
+ * byte-swaps it in place. The writer thread only concatenates whole
+ * tags, so a device write covers as many queued blocks as fit into
+ * Settings::iCoalesceBytes. With Settings::iBlockSamples set, start()
+ * reserves every block for that size; otherwise a block is allocated by
+ * the first push() that fills it. Either way a block only grows again
+ * if a larger block arrives.
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiffrecorder.h"
+
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_file.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QDeadlineTimer>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QThread>
+#include <QtEndian>
+
+#if defined(Q_OS_WIN)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace WRITETOFILEPLUGIN;
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+constexpr int TAG_HEADER_SIZE = 16;     /**< kind, type, size and next of a FIFF tag. */
+
+//=============================================================================================================
+/**
+ * Pushes the file's written data from the OS cache to the disk.
+ */
+void syncFile(QFile& file)
+{
+#if defined(Q_OS_WIN)
+    _commit(file.handle());
+#else
+    ::fsync(file.handle());
+#endif
+}
+
+} // anonymous namespace
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRecorder::FiffRecorder(const Settings& settings)
+: m_settings(settings)
+, m_iSamplesPerFile(0)
+, m_bRecording(false)
+, m_bStopRequested(false)
+, m_iPushesInFlight(0)
+, m_iFileSamples(0)
+, m_iSplitCount(0)
+, m_bWriteFailed(false)
+{
+    m_settings.iQueueBlocks = qMax(1, m_settings.iQueueBlocks);
+}
+
+//=============================================================================================================
+
+FiffRecorder::~FiffRecorder()
+{
+    stop();
+}
+
+//=============================================================================================================
+
+bool FiffRecorder::start(const QString& sFileName,
+                         const FiffInfo& info)
+{
+    stop();
+
+    m_info = info;
+
+    m_sBaseName = sFileName;
+    if (m_sBaseName.endsWith(QStringLiteral("_raw.fif"))) {
+        m_sBaseName.chop(8);
+    } else if (m_sBaseName.endsWith(QStringLiteral(".fif"))) {
+        m_sBaseName.chop(4);
+    }
+
+    // Files are split before the block that would take them past iSplitBytes of data
+    const qint64 iBytesPerSample = 4 * qint64(qMax(1, info.nchan));
+    m_iSamplesPerFile = qMax<qint64>(1, m_settings.iSplitBytes / iBytesPerSample);
+
+    // Allocate the tags here rather than on the acquisition thread when the block size is known
+    const int iBlockBytes = m_settings.iBlockSamples > 0
+                            ? TAG_HEADER_SIZE + static_cast<int>(iBytesPerSample * m_settings.iBlockSamples)
+                            : 0;
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_blocks.assign(m_settings.iQueueBlocks, Block());
+        if (iBlockBytes > 0) {
+            for (Block& block : m_blocks) {
+                block.tag.reserve(iBlockBytes);
+            }
+        }
+        m_freeBlocks.clear();
+        m_filledBlocks.clear();
+        for (int i = 0; i < m_settings.iQueueBlocks; ++i) {
+            m_freeBlocks.enqueue(i);
+        }
+        m_stats = Stats();
+        m_stats.iQueueCapacity = m_settings.iQueueBlocks;
+        m_lFileNames.clear();
+        m_bStopRequested = false;
+        m_iPushesInFlight = 0;
+    }
+
+    {
+        QMutexLocker fileLocker(&m_fileMutex);
+        m_iSplitCount = 0;
+        m_bWriteFailed = false;
+        m_coalesceBuffer.clear();
+        if (!startFile(sFileName)) {
+            return false;
+        }
+    }
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_bRecording = true;
+    }
+
+    m_pWriterThread.reset(QThread::create([this]() { writeLoop(); }));
+    m_pWriterThread->start();
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool FiffRecorder::push(const MatrixXd& matData)
+{
+    QMutexLocker locker(&m_queueMutex);
+    if (!m_bRecording) {
+        return false;
+    }
+
+    // Wait for the writer to hand back a block; waiting at all makes the block late
+    bool bLate = false;
+    QDeadlineTimer deadline(m_settings.iBlockTimeoutMs);
+    while (m_freeBlocks.isEmpty()) {
+        bLate = true;
+        if (!m_blockFreed.wait(&m_queueMutex, deadline) && m_freeBlocks.isEmpty()) {
+            ++m_stats.iDroppedBlocks;
+            return false;
+        }
+        if (!m_bRecording) {
+            return false;
+        }
+    }
+    const int iBlock = m_freeBlocks.dequeue();
+    ++m_iPushesInFlight;
+    locker.unlock();
+
+    Block& block = m_blocks[iBlock];
+    const int iChannels = static_cast<int>(matData.rows());
+    const qint64 iElements = matData.size();
+    const qint32 header[4] = { FIFF_DATA_BUFFER, FIFFT_FLOAT, static_cast<qint32>(iElements * 4), FIFFV_NEXT_SEQ };
+
+    block.tag.resize(TAG_HEADER_SIZE + static_cast<int>(iElements * 4));
+    block.iSamples = static_cast<int>(matData.cols());
+    char* pTag = block.tag.data();
+    qToBigEndian<qint32>(header, 4, pTag);
+
+    // Same values as FiffStream::write_raw_buffer(matData, cals)
+    float* pPayload = reinterpret_cast<float*>(pTag + TAG_HEADER_SIZE);
+    Map<MatrixXf> staged(pPayload, iChannels, block.iSamples);
+    if (m_vecInvCals.size() == iChannels) {
+        staged = (m_vecInvCals.asDiagonal() * matData).cast<float>();
+    } else {
+        staged = matData.cast<float>();
+    }
+    qToBigEndian<quint32>(pPayload, iElements, pPayload);
+
+    locker.relock();
+    m_filledBlocks.enqueue(iBlock);
+    --m_iPushesInFlight;
+    if (bLate) {
+        ++m_stats.iLateBlocks;
+    }
+    m_stats.iQueueDepth = static_cast<int>(m_filledBlocks.size());
+    m_stats.iMaxQueueDepth = qMax(m_stats.iMaxQueueDepth, m_stats.iQueueDepth);
+    m_blockFilled.wakeOne();
+
+    return true;
+}
+
+//=============================================================================================================
+
+void FiffRecorder::stop()
+{
+    if (!m_pWriterThread) {
+        return;
+    }
+
+    {
+        QMutexLocker locker(&m_queueMutex);
+        m_bRecording = false;
+        m_bStopRequested = true;
+        m_blockFilled.wakeAll();
+        m_blockFreed.wakeAll();
+    }
+
+    m_pWriterThread->wait();
+    m_pWriterThread.reset();
+}
+
+//=============================================================================================================
+
+bool FiffRecorder::withClosedFile(const std::function<void(const QString&)>& fnCopy)
+{
+    QMutexLocker fileLocker(&m_fileMutex);
+    if (!m_file.isOpen()) {
+        return false;
+    }
+
+    m_file.close();
+    fnCopy(m_file.fileName());
+
+    if (!m_file.open(QIODevice::ReadWrite) || !m_file.seek(m_file.size())) {
+        qWarning() << "[FiffRecorder::withClosedFile] Could not reopen" << m_file.fileName();
+        return false;
+    }
+    return true;
+}
+
+//=============================================================================================================
+
+bool FiffRecorder::isRecording() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_bRecording;
+}
+
+//=============================================================================================================
+
+QStringList FiffRecorder::fileNames() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_lFileNames;
+}
+
+//=============================================================================================================
+
+FiffRecorder::Stats FiffRecorder::stats() const
+{
+    QMutexLocker locker(&m_queueMutex);
+    return m_stats;
+}
+
+//=============================================================================================================
+
+void FiffRecorder::writeLoop()
+{
+    QElapsedTimer flushTimer;
+    flushTimer.start();
+
+    QList<int> batch;
+
+    while (true) {
+        {
+            // A block taken by push() before stop() was requested still has to reach the file
+            QMutexLocker locker(&m_queueMutex);
+            while (m_filledBlocks.isEmpty() && !(m_bStopRequested && m_iPushesInFlight == 0)) {
+                m_blockFilled.wait(&m_queueMutex);
+            }
+            if (m_filledBlocks.isEmpty()) {
+                break;
+            }
+
+            // Take as many queued blocks as fit into one coalesced write, but at least one
+            qint64 iBytes = 0;
+            while (!m_filledBlocks.isEmpty()
+                   && (batch.isEmpty() || iBytes + m_blocks[m_filledBlocks.head()].tag.size() <= m_settings.iCoalesceBytes)) {
+                iBytes += m_blocks[m_filledBlocks.head()].tag.size();
+                batch.append(m_filledBlocks.dequeue());
+            }
+        }
+
+        qint64 iDataBytes = 0;
+        qint64 iFileBytes = 0;
+        qint64 iWrittenBlocks = 0;
+        qint64 iFailedBlocks = 0;
+        {
+            QMutexLocker fileLocker(&m_fileMutex);
+
+            // Blocks and data bytes waiting in m_coalesceBuffer, counted as written or failed once it is handed on
+            qint64 iPendingBlocks = 0;
+            qint64 iPendingBytes = 0;
+            auto writePending = [&]() {
+                if (writeCoalesced()) {
+                    iWrittenBlocks += iPendingBlocks;
+                    iDataBytes += iPendingBytes;
+                } else {
+                    iFailedBlocks += iPendingBlocks;
+                }
+                iPendingBlocks = 0;
+                iPendingBytes = 0;
+            };
+
+            for (int iBlock : batch) {
+                const Block& block = m_blocks[iBlock];
+                if (m_bWriteFailed) {
+                    ++iFailedBlocks;
+                    continue;
+                }
+                if (m_pStream && m_iFileSamples > 0 && m_iFileSamples + block.iSamples > m_iSamplesPerFile) {
+                    writePending();
+                    if (!m_bWriteFailed && !splitFile()) {
+                        m_bWriteFailed = true;
+                    }
+                    if (m_bWriteFailed) {
+                        ++iFailedBlocks;
+                        continue;
+                    }
+                }
+                m_coalesceBuffer.append(block.tag);
+                m_iFileSamples += block.iSamples;
+                ++iPendingBlocks;
+                iPendingBytes += block.tag.size() - TAG_HEADER_SIZE;
+            }
+            writePending();
+
+            if (m_settings.flushPolicy != FlushPolicy::None
+                && flushTimer.elapsed() >= m_settings.iFlushIntervalMs
+                && m_file.isOpen()) {
+                m_file.flush();
+                if (m_settings.flushPolicy == FlushPolicy::Sync) {
+                    syncFile(m_file);
+                }
+                flushTimer.restart();
+            }
+            iFileBytes = m_file.isOpen() ? m_file.size() : 0;
+        }
+
+        {
+            QMutexLocker locker(&m_queueMutex);
+            for (int iBlock : batch) {
+                m_freeBlocks.enqueue(iBlock);
+            }
+            m_stats.iBlocksWritten += iWrittenBlocks;
+            m_stats.iFailedBlocks += iFailedBlocks;
+            m_stats.iBytesWritten += iDataBytes;
+            if (iFailedBlocks > 0 && m_bRecording) {
+                // The file cannot continue; stop push() from queueing data that would be lost as well
+                qWarning() << "[FiffRecorder::writeLoop] Stopping the recording," << m_stats.iFailedBlocks << "blocks could not be written";
+                m_bRecording = false;
+            }
+            m_stats.iFileBytes = iFileBytes;
+            m_stats.iQueueDepth = static_cast<int>(m_filledBlocks.size());
+            m_blockFreed.wakeAll();
+        }
+        batch.clear();
+    }
+
+    // The queue is drained; close the recording
+    QMutexLocker fileLocker(&m_fileMutex);
+    if (m_pStream) {
+        if (m_settings.flushPolicy == FlushPolicy::Sync && m_file.isOpen()) {
+            m_file.flush();
+            syncFile(m_file);
+        }
+        m_pStream->finish_writing_raw();
+        m_pStream.clear();
+    }
+}
+
+//=============================================================================================================
+
+bool FiffRecorder::writeCoalesced()
+{
+    if (m_coalesceBuffer.isEmpty()) {
+        return true;
+    }
+
+    bool bWritten = false;
+    if (m_bWriteFailed || !m_file.isOpen()) {
+        // The recording could not continue after a failed write, split or reopen; the data has nowhere to go
+        m_bWriteFailed = true;
+    } else if (m_file.write(m_coalesceBuffer) != m_coalesceBuffer.size()) {
+        qWarning() << "[FiffRecorder::writeCoalesced] Could not write to" << m_file.fileName() << m_file.errorString();
+        m_bWriteFailed = true;
+    } else {
+        bWritten = true;
+    }
+    m_coalesceBuffer.clear();
+
+    return bWritten;
+}
+
+//=============================================================================================================
+
+bool FiffRecorder::splitFile()
+{
+    ++m_iSplitCount;
+    const QString sNextFileName = m_sBaseName + QString("-%1_raw.fif").arg(m_iSplitCount);
+
+    // Link the current file to the next one
+    qint32 data;
+    m_pStream->start_block(FIFFB_REF);
+    data = FIFFV_ROLE_NEXT_FILE;
+    m_pStream->write_int(FIFF_REF_ROLE, &data);
+    m_pStream->write_string(FIFF_REF_FILE_NAME, sNextFileName);
+    m_pStream->write_id(FIFF_REF_FILE_ID);
+    data = m_iSplitCount - 1;
+    m_pStream->write_int(FIFF_REF_FILE_NUM, &data);
+    m_pStream->end_block(FIFFB_REF);
+
+    m_pStream->finish_writing_raw();
+    m_pStream.clear();
+
+    return startFile(sNextFileName);
+}
+
+//=============================================================================================================
+
+bool FiffRecorder::startFile(const QString& sFileName)
+{
+    m_file.setFileName(sFileName);
+
+    RowVectorXd cals;
+    m_pStream = FiffStream::start_writing_raw(m_file, m_info, cals);
+    if (!m_pStream) {
+        qWarning() << "[FiffRecorder::startFile] Could not start" << sFileName;
+        return false;
+    }
+    m_pStream->set_append_dir_on_close(true);
+
+    // push() reads the calibrations concurrently; they are the same for every split file
+    if (m_iSplitCount == 0) {
+        m_vecInvCals = cals.transpose().cwiseInverse();
+    }
+
+    fiff_int_t first = 0;
+    m_pStream->write_int(FIFF_FIRST_SAMPLE, &first);
+    m_iFileSamples = 0;
+
+    QMutexLocker locker(&m_queueMutex);
+    m_lFileNames.append(sFileName);
+    m_stats.iFileBytes = m_file.size();
+
+    return true;
+}
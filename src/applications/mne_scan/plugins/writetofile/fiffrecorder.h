@@ -0,0 +1,272 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     fiffrecorder.h
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    FiffRecorder class declaration: write-behind FIFF raw recording with a bounded block queue.
+ *
+ * The acquisition side calls @ref WRITETOFILEPLUGIN::FiffRecorder::push,
+ * which calibrates a block and converts it straight into a reused
+ * FIFF_DATA_BUFFER tag. A dedicated writer thread drains the queue,
+ * coalesces the queued tags into large device writes, splits the
+ * recording at sample boundaries computed when the recording starts
+ * and flushes according to a configurable policy. A slow disk therefore
+ * only fills the queue instead of stalling the acquisition pipeline.
+ * Once the file cannot be written any more, the recorder counts the lost
+ * blocks and stops accepting data.
+ */
+
+#ifndef FIFFRECORDER_H
+#define FIFFRECORDER_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "writetofile_global.h"
+
+#include <fiff/fiff_info.h>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QByteArray>
+#include <QFile>
+#include <QMutex>
+#include <QQueue>
+#include <QSharedPointer>
+#include <QStringList>
+#include <QWaitCondition>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class QThread;
+
+namespace FIFFLIB {
+    class FiffStream;
+}
+
+//=============================================================================================================
+// DEFINE NAMESPACE WRITETOFILEPLUGIN
+//=============================================================================================================
+
+namespace WRITETOFILEPLUGIN
+{
+
+//=============================================================================================================
+/**
+ * Writes a FIFF raw recording on a background thread.
+ *
+ * @brief Write-behind FIFF raw recorder with a bounded queue of reused tag buffers.
+ */
+class WRITETOFILESHARED_EXPORT FiffRecorder
+{
+public:
+    typedef QSharedPointer<FiffRecorder> SPtr;             /**< Shared pointer type for FiffRecorder. */
+
+    /** When the writer thread pushes written data towards the disk. */
+    enum class FlushPolicy {
+        None,       /**< Leave it to the operating system. */
+        Flush,      /**< Flush the file every flush interval. */
+        Sync        /**< Flush and fsync the file every flush interval. */
+    };
+
+    /** Recorder configuration, fixed for the duration of a recording. */
+    struct Settings {
+        int         iQueueBlocks = 64;                      /**< Number of blocks the queue holds. */
+        int         iBlockSamples = 0;                      /**< Expected samples per pushed block, used to allocate the blocks in start(). 0 allocates them on the first push. */
+        int         iBlockTimeoutMs = 500;                  /**< How long push() waits for a free block before dropping data. */
+        qint64      iSplitBytes = 2000000000LL;             /**< Data bytes per file before the recording continues in the next file. */
+        qint64      iCoalesceBytes = 8 * 1024 * 1024;       /**< Upper bound of queued bytes handed to one device write. */
+        FlushPolicy flushPolicy = FlushPolicy::Flush;       /**< Flush policy of the writer thread. */
+        int         iFlushIntervalMs = 1000;                /**< Minimum time between two flushes. */
+    };
+
+    /** Queue and writer statistics, for display in the plugin UI. */
+    struct Stats {
+        int     iQueueDepth = 0;        /**< Blocks currently waiting for the writer. */
+        int     iMaxQueueDepth = 0;     /**< Largest queue depth seen during this recording. */
+        int     iQueueCapacity = 0;     /**< Number of blocks the queue holds. */
+        qint64  iBlocksWritten = 0;     /**< Blocks written to disk. */
+        qint64  iLateBlocks = 0;        /**< Blocks that had to wait for a free queue slot. */
+        qint64  iDroppedBlocks = 0;     /**< Blocks dropped because no queue slot became free in time. */
+        qint64  iFailedBlocks = 0;      /**< Blocks lost because the file could not be written or split. */
+        qint64  iBytesWritten = 0;      /**< Data buffer bytes written over all files. */
+        qint64  iFileBytes = 0;         /**< Size of the file currently written. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Constructs an idle FiffRecorder.
+     *
+     * @param[in] settings   The recorder configuration.
+     */
+    explicit FiffRecorder(const Settings& settings = Settings());
+
+    //=========================================================================================================
+    /**
+     * Stops a running recording and destroys the FiffRecorder.
+     */
+    ~FiffRecorder();
+
+    //=========================================================================================================
+    /**
+     * Writes the measurement info to a new raw file and starts the writer thread.
+     *
+     * @param[in] sFileName  The file to record to. Split files are named <name>-<n>_raw.fif.
+     * @param[in] info       The measurement info of the recorded data.
+     *
+     * @return true if the file was started, false otherwise.
+     */
+    bool start(const QString& sFileName,
+               const FIFFLIB::FiffInfo& info);
+
+    //=========================================================================================================
+    /**
+     * Queues a block of data (channels x samples, physical units) for writing. Waits up to
+     * Settings::iBlockTimeoutMs for a free queue slot and drops the block if none becomes free.
+     * Called by one producer thread at a time.
+     *
+     * @param[in] matData    The block to record.
+     *
+     * @return true if the block was queued, false if it was dropped or the recorder is not running, e.g. because
+     *         the file could not be written.
+     */
+    bool push(const Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+     * Writes all queued blocks, finishes the current file and stops the writer thread.
+     */
+    void stop();
+
+    //=========================================================================================================
+    /**
+     * Runs fnCopy on the closed current file between two device writes, then reopens it for appending.
+     * Used to hand a consistent copy of a running recording to other applications.
+     *
+     * @param[in] fnCopy     Receives the name of the current file.
+     *
+     * @return true if the file was reopened for recording, false otherwise.
+     */
+    bool withClosedFile(const std::function<void(const QString&)>& fnCopy);
+
+    //=========================================================================================================
+    /**
+     * Returns whether a recording is running. Turns false on its own once the file cannot be written.
+     *
+     * @return true while recording.
+     */
+    bool isRecording() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the files written by the current or last recording, in order.
+     *
+     * @return The file names.
+     */
+    QStringList fileNames() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the queue and writer statistics of the current or last recording.
+     *
+     * @return The statistics.
+     */
+    Stats stats() const;
+
+private:
+    /** One reused FIFF_DATA_BUFFER tag. */
+    struct Block {
+        QByteArray  tag;                /**< Tag header and big-endian float payload. */
+        int         iSamples = 0;       /**< Samples held by the tag. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Writer thread main loop.
+     */
+    void writeLoop();
+
+    //=========================================================================================================
+    /**
+     * Hands the coalesced tags to the device and empties the coalesce buffer. After the first failed write all
+     * further data is discarded. Called with m_fileMutex held.
+     *
+     * @return true if the buffer was written completely, false if its data was lost.
+     */
+    bool writeCoalesced();
+
+    //=========================================================================================================
+    /**
+     * Links the current file to the next one, finishes it and starts the next file. Called with m_fileMutex
+     * held.
+     *
+     * @return true if the next file was started, false otherwise.
+     */
+    bool splitFile();
+
+    //=========================================================================================================
+    /**
+     * Opens sFileName, writes the measurement info and the first sample. Called with m_fileMutex held.
+     *
+     * @param[in] sFileName  The file to start.
+     *
+     * @return true if the file was started, false otherwise.
+     */
+    bool startFile(const QString& sFileName);
+
+    Settings                            m_settings;             /**< Recorder configuration. */
+
+    FIFFLIB::FiffInfo                   m_info;                 /**< Measurement info written to every file. */
+    Eigen::VectorXd                     m_vecInvCals;           /**< Inverse channel calibrations applied in push(). */
+    qint64                              m_iSamplesPerFile;      /**< Split boundary in samples, derived from Settings::iSplitBytes. */
+    QString                             m_sBaseName;            /**< File name without the _raw.fif suffix, for split files. */
+
+    mutable QMutex                      m_queueMutex;           /**< Guards the queues, the stats and the file names. */
+    QWaitCondition                      m_blockFreed;           /**< Signalled when the writer returns blocks. */
+    QWaitCondition                      m_blockFilled;          /**< Signalled when push() queues a block or stop() is requested. */
+    std::vector<Block>                  m_blocks;               /**< The blocks handed between push() and the writer. */
+    QQueue<int>                         m_freeBlocks;           /**< Indices of blocks push() may fill. */
+    QQueue<int>                         m_filledBlocks;         /**< Indices of blocks waiting for the writer. */
+    bool                                m_bRecording;           /**< Whether push() accepts data. */
+    bool                                m_bStopRequested;       /**< Whether the writer should drain the queue and finish. */
+    int                                 m_iPushesInFlight;      /**< Blocks taken by push() but not queued yet. */
+    Stats                               m_stats;                /**< Queue and writer statistics. */
+    QStringList                         m_lFileNames;           /**< Files written so far. */
+
+    QMutex                              m_fileMutex;            /**< Serializes device access between the writer and withClosedFile(). */
+    QFile                               m_file;                 /**< The file currently written. */
+    QSharedPointer<FIFFLIB::FiffStream> m_pStream;              /**< FIFF stream on m_file. */
+    QByteArray                          m_coalesceBuffer;       /**< Tags collected for the next device write. */
+    qint64                              m_iFileSamples;         /**< Samples written to the current file. */
+    qint32                              m_iSplitCount;          /**< Number of files started after the first one. */
+    bool                                m_bWriteFailed;         /**< Whether a write or split failed, so the recording cannot continue. */
+
+    std::unique_ptr<QThread>            m_pWriterThread;        /**< The writer thread. */
+};
+
+} // NAMESPACE
+
+#endif // FIFFRECORDER_H
@@ -44,7 +44,6 @@
 
 #include <disp/viewers/projectsettingsview.h>
 #include <scMeas/realtimemultisamplearray.h>
-#include <fiff/fiff_stream.h>
 
 #include <QFileInfo>
 
@@ -77,7 +76,6 @@ WriteToFile::WriteToFile()
 , m_bUseRecordTimer(false)
 , m_bContinuous(false) //CHANGE TO USER TOGGLE ASAP
 , m_iBlinkStatus(0)
-, m_iSplitCount(0)
 , m_iRecordingMSeconds(5*60*1000)
 , m_pCircularBuffer(CircularBuffer_Matrix_double::SPtr(new CircularBuffer_Matrix_double(40)))
 {
@@ -300,30 +298,20 @@ void WriteToFile::initPluginControlWidgets()
 void WriteToFile::run()
 {
     MatrixXd matData;
-    qint32 size = 0;
 
     while(!isInterruptionRequested()) {
         if(m_pCircularBuffer) {
             //pop matrix
 
             if(m_pCircularBuffer->pop(matData)) {
-                //Write raw data to fif file
+                //Hand the raw data to the recorder, which writes and splits the fif files on its own thread
                 m_mutex.lock();
-                if(m_bWriteToFile) {
-                    size += matData.rows()*matData.cols() * 4;
-
-                    if(size > MAX_DATA_LEN) {
-                        size = 0;
-                        this->splitRecordingFile();
-                    }
-
-                    if(m_pOutfid) {
-                        m_pOutfid->write_raw_buffer(matData, m_mCals);
-                    }
-                } else {
-                    size = 0;
-                }
+                FiffRecorder::SPtr pRecorder = m_bWriteToFile ? m_pRecorder : FiffRecorder::SPtr();
                 m_mutex.unlock();
+
+                if(pRecorder) {
+                    pRecorder->push(matData);
+                }
             }
         }
     }
@@ -368,11 +356,23 @@ void WriteToFile::toggleRecordingFile()
     //Setup writing to file
     if(m_bWriteToFile) {
         m_mutex.lock();
-        m_pOutfid->finish_writing_raw();
+        m_bWriteToFile = false;
+        FiffRecorder::SPtr pRecorder = m_pRecorder;
         m_mutex.unlock();
 
-        m_bWriteToFile = false;
-        m_iSplitCount = 0;
+        //Write the queued data and finish the last file
+        if(pRecorder) {
+            pRecorder->stop();
+
+            const QStringList lFiles = pRecorder->fileNames();
+            m_lFileNames.clear();
+            for(const QString& sFile : lFiles) {
+                m_lFileNames.append(QFileInfo(sFile).fileName());
+            }
+            if(!lFiles.isEmpty()) {
+                m_qFileOut.setFileName(lFiles.last());
+            }
+        }
 
         //Stop record timer
         m_pRecordTimer->stop();
@@ -389,8 +389,6 @@ void WriteToFile::toggleRecordingFile()
         promptFileName();
 
     } else {
-        m_iSplitCount = 0;
-
         if(!m_pFiffInfo) {
             popUp("FiffInfo missing!");
             return;
@@ -418,17 +416,20 @@ void WriteToFile::toggleRecordingFile()
             m_pFiffInfo->projs[i].active = false;
         }
 
-        //Start/Prepare writing process. Actual writing is done in run() method.
-        m_mutex.lock();
-        m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                                  *m_pFiffInfo,
-                                                  m_mCals);
+        //Start/Prepare writing process. Data is handed to the recorder in run() method.
+        FiffRecorder::Settings settings = m_recorderSettings;
+        settings.iSplitBytes = MAX_DATA_LEN;
+        FiffRecorder::SPtr pRecorder = FiffRecorder::SPtr::create(settings);
+        if(!pRecorder->start(m_sRecordFileName, *m_pFiffInfo)) {
+            popUp("Could not start recording to " + m_sRecordFileName);
+            return;
+        }
 
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
+        m_mutex.lock();
+        m_pRecorder = pRecorder;
+        m_bWriteToFile = true;
         m_mutex.unlock();
 
-        m_bWriteToFile = true;
         m_pActionRecordFile->setText(tr("Stop Recording"));
         m_pActionRecordFile->setStatusTip(tr("Stop Recording"));
 
@@ -445,49 +446,9 @@ void WriteToFile::toggleRecordingFile()
         if(m_bUseRecordTimer) {
             m_pRecordTimer->start(m_iRecordingMSeconds);
         }
-
-        m_lFileNames.append(QFileInfo(m_qFileOut).fileName());
     }
 }
 
-//=============================================================================================================
-#include <iostream>
-void WriteToFile::splitRecordingFile()
-{
-    //qDebug() << "Split recording file";
-    ++m_iSplitCount;
-    QString nextFileName = m_sRecordFileName.remove("_raw.fif");
-    nextFileName += QString("-%1_raw.fif").arg(m_iSplitCount);
-
-    //Write the link to the next file
-    qint32 data;
-    m_pOutfid->start_block(FIFFB_REF);
-    data = FIFFV_ROLE_NEXT_FILE;
-    m_pOutfid->write_int(FIFF_REF_ROLE,&data);
-    m_pOutfid->write_string(FIFF_REF_FILE_NAME, nextFileName);
-    m_pOutfid->write_id(FIFF_REF_FILE_ID);//ToDo meas_id
-    data = m_iSplitCount - 1;
-    m_pOutfid->write_int(FIFF_REF_FILE_NUM, &data);
-    m_pOutfid->end_block(FIFFB_REF);
-
-    //finish file
-    m_pOutfid->finish_writing_raw();
-
-    //start next file
-    m_qFileOut.setFileName(nextFileName);
-    MatrixXi sel;
-    m_pOutfid = FiffStream::start_writing_raw(m_qFileOut,
-                                              *m_pFiffInfo,
-                                              m_mCals,
-                                              sel,
-                                              false);
-
-    fiff_int_t first = 0;
-    m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
-
-    m_lFileNames.append(QFileInfo(m_qFileOut).fileName());
-}
-
 //=============================================================================================================
 
 void WriteToFile::changeRecordingButton()
@@ -507,16 +468,18 @@ void WriteToFile::clipRecording(bool bChecked)
 {
     Q_UNUSED(bChecked);
 
-    QMutexLocker locker(&m_mutex);
+    m_mutex.lock();
+    FiffRecorder::SPtr pRecorder = m_bWriteToFile ? m_pRecorder : FiffRecorder::SPtr();
+    m_mutex.unlock();
 
-    m_qFileOut.close();
-    m_FileSharer.copyRealtimeFile(m_qFileOut.fileName());
-    if (!m_qFileOut.open(QIODevice::ReadWrite)) {
-        qWarning() << "Could not reopen realtime file:" << m_qFileOut.fileName();
+    if (!pRecorder) {
         return;
     }
 
-    m_pOutfid->skipRawData(m_qFileOut.bytesAvailable());
+    //The recorder closes the file between two writes and reopens it at its end afterwards
+    if (!pRecorder->withClosedFile([this](const QString& sFileName) { m_FileSharer.copyRealtimeFile(sFileName); })) {
+        qWarning() << "Could not reopen realtime file:" << m_qFileOut.fileName();
+    }
 }
 
 //=============================================================================================================
@@ -663,6 +626,20 @@ QVariantMap WriteToFile::getAttributes() const
 {
     QVariantMap attrs;
     attrs[QStringLiteral("recordFileName")] = m_sRecordFileName;
+
+    switch (m_recorderSettings.flushPolicy) {
+    case FiffRecorder::FlushPolicy::None:
+        attrs[QStringLiteral("flushPolicy")] = QStringLiteral("none");
+        break;
+    case FiffRecorder::FlushPolicy::Sync:
+        attrs[QStringLiteral("flushPolicy")] = QStringLiteral("sync");
+        break;
+    default:
+        attrs[QStringLiteral("flushPolicy")] = QStringLiteral("flush");
+        break;
+    }
+    attrs[QStringLiteral("flushIntervalMs")] = m_recorderSettings.iFlushIntervalMs;
+    attrs[QStringLiteral("queueBlocks")] = m_recorderSettings.iQueueBlocks;
     return attrs;
 }
 
@@ -672,6 +649,22 @@ void WriteToFile::setAttributes(const QVariantMap& attributes)
 {
     if (attributes.contains(QStringLiteral("recordFileName")))
         m_sRecordFileName = attributes[QStringLiteral("recordFileName")].toString();
+
+    // Take effect with the next recording
+    if (attributes.contains(QStringLiteral("flushPolicy"))) {
+        const QString sPolicy = attributes[QStringLiteral("flushPolicy")].toString().toLower();
+        if (sPolicy == QLatin1String("none")) {
+            m_recorderSettings.flushPolicy = FiffRecorder::FlushPolicy::None;
+        } else if (sPolicy == QLatin1String("sync")) {
+            m_recorderSettings.flushPolicy = FiffRecorder::FlushPolicy::Sync;
+        } else {
+            m_recorderSettings.flushPolicy = FiffRecorder::FlushPolicy::Flush;
+        }
+    }
+    if (attributes.contains(QStringLiteral("flushIntervalMs")))
+        m_recorderSettings.iFlushIntervalMs = qMax(0, attributes[QStringLiteral("flushIntervalMs")].toInt());
+    if (attributes.contains(QStringLiteral("queueBlocks")))
+        m_recorderSettings.iQueueBlocks = qMax(1, attributes[QStringLiteral("queueBlocks")].toInt());
 }
 
 //=============================================================================================================
@@ -688,20 +681,33 @@ void WriteToFile::emitRecordingStatus()
 {
     qint64 iElapsed = 0;
     qint64 iSize    = 0;
+    FiffRecorder::SPtr pRecorder;
     {
         QMutexLocker locker(&m_mutex);
         if (!m_bWriteToFile) {
             return;
         }
         iElapsed = m_recordingStartedTime.isValid() ? m_recordingStartedTime.elapsed() : 0;
-        if (m_qFileOut.exists()) {
-            QFileInfo fi(m_qFileOut.fileName());
-            iSize = fi.size();
-        }
+        pRecorder = m_pRecorder;
     }
+
+    FiffRecorder::Stats stats;
+    if (pRecorder) {
+        stats = pRecorder->stats();
+        iSize = stats.iFileBytes;
+    } else if (m_qFileOut.exists()) {
+        QFileInfo fi(m_qFileOut.fileName());
+        iSize = fi.size();
+    }
+
     const QString summary = QStringLiteral("%1  %2")
         .arg(formatElapsed(iElapsed), formatBytes(iSize));
     emit recordingStatus(summary);
+
+    if (pRecorder) {
+        emit recorderStatus(stats.iQueueDepth, stats.iQueueCapacity, stats.iLateBlocks,
+                            stats.iDroppedBlocks + stats.iFailedBlocks);
+    }
 }
 
 //=============================================================================================================
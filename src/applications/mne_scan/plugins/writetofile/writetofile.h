@@ -41,6 +41,7 @@
 //=============================================================================================================
 
 #include "writetofile_global.h"
+#include "fiffrecorder.h"
 
 #include <utils/generics/circularbuffer.h>
 #include <scShared/Plugins/abstractalgorithm.h>
@@ -69,7 +70,6 @@ class TestWriteToFileStatus;
 
 namespace FIFFLIB{
     class FiffInfo;
-    class FiffStream;
 }
 
 namespace SCMEASLIB{
@@ -155,6 +155,20 @@ signals:
      */
     void recordingActiveChanged(bool bActive);
 
+    //=========================================================================================================
+    /**
+     * Emitted together with recordingStatus while recording with the state of the write-behind queue.
+     *
+     * @param[in] iQueueDepth       Blocks waiting for the writer thread.
+     * @param[in] iQueueCapacity    Number of blocks the queue holds.
+     * @param[in] iLateBlocks       Blocks that had to wait for a free queue slot so far.
+     * @param[in] iLostBlocks       Blocks lost so far, because the queue stayed full or the file could not be written.
+     */
+    void recorderStatus(int iQueueDepth,
+                        int iQueueCapacity,
+                        qint64 iLateBlocks,
+                        qint64 iLostBlocks);
+
 public:
 
     //=========================================================================================================
@@ -224,12 +238,6 @@ private:
      */
     void toggleRecordingFile();
 
-    //=========================================================================================================
-    /**
-     * Determines current file. And starts a new one.
-     */
-    void splitRecordingFile();
-
     //=========================================================================================================
     /**
      * change recording button.
@@ -312,13 +320,13 @@ private:
     bool                                    m_bContinuous;                  /**< Flag for whether to start plugin in continuous save mode */
 
     qint16                                  m_iBlinkStatus;                 /**< The blink status of the recording button.*/
-    qint32                                  m_iSplitCount;                  /**< File split count. */
     int                                     m_iRecordingMSeconds;           /**< Recording length in mseconds.*/
 
     QMutex                                  m_mutex;                        /**< The threads mutex.*/
 
     QSharedPointer<FIFFLIB::FiffInfo>       m_pFiffInfo;                    /**< Fiff measurement info.*/
-    QSharedPointer<FIFFLIB::FiffStream>     m_pOutfid;                      /**< FiffStream to write to.*/
+    FiffRecorder::SPtr                      m_pRecorder;                    /**< Write-behind recorder of the current recording.*/
+    FiffRecorder::Settings                  m_recorderSettings;             /**< Queue and flush settings used for new recordings.*/
 
     QSharedPointer<QTimer>                  m_pUpdateTimeInfoTimer;         /**< timer to control remaining time. */
     QSharedPointer<QTimer>                  m_pBlinkingRecordButtonTimer;   /**< timer to control blinking recording button. */
@@ -356,8 +364,6 @@ private:
 
     SCSHAREDLIB::PluginInputData<SCMEASLIB::RealTimeMultiSampleArray>::SPtr      m_pWriteToFileInput;   /**< The RealTimeMultiSampleArray of the WriteToFile input.*/
 
-    Eigen::RowVectorXd                      m_mCals;                        /**< Row vector with channel calibration values. */
-
     FIFFLIB::FiffFileSharer                 m_FileSharer;                   /**< Handles copying recording file and saving copy to shared directory. */
 
     QStringList                             m_lFileNames;                   /**< List of file names of latest recording */
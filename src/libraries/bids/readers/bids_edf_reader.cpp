@@ -18,12 +18,17 @@
 
 #include <fiff/fiff_constants.h>
 
+#include <algorithm>
+#include <numeric>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QDebug>
 #include <QIODevice>
+#include <QtEndian>
+#include <QtConcurrent>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -33,6 +38,61 @@ using namespace BIDSLIB;
 using namespace FIFFLIB;
 using namespace Eigen;
 
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+const int BYTES_PER_TASK = 1 << 18;     /**< Amount of record data decoded by one concurrent task. */
+
+/**
+ * Sample k of a channel stored as 16-bit little-endian integers (EDF).
+ */
+inline qint32 sampleInt16(const uchar* pChannel, int k)
+{
+    return qFromLittleEndian<qint16>(pChannel + 2 * k);
+}
+
+/**
+ * Sample k of a channel stored as 24-bit little-endian integers (BDF).
+ */
+inline qint32 sampleInt24(const uchar* pChannel, int k)
+{
+    const uchar* p = pChannel + 3 * k;
+    // Assemble in the upper three bytes, the arithmetic shift extends the sign
+    return static_cast<qint32>(static_cast<quint32>(p[0]) << 8
+                               | static_cast<quint32>(p[1]) << 16
+                               | static_cast<quint32>(p[2]) << 24) >> 8;
+}
+
+/**
+ * Converts the samples [iFirst, iFirst + iCount) of one channel of a record to physical values. Full-rate channels
+ * are read contiguously, lower-rate channels through their index table; either loop is free of branches.
+ */
+template<qint32 (*Sample)(const uchar*, int)>
+void decodeChannel(const uchar* pChannel,
+                   const std::vector<int>& vSourceIdx,
+                   int iFirst,
+                   int iCount,
+                   float fGain,
+                   float fOffset,
+                   float* pOut)
+{
+    if(vSourceIdx.empty()) {
+        for(int k = 0; k < iCount; ++k) {
+            pOut[k] = static_cast<float>(Sample(pChannel, iFirst + k)) * fGain + fOffset;
+        }
+    } else {
+        const int* pIdx = vSourceIdx.data() + iFirst;
+        for(int k = 0; k < iCount; ++k) {
+            pOut[k] = static_cast<float>(Sample(pChannel, pIdx[k])) * fGain + fOffset;
+        }
+    }
+}
+
+} // anonymous namespace
+
 //=============================================================================================================
 // EDFChannelInfo
 //=============================================================================================================
@@ -93,8 +153,10 @@ FiffChInfo EDFChannelInfo::toFiffChInfo() const
 // EDFReader
 //=============================================================================================================
 
-EDFReader::EDFReader(float fScaleFactor)
+EDFReader::EDFReader(float fScaleFactor,
+                     bool bIncludeAllChannels)
     : m_fScaleFactor(fScaleFactor)
+    , m_bIncludeAllChannels(bIncludeAllChannels)
 {
 }
 
@@ -132,8 +194,10 @@ void EDFReader::parseHeader(QIODevice* pDev)
         pDev->seek(0);
     }
 
-    // General header fields
-    m_sVersionNo = QString::fromLatin1(pDev->read(EDF_VERSION)).trimmed();
+    // General header fields, BDF marks its version field with a leading 0xFF byte
+    const QByteArray baVersion = pDev->read(EDF_VERSION);
+    m_sVersionNo = QString::fromLatin1(baVersion).trimmed();
+    m_iBytesPerSample = (!baVersion.isEmpty() && static_cast<uchar>(baVersion.at(0)) == 0xFF) ? 3 : 2;
     m_sPatientId = QString::fromLatin1(pDev->read(LOCAL_PATIENT_INFO)).trimmed();
     m_sRecordingId = QString::fromLatin1(pDev->read(LOCAL_RECORD_INFO)).trimmed();
     m_startDateTime.setDate(QDate::fromString(QString::fromLatin1(pDev->read(STARTDATE)), "dd.MM.yy"));
@@ -190,6 +254,7 @@ void EDFReader::parseHeader(QIODevice* pDev)
                          ? vSamplesPerRecord[i] / m_fDataRecordsDuration
                          : 0.0f;
         ch.isMeasurement = false;
+        ch.isAnnotation = (ch.label == QLatin1String("EDF Annotations") || ch.label == QLatin1String("BDF Annotations"));
         m_vAllChannels.push_back(ch);
     }
 
@@ -202,34 +267,91 @@ void EDFReader::parseHeader(QIODevice* pDev)
     // Calculate bytes per data record
     m_iNumBytesPerDataRecord = 0;
     for(const auto& ch : m_vAllChannels) {
-        m_iNumBytesPerDataRecord += ch.samplesPerRecord * 2;  // 16-bit integers
+        m_iNumBytesPerDataRecord += ch.samplesPerRecord * m_iBytesPerSample;  // 16-bit (EDF) or 24-bit (BDF) integers
     }
 
-    // Identify measurement channels (those with the highest sample rate)
+    // Identify measurement channels (those with the highest sample rate). Annotation signals hold text and
+    // often use more bytes per record than the data channels, so they take no part.
     long iMaxSamplesPerRecord = -1;
     for(const auto& ch : m_vAllChannels) {
-        if(ch.samplesPerRecord > iMaxSamplesPerRecord) {
+        if(!ch.isAnnotation && ch.samplesPerRecord > iMaxSamplesPerRecord) {
             iMaxSamplesPerRecord = ch.samplesPerRecord;
         }
     }
 
     m_vMeasChannels.clear();
+    m_vDataChannels.clear();
     for(int i = 0; i < m_vAllChannels.size(); ++i) {
+        if(m_vAllChannels[i].isAnnotation) {
+            continue;
+        }
         if(m_vAllChannels[i].samplesPerRecord == iMaxSamplesPerRecord) {
             m_vAllChannels[i].isMeasurement = true;
             m_vMeasChannels.push_back(m_vAllChannels[i]);
         }
+        m_vDataChannels.push_back(m_vAllChannels[i]);
+    }
+
+    setupDecoders();
+}
+
+//=============================================================================================================
+
+void EDFReader::setupDecoders()
+{
+    m_vDecoders.clear();
+
+    const long iMaxSamplesPerRecord = m_vMeasChannels.isEmpty() ? 0 : m_vMeasChannels[0].samplesPerRecord;
+    int iByteOffset = 0;
+
+    for(const auto& ch : m_vAllChannels) {
+        if(ch.isMeasurement || (m_bIncludeAllChannels && !ch.isAnnotation)) {
+            ChannelDecoder decoder;
+            decoder.iByteOffset = iByteOffset;
+
+            // phys = (dig - digMin) / digRange * physRange + physMin, folded into one multiply-add
+            const double dGain = static_cast<double>(ch.physicalMax - ch.physicalMin)
+                                 / static_cast<double>(ch.digitalMax - ch.digitalMin);
+            const double dOffset = ch.physicalMin - ch.digitalMin * dGain;
+            const double dScale = ch.isMeasurement ? m_fScaleFactor : 1.0;
+            decoder.fGain = static_cast<float>(dGain / dScale);
+            decoder.fOffset = static_cast<float>(dOffset / dScale);
+
+            // Hold each sample of a lower-rate channel for the corresponding full-rate samples
+            if(ch.samplesPerRecord != iMaxSamplesPerRecord) {
+                decoder.vSourceIdx.resize(iMaxSamplesPerRecord);
+                for(long s = 0; s < iMaxSamplesPerRecord; ++s) {
+                    decoder.vSourceIdx[s] = static_cast<int>(s * ch.samplesPerRecord / iMaxSamplesPerRecord);
+                }
+                if(ch.samplesPerRecord <= 0) {
+                    // No samples at all: read zeros from the start of the record
+                    decoder.iByteOffset = 0;
+                    decoder.fGain = 0.0f;
+                    decoder.fOffset = 0.0f;
+                }
+            }
+
+            m_vDecoders.push_back(decoder);
+        }
+        iByteOffset += ch.samplesPerRecord * m_iBytesPerSample;
     }
 }
 
 //=============================================================================================================
 
+const QVector<EDFChannelInfo>& EDFReader::readChannels() const
+{
+    return m_bIncludeAllChannels ? m_vDataChannels : m_vMeasChannels;
+}
+
+//=============================================================================================================
+
 FiffInfo EDFReader::getInfo() const
 {
     FiffInfo info;
-    info.nchan = m_vMeasChannels.size();
+    info.nchan = readChannels().size();
 
-    for(const auto& ch : m_vMeasChannels) {
+    for(const auto& ch : readChannels()) {
         FiffChInfo fiffCh = ch.toFiffChInfo();
         info.chs.append(fiffCh);
         info.ch_names.append(fiffCh.ch_name);
@@ -267,69 +389,85 @@ MatrixXf EDFReader::readRawSegment(int iStartSampleIdx, int iEndSampleIdx) const
     }
 
     // Calculate which data records to read
-    int iFirstRecord = iStartSampleIdx / iSamplesPerRecord;
-    int iRelativeFirst = iStartSampleIdx % iSamplesPerRecord;
-    int iNumRecords = static_cast<int>(
-        std::ceil(static_cast<float>(iNumSamples + iRelativeFirst) / iSamplesPerRecord));
-
-    // Seek to first needed data record
-    m_file.seek(m_iNumBytesInHeader + static_cast<qint64>(iFirstRecord) * m_iNumBytesPerDataRecord);
-
-    // Read needed data records
-    QVector<QByteArray> vRecords;
-    vRecords.reserve(iNumRecords);
-    for(int i = 0; i < iNumRecords; ++i) {
-        vRecords.push_back(m_file.read(m_iNumBytesPerDataRecord));
+    const int iFirstRecord = iStartSampleIdx / iSamplesPerRecord;
+    const int iRelativeFirst = iStartSampleIdx % iSamplesPerRecord;
+    const int iNumRecords = (iNumSamples + iRelativeFirst + iSamplesPerRecord - 1) / iSamplesPerRecord;
+
+    const qint64 iDataOffset = m_iNumBytesInHeader + static_cast<qint64>(iFirstRecord) * m_iNumBytesPerDataRecord;
+    const qint64 iDataSize = static_cast<qint64>(iNumRecords) * m_iNumBytesPerDataRecord;
+
+    // Map all needed data records, or read them with a single call if the file cannot be mapped
+    QByteArray baRecords;
+    uchar* pMapped = m_file.map(iDataOffset, iDataSize);
+    const uchar* pRecords = pMapped;
+    if(!pRecords) {
+        m_file.seek(iDataOffset);
+        baRecords = m_file.read(iDataSize);
+        if(baRecords.size() < iDataSize) {
+            qWarning() << "[EDFReader::readRawSegment] Could only read" << baRecords.size() << "of" << iDataSize << "bytes";
+            return MatrixXf();
+        }
+        pRecords = reinterpret_cast<const uchar*>(baRecords.constData());
     }
 
-    // Demultiplex: channels are interleaved within each record
-    QVector<QVector<int>> vRawPatches(m_vAllChannels.size());
-    for(int iRec = 0; iRec < vRecords.size(); ++iRec) {
-        int iOffset = 0;
-        for(int iCh = 0; iCh < m_vAllChannels.size(); ++iCh) {
-            int nSamp = m_vAllChannels[iCh].samplesPerRecord;
-            QVector<int> patch(nSamp);
-            for(int s = 0; s < nSamp; ++s) {
-                int byteIdx = (iOffset + s) * 2;
-                // 16-bit little-endian signed integer
-                patch[s] = static_cast<int16_t>(
-                    (static_cast<unsigned char>(vRecords[iRec].at(byteIdx + 1)) << 8) |
-                    (static_cast<unsigned char>(vRecords[iRec].at(byteIdx))));
-            }
-            iOffset += nSamp;
-            vRawPatches[iCh] += patch;
+    // Decode into a row-major buffer, so that every channel of a record lands in one contiguous run
+    Matrix<float, Dynamic, Dynamic, RowMajor> matData(m_vDecoders.size(), iNumSamples);
+
+    const int iRecordsPerTask = std::max(1, BYTES_PER_TASK / m_iNumBytesPerDataRecord);
+    auto decodeRecords = [&](int iRecBegin) {
+        const int iRecEnd = std::min(iRecBegin + iRecordsPerTask, iNumRecords);
+        for(int iRec = iRecBegin; iRec < iRecEnd; ++iRec) {
+            // Segment column of the first record sample, and the part of the record inside the segment
+            const int iColumn = iRec * iSamplesPerRecord - iRelativeFirst;
+            const int iFirst = std::max(0, -iColumn);
+            const int iLast = std::min(iSamplesPerRecord, iNumSamples - iColumn);
+            decodeRecord(pRecords + static_cast<qint64>(iRec) * m_iNumBytesPerDataRecord,
+                         iFirst,
+                         iLast,
+                         matData.data() + iColumn + iFirst,
+                         iNumSamples);
         }
-    }
+    };
 
-    // Filter to measurement channels only
-    QVector<QVector<int>> vMeasPatches;
-    vMeasPatches.reserve(m_vMeasChannels.size());
-    for(int iCh = 0; iCh < m_vAllChannels.size(); ++iCh) {
-        if(m_vAllChannels[iCh].isMeasurement) {
-            vMeasPatches.push_back(vRawPatches[iCh]);
+    if(iNumRecords <= iRecordsPerTask) {
+        decodeRecords(0);
+    } else {
+        std::vector<int> vTaskBegins;
+        for(int iRec = 0; iRec < iNumRecords; iRec += iRecordsPerTask) {
+            vTaskBegins.push_back(iRec);
         }
+        QtConcurrent::blockingMap(vTaskBegins, decodeRecords);
     }
 
-    // Scale and copy to result matrix
-    MatrixXf result(vMeasPatches.size(), iNumSamples);
+    if(pMapped) {
+        m_file.unmap(pMapped);
+    }
 
-    for(int iCh = 0; iCh < vMeasPatches.size(); ++iCh) {
-        const EDFChannelInfo& ch = m_vMeasChannels[iCh];
-        float digRange = static_cast<float>(ch.digitalMax - ch.digitalMin);
-        float physRange = ch.physicalMax - ch.physicalMin;
+    return matData;
+}
 
-        for(int s = 0; s < iNumSamples; ++s) {
-            int rawIdx = s + iRelativeFirst;
-            float physVal = static_cast<float>(vMeasPatches[iCh][rawIdx] - ch.digitalMin) / digRange
-                            * physRange + ch.physicalMin;
-            if(ch.isMeasurement) {
-                physVal /= m_fScaleFactor;
-            }
-            result(iCh, s) = physVal;
+//=============================================================================================================
+
+void EDFReader::decodeRecord(const uchar* pRecord,
+                             int iFirst,
+                             int iLast,
+                             float* pData,
+                             int iRowStride) const
+{
+    const int iCount = iLast - iFirst;
+
+    for(int iCh = 0; iCh < m_vDecoders.size(); ++iCh) {
+        const ChannelDecoder& decoder = m_vDecoders[iCh];
+        float* pOut = pData + static_cast<qint64>(iCh) * iRowStride;
+
+        if(m_iBytesPerSample == 3) {
+            decodeChannel<sampleInt24>(pRecord + decoder.iByteOffset, decoder.vSourceIdx, iFirst, iCount,
+                                       decoder.fGain, decoder.fOffset, pOut);
+        } else {
+            decodeChannel<sampleInt16>(pRecord + decoder.iByteOffset, decoder.vSourceIdx, iFirst, iCount,
+                                       decoder.fGain, decoder.fOffset, pOut);
         }
     }
-
-    return result;
 }
 
 //=============================================================================================================
@@ -356,7 +494,7 @@ float EDFReader::getFrequency() const
 
 int EDFReader::getChannelCount() const
 {
-    return m_vMeasChannels.size();
+    return readChannels().size();
 }
 
 //=============================================================================================================
@@ -381,7 +519,7 @@ FiffRawData EDFReader::toFiffRawData() const
 
 QString EDFReader::formatName() const
 {
-    return QStringLiteral("EDF");
+    return (m_iBytesPerSample == 3) ? QStringLiteral("BDF") : QStringLiteral("EDF");
 }
 
 //=============================================================================================================
@@ -26,6 +26,16 @@
  * iEEG channels emerge in volts, matching the MNE-CPP @c FIFFLIB
  * convention.
  *
+ * BDF (BioSemi) files share the layout but store 24-bit samples; they
+ * are recognised by the @c 0xFF first byte of the version field.
+ * @ref BIDSLIB::EDFReader::readRawSegment maps (or, failing that, reads)
+ * all records of a segment in one go and decodes the records
+ * concurrently. Every channel is converted with one fused
+ * multiply-add over its contiguous samples, which the compiler
+ * vectorises; channels at a lower rate than the measurement channels
+ * are optionally held to the full rate through a precomputed index
+ * table.
+ *
  * Format reference: Kemp & Olivan, ``European data format 'plus'
  * (EDF+)'', Clin. Neurophysiol. 114 (2003) 1755–1761; spec at
  * https://www.edfplus.info/specs/edf.html.
@@ -48,6 +58,12 @@
 #include <QVector>
 #include <QFile>
 
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <vector>
+
 //=============================================================================================================
 // DEFINE NAMESPACE BIDSLIB
 //=============================================================================================================
@@ -74,6 +90,7 @@ struct BIDSSHARED_EXPORT EDFChannelInfo
     long    sampleCount{0};
     float   frequency{0.0f};
     bool    isMeasurement{false};
+    bool    isAnnotation{false};    /**< EDF+/BDF+ annotation signal, holds TAL text instead of samples. */
 
     FIFFLIB::FiffChInfo toFiffChInfo() const;
 };
@@ -92,9 +109,13 @@ public:
     //=========================================================================================================
     /**
      * @brief EDFReader Default constructor.
-     * @param[in] fScaleFactor  Raw value scaling factor (default: 1e6 for uV→V conversion).
+     * @param[in] fScaleFactor          Raw value scaling factor (default: 1e6 for uV→V conversion).
+     * @param[in] bIncludeAllChannels   Also return the channels with fewer samples per record than the measurement
+     *                                  channels, each sample held until the next (default: measurement channels only).
+     *                                  Annotation signals are never returned as data.
      */
-    explicit EDFReader(float fScaleFactor = 1e6);
+    explicit EDFReader(float fScaleFactor = 1e6,
+                       bool bIncludeAllChannels = false);
 
     ~EDFReader() override;
 
@@ -146,9 +167,31 @@ private:
         SIG_RESERVED        = 32,
     };
 
+    /**
+     * @brief How to decode one returned channel from a data record.
+     */
+    struct ChannelDecoder
+    {
+        int                 iByteOffset{0};     /**< Offset of the channel's first sample within a record. */
+        float               fGain{1.0f};        /**< Physical value per digital step, scale factor included. */
+        float               fOffset{0.0f};      /**< Physical value of digital zero, scale factor included. */
+        std::vector<int>    vSourceIdx;         /**< Record sample for each output sample of a lower-rate channel, empty at full rate. */
+    };
+
     void parseHeader(QIODevice* pDev);
 
+    void setupDecoders();
+
+    const QVector<EDFChannelInfo>& readChannels() const;
+
+    void decodeRecord(const uchar* pRecord,
+                      int iFirst,
+                      int iLast,
+                      float* pData,
+                      int iRowStride) const;
+
     float   m_fScaleFactor;
+    bool    m_bIncludeAllChannels{false};
     QString m_sFilePath;
 
     // Header data
@@ -161,9 +204,12 @@ private:
     float       m_fDataRecordsDuration{0.0f};
     int         m_iNumChannels{0};
     int         m_iNumBytesPerDataRecord{0};
+    int         m_iBytesPerSample{2};           /**< 2 for EDF, 3 for BDF. */
 
     QVector<EDFChannelInfo> m_vAllChannels;
+    QVector<EDFChannelInfo> m_vDataChannels;    /**< All channels except the annotation signals. */
     QVector<EDFChannelInfo> m_vMeasChannels;
+    QVector<ChannelDecoder> m_vDecoders;        /**< One per channel returned by readRawSegment. */
 
     mutable QFile m_file;
     bool m_bIsOpen{false};
@@ -62,6 +62,7 @@ ConnectivitySettings::ConnectivitySettings()
 : m_fFreqResolution(1.0f)
 , m_fSFreq(1000.0f)
 , m_sWindowType("hanning")
+, m_bDenseNetworkActive(false)
 {
     m_iNfft = int(m_fSFreq/m_fFreqResolution);
     qRegisterMetaType<CONNECTIVITYLIB::ConnectivitySettings>("CONNECTIVITYLIB::ConnectivitySettings");
@@ -325,6 +326,20 @@ const QString& ConnectivitySettings::getWindowType() const
 
 //*******************************************************************************************************
 
+void ConnectivitySettings::setDenseNetworkActive(bool bDenseNetworkActive)
+{
+    m_bDenseNetworkActive = bDenseNetworkActive;
+}
+
+//*******************************************************************************************************
+
+bool ConnectivitySettings::isDenseNetworkActive() const
+{
+    return m_bDenseNetworkActive;
+}
+
+//*******************************************************************************************************
+
 void ConnectivitySettings::setNodePositions(const FiffInfo& fiffInfo,
                                             const RowVectorXi& picks)
 {
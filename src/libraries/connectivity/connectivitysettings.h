@@ -168,6 +168,10 @@ public:
 
     const QString& getWindowType() const;
 
+    void setDenseNetworkActive(bool bDenseNetworkActive);
+
+    bool isDenseNetworkActive() const;
+
     void setNodePositions(const FIFFLIB::FiffInfo& fiffInfo,
                           const Eigen::RowVectorXi& picks);
 
@@ -185,6 +189,7 @@ public:
 protected:
     QStringList                     m_sConnectivityMethods;         /**< The connectivity methods. */
     QString                         m_sWindowType;                  /**< The window type used to compute tapered spectra. */
+    bool                            m_bDenseNetworkActive;          /**< Whether the undirected metrics write their spectra into the dense pair tensor of the Network instead of one NetworkEdge per pair. */
 
     float                           m_fSFreq;                       /**< The sampling frequency. */
     int                             m_iNfft;                        /**< The FFT length. Also includes the negativ frequencies. Gets recalculated if the sFreq or spectrum resolution change. */
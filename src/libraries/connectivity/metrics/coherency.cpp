@@ -112,6 +112,10 @@ void Coherency::calculateAbs(Network& finalNetwork,
 //    timer.restart();
 
     // Compute CSD/sqrt(PSD_X * PSD_Y)
+    if(connectivitySettings.isDenseNetworkActive()) {
+        finalNetwork.initDenseStorage(iNRows, m_iNumberBinAmount);
+    }
+
     std::function<void(QPair<int,MatrixXcd>&)> computePSDCSDLambda = [&](QPair<int,MatrixXcd>& pairInput) {
         computePSDCSDAbs(mutex,
                          finalNetwork,
@@ -123,6 +127,8 @@ void Coherency::calculateAbs(Network& finalNetwork,
                                                    computePSDCSDLambda);
     resultCSDPSD.waitForFinished();
 
+    finalNetwork.updateDenseWeights();
+
 //    iTime = timer.elapsed();
 //    qWarning() << "Compute" << iTime;
 //    timer.restart();
@@ -183,6 +189,10 @@ void Coherency::calculateImag(Network& finalNetwork,
 //    timer.restart();
 
     // Compute CSD/sqrt(PSD_X * PSD_Y)
+    if(connectivitySettings.isDenseNetworkActive()) {
+        finalNetwork.initDenseStorage(iNRows, m_iNumberBinAmount);
+    }
+
     std::function<void(QPair<int,MatrixXcd>&)> computePSDCSDLambda = [&](QPair<int,MatrixXcd>& pairInput) {
         computePSDCSDImag(mutex,
                           finalNetwork,
@@ -194,6 +204,8 @@ void Coherency::calculateImag(Network& finalNetwork,
                                                    computePSDCSDLambda);
     resultCSDPSD.waitForFinished();
 
+    finalNetwork.updateDenseWeights();
+
 //    iTime = timer.elapsed();
 //    qWarning() << "Compute" << iTime;
 //    timer.restart();
@@ -371,6 +383,13 @@ void Coherency::computePSDCSDAbs(QMutex& mutex,
 
     for(j = i; j < matCohy.rows(); ++j) {
         matWeight = matCohy.row(j).cwiseAbs().transpose();
+
+        // Every row i is handled by one thread only, so the dense tensor needs no locking
+        if(finalNetwork.isDense()) {
+            finalNetwork.setDenseEdgeWeights(i, j, matWeight.col(0));
+            continue;
+        }
+
         pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
 
         mutex.lock();
@@ -404,6 +423,13 @@ void Coherency::computePSDCSDImag(QMutex& mutex,
 
     for(j = i; j < matCohy.rows(); ++j) {
         matWeight = matCohy.row(j).imag().transpose();
+
+        // Every row i is handled by one thread only, so the dense tensor needs no locking
+        if(finalNetwork.isDense()) {
+            finalNetwork.setDenseEdgeWeights(i, j, matWeight.col(0));
+            continue;
+        }
+
         pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
 
         mutex.lock();
@@ -119,10 +119,19 @@ Network Correlation::calculate(ConnectivitySettings& connectivitySettings)
     QSharedPointer<NetworkEdge> pEdge;
     int j;
 
+    if(connectivitySettings.isDenseNetworkActive()) {
+        finalNetwork.initDenseStorage(matDist.rows(), 1);
+    }
+
     for(int i = 0; i < matDist.rows(); ++i) {
         for(j = i; j < matDist.cols(); ++j) {
             matWeight << matDist(i,j);
 
+            if(finalNetwork.isDense()) {
+                finalNetwork.setDenseEdgeWeights(i, j, matWeight.col(0));
+                continue;
+            }
+
             pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
 
             finalNetwork.getNodeAt(i)->append(pEdge);
@@ -131,6 +140,8 @@ Network Correlation::calculate(ConnectivitySettings& connectivitySettings)
         }
     }
 
+    finalNetwork.updateDenseWeights();
+
 //    iTime = timer.elapsed();
 //    qWarning() << "Compute" << iTime;
 //    timer.restart();
@@ -135,10 +135,19 @@ Network CrossCorrelation::calculate(ConnectivitySettings& connectivitySettings)
     QSharedPointer<NetworkEdge> pEdge;
     int j;
 
+    if(connectivitySettings.isDenseNetworkActive()) {
+        finalNetwork.initDenseStorage(matDist.rows(), 1);
+    }
+
     for(int i = 0; i < matDist.rows(); ++i) {
         for(j = i; j < matDist.cols(); ++j) {
             matWeight << matDist(i,j);
 
+            if(finalNetwork.isDense()) {
+                finalNetwork.setDenseEdgeWeights(i, j, matWeight.col(0));
+                continue;
+            }
+
             pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
 
             finalNetwork.getNodeAt(i)->append(pEdge);
@@ -147,6 +156,8 @@ Network CrossCorrelation::calculate(ConnectivitySettings& connectivitySettings)
         }
     }
 
+    finalNetwork.updateDenseWeights();
+
 //    iTime = timer.elapsed();
 //    qWarning() << "Compute" << iTime;
 //    timer.restart();
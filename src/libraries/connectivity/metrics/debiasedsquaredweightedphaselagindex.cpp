@@ -314,6 +314,10 @@ void DebiasedSquaredWeightedPhaseLagIndex::compute(ConnectivitySettings::Interme
 void DebiasedSquaredWeightedPhaseLagIndex::computeDSWPLI(ConnectivitySettings &connectivitySettings,
                                                          Network& finalNetwork)
 {
+    if(connectivitySettings.isDenseNetworkActive()) {
+        finalNetwork.initDenseStorage(connectivitySettings.at(0).matData.rows(), m_iNumberBinAmount);
+    }
+
     // Compute final DSWPLI and create Network
     MatrixXd matNom, matDenom;
     MatrixXd matWeight;
@@ -334,6 +338,11 @@ void DebiasedSquaredWeightedPhaseLagIndex::computeDSWPLI(ConnectivitySettings &c
         for(j = i; j < connectivitySettings.at(0).matData.rows(); ++j) {
             matWeight = matDenom.row(j).transpose();
 
+            if(finalNetwork.isDense()) {
+                finalNetwork.setDenseEdgeWeights(i, j, matWeight.col(0));
+                continue;
+            }
+
             pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
 
             finalNetwork.getNodeAt(i)->append(pEdge);
@@ -342,5 +351,7 @@ void DebiasedSquaredWeightedPhaseLagIndex::computeDSWPLI(ConnectivitySettings &c
         }
 
     }
+
+    finalNetwork.updateDenseWeights();
 }
 
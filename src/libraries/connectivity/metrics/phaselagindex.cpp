@@ -286,6 +286,10 @@ void PhaseLagIndex::compute(ConnectivitySettings::IntermediateTrialData& inputDa
 void PhaseLagIndex::computePLI(ConnectivitySettings &connectivitySettings,
                                Network& finalNetwork)
 {
+    if(connectivitySettings.isDenseNetworkActive()) {
+        finalNetwork.initDenseStorage(connectivitySettings.at(0).matData.rows(), m_iNumberBinAmount);
+    }
+
     // Compute final PLI and create Network
     MatrixXd matNom;
     MatrixXd matWeight;
@@ -298,6 +302,11 @@ void PhaseLagIndex::computePLI(ConnectivitySettings &connectivitySettings,
         for(j = i; j < matNom.rows(); ++j) {
             matWeight = matNom.row(j).transpose();
 
+            if(finalNetwork.isDense()) {
+                finalNetwork.setDenseEdgeWeights(i, j, matWeight.col(0));
+                continue;
+            }
+
             pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
 
             finalNetwork.getNodeAt(i)->append(pEdge);
@@ -305,5 +314,7 @@ void PhaseLagIndex::computePLI(ConnectivitySettings &connectivitySettings,
             finalNetwork.append(pEdge);
         }
     }
+
+    finalNetwork.updateDenseWeights();
 }
 
@@ -287,6 +287,10 @@ void PhaseLockingValue::compute(ConnectivitySettings::IntermediateTrialData& inp
 void PhaseLockingValue::computePLV(ConnectivitySettings &connectivitySettings,
                                    Network& finalNetwork)
 {
+    if(connectivitySettings.isDenseNetworkActive()) {
+        finalNetwork.initDenseStorage(connectivitySettings.at(0).matData.rows(), m_iNumberBinAmount);
+    }
+
     // Compute final PLV and create Network
     MatrixXd matNom;
     MatrixXd matWeight;
@@ -299,6 +303,11 @@ void PhaseLockingValue::computePLV(ConnectivitySettings &connectivitySettings,
         for(j = i; j < connectivitySettings.at(0).matData.rows(); ++j) {
             matWeight = matNom.row(j).transpose();
 
+            if(finalNetwork.isDense()) {
+                finalNetwork.setDenseEdgeWeights(i, j, matWeight.col(0));
+                continue;
+            }
+
             pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
 
             finalNetwork.getNodeAt(i)->append(pEdge);
@@ -306,4 +315,6 @@ void PhaseLockingValue::computePLV(ConnectivitySettings &connectivitySettings,
             finalNetwork.append(pEdge);
         }
     }
+
+    finalNetwork.updateDenseWeights();
 }
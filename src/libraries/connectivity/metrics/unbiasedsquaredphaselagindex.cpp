@@ -290,6 +290,10 @@ void UnbiasedSquaredPhaseLagIndex::compute(ConnectivitySettings::IntermediateTri
 void UnbiasedSquaredPhaseLagIndex::computeUSPLI(ConnectivitySettings &connectivitySettings,
                                Network& finalNetwork)
 {
+    if(connectivitySettings.isDenseNetworkActive()) {
+        finalNetwork.initDenseStorage(connectivitySettings.at(0).matData.rows(), m_iNumberBinAmount);
+    }
+
     // Compute final DSWPLV and create Network
     MatrixXd matNom;
     MatrixXd matWeight;
@@ -304,6 +308,11 @@ void UnbiasedSquaredPhaseLagIndex::computeUSPLI(ConnectivitySettings &connectivi
         for(j = i; j < matNom.rows(); ++j) {
             matWeight = matNom.row(j).transpose();
 
+            if(finalNetwork.isDense()) {
+                finalNetwork.setDenseEdgeWeights(i, j, matWeight.col(0));
+                continue;
+            }
+
             pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
 
             finalNetwork.getNodeAt(i)->append(pEdge);
@@ -311,5 +320,7 @@ void UnbiasedSquaredPhaseLagIndex::computeUSPLI(ConnectivitySettings &connectivi
             finalNetwork.append(pEdge);
         }
     }
+
+    finalNetwork.updateDenseWeights();
 }
 
@@ -309,6 +309,10 @@ void WeightedPhaseLagIndex::compute(ConnectivitySettings::IntermediateTrialData&
 void WeightedPhaseLagIndex::computeWPLI(ConnectivitySettings &connectivitySettings,
                                         Network& finalNetwork)
 {
+    if(connectivitySettings.isDenseNetworkActive()) {
+        finalNetwork.initDenseStorage(connectivitySettings.at(0).matData.rows(), m_iNumberBinAmount);
+    }
+
     // Compute final WPLI and create Network
     MatrixXd matDenom, matNom;
     MatrixXd matWeight;
@@ -324,6 +328,11 @@ void WeightedPhaseLagIndex::computeWPLI(ConnectivitySettings &connectivitySettin
         for(j = i; j < matNom.rows(); ++j) {
             matWeight = matNom.row(j).transpose();
 
+            if(finalNetwork.isDense()) {
+                finalNetwork.setDenseEdgeWeights(i, j, matWeight.col(0));
+                continue;
+            }
+
             pEdge = QSharedPointer<NetworkEdge>(new NetworkEdge(i, j, matWeight));
 
             finalNetwork.getNodeAt(i)->append(pEdge);
@@ -331,5 +340,7 @@ void WeightedPhaseLagIndex::computeWPLI(ConnectivitySettings &connectivitySettin
             finalNetwork.append(pEdge);
         }
     }
+
+    finalNetwork.updateDenseWeights();
 }
 
@@ -24,6 +24,7 @@
 
 #include <math/spectral.h>
 
+#include <algorithm>
 #include <limits>
 
 //=============================================================================================================
@@ -32,6 +33,8 @@
 
 #include <QDebug>
 #include <QList>
+#include <QMutex>
+#include <QMutexLocker>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -49,6 +52,19 @@ using namespace UTILSLIB;
 // DEFINE GLOBAL METHODS
 //=============================================================================================================
 
+/**
+ * The edge and node objects of a dense network. Created once from the dense weights and read-only afterwards, so
+ * copies of the network can share them.
+ */
+struct Network::DenseEdgeViews
+{
+    QMutex                      mutex;                  /**< Guards the creation.*/
+    bool                        bCreated = false;       /**< Whether the lists below were filled.*/
+    QList<NetworkNode::SPtr>    lNodes;                 /**< Copies of the network's nodes, holding the edges.*/
+    QList<NetworkEdge::SPtr>    lFullEdges;             /**< All edges.*/
+    QList<NetworkEdge::SPtr>    lThresholdedEdges;      /**< The active edges.*/
+};
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -62,6 +78,10 @@ Network::Network(const QString& sConnectivityMethod,
 , m_fSFreq(0.0f)
 , m_iFFTSize(128)
 , m_iNumberFreqBins(0)
+, m_pDenseTensor(new DenseTensor)
+, m_pDenseEdgeViews(QSharedPointer<DenseEdgeViews>::create())
+, m_denseFreqBins(QPair<int,int>(-1,-1))
+, m_iDenseNodes(0)
 {
     qRegisterMetaType<CONNECTIVITYLIB::Network>("CONNECTIVITYLIB::Network");
     qRegisterMetaType<CONNECTIVITYLIB::Network::SPtr>("CONNECTIVITYLIB::Network::SPtr");
@@ -76,6 +96,25 @@ MatrixXd Network::getFullConnectivityMatrix(bool bGetMirroredVersion) const
     MatrixXd matDist(m_lNodes.size(), m_lNodes.size());
     matDist.setZero();
 
+    if(isDense()) {
+        const int iNodes = std::min<int>(m_iDenseNodes, m_lNodes.size());
+        Index p = 0;
+
+        for(int i = 0; i < m_iDenseNodes; ++i) {
+            for(int j = i + 1; j < m_iDenseNodes; ++j, ++p) {
+                if(j < iNodes) {
+                    matDist(i,j) = m_vecDenseWeights(p);
+
+                    if(bGetMirroredVersion) {
+                        matDist(j,i) = m_vecDenseWeights(p);
+                    }
+                }
+            }
+        }
+
+        return matDist;
+    }
+
     for(int i = 0; i < m_lFullEdges.size(); ++i) {
         int row = m_lFullEdges.at(i)->getStartNodeID();
         int col = m_lFullEdges.at(i)->getEndNodeID();
@@ -100,6 +139,25 @@ MatrixXd Network::getThresholdedConnectivityMatrix(bool bGetMirroredVersion) con
     MatrixXd matDist(m_lNodes.size(), m_lNodes.size());
     matDist.setZero();
 
+    if(isDense()) {
+        const int iNodes = std::min<int>(m_iDenseNodes, m_lNodes.size());
+        Index p = 0;
+
+        for(int i = 0; i < m_iDenseNodes; ++i) {
+            for(int j = i + 1; j < m_iDenseNodes; ++j, ++p) {
+                if(j < iNodes && fabs(m_vecDenseWeights(p)) >= m_dThreshold) {
+                    matDist(i,j) = m_vecDenseWeights(p);
+
+                    if(bGetMirroredVersion) {
+                        matDist(j,i) = m_vecDenseWeights(p);
+                    }
+                }
+            }
+        }
+
+        return matDist;
+    }
+
     for(int i = 0; i < m_lThresholdedEdges.size(); ++i) {
         int row = m_lThresholdedEdges.at(i)->getStartNodeID();
         int col = m_lThresholdedEdges.at(i)->getEndNodeID();
@@ -121,6 +179,10 @@ MatrixXd Network::getThresholdedConnectivityMatrix(bool bGetMirroredVersion) con
 
 const QList<NetworkEdge::SPtr>& Network::getFullEdges() const
 {
+    if(isDense()) {
+        return denseEdgeViews().lFullEdges;
+    }
+
     return m_lFullEdges;
 }
 
@@ -128,6 +190,10 @@ const QList<NetworkEdge::SPtr>& Network::getFullEdges() const
 
 const QList<NetworkEdge::SPtr>& Network::getThresholdedEdges() const
 {
+    if(isDense()) {
+        return denseEdgeViews().lThresholdedEdges;
+    }
+
     return m_lThresholdedEdges;
 }
 
@@ -135,6 +201,10 @@ const QList<NetworkEdge::SPtr>& Network::getThresholdedEdges() const
 
 const QList<NetworkNode::SPtr>& Network::getNodes() const
 {
+    if(isDense()) {
+        return denseEdgeViews().lNodes;
+    }
+
     return m_lNodes;
 }
 
@@ -142,24 +212,26 @@ const QList<NetworkNode::SPtr>& Network::getNodes() const
 
 NetworkNode::SPtr Network::getNodeAt(int i)
 {
-    return m_lNodes.at(i);
+    return getNodes().at(i);
 }
 
 //=============================================================================================================
 
 NetworkEdge::SPtr Network::getEdgeAt(int i)
 {
-    return m_lFullEdges.at(i);
+    return getFullEdges().at(i);
 }
 
 //=============================================================================================================
 
 qint16 Network::getFullDistribution() const
 {
+    const QList<NetworkNode::SPtr>& lNodes = getNodes();
+
     qint16 distribution = 0;
 
-    for(int i = 0; i < m_lNodes.size(); ++i) {
-        distribution += m_lNodes.at(i)->getFullDegree();
+    for(int i = 0; i < lNodes.size(); ++i) {
+        distribution += lNodes.at(i)->getFullDegree();
     }
 
     return distribution;
@@ -169,10 +241,12 @@ qint16 Network::getFullDistribution() const
 
 qint16 Network::getThresholdedDistribution() const
 {
+    const QList<NetworkNode::SPtr>& lNodes = getNodes();
+
     qint16 distribution = 0;
 
-    for(int i = 0; i < m_lNodes.size(); ++i) {
-        distribution += m_lNodes.at(i)->getThresholdedDegree();
+    for(int i = 0; i < lNodes.size(); ++i) {
+        distribution += lNodes.at(i)->getThresholdedDegree();
     }
 
     return distribution;
@@ -210,14 +284,16 @@ QPair<double, double> Network::getMinMaxThresholdedWeights() const
 
 QPair<int,int> Network::getMinMaxFullDegrees() const
 {
+    const QList<NetworkNode::SPtr>& lNodes = getNodes();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
-    for(int i = 0; i < m_lNodes.size(); ++i) {
-        if(m_lNodes.at(i)->getFullDegree() > maxDegree){
-            maxDegree = m_lNodes.at(i)->getFullDegree();
-        } else if (m_lNodes.at(i)->getFullDegree() < minDegree){
-            minDegree = m_lNodes.at(i)->getFullDegree();
+    for(int i = 0; i < lNodes.size(); ++i) {
+        if(lNodes.at(i)->getFullDegree() > maxDegree){
+            maxDegree = lNodes.at(i)->getFullDegree();
+        } else if (lNodes.at(i)->getFullDegree() < minDegree){
+            minDegree = lNodes.at(i)->getFullDegree();
         }
     }
 
@@ -228,14 +304,16 @@ QPair<int,int> Network::getMinMaxFullDegrees() const
 
 QPair<int,int> Network::getMinMaxThresholdedDegrees() const
 {
+    const QList<NetworkNode::SPtr>& lNodes = getNodes();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
-    for(int i = 0; i < m_lNodes.size(); ++i) {
-        if(m_lNodes.at(i)->getThresholdedDegree() > maxDegree){
-            maxDegree = m_lNodes.at(i)->getThresholdedDegree();
-        } else if (m_lNodes.at(i)->getThresholdedDegree() < minDegree){
-            minDegree = m_lNodes.at(i)->getThresholdedDegree();
+    for(int i = 0; i < lNodes.size(); ++i) {
+        if(lNodes.at(i)->getThresholdedDegree() > maxDegree){
+            maxDegree = lNodes.at(i)->getThresholdedDegree();
+        } else if (lNodes.at(i)->getThresholdedDegree() < minDegree){
+            minDegree = lNodes.at(i)->getThresholdedDegree();
         }
     }
 
@@ -246,14 +324,16 @@ QPair<int,int> Network::getMinMaxThresholdedDegrees() const
 
 QPair<int,int> Network::getMinMaxFullIndegrees() const
 {
+    const QList<NetworkNode::SPtr>& lNodes = getNodes();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
-    for(int i = 0; i < m_lNodes.size(); ++i) {
-        if(m_lNodes.at(i)->getFullIndegree() > maxDegree){
-            maxDegree = m_lNodes.at(i)->getFullIndegree();
-        } else if (m_lNodes.at(i)->getFullIndegree() < minDegree){
-            minDegree = m_lNodes.at(i)->getFullIndegree();
+    for(int i = 0; i < lNodes.size(); ++i) {
+        if(lNodes.at(i)->getFullIndegree() > maxDegree){
+            maxDegree = lNodes.at(i)->getFullIndegree();
+        } else if (lNodes.at(i)->getFullIndegree() < minDegree){
+            minDegree = lNodes.at(i)->getFullIndegree();
         }
     }
 
@@ -264,14 +344,16 @@ QPair<int,int> Network::getMinMaxFullIndegrees() const
 
 QPair<int,int> Network::getMinMaxThresholdedIndegrees() const
 {
+    const QList<NetworkNode::SPtr>& lNodes = getNodes();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
-    for(int i = 0; i < m_lNodes.size(); ++i) {
-        if(m_lNodes.at(i)->getThresholdedIndegree() > maxDegree){
-            maxDegree = m_lNodes.at(i)->getThresholdedIndegree();
-        } else if (m_lNodes.at(i)->getThresholdedIndegree() < minDegree){
-            minDegree = m_lNodes.at(i)->getThresholdedIndegree();
+    for(int i = 0; i < lNodes.size(); ++i) {
+        if(lNodes.at(i)->getThresholdedIndegree() > maxDegree){
+            maxDegree = lNodes.at(i)->getThresholdedIndegree();
+        } else if (lNodes.at(i)->getThresholdedIndegree() < minDegree){
+            minDegree = lNodes.at(i)->getThresholdedIndegree();
         }
     }
 
@@ -282,14 +364,16 @@ QPair<int,int> Network::getMinMaxThresholdedIndegrees() const
 
 QPair<int,int> Network::getMinMaxFullOutdegrees() const
 {
+    const QList<NetworkNode::SPtr>& lNodes = getNodes();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
-    for(int i = 0; i < m_lNodes.size(); ++i) {
-        if(m_lNodes.at(i)->getFullOutdegree() > maxDegree){
-            maxDegree = m_lNodes.at(i)->getFullOutdegree();
-        } else if (m_lNodes.at(i)->getFullOutdegree() < minDegree){
-            minDegree = m_lNodes.at(i)->getFullOutdegree();
+    for(int i = 0; i < lNodes.size(); ++i) {
+        if(lNodes.at(i)->getFullOutdegree() > maxDegree){
+            maxDegree = lNodes.at(i)->getFullOutdegree();
+        } else if (lNodes.at(i)->getFullOutdegree() < minDegree){
+            minDegree = lNodes.at(i)->getFullOutdegree();
         }
     }
 
@@ -300,14 +384,16 @@ QPair<int,int> Network::getMinMaxFullOutdegrees() const
 
 QPair<int,int> Network::getMinMaxThresholdedOutdegrees() const
 {
+    const QList<NetworkNode::SPtr>& lNodes = getNodes();
+
     int maxDegree = 0;
     int minDegree = 1000000;
 
-    for(int i = 0; i < m_lNodes.size(); ++i) {
-        if(m_lNodes.at(i)->getThresholdedOutdegree() > maxDegree){
-            maxDegree = m_lNodes.at(i)->getThresholdedOutdegree();
-        } else if (m_lNodes.at(i)->getThresholdedOutdegree() < minDegree){
-            minDegree = m_lNodes.at(i)->getThresholdedOutdegree();
+    for(int i = 0; i < lNodes.size(); ++i) {
+        if(lNodes.at(i)->getThresholdedOutdegree() > maxDegree){
+            maxDegree = lNodes.at(i)->getThresholdedOutdegree();
+        } else if (lNodes.at(i)->getThresholdedOutdegree() < minDegree){
+            minDegree = lNodes.at(i)->getThresholdedOutdegree();
         }
     }
 
@@ -319,6 +405,15 @@ QPair<int,int> Network::getMinMaxThresholdedOutdegrees() const
 void Network::setThreshold(double dThreshold)
 {
     m_dThreshold = dThreshold;
+
+    if(isDense()) {
+        resetDenseEdgeViews();
+
+        m_minMaxThresholdedWeights.first = m_dThreshold;
+        m_minMaxThresholdedWeights.second = m_minMaxFullWeights.second;
+        return;
+    }
+
     m_lThresholdedEdges.clear();
 
     for(int i = 0; i < m_lFullEdges.size(); ++i) {
@@ -373,6 +468,12 @@ void Network::setFrequencyRange(float fLowerFreq, float fUpperFreq)
     int iLowerBin = fLowerFreq * dScaleFactor;
     int iUpperBin = fUpperFreq * dScaleFactor;
 
+    if(isDense()) {
+        m_denseFreqBins = QPair<int,int>(iLowerBin,iUpperBin);
+        updateDenseWeights();
+        return;
+    }
+
     // Update the min max values
     m_minMaxFullWeights = QPair<double,double>(std::numeric_limits<double>::max(),0.0);
 
@@ -398,6 +499,29 @@ const QPair<float,float>& Network::getFrequencyRange() const
 
 void Network::append(NetworkEdge::SPtr newEdge)
 {
+    if(isDense()) {
+        int i = std::min(newEdge->getStartNodeID(), newEdge->getEndNodeID());
+        int j = std::max(newEdge->getStartNodeID(), newEdge->getEndNodeID());
+
+        if(i == j || i < 0 || j >= m_iDenseNodes) {
+            return;
+        }
+
+        Index p = densePairIndex(i, j, m_iDenseNodes);
+        setDenseEdgeWeights(i, j, newEdge->getMatrixWeight().col(0));
+        m_vecDenseWeights(p) = newEdge->getWeight();
+
+        if(fabs(newEdge->getWeight()) < m_minMaxFullWeights.first) {
+            m_minMaxFullWeights.first = fabs(newEdge->getWeight());
+        }
+        if(fabs(newEdge->getWeight()) > m_minMaxFullWeights.second) {
+            m_minMaxFullWeights.second = fabs(newEdge->getWeight());
+        }
+
+        resetDenseEdgeViews();
+        return;
+    }
+
     if(newEdge->getEndNodeID() != newEdge->getStartNodeID()) {
         double dEdgeWeight = newEdge->getWeight();
         if(dEdgeWeight < m_minMaxFullWeights.first) {
@@ -419,12 +543,20 @@ void Network::append(NetworkEdge::SPtr newEdge)
 void Network::append(NetworkNode::SPtr newNode)
 {
     m_lNodes << newNode;
+
+    if(isDense()) {
+        resetDenseEdgeViews();
+    }
 }
 
 //=============================================================================================================
 
 bool Network::isEmpty() const
 {
+    if(isDense()) {
+        return m_vecDenseWeights.size() == 0 || m_lNodes.isEmpty();
+    }
+
     if(m_lFullEdges.isEmpty() || m_lNodes.isEmpty()) {
         return true;
     }
@@ -442,8 +574,12 @@ void Network::normalize()
         return;
     }
 
-    for(int i = 0; i < m_lFullEdges.size(); ++i) {
-        m_lFullEdges.at(i)->setWeight(m_lFullEdges.at(i)->getWeight()/m_minMaxFullWeights.second);
+    if(isDense()) {
+        m_vecDenseWeights /= static_cast<float>(m_minMaxFullWeights.second);
+    } else {
+        for(int i = 0; i < m_lFullEdges.size(); ++i) {
+            m_lFullEdges.at(i)->setWeight(m_lFullEdges.at(i)->getWeight()/m_minMaxFullWeights.second);
+        }
     }
 
     m_minMaxFullWeights.first = m_minMaxFullWeights.first/m_minMaxFullWeights.second;
@@ -451,6 +587,10 @@ void Network::normalize()
 
     m_minMaxThresholdedWeights.first = m_minMaxThresholdedWeights.first/m_minMaxThresholdedWeights.second;
     m_minMaxThresholdedWeights.second = 1.0;
+
+    if(isDense()) {
+        resetDenseEdgeViews();
+    }
 }
 
 //=============================================================================================================
@@ -509,3 +649,180 @@ int Network::getFFTSize()
     return m_iFFTSize;
 }
 
+//=============================================================================================================
+
+void Network::initDenseStorage(int iNumberNodes,
+                               int iNumberFreqBins)
+{
+    m_iDenseNodes = std::max(iNumberNodes, 0);
+    Index iNumberPairs = Index(m_iDenseNodes) * (m_iDenseNodes - 1) / 2;
+
+    // A fresh tensor, so that copies made before keep their weights and the concurrent writes never detach
+    m_pDenseTensor = new DenseTensor;
+    m_pDenseTensor->matWeights = MatrixXf::Zero(std::max(iNumberFreqBins, 0), iNumberPairs);
+    m_vecDenseWeights = VectorXf::Zero(iNumberPairs);
+    m_denseFreqBins = QPair<int,int>(-1,-1);
+
+    m_lFullEdges.clear();
+    m_lThresholdedEdges.clear();
+    resetDenseEdgeViews();
+
+    m_minMaxFullWeights = QPair<double,double>(std::numeric_limits<double>::max(),0.0);
+}
+
+//=============================================================================================================
+
+bool Network::isDense() const
+{
+    return m_iDenseNodes > 0;
+}
+
+//=============================================================================================================
+
+Index Network::densePairIndex(int i,
+                              int j,
+                              int iNumberNodes)
+{
+    // Row-wise enumeration of the strict upper triangle
+    return Index(i) * iNumberNodes - Index(i) * (i + 1) / 2 + (j - i - 1);
+}
+
+//=============================================================================================================
+
+void Network::setDenseEdgeWeights(int i,
+                                  int j,
+                                  const Ref<const VectorXd>& vecWeights)
+{
+    if(i == j || !isDense()) {
+        return;
+    }
+
+    if(i > j) {
+        std::swap(i, j);
+    }
+
+    // Detaches the tensor from copies of this network, if there are any
+    MatrixXf& matWeights = m_pDenseTensor->matWeights;
+
+    const Index iRows = std::min<Index>(matWeights.rows(), vecWeights.size());
+    matWeights.col(densePairIndex(i, j, m_iDenseNodes)).head(iRows) = vecWeights.head(iRows).cast<float>();
+}
+
+//=============================================================================================================
+
+void Network::updateDenseWeights()
+{
+    if(!isDense()) {
+        return;
+    }
+
+    // Same band averaging as NetworkEdge::calculateAveragedWeight, for all pairs at once
+    const int iStartBin = m_denseFreqBins.first;
+    const int iEndBin = m_denseFreqBins.second;
+    const int rows = getDenseTensor().rows();
+
+    if(rows > 0 && iEndBin >= iStartBin && iStartBin >= -1) {
+        if(iStartBin == -1 && iEndBin == -1) {
+            m_vecDenseWeights = getDenseTensor().colwise().mean().transpose();
+        } else if(iStartBin >= 0 && iStartBin < rows) {
+            m_vecDenseWeights = getDenseFrequencyBand(iStartBin, iEndBin).colwise().mean().transpose();
+        }
+    }
+
+    if(m_vecDenseWeights.size() > 0) {
+        m_minMaxFullWeights.first = m_vecDenseWeights.cwiseAbs().minCoeff();
+        m_minMaxFullWeights.second = m_vecDenseWeights.cwiseAbs().maxCoeff();
+    } else {
+        m_minMaxFullWeights = QPair<double,double>(std::numeric_limits<double>::max(),0.0);
+    }
+
+    resetDenseEdgeViews();
+}
+
+//=============================================================================================================
+
+const MatrixXf& Network::getDenseTensor() const
+{
+    return m_pDenseTensor->matWeights;
+}
+
+//=============================================================================================================
+
+Block<const MatrixXf> Network::getDenseFrequencyBand(int iLowerBin,
+                                                      int iUpperBin) const
+{
+    const MatrixXf& matWeights = getDenseTensor();
+    const int rows = matWeights.rows();
+
+    iLowerBin = std::clamp(iLowerBin, 0, rows);
+    iUpperBin = std::min(iUpperBin, rows - 1);
+
+    return matWeights.middleRows(iLowerBin, std::max(iUpperBin - iLowerBin + 1, 0));
+}
+
+//=============================================================================================================
+
+const VectorXf& Network::getDenseWeights() const
+{
+    return m_vecDenseWeights;
+}
+
+//=============================================================================================================
+
+const Network::DenseEdgeViews& Network::denseEdgeViews() const
+{
+    DenseEdgeViews& views = *m_pDenseEdgeViews;
+    QMutexLocker locker(&views.mutex);
+
+    if(views.bCreated) {
+        return views;
+    }
+
+    views.bCreated = true;
+
+    // The edges go to copies of the nodes, since the nodes themselves may be shared with other networks
+    views.lNodes.reserve(m_lNodes.size());
+
+    for(const NetworkNode::SPtr& pNode : m_lNodes) {
+        NetworkNode::SPtr pNodeView(new NetworkNode(pNode->getId(), pNode->getVert()));
+        pNodeView->setHubStatus(pNode->getHubStatus());
+        views.lNodes << pNodeView;
+    }
+
+    const MatrixXf& matWeights = getDenseTensor();
+    views.lFullEdges.reserve(m_vecDenseWeights.size());
+
+    MatrixXd matWeight;
+    NetworkEdge::SPtr pEdge;
+    Index p = 0;
+
+    for(int i = 0; i < m_iDenseNodes; ++i) {
+        for(int j = i + 1; j < m_iDenseNodes; ++j, ++p) {
+            matWeight = matWeights.col(p).cast<double>();
+            bool bActive = fabs(m_vecDenseWeights(p)) >= m_dThreshold;
+
+            pEdge = NetworkEdge::SPtr(new NetworkEdge(i, j, matWeight, bActive, m_denseFreqBins.first, m_denseFreqBins.second));
+            pEdge->setWeight(m_vecDenseWeights(p));
+
+            if(j < views.lNodes.size()) {
+                views.lNodes.at(i)->append(pEdge);
+                views.lNodes.at(j)->append(pEdge);
+            }
+
+            views.lFullEdges << pEdge;
+
+            if(bActive) {
+                views.lThresholdedEdges << pEdge;
+            }
+        }
+    }
+
+    return views;
+}
+
+//=============================================================================================================
+
+void Network::resetDenseEdgeViews()
+{
+    m_pDenseEdgeViews = QSharedPointer<DenseEdgeViews>::create();
+}
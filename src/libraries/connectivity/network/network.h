@@ -29,6 +29,13 @@
  * extraction, and a @ref VisualizationInfo block carrying the colour-map
  * choice that disp3D and the @c connectivity-estimator plugin honour when
  * rendering the graph in 3D.
+ *
+ * For large undirected networks the container can alternatively hold its
+ * weights in a dense upper-triangular tensor (one float column of frequency
+ * bins per channel pair) instead of one heap-allocated @ref NetworkEdge per
+ * pair. Band averages and thresholds are then evaluated on the tensor, and
+ * the edge objects are only created on first request. Copies of such a
+ * network share the tensor until one of them writes to it.
  */
 
 #ifndef NETWORK_H
@@ -45,6 +52,8 @@
 //=============================================================================================================
 
 #include <QSharedPointer>
+#include <QSharedData>
+#include <QSharedDataPointer>
 #include <QList>
 
 //=============================================================================================================
@@ -91,6 +100,19 @@ struct VisualizationInfo {
  * "GC", ...) and threshold currently in effect, and the @ref VisualizationInfo
  * block read by the disp3D rendering layer.
  *
+ * After @ref initDenseStorage the weights of an undirected network live in
+ * one nFreqBins x nPairs float matrix, where pair (i,j), i < j, is column
+ * @ref densePairIndex(i,j,nNodes). Metrics fill it with
+ * @ref setDenseEdgeWeights (safe from several threads as long as each pair
+ * is written by one thread) and finish with @ref updateDenseWeights.
+ * The edge based getters keep working: the first call to @ref getFullEdges,
+ * @ref getThresholdedEdges, @ref getNodes or a degree getter creates the
+ * @ref NetworkEdge objects from the tensor, together with copies of the nodes
+ * that hold them, so nodes shared with other networks are never modified.
+ * Any later non-const call (threshold, band, normalisation, append) drops
+ * these objects and invalidates the lists returned before.
+ * Self-connections are not stored in this mode.
+ *
  * @brief Graph container for one connectivity metric; nodes + weighted edges + threshold/visualisation state.
  */
 
@@ -402,7 +424,115 @@ public:
      */
     int getFFTSize();
 
+    //=========================================================================================================
+    /**
+     * Switches the network to dense storage and allocates a zeroed tensor for all node pairs. Any edges added
+     * before are dropped from the network (not from the nodes). The nodes themselves still have to be appended
+     * as usual.
+     *
+     * @param[in] iNumberNodes       The number of nodes.
+     * @param[in] iNumberFreqBins    The number of frequency bins stored per pair.
+     */
+    void initDenseStorage(int iNumberNodes,
+                          int iNumberFreqBins);
+
+    //=========================================================================================================
+    /**
+     * Returns whether the network keeps its weights in the dense pair tensor.
+     *
+     * @return True if initDenseStorage was called.
+     */
+    bool isDense() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the tensor column of the undirected pair (i,j) with i < j < iNumberNodes.
+     *
+     * @param[in] i                  The smaller node index.
+     * @param[in] j                  The larger node index.
+     * @param[in] iNumberNodes       The number of nodes.
+     *
+     * @return The pair index.
+     */
+    static Eigen::Index densePairIndex(int i,
+                                       int j,
+                                       int iNumberNodes);
+
+    //=========================================================================================================
+    /**
+     * Writes the per-frequency weights of the pair (i,j) into the dense tensor. The order of i and j does not
+     * matter, i == j is ignored. Different pairs may be written concurrently, as long as the network is not copied
+     * meanwhile. Call updateDenseWeights once all pairs are written.
+     *
+     * @param[in] i              The first node index.
+     * @param[in] j              The second node index.
+     * @param[in] vecWeights     The weights, one per frequency bin.
+     */
+    void setDenseEdgeWeights(int i,
+                             int j,
+                             const Eigen::Ref<const Eigen::VectorXd>& vecWeights);
+
+    //=========================================================================================================
+    /**
+     * Recomputes the band-averaged weights of all pairs from the dense tensor, as well as the minimum and
+     * maximum weights.
+     */
+    void updateDenseWeights();
+
+    //=========================================================================================================
+    /**
+     * Returns the dense tensor, nFreqBins x nPairs. Empty if the network is not dense.
+     *
+     * @return The dense tensor.
+     */
+    const Eigen::MatrixXf& getDenseTensor() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the rows [iLowerBin, iUpperBin] of the dense tensor without copying them.
+     *
+     * @param[in] iLowerBin      The first frequency bin.
+     * @param[in] iUpperBin      The last frequency bin. Clamped to the number of bins.
+     *
+     * @return The frequency band of all pairs.
+     */
+    Eigen::Block<const Eigen::MatrixXf> getDenseFrequencyBand(int iLowerBin,
+                                                               int iUpperBin) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the band-averaged weight of every pair, indexed by densePairIndex. A thresholded view is simply
+     * getDenseWeights().array().abs() >= getThreshold().
+     *
+     * @return The band-averaged weights.
+     */
+    const Eigen::VectorXf& getDenseWeights() const;
+
 protected:
+    /**
+     * The per-frequency weights of a dense network. Implicitly shared, so copying a network does not copy them.
+     */
+    struct DenseTensor : public QSharedData {
+        Eigen::MatrixXf matWeights;         /**< The weights of all node pairs, nFreqBins x nPairs.*/
+    };
+
+    struct DenseEdgeViews;
+
+    //=========================================================================================================
+    /**
+     * Returns the edge and node objects of a dense network and creates them from the tensor on the first call.
+     * Thread safe.
+     *
+     * @return The edges and nodes of the current dense weights and threshold.
+     */
+    const DenseEdgeViews& denseEdgeViews() const;
+
+    //=========================================================================================================
+    /**
+     * Drops the edge and node objects created from the dense weights. Copies that share them keep theirs.
+     */
+    void resetDenseEdgeViews();
+
     QList<QSharedPointer<NetworkEdge> >     m_lFullEdges;               /**< List with all edges of the network.*/
     QList<QSharedPointer<NetworkEdge> >     m_lThresholdedEdges;        /**< List with all the active (thresholded) edges of the network.*/
 
@@ -422,6 +552,12 @@ protected:
     int                                     m_iFFTSize;                 /**< The used FFT size (number of total frequency bins for a half spectrum - only positive frequencies).*/
 
     VisualizationInfo                       m_visualizationInfo;        /**< The current visualization info used to plot the network later on.*/
+
+    QSharedDataPointer<DenseTensor>         m_pDenseTensor;             /**< The per-frequency weights of all node pairs in dense mode.*/
+    QSharedPointer<DenseEdgeViews>          m_pDenseEdgeViews;          /**< The edges and nodes created on demand from the dense weights.*/
+    Eigen::VectorXf                         m_vecDenseWeights;          /**< The band-averaged weight of all node pairs in dense mode.*/
+    QPair<int,int>                          m_denseFreqBins;            /**< The frequency bins the dense weights are averaged over. (-1,-1) averages all.*/
+    int                                     m_iDenseNodes;              /**< The number of nodes of the dense tensor. 0 if the network is not dense.*/
 };
 
 //=============================================================================================================
@@ -0,0 +1,328 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     fft_filter_engine.cpp
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Implementation of @ref FftFilterEngine: cached coefficient spectra and a pool of per-thread FFT workspaces.
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fft_filter_engine.h"
+
+#include <algorithm>
+#include <functional>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent>
+#include <QThreadPool>
+#include <QDebug>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <unsupported/Eigen/FFT>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+struct RowChunk
+{
+    int iBegin;     /**< First index into the picks. */
+    int iEnd;       /**< One past the last index into the picks. */
+};
+
+} // anonymous namespace
+
+//=============================================================================================================
+// DEFINE PRIVATE TYPES
+//=============================================================================================================
+
+/**
+ * FFT plan and scratch vectors of one worker thread. The vectors only grow, so once a workspace has seen the
+ * largest FFT length of a run it never allocates again.
+ */
+struct FftFilterEngine::Workspace
+{
+    Eigen::FFT<double>  fft;        /**< The FFT object, which caches its plans (twiddles) per length. */
+    VectorXd            vecTime;    /**< Zero-padded time-domain row. */
+    VectorXcd           vecFreq;    /**< Half spectrum of the row. */
+
+    Workspace()
+    {
+        fft.SetFlag(fft.HalfSpectrum);
+    }
+
+    void reserve(int iFftLength)
+    {
+        if(vecTime.size() < iFftLength) {
+            vecTime.resize(iFftLength);
+        }
+        if(vecFreq.size() < iFftLength/2 + 1) {
+            vecFreq.resize(iFftLength/2 + 1);
+        }
+    }
+};
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FftFilterEngine::FftFilterEngine(const FilterKernel& filterKernel,
+                                 bool bGoodSize)
+: m_filterKernel(filterKernel)
+, m_vecCoeff(filterKernel.getCoefficients())
+, m_bGoodSize(bGoodSize)
+{
+    #ifdef EIGEN_FFTW_DEFAULT
+    fftw_make_planner_thread_safe();
+    #endif
+}
+
+//=============================================================================================================
+
+FftFilterEngine::~FftFilterEngine()
+{
+}
+
+//=============================================================================================================
+
+const FilterKernel& FftFilterEngine::filterKernel() const
+{
+    return m_filterKernel;
+}
+
+//=============================================================================================================
+
+bool FftFilterEngine::matches(const FilterKernel& filterKernel) const
+{
+    if(filterKernel.getFilterOrder() != filterOrder()) {
+        return false;
+    }
+
+    const RowVectorXd vecCoeff = filterKernel.getCoefficients();
+
+    return vecCoeff.cols() == m_vecCoeff.cols() && vecCoeff == m_vecCoeff;
+}
+
+//=============================================================================================================
+
+int FftFilterEngine::filterOrder() const
+{
+    return m_filterKernel.getFilterOrder();
+}
+
+//=============================================================================================================
+
+int FftFilterEngine::fftLength(int iDataLength) const
+{
+    // Same minimum length as FilterKernel::applyFftFilter, so that the tail kept as overhead is free of wrap-around
+    const int iMinLength = iDataLength + m_vecCoeff.cols();
+
+    return m_bGoodSize ? nextGoodSize(iMinLength) : nextPow2(iMinLength);
+}
+
+//=============================================================================================================
+
+void FftFilterEngine::prepare(int iDataLength)
+{
+    spectrum(fftLength(iDataLength));
+}
+
+//=============================================================================================================
+
+void FftFilterEngine::filterBlock(const Ref<const MatrixXd>& matData,
+                                  MatrixXd& matDataOut,
+                                  const RowVectorXi& vecPicks,
+                                  bool bUseThreads)
+{
+    const int iOrder = filterOrder();
+
+    if(matData.cols() < iOrder) {
+        qWarning() << "[FftFilterEngine::filterBlock] Filter length/order is bigger than data length. Returning.";
+        matDataOut = matData;
+        return;
+    }
+
+    // Copy in the data delayed by half the filter order. This keeps channels which are not filtered aligned.
+    matDataOut.resize(matData.rows(), matData.cols() + iOrder);
+    matDataOut.leftCols(iOrder/2).setZero();
+    matDataOut.middleCols(iOrder/2, matData.cols()) = matData;
+    matDataOut.rightCols(iOrder - iOrder/2).setZero();
+
+    RowVectorXi vecPicksAll;
+    if(vecPicks.cols() == 0) {
+        vecPicksAll = RowVectorXi::LinSpaced(matData.rows(), 0, matData.rows() - 1);
+    }
+    const RowVectorXi& vecRows = vecPicks.cols() == 0 ? vecPicksAll : vecPicks;
+
+    if(vecRows.cols() == 0) {
+        return;
+    }
+
+    const int iFftLength = fftLength(matData.cols());
+    const VectorXcd& vecSpectrum = spectrum(iFftLength);
+
+    const int iNumThreads = bUseThreads ? std::min<int>(QThreadPool::globalInstance()->maxThreadCount(), vecRows.cols()) : 1;
+
+    if(iNumThreads <= 1) {
+        filterRows(matData, matDataOut, vecRows, 0, vecRows.cols(), vecSpectrum, iFftLength);
+        return;
+    }
+
+    // One contiguous range of rows per thread, so every thread borrows exactly one workspace
+    QVector<RowChunk> chunks;
+    chunks.reserve(iNumThreads);
+    const int iStep = (vecRows.cols() + iNumThreads - 1) / iNumThreads;
+    for(int i = 0; i < vecRows.cols(); i += iStep) {
+        chunks.append(RowChunk{i, std::min<int>(i + iStep, vecRows.cols())});
+    }
+
+    std::function<void(RowChunk&)> filterChunk = [&](RowChunk& chunk) {
+        filterRows(matData, matDataOut, vecRows, chunk.iBegin, chunk.iEnd, vecSpectrum, iFftLength);
+    };
+
+    QtConcurrent::blockingMap(chunks, filterChunk);
+}
+
+//=============================================================================================================
+
+int FftFilterEngine::nextPow2(int iLength)
+{
+    int iResult = 1;
+    while(iResult < iLength) {
+        iResult <<= 1;
+    }
+    return iResult;
+}
+
+//=============================================================================================================
+
+int FftFilterEngine::nextGoodSize(int iLength)
+{
+    // Kiss FFT (and FFTW) have dedicated radix-2, -3, -4 and -5 butterflies, and an even length keeps the fast real
+    // transform path
+    int iBest = nextPow2(std::max(iLength, 2));
+
+    for(qint64 i5 = 1; i5 < iBest; i5 *= 5) {
+        for(qint64 i35 = i5; i35 < iBest; i35 *= 3) {
+            qint64 iCandidate = 2 * i35;
+            while(iCandidate < iLength) {
+                iCandidate *= 2;
+            }
+            if(iCandidate < iBest) {
+                iBest = static_cast<int>(iCandidate);
+            }
+        }
+    }
+
+    return iBest;
+}
+
+//=============================================================================================================
+
+const VectorXcd& FftFilterEngine::spectrum(int iFftLength)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_mapSpectra.constFind(iFftLength);
+    if(it != m_mapSpectra.constEnd()) {
+        return it.value();
+    }
+
+    if(m_vecCoeff.cols() > iFftLength) {
+        qWarning() << "[FftFilterEngine::spectrum] The number of filter taps is bigger than the FFT length.";
+    }
+
+    VectorXd vecPadded = VectorXd::Zero(iFftLength);
+    const int iTaps = std::min<int>(m_vecCoeff.cols(), iFftLength);
+    vecPadded.head(iTaps) = m_vecCoeff.head(iTaps).transpose();
+
+    Eigen::FFT<double> fft;
+    fft.SetFlag(fft.HalfSpectrum);
+
+    VectorXcd vecSpectrum(iFftLength/2 + 1);
+    fft.fwd(vecSpectrum.data(), vecPadded.data(), iFftLength);
+
+    return m_mapSpectra.insert(iFftLength, vecSpectrum).value();
+}
+
+//=============================================================================================================
+
+QSharedPointer<FftFilterEngine::Workspace> FftFilterEngine::acquireWorkspace()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(m_lFreeWorkspaces.isEmpty()) {
+        return QSharedPointer<Workspace>::create();
+    }
+
+    return m_lFreeWorkspaces.takeLast();
+}
+
+//=============================================================================================================
+
+void FftFilterEngine::releaseWorkspace(const QSharedPointer<Workspace>& pWorkspace)
+{
+    QMutexLocker locker(&m_mutex);
+    m_lFreeWorkspaces.append(pWorkspace);
+}
+
+//=============================================================================================================
+
+void FftFilterEngine::filterRows(const Ref<const MatrixXd>& matData,
+                                 MatrixXd& matDataOut,
+                                 const RowVectorXi& vecPicks,
+                                 int iBegin,
+                                 int iEnd,
+                                 const VectorXcd& vecSpectrum,
+                                 int iFftLength)
+{
+    QSharedPointer<Workspace> pWorkspace = acquireWorkspace();
+    pWorkspace->reserve(iFftLength);
+
+    const Index iCols = matData.cols();
+    const Index iBins = iFftLength/2 + 1;
+    const Index iKeep = std::min<Index>(iCols + m_vecCoeff.cols(), matDataOut.cols());
+
+    double* pTime = pWorkspace->vecTime.data();
+    std::complex<double>* pFreq = pWorkspace->vecFreq.data();
+
+    for(int i = iBegin; i < iEnd; ++i) {
+        const int iRow = vecPicks[i];
+
+        // Zero-pad the row to the FFT length
+        pWorkspace->vecTime.head(iCols) = matData.row(iRow).transpose();
+        pWorkspace->vecTime.segment(iCols, iFftLength - iCols).setZero();
+
+        pWorkspace->fft.fwd(pFreq, pTime, iFftLength);
+        pWorkspace->vecFreq.head(iBins).array() *= vecSpectrum.array();
+        pWorkspace->fft.inv(pTime, pFreq, iFftLength);
+
+        // The full linear convolution. It carries a delay of order/2 in front and back.
+        matDataOut.row(iRow).head(iKeep) = pWorkspace->vecTime.head(iKeep).transpose();
+        matDataOut.row(iRow).tail(matDataOut.cols() - iKeep).setZero();
+    }
+
+    releaseWorkspace(pWorkspace);
+}
@@ -0,0 +1,239 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     fft_filter_engine.h
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Reusable multi-channel FFT convolution engine for a fixed FilterKernel.
+ *
+ * @ref FilterKernel::applyFftFilter builds a fresh FFT object, re-derives
+ * the FFT length and re-allocates its frequency buffers for every single
+ * row it filters, and @ref RTPROCESSINGLIB::filterDataBlock additionally
+ * copies the whole kernel once per channel. @ref FftFilterEngine does all
+ * of that set-up once: it keeps the transformed coefficients for every FFT
+ * length it has been asked for, and a pool of per-thread workspaces (FFT
+ * plan plus time and frequency scratch vectors) that are handed out to the
+ * worker threads and returned afterwards. Filtering a channel × sample
+ * block therefore costs one forward FFT, one complex product and one
+ * inverse FFT per picked row and nothing else.
+ *
+ * Besides the classic next-power-of-two FFT length the engine can pick the
+ * smallest even 5-smooth length (2^a·3^b·5^c) that avoids circular
+ * wrap-around, which for long single-block files is often considerably
+ * shorter.
+ */
+
+#ifndef FFT_FILTER_ENGINE_H
+#define FFT_FILTER_ENGINE_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "dsp_global.h"
+#include "filterkernel.h"
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
+
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+//=============================================================================================================
+/**
+ * @brief Batched FFT convolution of the rows of a data matrix with one FIR kernel, with cached plans, spectra and scratch buffers.
+ *
+ * The output layout is the one of @ref RTPROCESSINGLIB::filterDataBlock:
+ * a block of n columns becomes n + order columns, picked rows hold the
+ * full linear convolution, all other rows are copied with a delay of
+ * order/2 samples so that they stay aligned with the filtered ones.
+ *
+ * The engine is safe to use from several threads at once; each call to
+ * @ref filterBlock borrows as many workspaces as it runs threads.
+ *
+ * @code
+ *   FftFilterEngine engine(kernel);
+ *   MatrixXd matOut;
+ *   for(const MatrixXd& matBlock : blocks) {
+ *       engine.filterBlock(matBlock, matOut);    // no allocations after the first block
+ *       ...
+ *   }
+ * @endcode
+ */
+class DSPSHARED_EXPORT FftFilterEngine
+{
+public:
+    typedef QSharedPointer<FftFilterEngine> SPtr;             /**< Shared pointer type for FftFilterEngine. */
+    typedef QSharedPointer<const FftFilterEngine> ConstSPtr;  /**< Const shared pointer type for FftFilterEngine. */
+
+    //=========================================================================================================
+    /**
+     * Constructs the engine for the given filter.
+     *
+     * @param[in] filterKernel   The FIR filter to apply.
+     * @param[in] bGoodSize      If true, use the smallest even 5-smooth FFT length instead of the next power of two.
+     */
+    explicit FftFilterEngine(const FilterKernel& filterKernel,
+                             bool bGoodSize = false);
+
+    //=========================================================================================================
+    /**
+     * Destroys the engine and its workspaces.
+     */
+    ~FftFilterEngine();
+
+    FftFilterEngine(const FftFilterEngine&) = delete;
+    FftFilterEngine& operator=(const FftFilterEngine&) = delete;
+
+    //=========================================================================================================
+    /**
+     * Returns the filter this engine applies.
+     *
+     * @return The filter kernel.
+     */
+    const FilterKernel& filterKernel() const;
+
+    //=========================================================================================================
+    /**
+     * True if this engine applies the same coefficients as the given filter, so that it can be reused for it.
+     *
+     * @param[in] filterKernel   The filter to compare with.
+     *
+     * @return true if the coefficients and the order match.
+     */
+    bool matches(const FilterKernel& filterKernel) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the filter order, i.e. the number of columns a filtered block grows by.
+     *
+     * @return The filter order.
+     */
+    int filterOrder() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the FFT length used for blocks of the given number of samples.
+     *
+     * @param[in] iDataLength    Number of samples per block.
+     *
+     * @return The FFT length.
+     */
+    int fftLength(int iDataLength) const;
+
+    //=========================================================================================================
+    /**
+     * Transforms the coefficients for the FFT length belonging to iDataLength ahead of time, so that the first
+     * filterBlock call of that size does not have to.
+     *
+     * @param[in] iDataLength    Number of samples per block.
+     */
+    void prepare(int iDataLength);
+
+    //=========================================================================================================
+    /**
+     * Filters a block of data. matDataOut is resized to matData.rows() x (matData.cols() + filterOrder()); if it
+     * already has that size its memory is reused.
+     *
+     * @param[in] matData        The data block (channels x samples). Must have at least filterOrder() columns.
+     * @param[out] matDataOut    The filtered block, delayed by filterOrder()/2 samples.
+     * @param[in] vecPicks       Rows to filter. Empty filters all rows.
+     * @param[in] bUseThreads    Whether to spread the rows over the global thread pool.
+     */
+    void filterBlock(const Eigen::Ref<const Eigen::MatrixXd>& matData,
+                     Eigen::MatrixXd& matDataOut,
+                     const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi(),
+                     bool bUseThreads = true);
+
+    //=========================================================================================================
+    /**
+     * Returns the smallest power of two that is >= iLength.
+     *
+     * @param[in] iLength    The minimum length.
+     *
+     * @return The power of two.
+     */
+    static int nextPow2(int iLength);
+
+    //=========================================================================================================
+    /**
+     * Returns the smallest even number >= iLength that has no prime factors other than 2, 3 and 5.
+     *
+     * @param[in] iLength    The minimum length.
+     *
+     * @return The good FFT size.
+     */
+    static int nextGoodSize(int iLength);
+
+private:
+    struct Workspace;
+
+    //=========================================================================================================
+    /**
+     * Returns the half spectrum of the zero-padded coefficients for the given FFT length, transforming them on
+     * first use. The returned reference stays valid for the lifetime of the engine.
+     *
+     * @param[in] iFftLength     The FFT length.
+     *
+     * @return The coefficient spectrum (iFftLength/2 + 1 bins).
+     */
+    const Eigen::VectorXcd& spectrum(int iFftLength);
+
+    //=========================================================================================================
+    /**
+     * Takes a workspace from the pool, creating one if the pool is empty.
+     *
+     * @return The workspace.
+     */
+    QSharedPointer<Workspace> acquireWorkspace();
+
+    //=========================================================================================================
+    /**
+     * Returns a workspace to the pool.
+     *
+     * @param[in] pWorkspace     The workspace.
+     */
+    void releaseWorkspace(const QSharedPointer<Workspace>& pWorkspace);
+
+    //=========================================================================================================
+    /**
+     * Filters the picked rows [iBegin, iEnd) with one workspace.
+     */
+    void filterRows(const Eigen::Ref<const Eigen::MatrixXd>& matData,
+                    Eigen::MatrixXd& matDataOut,
+                    const Eigen::RowVectorXi& vecPicks,
+                    int iBegin,
+                    int iEnd,
+                    const Eigen::VectorXcd& vecSpectrum,
+                    int iFftLength);
+
+    FilterKernel                        m_filterKernel;         /**< The filter. */
+    Eigen::RowVectorXd                  m_vecCoeff;             /**< Time-domain filter coefficients. */
+    bool                                m_bGoodSize;            /**< Whether to use 5-smooth instead of power-of-two FFT lengths. */
+
+    QMutex                              m_mutex;                /**< Guards the spectrum cache and the workspace pool. */
+    QMap<int, Eigen::VectorXcd>         m_mapSpectra;           /**< Coefficient half spectra keyed by FFT length. */
+    QVector<QSharedPointer<Workspace> > m_lFreeWorkspaces;      /**< Idle workspaces. */
+};
+} // NAMESPACE UTILSLIB
+
+#endif // FFT_FILTER_ENGINE_H
@@ -122,7 +122,7 @@ void FilterKernel::prepareFilter(int iDataSize)
     iFftLength = pow(2, exp);
 
     // Transform coefficients anew if needed
-    if(m_vecCoeff.cols() != (iFftLength/2+1)) {
+    if(m_vecFftCoeff.cols() != (iFftLength/2+1)) {
         fftTransformCoeffs(iFftLength);
     }
 }
@@ -0,0 +1,168 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     iir_sos_engine.cpp
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Implementation of @ref IirSosEngine: channel-interleaved biquad states evaluated tile by tile.
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "iir_sos_engine.h"
+
+#include <algorithm>
+#include <utility>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+/**
+ * Number of channels filtered together. The states of one tile take at most about 16 KiB, so that they stay in
+ * the L1 cache for the whole block; the tile is a multiple of 8 so that it fills whole SIMD registers.
+ */
+int tileSize(int iNChannels, int iNSections)
+{
+    const int iBytesPerChannel = 2 * iNSections * static_cast<int>(sizeof(double));
+    const int iTile = std::max(8, (16 * 1024 / std::max(iBytesPerChannel, 1)) / 8 * 8);
+
+    return std::min(iTile, std::max(iNChannels, 1));
+}
+
+} // anonymous namespace
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+IirSosEngine::IirSosEngine(const QVector<IirBiquad>& sos,
+                           int iNChannels)
+: m_sos(sos)
+, m_matZi(IirFilter::sosFiltZi(sos))
+{
+    reset(iNChannels);
+}
+
+//=============================================================================================================
+
+const QVector<IirBiquad>& IirSosEngine::sos() const
+{
+    return m_sos;
+}
+
+//=============================================================================================================
+
+int IirSosEngine::channels() const
+{
+    return static_cast<int>(m_matState.rows());
+}
+
+//=============================================================================================================
+
+void IirSosEngine::reset(int iNChannels)
+{
+    m_matState = MatrixXd::Zero(std::max(iNChannels, 0), 2 * m_sos.size());
+}
+
+//=============================================================================================================
+
+void IirSosEngine::reset()
+{
+    m_matState.setZero();
+}
+
+//=============================================================================================================
+
+void IirSosEngine::initialize(const Ref<const VectorXd>& vecX0)
+{
+    if(m_matState.rows() != vecX0.size()) {
+        reset(static_cast<int>(vecX0.size()));
+    }
+
+    for(int k = 0; k < m_sos.size(); ++k) {
+        m_matState.col(2 * k) = m_matZi(k, 0) * vecX0;
+        m_matState.col(2 * k + 1) = m_matZi(k, 1) * vecX0;
+    }
+}
+
+//=============================================================================================================
+
+void IirSosEngine::filterBlock(const Ref<const MatrixXd>& matData,
+                               MatrixXd& matDataOut)
+{
+    const int iNChannels = static_cast<int>(matData.rows());
+    const int iNSamples = static_cast<int>(matData.cols());
+    const int iNSections = m_sos.size();
+
+    if(iNChannels != channels()) {
+        if(channels() != 0) {
+            qWarning() << "[IirSosEngine::filterBlock] Block has" << iNChannels << "channels instead of" << channels() << ". Resetting the state.";
+        }
+        reset(iNChannels);
+    }
+
+    // Only resize if needed, matDataOut may alias matData
+    if(matDataOut.rows() != iNChannels || matDataOut.cols() != iNSamples) {
+        matDataOut.resize(iNChannels, iNSamples);
+    }
+
+    if(iNSections == 0) {
+        matDataOut = matData;
+        return;
+    }
+
+    const int iTile = tileSize(iNChannels, iNSections);
+    if(m_vecX.size() < iTile) {
+        m_vecX.resize(iTile);
+        m_vecY.resize(iTile);
+    }
+
+    for(int c0 = 0; c0 < iNChannels; c0 += iTile) {
+        const int n = std::min(iTile, iNChannels - c0);
+
+        for(int t = 0; t < iNSamples; ++t) {
+            ArrayXd* pX = &m_vecX;
+            ArrayXd* pY = &m_vecY;
+
+            pX->head(n) = matData.col(t).segment(c0, n).array();
+
+            // Direct-Form II transposed, evaluated for all channels of the tile at once
+            for(int k = 0; k < iNSections; ++k) {
+                const IirBiquad& bq = m_sos.at(k);
+                auto s1 = m_matState.col(2 * k).segment(c0, n).array();
+                auto s2 = m_matState.col(2 * k + 1).segment(c0, n).array();
+                const auto x = pX->head(n);
+                auto y = pY->head(n);
+
+                y = bq.b0 * x + s1;
+                s1 = bq.b1 * x - bq.a1 * y + s2;
+                s2 = bq.b2 * x - bq.a2 * y;
+
+                std::swap(pX, pY);
+            }
+
+            matDataOut.col(t).segment(c0, n) = pX->head(n).matrix();
+        }
+    }
+}
@@ -0,0 +1,149 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     iir_sos_engine.h
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Stateful multi-channel biquad cascade that filters a stream block by block, all channels at once.
+ *
+ * @ref IirFilter::applySos filters one row at a time and always starts
+ * from zero state, so filtering a stream block by block restarts the
+ * filter at every block boundary. @ref IirSosEngine keeps the two Direct-
+ * Form II transposed states of every section and channel between calls,
+ * so consecutive blocks are filtered exactly as one long signal.
+ *
+ * The states are stored channel-interleaved: for every section and state
+ * variable one contiguous column over the channels. At each sample the
+ * recurrence is evaluated for a whole tile of channels with Eigen array
+ * expressions, which Eigen maps onto the SIMD lanes enabled at compile
+ * time (SSE2, AVX/AVX2 or AVX-512); the input block is column-major, so a
+ * column of it is exactly one sample of all channels. Tiles are sized so
+ * that their states stay in the L1 cache.
+ */
+
+#ifndef IIR_SOS_ENGINE_H
+#define IIR_SOS_ENGINE_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "dsp_global.h"
+#include "iirfilter.h"
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+//=============================================================================================================
+/**
+ * @brief Biquad cascade with per-channel state for block-wise (real-time) filtering of channel × sample blocks.
+ *
+ * IirFilter::applyZeroPhase and applyZeroPhaseMatrix run both of their passes on this engine. The mne_scan
+ * filter paths do not use it yet, they still filter with FIR kernels.
+ *
+ * @code
+ *   auto sos = IirFilter::designButterworth(4, IirFilter::BandStop, 49.0, 51.0, 1000.0);
+ *   IirSosEngine engine(sos, iNChannels);
+ *   engine.initialize(matFirstBlock.col(0));      // optional: no transient from DC offsets
+ *   for(const MatrixXd& matBlock : blocks) {
+ *       engine.filterBlock(matBlock, matOut);     // continues where the previous block stopped
+ *       ...
+ *   }
+ * @endcode
+ */
+class DSPSHARED_EXPORT IirSosEngine
+{
+public:
+    typedef QSharedPointer<IirSosEngine> SPtr;             /**< Shared pointer type for IirSosEngine. */
+    typedef QSharedPointer<const IirSosEngine> ConstSPtr;  /**< Const shared pointer type for IirSosEngine. */
+
+    //=========================================================================================================
+    /**
+     * Constructs the engine with zero state.
+     *
+     * @param[in] sos            Second-order sections, e.g. from IirFilter::designButterworth().
+     * @param[in] iNChannels     Number of channels (rows) of the blocks to filter.
+     */
+    explicit IirSosEngine(const QVector<IirBiquad>& sos,
+                          int iNChannels = 0);
+
+    //=========================================================================================================
+    /**
+     * Returns the second-order sections this engine applies.
+     *
+     * @return The sections.
+     */
+    const QVector<IirBiquad>& sos() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the number of channels the state is kept for.
+     *
+     * @return The number of channels.
+     */
+    int channels() const;
+
+    //=========================================================================================================
+    /**
+     * Sets the number of channels and clears the state of all channels.
+     *
+     * @param[in] iNChannels     Number of channels.
+     */
+    void reset(int iNChannels);
+
+    //=========================================================================================================
+    /**
+     * Clears the state of all channels.
+     */
+    void reset();
+
+    //=========================================================================================================
+    /**
+     * Sets the state of every channel to the steady state for a constant input equal to vecX0, using
+     * IirFilter::sosFiltZi(). The number of channels becomes vecX0.size().
+     *
+     * @param[in] vecX0          Per-channel input level, typically the first sample of the first block.
+     */
+    void initialize(const Eigen::Ref<const Eigen::VectorXd>& vecX0);
+
+    //=========================================================================================================
+    /**
+     * Filters a block and advances the state. matDataOut is resized to the size of matData; it may be the same
+     * matrix as matData. If the number of rows differs from channels() the state is reset to zero first.
+     *
+     * @param[in] matData        The data block (channels x samples).
+     * @param[out] matDataOut    The filtered block.
+     */
+    void filterBlock(const Eigen::Ref<const Eigen::MatrixXd>& matData,
+                     Eigen::MatrixXd& matDataOut);
+
+private:
+    QVector<IirBiquad>  m_sos;          /**< The sections. */
+    Eigen::MatrixXd     m_matZi;        /**< Unit-step steady state, n_sections x 2. */
+    Eigen::MatrixXd     m_matState;     /**< Channels x (2 * n_sections): columns s1, s2 of section 0, then section 1, ... */
+    Eigen::ArrayXd      m_vecX;         /**< Section input of the current tile. */
+    Eigen::ArrayXd      m_vecY;         /**< Section output of the current tile. */
+};
+} // NAMESPACE UTILSLIB
+
+#endif // IIR_SOS_ENGINE_H
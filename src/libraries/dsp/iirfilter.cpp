@@ -15,6 +15,7 @@
 //=============================================================================================================
 
 #include "iirfilter.h"
+#include "iir_sos_engine.h"
 
 //=============================================================================================================
 // QT INCLUDES
@@ -371,14 +372,14 @@ RowVectorXd IirFilter::applySos(const RowVectorXd& vecData, const QVector<IirBiq
     // Cascade all biquad sections using Direct-Form II transposed structure:
     // w[n] = x[n] - a1*w[n-1] - a2*w[n-2]
     // y[n] = b0*w[n] + b1*w[n-1] + b2*w[n-2]
-    // Equivalent transposed: uses two state variables (s1, s2)
+    // Equivalent transposed: uses two state variables (s1, s2).
+    // Every sample is read before it is overwritten, so each section runs in place.
 
     for (const IirBiquad& bq : sos) {
-        RowVectorXd x = y;
         double s1 = 0.0, s2 = 0.0;
 
-        for (int i = 0; i < static_cast<int>(x.size()); ++i) {
-            double xi = x(i);
+        for (int i = 0; i < static_cast<int>(y.size()); ++i) {
+            double xi = y(i);
             double yi = bq.b0 * xi + s1;
             s1 = bq.b1 * xi - bq.a1 * yi + s2;
             s2 = bq.b2 * xi - bq.a2 * yi;
@@ -397,17 +398,8 @@ RowVectorXd IirFilter::applyZeroPhase(const RowVectorXd& vecData, const QVector<
         return vecData;
     }
 
-    // Forward pass
-    RowVectorXd y = applySos(vecData, sos);
-
-    // Reverse
-    RowVectorXd yRev = y.reverse();
-
-    // Backward pass
-    RowVectorXd yRevFilt = applySos(yRev, sos);
-
-    // Reverse again
-    return yRevFilt.reverse();
+    MatrixXd matData = vecData;
+    return applyZeroPhaseMatrix(matData, sos).row(0);
 }
 
 //=============================================================================================================
@@ -418,9 +410,51 @@ MatrixXd IirFilter::applyZeroPhaseMatrix(const MatrixXd& matData, const QVector<
         return matData;
     }
 
-    MatrixXd matOut(matData.rows(), matData.cols());
-    for (int i = 0; i < static_cast<int>(matData.rows()); ++i) {
-        matOut.row(i) = applyZeroPhase(matData.row(i), sos);
-    }
+    IirSosEngine engine(sos, static_cast<int>(matData.rows()));
+
+    // Forward pass, started in the steady state of the first sample
+    MatrixXd matOut;
+    engine.initialize(matData.col(0));
+    engine.filterBlock(matData, matOut);
+
+    // Backward pass on the time-reversed result, started in the steady state of its last sample
+    matOut.rowwise().reverseInPlace();
+    engine.initialize(matOut.col(0));
+    engine.filterBlock(matOut, matOut);
+    matOut.rowwise().reverseInPlace();
+
     return matOut;
 }
+
+//=============================================================================================================
+
+MatrixXd IirFilter::sosFiltZi(const QVector<IirBiquad>& sos)
+{
+    MatrixXd matZi = MatrixXd::Zero(sos.size(), 2);
+
+    // Each section sees the DC output of the sections before it
+    double dScale = 1.0;
+
+    for (int k = 0; k < sos.size(); ++k) {
+        const IirBiquad& bq = sos[k];
+        const double dDen = 1.0 + bq.a1 + bq.a2;
+
+        if (std::abs(dDen) < 1e-14) {
+            qWarning() << "[IirFilter::sosFiltZi] Section" << k << "has a pole at z = 1, no steady state exists.";
+            return MatrixXd::Zero(sos.size(), 2);
+        }
+
+        // For a constant input x = 1 the output is the DC gain G and the transposed states settle at
+        // s2 = b2 - a2*G, s1 = b1 - a1*G + s2
+        const double dGain = (bq.b0 + bq.b1 + bq.b2) / dDen;
+        const double dS2 = bq.b2 - bq.a2 * dGain;
+        const double dS1 = bq.b1 - bq.a1 * dGain + dS2;
+
+        matZi(k, 0) = dScale * dS1;
+        matZi(k, 1) = dScale * dS2;
+
+        dScale *= dGain;
+    }
+
+    return matZi;
+}
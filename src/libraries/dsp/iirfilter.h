@@ -143,7 +143,8 @@ public:
     //=========================================================================================================
     /**
      * Apply a biquad cascade with zero-phase (forward + backward pass) to one row.
-     * The effective order is doubled and there is no phase distortion.
+     * The effective order is doubled and there is no phase distortion. Same edge handling as
+     * applyZeroPhaseMatrix().
      *
      * @param[in] vecData   Input row vector.
      * @param[in] sos       Second-order sections from designButterworth().
@@ -156,6 +157,8 @@ public:
     //=========================================================================================================
     /**
      * Apply zero-phase filtering to every row of a matrix (each row = one channel).
+     * Both passes start from the sosFiltZi() steady state for the first sample they see, so a signal offset does
+     * not produce edge transients. All channels are filtered together by an IirSosEngine.
      *
      * @param[in] matData   Input matrix (n_channels x n_samples).
      * @param[in] sos       Second-order sections from designButterworth().
@@ -165,6 +168,18 @@ public:
     static Eigen::MatrixXd applyZeroPhaseMatrix(const Eigen::MatrixXd&    matData,
                                                  const QVector<IirBiquad>& sos);
 
+    //=========================================================================================================
+    /**
+     * Steady-state initial conditions of a biquad cascade for a unit step input, the equivalent of
+     * @c scipy.signal.sosfilt_zi. Scaling row k by the first input sample x0 starts the cascade as if x0 had
+     * been applied forever, which removes the start-up transient of a signal with an offset.
+     *
+     * @param[in] sos       Second-order sections from designButterworth().
+     *
+     * @return n_sections x 2 matrix with the two Direct-Form II transposed states of every section.
+     */
+    static Eigen::MatrixXd sosFiltZi(const QVector<IirBiquad>& sos);
+
 private:
     //=========================================================================================================
     /**
@@ -102,6 +102,10 @@ public:
     /**
      * Compute Morlet TFR for every (selected) channel of a data matrix.
      *
+     * Runs a @ref MorletTfrEngine, so every channel is transformed once and the wavelet spectra are shared by
+     * all channels. Keep a MorletTfrEngine around instead to reuse the spectra across calls, or to average
+     * power and ITC over epochs.
+     *
      * @param[in] matData   Data matrix (n_channels × n_samples).
      * @param[in] dSFreq    Sampling frequency in Hz.
      * @param[in] vecFreqs  Centre frequencies in Hz.
@@ -117,6 +121,8 @@ public:
             const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi());
 
 private:
+    friend class MorletTfrEngine;
+
     //=========================================================================================================
     /**
      * Build a complex Morlet wavelet for a given frequency.
@@ -128,9 +134,6 @@ private:
      * @return              Complex wavelet column vector of length 2·halfLen+1.
      */
     static Eigen::VectorXcd buildWavelet(double dFreq, double dSFreq, double dNCycles, int& halfLen);
-
-    /** Return the smallest power of 2 ≥ n. */
-    static int nextPow2(int n);
 };
 
 } // namespace UTILSLIB
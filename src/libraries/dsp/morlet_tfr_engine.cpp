@@ -0,0 +1,491 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     morlet_tfr_engine.cpp
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Implementation of @ref MorletTfrEngine: one forward FFT per channel, cached wavelet spectra and a pool of per-thread FFT workspaces.
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "morlet_tfr_engine.h"
+#include "fft_filter_engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtConcurrent>
+#include <QThreadPool>
+#include <QDebug>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <unsupported/Eigen/FFT>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace UTILSLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+struct TaskChunk
+{
+    int iBegin;     /**< First task index. */
+    int iEnd;       /**< One past the last task index. */
+};
+
+//=============================================================================================================
+
+/**
+ * Splits [0, iNTasks) into one contiguous range per thread.
+ */
+QVector<TaskChunk> makeChunks(int iNTasks, bool bUseThreads)
+{
+    const int iNumThreads = bUseThreads ? std::max(1, std::min<int>(QThreadPool::globalInstance()->maxThreadCount(), iNTasks)) : 1;
+    const int iStep = (iNTasks + iNumThreads - 1) / iNumThreads;
+
+    QVector<TaskChunk> chunks;
+    chunks.reserve(iNumThreads);
+    for(int i = 0; i < iNTasks; i += iStep) {
+        chunks.append(TaskChunk{i, std::min(i + iStep, iNTasks)});
+    }
+    return chunks;
+}
+
+//=============================================================================================================
+
+/**
+ * Runs fnChunk on every chunk, in the calling thread if there is only one.
+ */
+void runChunks(QVector<TaskChunk>& chunks, const std::function<void(TaskChunk&)>& fnChunk)
+{
+    if(chunks.size() == 1) {
+        fnChunk(chunks[0]);
+        return;
+    }
+
+    QtConcurrent::blockingMap(chunks, fnChunk);
+}
+
+} // anonymous namespace
+
+//=============================================================================================================
+// DEFINE PRIVATE TYPES
+//=============================================================================================================
+
+/**
+ * FFT plan and scratch vectors of one worker thread. The vectors only grow, so once a workspace has seen the
+ * largest FFT length of a run it never allocates again.
+ */
+struct MorletTfrEngine::Workspace
+{
+    Eigen::FFT<double>  fft;        /**< The FFT object, which caches its plans (twiddles) per length. */
+    VectorXd            vecTime;    /**< Zero-padded time-domain row. */
+    VectorXcd           vecSpec;    /**< Full spectrum of the row (epoch mode). */
+    VectorXcd           vecProd;    /**< Product of signal and wavelet spectrum. */
+    VectorXcd           vecConv;    /**< Complex convolution result. */
+
+    void reserve(int iFftLength)
+    {
+        if(vecTime.size() < iFftLength) {
+            vecTime.resize(iFftLength);
+            vecSpec.resize(iFftLength);
+            vecProd.resize(iFftLength);
+            vecConv.resize(iFftLength);
+        }
+    }
+};
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MorletTfrEngine::MorletTfrEngine(double dSFreq,
+                                 const RowVectorXd& vecFreqs,
+                                 double dNCycles,
+                                 bool bGoodSize)
+: m_dSFreq(dSFreq)
+, m_vecFreqs(vecFreqs)
+, m_dNCycles(dNCycles)
+, m_bGoodSize(bGoodSize)
+, m_iMaxWaveletLength(1)
+{
+    #ifdef EIGEN_FFTW_DEFAULT
+    fftw_make_planner_thread_safe();
+    #endif
+
+    m_lWavelets.reserve(vecFreqs.cols());
+    m_lHalfLengths.reserve(vecFreqs.cols());
+
+    for(int fi = 0; fi < vecFreqs.cols(); ++fi) {
+        int iHalfLen = 0;
+        m_lWavelets.append(MorletTfr::buildWavelet(vecFreqs[fi], dSFreq, dNCycles, iHalfLen));
+        m_lHalfLengths.append(iHalfLen);
+        m_iMaxWaveletLength = std::max<int>(m_iMaxWaveletLength, m_lWavelets.last().size());
+    }
+}
+
+//=============================================================================================================
+
+MorletTfrEngine::~MorletTfrEngine()
+{
+}
+
+//=============================================================================================================
+
+bool MorletTfrEngine::matches(double dSFreq,
+                              const RowVectorXd& vecFreqs,
+                              double dNCycles) const
+{
+    return dSFreq == m_dSFreq
+           && dNCycles == m_dNCycles
+           && vecFreqs.cols() == m_vecFreqs.cols()
+           && vecFreqs == m_vecFreqs;
+}
+
+//=============================================================================================================
+
+const RowVectorXd& MorletTfrEngine::freqs() const
+{
+    return m_vecFreqs;
+}
+
+//=============================================================================================================
+
+int MorletTfrEngine::fftLength(int iNTimes) const
+{
+    const int iMinLength = iNTimes + m_iMaxWaveletLength - 1;
+
+    return m_bGoodSize ? FftFilterEngine::nextGoodSize(iMinLength) : FftFilterEngine::nextPow2(iMinLength);
+}
+
+//=============================================================================================================
+
+void MorletTfrEngine::prepare(int iNTimes)
+{
+    spectra(fftLength(iNTimes));
+}
+
+//=============================================================================================================
+
+QVector<MorletTfrResult> MorletTfrEngine::computePower(const Ref<const MatrixXd>& matData,
+                                                       const RowVectorXi& vecPicks,
+                                                       bool bUseThreads)
+{
+    const RowVectorXi vecRows = resolvePicks(vecPicks, matData.rows());
+    const int iNTimes = matData.cols();
+    const int iNFreqs = m_vecFreqs.cols();
+
+    QVector<MorletTfrResult> results(vecRows.cols());
+    for(MorletTfrResult& result : results) {
+        result.matPower.resize(iNFreqs, iNTimes);
+        result.vecFreqs = m_vecFreqs;
+    }
+
+    if(vecRows.cols() == 0 || iNFreqs == 0 || iNTimes == 0) {
+        return results;
+    }
+
+    const int iFftLength = fftLength(iNTimes);
+    const MatrixXcd matSpectra = transformRows(matData, vecRows, iFftLength, bUseThreads);
+
+    // Raw pointer, so that the worker threads never go through QVector's detaching accessors
+    MorletTfrResult* pResults = results.data();
+
+    convolveRows(matSpectra, iNTimes, iFftLength, bUseThreads,
+                 [pResults](int iPick, int iFreq, const Ref<const VectorXcd>& vecConv) {
+        pResults[iPick].matPower.row(iFreq) = vecConv.cwiseAbs2().transpose();
+    });
+
+    return results;
+}
+
+//=============================================================================================================
+
+QVector<MatrixXcd> MorletTfrEngine::computeComplex(const Ref<const MatrixXd>& matData,
+                                                   const RowVectorXi& vecPicks,
+                                                   bool bUseThreads)
+{
+    const RowVectorXi vecRows = resolvePicks(vecPicks, matData.rows());
+    const int iNTimes = matData.cols();
+    const int iNFreqs = m_vecFreqs.cols();
+
+    QVector<MatrixXcd> results(vecRows.cols());
+    for(MatrixXcd& matCoeff : results) {
+        matCoeff.resize(iNFreqs, iNTimes);
+    }
+
+    if(vecRows.cols() == 0 || iNFreqs == 0 || iNTimes == 0) {
+        return results;
+    }
+
+    const int iFftLength = fftLength(iNTimes);
+    const MatrixXcd matSpectra = transformRows(matData, vecRows, iFftLength, bUseThreads);
+
+    MatrixXcd* pResults = results.data();
+
+    convolveRows(matSpectra, iNTimes, iFftLength, bUseThreads,
+                 [pResults](int iPick, int iFreq, const Ref<const VectorXcd>& vecConv) {
+        pResults[iPick].row(iFreq) = vecConv.transpose();
+    });
+
+    return results;
+}
+
+//=============================================================================================================
+
+MorletTfrEpochsResult MorletTfrEngine::computeEpochs(const QVector<MatrixXd>& lEpochs,
+                                                     const RowVectorXi& vecPicks,
+                                                     bool bItc,
+                                                     bool bUseThreads)
+{
+    MorletTfrEpochsResult result;
+    result.vecFreqs = m_vecFreqs;
+
+    if(lEpochs.isEmpty()) {
+        return result;
+    }
+
+    const int iNChannels = lEpochs.first().rows();
+    const int iNTimes = lEpochs.first().cols();
+    const int iNFreqs = m_vecFreqs.cols();
+
+    for(const MatrixXd& matEpoch : lEpochs) {
+        if(matEpoch.rows() != iNChannels || matEpoch.cols() != iNTimes) {
+            qWarning() << "[MorletTfrEngine::computeEpochs] All epochs must have the same size. Returning.";
+            return result;
+        }
+    }
+
+    const RowVectorXi vecRows = resolvePicks(vecPicks, iNChannels);
+    const int iNEpochs = lEpochs.size();
+
+    result.iNEpochs = iNEpochs;
+    result.matPower.fill(MatrixXd::Zero(iNFreqs, iNTimes), vecRows.cols());
+    if(bItc) {
+        result.matItc.fill(MatrixXd::Zero(iNFreqs, iNTimes), vecRows.cols());
+    }
+
+    if(vecRows.cols() == 0 || iNFreqs == 0 || iNTimes == 0) {
+        return result;
+    }
+
+    const int iFftLength = fftLength(iNTimes);
+    const QVector<VectorXcd>& lSpectra = spectra(iFftLength);
+
+    // Parallel over channels: each task owns the output of its channels, so the epochs can be reduced in place
+    MatrixXd* pPower = result.matPower.data();
+    MatrixXd* pItc = bItc ? result.matItc.data() : nullptr;
+    QVector<TaskChunk> chunks = makeChunks(vecRows.cols(), bUseThreads);
+
+    std::function<void(TaskChunk&)> reduceChunk = [&](TaskChunk& chunk) {
+        QSharedPointer<Workspace> pWorkspace = acquireWorkspace();
+        pWorkspace->reserve(iFftLength);
+
+        // Sum of unit phasors, one row per frequency
+        MatrixXcd matPhase;
+        if(bItc) {
+            matPhase.resize(iNFreqs, iNTimes);
+        }
+
+        for(int i = chunk.iBegin; i < chunk.iEnd; ++i) {
+            MatrixXd& matPower = pPower[i];
+            if(bItc) {
+                matPhase.setZero();
+            }
+
+            for(const MatrixXd& matEpoch : lEpochs) {
+                pWorkspace->vecTime.head(iNTimes) = matEpoch.row(vecRows[i]).transpose();
+                pWorkspace->vecTime.segment(iNTimes, iFftLength - iNTimes).setZero();
+                pWorkspace->fft.fwd(pWorkspace->vecSpec.data(), pWorkspace->vecTime.data(), iFftLength);
+
+                for(int fi = 0; fi < iNFreqs; ++fi) {
+                    convolve(*pWorkspace, pWorkspace->vecSpec.data(), lSpectra[fi], iFftLength);
+                    const auto vecConv = pWorkspace->vecConv.segment(m_lHalfLengths.at(fi), iNTimes);
+
+                    matPower.row(fi) += vecConv.cwiseAbs2().transpose();
+
+                    if(bItc) {
+                        for(int t = 0; t < iNTimes; ++t) {
+                            const double dAbs = std::abs(vecConv[t]);
+                            if(dAbs > 0.0) {
+                                matPhase(fi, t) += vecConv[t] / dAbs;
+                            }
+                        }
+                    }
+                }
+            }
+
+            matPower /= static_cast<double>(iNEpochs);
+            if(bItc) {
+                pItc[i] = matPhase.cwiseAbs() / static_cast<double>(iNEpochs);
+            }
+        }
+
+        releaseWorkspace(pWorkspace);
+    };
+
+    runChunks(chunks, reduceChunk);
+
+    return result;
+}
+
+//=============================================================================================================
+
+const QVector<VectorXcd>& MorletTfrEngine::spectra(int iFftLength)
+{
+    QMutexLocker locker(&m_mutex);
+
+    auto it = m_mapSpectra.constFind(iFftLength);
+    if(it != m_mapSpectra.constEnd()) {
+        return it.value();
+    }
+
+    Eigen::FFT<double> fft;
+    VectorXcd vecPadded = VectorXcd::Zero(iFftLength);
+
+    QVector<VectorXcd> lSpectra;
+    lSpectra.reserve(m_lWavelets.size());
+
+    for(const VectorXcd& vecWavelet : m_lWavelets) {
+        vecPadded.setZero();
+        vecPadded.head(vecWavelet.size()) = vecWavelet;
+
+        VectorXcd vecSpectrum(iFftLength);
+        fft.fwd(vecSpectrum.data(), vecPadded.data(), iFftLength);
+        lSpectra.append(vecSpectrum);
+    }
+
+    return m_mapSpectra.insert(iFftLength, lSpectra).value();
+}
+
+//=============================================================================================================
+
+QSharedPointer<MorletTfrEngine::Workspace> MorletTfrEngine::acquireWorkspace()
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(m_lFreeWorkspaces.isEmpty()) {
+        return QSharedPointer<Workspace>::create();
+    }
+
+    return m_lFreeWorkspaces.takeLast();
+}
+
+//=============================================================================================================
+
+void MorletTfrEngine::releaseWorkspace(const QSharedPointer<Workspace>& pWorkspace)
+{
+    QMutexLocker locker(&m_mutex);
+    m_lFreeWorkspaces.append(pWorkspace);
+}
+
+//=============================================================================================================
+
+RowVectorXi MorletTfrEngine::resolvePicks(const RowVectorXi& vecPicks,
+                                          int iNRows)
+{
+    if(vecPicks.cols() > 0) {
+        return vecPicks;
+    }
+
+    return iNRows > 0 ? RowVectorXi::LinSpaced(iNRows, 0, iNRows - 1) : RowVectorXi();
+}
+
+//=============================================================================================================
+
+MatrixXcd MorletTfrEngine::transformRows(const Ref<const MatrixXd>& matData,
+                                         const RowVectorXi& vecRows,
+                                         int iFftLength,
+                                         bool bUseThreads)
+{
+    const int iNTimes = matData.cols();
+    MatrixXcd matSpectra(iFftLength, vecRows.cols());
+
+    QVector<TaskChunk> chunks = makeChunks(vecRows.cols(), bUseThreads);
+
+    std::function<void(TaskChunk&)> transformChunk = [&](TaskChunk& chunk) {
+        QSharedPointer<Workspace> pWorkspace = acquireWorkspace();
+        pWorkspace->reserve(iFftLength);
+
+        for(int i = chunk.iBegin; i < chunk.iEnd; ++i) {
+            pWorkspace->vecTime.head(iNTimes) = matData.row(vecRows[i]).transpose();
+            pWorkspace->vecTime.segment(iNTimes, iFftLength - iNTimes).setZero();
+
+            // Without the HalfSpectrum flag Eigen::FFT fills in the conjugate-symmetric upper half as well
+            pWorkspace->fft.fwd(matSpectra.col(i).data(), pWorkspace->vecTime.data(), iFftLength);
+        }
+
+        releaseWorkspace(pWorkspace);
+    };
+
+    runChunks(chunks, transformChunk);
+
+    return matSpectra;
+}
+
+//=============================================================================================================
+
+void MorletTfrEngine::convolveRows(const MatrixXcd& matSpectra,
+                                   int iNTimes,
+                                   int iFftLength,
+                                   bool bUseThreads,
+                                   const std::function<void(int, int, const Ref<const VectorXcd>&)>& fnStore)
+{
+    const QVector<VectorXcd>& lSpectra = spectra(iFftLength);
+    const int iNFreqs = lSpectra.size();
+    const int iNTasks = matSpectra.cols() * iNFreqs;
+
+    // All inverse FFTs have the same length, so equal contiguous ranges of (pick, frequency) tasks balance well
+    QVector<TaskChunk> chunks = makeChunks(iNTasks, bUseThreads);
+
+    std::function<void(TaskChunk&)> convolveChunk = [&](TaskChunk& chunk) {
+        QSharedPointer<Workspace> pWorkspace = acquireWorkspace();
+        pWorkspace->reserve(iFftLength);
+
+        for(int iTask = chunk.iBegin; iTask < chunk.iEnd; ++iTask) {
+            const int iPick = iTask / iNFreqs;
+            const int iFreq = iTask % iNFreqs;
+
+            convolve(*pWorkspace, matSpectra.col(iPick).data(), lSpectra[iFreq], iFftLength);
+
+            // Trim to "same" length: skip the first halfLen samples of the linear convolution
+            fnStore(iPick, iFreq, pWorkspace->vecConv.segment(m_lHalfLengths.at(iFreq), iNTimes));
+        }
+
+        releaseWorkspace(pWorkspace);
+    };
+
+    runChunks(chunks, convolveChunk);
+}
+
+//=============================================================================================================
+
+void MorletTfrEngine::convolve(Workspace& workspace,
+                               const std::complex<double>* pSignalSpectrum,
+                               const VectorXcd& vecWaveletSpectrum,
+                               int iFftLength) const
+{
+    workspace.vecProd.head(iFftLength) = Map<const VectorXcd>(pSignalSpectrum, iFftLength).cwiseProduct(vecWaveletSpectrum);
+    workspace.fft.inv(workspace.vecConv.data(), workspace.vecProd.data(), iFftLength);
+}
@@ -0,0 +1,289 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     morlet_tfr_engine.h
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Batched multi-channel Morlet TFR with cached wavelet spectra and parallel inverse FFTs.
+ *
+ * @ref MorletTfr::compute transforms the signal once per analysis
+ * frequency and rebuilds and transforms every wavelet for every channel.
+ * @ref MorletTfrEngine fixes the sampling frequency, the centre
+ * frequencies and the number of cycles up front and works at one common
+ * convolution length, the one needed by the longest wavelet. Each channel
+ * is then transformed exactly once, the wavelet spectra are computed once
+ * per FFT length and kept for later calls, and the remaining work — one
+ * complex product and one inverse FFT per channel and frequency — is
+ * spread over the global thread pool.
+ *
+ * For epoched data the engine can reduce directly to the trial-averaged
+ * power and the inter-trial coherence (ITC) without ever holding the
+ * complex coefficients of more than one row.
+ */
+
+#ifndef MORLET_TFR_ENGINE_H
+#define MORLET_TFR_ENGINE_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "dsp_global.h"
+#include "morlet_tfr.h"
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// STD INCLUDES
+//=============================================================================================================
+
+#include <functional>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMap>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QVector>
+
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+//=============================================================================================================
+/**
+ * @brief Trial-averaged Morlet TFR of epoched data, one matrix per selected channel.
+ */
+struct DSPSHARED_EXPORT MorletTfrEpochsResult
+{
+    QVector<Eigen::MatrixXd> matPower;  ///< Per channel: n_freqs × n_times power averaged over epochs
+    QVector<Eigen::MatrixXd> matItc;    ///< Per channel: n_freqs × n_times inter-trial coherence in [0, 1]; empty if not requested
+    Eigen::RowVectorXd       vecFreqs;  ///< Centre frequencies in Hz, length n_freqs
+    int                      iNEpochs = 0; ///< Number of epochs that were averaged
+};
+
+//=============================================================================================================
+/**
+ * @brief Reusable Morlet TFR engine for a fixed sampling frequency, frequency grid and number of cycles.
+ *
+ * The wavelet spectra are cached per FFT length; together with the parameters fixed at construction this
+ * amounts to one cached spectrum per (sfreq, frequency, n_cycles, length). The engine is safe to use from
+ * several threads at once; each call borrows as many workspaces as it runs threads.
+ *
+ * @code
+ *   MorletTfrEngine engine(600.0, RowVectorXd::LinSpaced(30, 4.0, 80.0), 7.0);
+ *   QVector<MorletTfrResult> tfr = engine.computePower(matData);       // n_channels results
+ *   MorletTfrEpochsResult avg    = engine.computeEpochs(lEpochs);      // power and ITC, no complex tensor
+ * @endcode
+ */
+class DSPSHARED_EXPORT MorletTfrEngine
+{
+public:
+    typedef QSharedPointer<MorletTfrEngine> SPtr;             /**< Shared pointer type for MorletTfrEngine. */
+    typedef QSharedPointer<const MorletTfrEngine> ConstSPtr;  /**< Const shared pointer type for MorletTfrEngine. */
+
+    //=========================================================================================================
+    /**
+     * Constructs the engine and builds the time-domain wavelets.
+     *
+     * @param[in] dSFreq     Sampling frequency in Hz.
+     * @param[in] vecFreqs   Centre frequencies in Hz.
+     * @param[in] dNCycles   Number of wavelet cycles (default 7).
+     * @param[in] bGoodSize  If true, use the smallest even 5-smooth FFT length instead of the next power of two.
+     */
+    MorletTfrEngine(double dSFreq,
+                    const Eigen::RowVectorXd& vecFreqs,
+                    double dNCycles = 7.0,
+                    bool bGoodSize = false);
+
+    //=========================================================================================================
+    /**
+     * Destroys the engine and its workspaces.
+     */
+    ~MorletTfrEngine();
+
+    MorletTfrEngine(const MorletTfrEngine&) = delete;
+    MorletTfrEngine& operator=(const MorletTfrEngine&) = delete;
+
+    //=========================================================================================================
+    /**
+     * True if this engine was built for the given parameters, so that it can be reused for them.
+     *
+     * @param[in] dSFreq     Sampling frequency in Hz.
+     * @param[in] vecFreqs   Centre frequencies in Hz.
+     * @param[in] dNCycles   Number of wavelet cycles.
+     *
+     * @return true if all parameters match.
+     */
+    bool matches(double dSFreq,
+                 const Eigen::RowVectorXd& vecFreqs,
+                 double dNCycles) const;
+
+    //=========================================================================================================
+    /**
+     * Returns the centre frequencies.
+     *
+     * @return The centre frequencies in Hz.
+     */
+    const Eigen::RowVectorXd& freqs() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the common FFT length used for signals of the given number of samples. It is long enough for the
+     * linear convolution with the longest wavelet.
+     *
+     * @param[in] iNTimes    Number of samples per channel.
+     *
+     * @return The FFT length.
+     */
+    int fftLength(int iNTimes) const;
+
+    //=========================================================================================================
+    /**
+     * Transforms the wavelets for the FFT length belonging to iNTimes ahead of time.
+     *
+     * @param[in] iNTimes    Number of samples per channel.
+     */
+    void prepare(int iNTimes);
+
+    //=========================================================================================================
+    /**
+     * Computes the instantaneous power of every selected channel.
+     *
+     * @param[in] matData        Data matrix (n_channels × n_samples).
+     * @param[in] vecPicks       Channel row indices; empty = all channels.
+     * @param[in] bUseThreads    Whether to spread the work over the global thread pool.
+     *
+     * @return One MorletTfrResult (n_freqs × n_samples) per selected channel.
+     */
+    QVector<MorletTfrResult> computePower(const Eigen::Ref<const Eigen::MatrixXd>& matData,
+                                          const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi(),
+                                          bool bUseThreads = true);
+
+    //=========================================================================================================
+    /**
+     * Computes the complex wavelet coefficients of every selected channel.
+     *
+     * @param[in] matData        Data matrix (n_channels × n_samples).
+     * @param[in] vecPicks       Channel row indices; empty = all channels.
+     * @param[in] bUseThreads    Whether to spread the work over the global thread pool.
+     *
+     * @return One n_freqs × n_samples complex matrix per selected channel.
+     */
+    QVector<Eigen::MatrixXcd> computeComplex(const Eigen::Ref<const Eigen::MatrixXd>& matData,
+                                             const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi(),
+                                             bool bUseThreads = true);
+
+    //=========================================================================================================
+    /**
+     * Computes the trial-averaged power and, optionally, the inter-trial coherence
+     * ITC = |Σ_k c_k / |c_k|| / n_epochs of a list of epochs. The coefficients are reduced row by row as they are
+     * produced, so the memory needed does not grow with the number of epochs. The work is spread over channels.
+     *
+     * @param[in] lEpochs        Epochs, all with the same size (n_channels × n_samples).
+     * @param[in] vecPicks       Channel row indices; empty = all channels.
+     * @param[in] bItc           Whether to compute the ITC as well.
+     * @param[in] bUseThreads    Whether to spread the work over the global thread pool.
+     *
+     * @return The averaged power and ITC per selected channel. Empty if the epochs are empty or differ in size.
+     */
+    MorletTfrEpochsResult computeEpochs(const QVector<Eigen::MatrixXd>& lEpochs,
+                                        const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi(),
+                                        bool bItc = true,
+                                        bool bUseThreads = true);
+
+private:
+    struct Workspace;
+
+    //=========================================================================================================
+    /**
+     * Returns the full spectra of the zero-padded wavelets for the given FFT length, one per frequency,
+     * transforming them on first use. The returned reference stays valid for the lifetime of the engine.
+     *
+     * @param[in] iFftLength     The FFT length.
+     *
+     * @return The wavelet spectra.
+     */
+    const QVector<Eigen::VectorXcd>& spectra(int iFftLength);
+
+    //=========================================================================================================
+    /**
+     * Takes a workspace from the pool, creating one if the pool is empty.
+     *
+     * @return The workspace.
+     */
+    QSharedPointer<Workspace> acquireWorkspace();
+
+    //=========================================================================================================
+    /**
+     * Returns a workspace to the pool.
+     *
+     * @param[in] pWorkspace     The workspace.
+     */
+    void releaseWorkspace(const QSharedPointer<Workspace>& pWorkspace);
+
+    //=========================================================================================================
+    /**
+     * Returns the data rows to process: vecPicks, or all rows if it is empty.
+     */
+    static Eigen::RowVectorXi resolvePicks(const Eigen::RowVectorXi& vecPicks,
+                                           int iNRows);
+
+    //=========================================================================================================
+    /**
+     * Computes the full spectra of the zero-padded picked rows, one column per pick.
+     */
+    Eigen::MatrixXcd transformRows(const Eigen::Ref<const Eigen::MatrixXd>& matData,
+                                   const Eigen::RowVectorXi& vecRows,
+                                   int iFftLength,
+                                   bool bUseThreads);
+
+    //=========================================================================================================
+    /**
+     * Convolves every transformed row with every wavelet and hands the "same"-length result (iNTimes samples
+     * centred on the wavelet) to fnStore together with the pick and frequency index. Calls with different
+     * indices may run concurrently.
+     */
+    void convolveRows(const Eigen::MatrixXcd& matSpectra,
+                      int iNTimes,
+                      int iFftLength,
+                      bool bUseThreads,
+                      const std::function<void(int, int, const Eigen::Ref<const Eigen::VectorXcd>&)>& fnStore);
+
+    //=========================================================================================================
+    /**
+     * Multiplies one signal spectrum with the spectrum of one wavelet and transforms back into the workspace's
+     * convolution buffer.
+     */
+    void convolve(Workspace& workspace,
+                  const std::complex<double>* pSignalSpectrum,
+                  const Eigen::VectorXcd& vecWaveletSpectrum,
+                  int iFftLength) const;
+
+    double                                          m_dSFreq;           /**< Sampling frequency in Hz. */
+    Eigen::RowVectorXd                              m_vecFreqs;         /**< Centre frequencies in Hz. */
+    double                                          m_dNCycles;         /**< Number of wavelet cycles. */
+    bool                                            m_bGoodSize;        /**< Whether to use 5-smooth instead of power-of-two FFT lengths. */
+    QVector<Eigen::VectorXcd>                       m_lWavelets;        /**< Time-domain wavelets, one per frequency. */
+    QVector<int>                                    m_lHalfLengths;     /**< Half-length of each wavelet in samples. */
+    int                                             m_iMaxWaveletLength;/**< Length of the longest wavelet. */
+
+    QMutex                                          m_mutex;            /**< Guards the spectrum cache and the workspace pool. */
+    QMap<int, QVector<Eigen::VectorXcd> >           m_mapSpectra;       /**< Wavelet spectra keyed by FFT length. */
+    QVector<QSharedPointer<Workspace> >             m_lFreeWorkspaces;  /**< Idle workspaces. */
+};
+} // NAMESPACE UTILSLIB
+
+#endif // MORLET_TFR_ENGINE_H
@@ -62,6 +62,7 @@ RtAveragingWorker::RtAveragingWorker(quint32 numAverages,
 , m_iTriggerChIndex(-1)
 , m_iNewTriggerIndex(iTriggerIndex)
 , m_bDoBaselineCorrection(false)
+, m_bComputeVariance(false)
 , m_pairBaselineSec(qMakePair(float(iBaselineFromMSecs),float(iBaselineToMSecs)))
 , m_bActivateThreshold(false)
 {
@@ -102,22 +103,21 @@ void RtAveragingWorker::setAverageNumber(qint32 numAve)
         return;
     }
 
-    if(numAve < m_iNumAverages) {
-        int iDiff = m_iNumAverages - numAve;
+    //Move the newest epochs of each trigger type into a ring of the new size
+    for(EpochAccumulator& accumulator : m_mapStimAve) {
+        const int iOldCapacity = static_cast<int>(accumulator.vecRing.size());
+        const int iKeep = qMin(accumulator.iCount, numAve);
 
-        //Do averaging for each trigger type
-        QMutableMapIterator<double,QList<Eigen::MatrixXd> > idx(m_mapStimAve);
-
-        while(idx.hasNext()) {
-            idx.next();
-
-            if(idx.value().size() > iDiff) {
-                //Pop data from buffer
-                for(int i = 0; i < iDiff; ++i) {
-                    idx.value().pop_front();
-                }
-            }
+        std::vector<MatrixXd> vecRing(numAve);
+        for(int i = 0; i < iKeep; ++i) {
+            const int iSlot = (accumulator.iHead + accumulator.iCount - iKeep + i) % iOldCapacity;
+            vecRing[i].swap(accumulator.vecRing[iSlot]);
         }
+
+        accumulator.vecRing.swap(vecRing);
+        accumulator.iHead = 0;
+        accumulator.iCount = iKeep;
+        recomputeSums(accumulator);
     }
 
     m_iNumAverages = numAve;
@@ -206,6 +206,18 @@ void RtAveragingWorker::setBaselineTo(int toSamp,
 
 //=============================================================================================================
 
+void RtAveragingWorker::setVarianceActive(bool activate)
+{
+    m_bComputeVariance = activate;
+
+    //Start the sums of squares from the epochs already in the rings
+    for(EpochAccumulator& accumulator : m_mapStimAve) {
+        recomputeSums(accumulator);
+    }
+}
+
+//=============================================================================================================
+
 void RtAveragingWorker::doAveraging(const MatrixXd& rawSegment)
 {
     //Detect trigger
@@ -417,14 +429,87 @@ void RtAveragingWorker::mergeData(double dTriggerType)
 
     if(!bArtifactDetected) {
         //Add cut data to average buffer
-        m_mapStimAve[dTriggerType].append(mergedData);
+        addEpoch(m_mapStimAve[dTriggerType], mergedData);
+    }
+}
 
-        //Pop data from buffer
-        int iDiff =  m_mapStimAve[dTriggerType].size() - m_iNumAverages;
-        if(iDiff > 0) {
-            for(int i = 0; i < iDiff; ++i) {
-                m_mapStimAve[dTriggerType].pop_front();
-            }
+//=============================================================================================================
+
+void RtAveragingWorker::addEpoch(EpochAccumulator& accumulator,
+                                 const MatrixXd& matEpoch)
+{
+    //Start over if the ring does not match the settings or the epoch size anymore
+    if(static_cast<int>(accumulator.vecRing.size()) != m_iNumAverages
+       || accumulator.matSum.rows() != matEpoch.rows()
+       || accumulator.matSum.cols() != matEpoch.cols()) {
+        accumulator = EpochAccumulator();
+        accumulator.vecRing.resize(m_iNumAverages);
+        accumulator.matSum = MatrixXd::Zero(matEpoch.rows(), matEpoch.cols());
+        if(m_bComputeVariance) {
+            accumulator.matSumSquares = MatrixXd::Zero(matEpoch.rows(), matEpoch.cols());
+        }
+    }
+
+    const int iCapacity = static_cast<int>(accumulator.vecRing.size());
+    int iSlot = 0;
+
+    if(accumulator.iCount < iCapacity) {
+        iSlot = (accumulator.iHead + accumulator.iCount) % iCapacity;
+        ++accumulator.iCount;
+    } else {
+        //Subtract the oldest epoch which leaves the window
+        iSlot = accumulator.iHead;
+        accumulator.iHead = (accumulator.iHead + 1) % iCapacity;
+        accumulator.matSum -= accumulator.vecRing[iSlot];
+        if(m_bComputeVariance) {
+            accumulator.matSumSquares -= accumulator.vecRing[iSlot].cwiseAbs2();
+        }
+        ++accumulator.iReplaced;
+    }
+
+    accumulator.vecRing[iSlot] = matEpoch;
+    accumulator.matSum += matEpoch;
+    if(m_bComputeVariance) {
+        accumulator.matSumSquares += matEpoch.cwiseAbs2();
+    }
+
+    //Refresh the sums once per ring turn, which keeps the cost per epoch constant
+    if(accumulator.iReplaced >= iCapacity) {
+        recomputeSums(accumulator);
+    }
+}
+
+//=============================================================================================================
+
+void RtAveragingWorker::recomputeSums(EpochAccumulator& accumulator)
+{
+    accumulator.iReplaced = 0;
+
+    if(accumulator.iCount == 0) {
+        accumulator.matSum.setZero();
+        if(m_bComputeVariance) {
+            accumulator.matSumSquares = MatrixXd::Zero(accumulator.matSum.rows(), accumulator.matSum.cols());
+        } else {
+            accumulator.matSumSquares.resize(0, 0);
+        }
+        return;
+    }
+
+    const int iCapacity = static_cast<int>(accumulator.vecRing.size());
+    const MatrixXd& matFirst = accumulator.vecRing[accumulator.iHead];
+
+    accumulator.matSum = MatrixXd::Zero(matFirst.rows(), matFirst.cols());
+    if(m_bComputeVariance) {
+        accumulator.matSumSquares = MatrixXd::Zero(matFirst.rows(), matFirst.cols());
+    } else {
+        accumulator.matSumSquares.resize(0, 0);
+    }
+
+    for(int i = 0; i < accumulator.iCount; ++i) {
+        const MatrixXd& matEpoch = accumulator.vecRing[(accumulator.iHead + i) % iCapacity];
+        accumulator.matSum += matEpoch;
+        if(m_bComputeVariance) {
+            accumulator.matSumSquares += matEpoch.cwiseAbs2();
         }
     }
 }
@@ -433,7 +518,9 @@ void RtAveragingWorker::mergeData(double dTriggerType)
 
 void RtAveragingWorker::generateEvoked(double dTriggerType)
 {
-    if(m_mapStimAve[dTriggerType].isEmpty()) {
+    const EpochAccumulator& accumulator = m_mapStimAve[dTriggerType];
+
+    if(accumulator.iCount == 0) {
         qDebug() << "[RtAveragingWorker::generateEvoked] m_mapStimAve is empty for type" << dTriggerType << "Returning.";
         return;
     }
@@ -465,24 +552,35 @@ void RtAveragingWorker::generateEvoked(double dTriggerType)
         evoked.comment = QString::number(dTriggerType);
     }
 
-    // Generate final evoked
-    MatrixXd finalAverage = MatrixXd::Zero(m_mapStimAve[dTriggerType].first().rows(), m_iPreStimSamples+m_iPostStimSamples);
-
-    for(int i = 0; i < m_mapStimAve[dTriggerType].size(); ++i) {
-        finalAverage += m_mapStimAve[dTriggerType].at(i);
-    }
-
-    if(!m_mapStimAve[dTriggerType].isEmpty()) {
-        finalAverage = finalAverage/m_mapStimAve[dTriggerType].size();
-    }
+    // Generate final evoked from the running sum
+    const double dCount = accumulator.iCount;
+    MatrixXd finalAverage = accumulator.matSum / dCount;
 
+    // The mean baseline correction is linear, so correcting the average equals averaging corrected epochs
     if(m_bDoBaselineCorrection) {
         finalAverage = Numerics::rescale(finalAverage, evoked.times, m_pairBaselineSec, QString("mean"));
     }
 
     evoked.data = finalAverage;
 
-    evoked.nave = m_mapStimAve[dTriggerType].size();
+    evoked.nave = accumulator.iCount;
+
+    //Standard error of the average and SNR for quality monitoring
+    if(m_bComputeVariance && accumulator.iCount > 1 && accumulator.matSumSquares.size() == accumulator.matSum.size()) {
+        const MatrixXd matVariance = ((accumulator.matSumSquares - accumulator.matSum.cwiseAbs2() / dCount) / (dCount - 1.0)).cwiseMax(0.0);
+        const MatrixXd matStdErr = (matVariance / dCount).cwiseSqrt();
+
+        double dSignal = 0.0;
+        double dNoise = 0.0;
+        for(int i = 0; i < finalAverage.rows() && i < m_pFiffInfo->chs.size(); ++i) {
+            if(m_pFiffInfo->chs.at(i).kind == FIFFV_MEG_CH || m_pFiffInfo->chs.at(i).kind == FIFFV_EEG_CH) {
+                dSignal += finalAverage.row(i).squaredNorm();
+                dNoise += matStdErr.row(i).squaredNorm();
+            }
+        }
+
+        emit qualityReady(QString::number(dTriggerType), matStdErr, dNoise > 0.0 ? dSignal / dNoise : 0.0);
+    }
 
     //Add new data to evoked data set
     if(iEvokedIdx != -1) {
@@ -548,6 +646,8 @@ RtAveraging::RtAveraging(quint32 numAverages,
 
     connect(worker, &RtAveragingWorker::resultReady,
             this, &RtAveraging::handleResults, Qt::DirectConnection);
+    connect(worker, &RtAveragingWorker::qualityReady,
+            this, &RtAveraging::handleQuality, Qt::DirectConnection);
 
     connect(this, &RtAveraging::averageNumberChanged,
             worker, &RtAveragingWorker::setAverageNumber);
@@ -565,6 +665,8 @@ RtAveraging::RtAveraging(quint32 numAverages,
             worker, &RtAveragingWorker::setBaselineFrom);
     connect(this, &RtAveraging::averageBaselineToChanged,
             worker, &RtAveragingWorker::setBaselineTo);
+    connect(this, &RtAveraging::averageVarianceActiveChanged,
+            worker, &RtAveragingWorker::setVarianceActive);
     connect(this, &RtAveraging::averageResetRequested,
             worker, &RtAveragingWorker::reset);
 
@@ -596,6 +698,17 @@ void RtAveraging::handleResults(const FiffEvokedSet& evokedStimSet,
 
 //=============================================================================================================
 
+void RtAveraging::handleQuality(const QString& sTriggerType,
+                                const MatrixXd& matStdErr,
+                                double dSnr)
+{
+    emit evokedQuality(sTriggerType,
+                       matStdErr,
+                       dSnr);
+}
+
+//=============================================================================================================
+
 void RtAveraging::restart(quint32 numAverages,
                           quint32 iPreStimSamples,
                           quint32 iPostStimSamples,
@@ -623,6 +736,8 @@ void RtAveraging::restart(quint32 numAverages,
 
     connect(worker, &RtAveragingWorker::resultReady,
             this, &RtAveraging::handleResults, Qt::DirectConnection);
+    connect(worker, &RtAveragingWorker::qualityReady,
+            this, &RtAveraging::handleQuality, Qt::DirectConnection);
 
     connect(this, &RtAveraging::averageNumberChanged,
             worker, &RtAveragingWorker::setAverageNumber);
@@ -640,6 +755,8 @@ void RtAveraging::restart(quint32 numAverages,
             worker, &RtAveragingWorker::setBaselineFrom);
     connect(this, &RtAveraging::averageBaselineToChanged,
             worker, &RtAveragingWorker::setBaselineTo);
+    connect(this, &RtAveraging::averageVarianceActiveChanged,
+            worker, &RtAveragingWorker::setVarianceActive);
     connect(this, &RtAveraging::averageResetRequested,
             worker, &RtAveragingWorker::reset);
 
@@ -725,6 +842,13 @@ void RtAveraging::setBaselineTo(int toSamp,
 
 //=============================================================================================================
 
+void RtAveraging::setVarianceActive(bool activate)
+{
+    emit averageVarianceActiveChanged(activate);
+}
+
+//=============================================================================================================
+
 void RtAveraging::reset()
 {
     emit averageResetRequested();
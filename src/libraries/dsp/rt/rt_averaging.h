@@ -19,9 +19,16 @@
  * (pre/post-stim samples, baseline window, average count) and re-emits the
  * worker's result signal back to the main thread.
  *
- * Baseline correction is applied per epoch on the configured baseline
- * window before accumulation, and the @c numAverages parameter selects
- * between a strict moving-window mean and a cumulative running mean.
+ * Accepted epochs go into a fixed ring of @c numAverages slots per trigger
+ * type, together with their running sum. A new epoch is added to the sum
+ * and the epoch it replaces is subtracted, so each trigger costs
+ * O(channels × samples) regardless of the number of averages. The sums
+ * are recomputed from the ring once per ring turn to keep rounding errors
+ * from accumulating. Artifact rejection is decided per epoch before it
+ * enters the ring; the linear mean baseline correction is applied to the
+ * average. Optionally the worker also keeps element-wise sums of squares
+ * and reports the standard error of the average and an SNR estimate for
+ * online quality monitoring.
  */
 
 #ifndef RT_AVERAGING_RTPROCESSING_H
@@ -50,6 +57,12 @@
 
 #include <Eigen/Core>
 
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <vector>
+
 //=============================================================================================================
 // FORWARD DECLARATIONS
 //=============================================================================================================
@@ -176,6 +189,14 @@ public:
     void setBaselineTo(int toSamp,
                        int toMSec);
 
+    //=========================================================================================================
+    /**
+     * Sets whether the running variance is kept and qualityReady is emitted with each new average.
+     *
+     * @param[in] activate    activate the variance computation.
+     */
+    void setVarianceActive(bool activate);
+
     //=========================================================================================================
     /**
      * Resets the averaged data stored.
@@ -183,6 +204,34 @@ public:
     void reset();
 
 protected:
+    /** The accepted epochs of one trigger type and their running sums. */
+    struct EpochAccumulator {
+        std::vector<Eigen::MatrixXd>    vecRing;            /**< Ring of m_iNumAverages epoch slots, oldest at iHead. */
+        int                             iHead = 0;          /**< Ring index of the oldest epoch. */
+        int                             iCount = 0;         /**< Number of epochs in the ring. */
+        int                             iReplaced = 0;      /**< Epochs replaced since the sums were last recomputed. */
+        Eigen::MatrixXd                 matSum;             /**< Sum of the epochs in the ring. */
+        Eigen::MatrixXd                 matSumSquares;      /**< Element-wise sum of squares, kept while the variance is active. */
+    };
+
+    //=========================================================================================================
+    /**
+     * Adds an epoch to the ring and the running sums, replacing the oldest epoch once the ring is full.
+     *
+     * @param[in, out] accumulator   The accumulator of the epoch's trigger type.
+     * @param[in] matEpoch           The epoch (channels x samples).
+     */
+    void addEpoch(EpochAccumulator& accumulator,
+                  const Eigen::MatrixXd& matEpoch);
+
+    //=========================================================================================================
+    /**
+     * Recomputes the running sums from the epochs in the ring.
+     *
+     * @param[in, out] accumulator   The accumulator to refresh.
+     */
+    void recomputeSums(EpochAccumulator& accumulator);
+
     //=========================================================================================================
     /**
      * do the actual averaging here.
@@ -241,6 +290,8 @@ protected:
 
     bool                                            m_bDoBaselineCorrection;    /**< Whether to perform baseline correction. */
 
+    bool                                            m_bComputeVariance;         /**< Whether to keep the running variance and emit qualityReady. */
+
     QPair<float,float>                              m_pairBaselineSec;          /**< Baseline information in seconds form where the seconds are seen relative to the trigger, meaning they can also be negative [from to]*/
     QPair<float,float>                              m_pairBaselineSamp;         /**< Baseline information in samples form where the seconds are seen relative to the trigger, meaning they can also be negative [from to]*/
 
@@ -248,7 +299,7 @@ protected:
     FIFFLIB::FiffEvokedSet                          m_stimEvokedSet;            /**< Holds the evoked information. */
 
     QMap<QString,double>                            m_mapThresholds;            /**< Holds the current thresholds for artifact rejection. */
-    QMap<double,QList<Eigen::MatrixXd> >            m_mapStimAve;               /**< the current stimulus average buffer. Holds m_iNumAverages vectors. */
+    QMap<double,EpochAccumulator>                   m_mapStimAve;               /**< the current stimulus average buffers. Hold up to m_iNumAverages epochs each. */
     QMap<double,Eigen::MatrixXd>                    m_mapDataPre;               /**< The matrix holding pre stim data. */
     QMap<double,Eigen::MatrixXd>                    m_mapDataPost;              /**< The matrix holding post stim data. */
     QMap<double,qint32>                             m_mapMatDataPostIdx;        /**< Current index inside of the matrix m_matDataPost. */
@@ -264,6 +315,19 @@ signals:
      */
     void resultReady(const FIFFLIB::FiffEvokedSet& evokedStimSet,
                      const QStringList& lResponsibleTriggerTypes);
+
+    //=========================================================================================================
+    /**
+     * Signal which is emitted with each new average while the variance is active.
+     *
+     * @param[in] sTriggerType   The trigger type of the average.
+     * @param[in] matStdErr      Standard error of the average (channels x samples), before baseline correction.
+     * @param[in] dSnr           Power SNR of the average over the MEG/EEG channels: mean squared average over
+     *                           mean squared standard error.
+     */
+    void qualityReady(const QString& sTriggerType,
+                      const Eigen::MatrixXd& matStdErr,
+                      double dSnr);
 };
 
 //=============================================================================================================
@@ -414,6 +478,14 @@ public:
     void setBaselineTo(int toSamp,
                        int toMSec);
 
+    //=========================================================================================================
+    /**
+     * Sets the running variance and the quality output on or off
+     *
+     * @param[in] activate    activate the variance computation.
+     */
+    void setVarianceActive(bool activate);
+
     //=========================================================================================================
     /**
      * Reset the data processing in the real-time worker
@@ -428,11 +500,22 @@ protected:
     void handleResults(const FIFFLIB::FiffEvokedSet& evokedStimSet,
                        const QStringList& lResponsibleTriggerTypes);
 
+    //=========================================================================================================
+    /**
+     * Handles the quality results.
+     */
+    void handleQuality(const QString& sTriggerType,
+                       const Eigen::MatrixXd& matStdErr,
+                       double dSnr);
+
     QThread             m_workerThread;         /**< The worker thread. */
 
 signals:
     void evokedStim(const FIFFLIB::FiffEvokedSet& evokedStimSet,
                     const QStringList& lResponsibleTriggerTypes);
+    void evokedQuality(const QString& sTriggerType,
+                       const Eigen::MatrixXd& matStdErr,
+                       double dSnr);
     void operate(const Eigen::MatrixXd& matData);
     void averageNumberChanged(qint32 numAve);
     void averagePreStimChanged(qint32 samples,
@@ -446,6 +529,7 @@ signals:
                                     int fromMSec);
     void averageBaselineToChanged(int toSamp,
                                   int toMSec);
+    void averageVarianceActiveChanged(bool activate);
     void averageResetRequested();
 };
 
@@ -21,13 +21,15 @@
 //=============================================================================================================
 
 #include <QDebug>
-#include <QtConcurrent>
 
 //=============================================================================================================
 // STL INCLUDES
 //=============================================================================================================
 
+#include <cmath>
 #include <iostream>
+#include <limits>
+#include <utility>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -42,8 +44,15 @@ using namespace Eigen;
 //=============================================================================================================
 
 RtCov::RtCov(QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo)
-: m_fiffInfo(*pFiffInfo)
+: m_mode(Mode::Block)
+, m_dLambda(1.0)
+, m_iWindowSamples(0)
 , m_iSamples(0)
+, m_dWeight(0.0)
+, m_dWeightSquares(0.0)
+, m_iWindowFill(0)
+, m_iWindowDowndated(0)
+, m_fiffInfo(*pFiffInfo)
 , m_bPicksReady(false)
 {
 }
@@ -71,102 +80,226 @@ FiffCov RtCov::estimateCovariance(const Eigen::MatrixXd& matData,
     }
 
     // Apply picks: extract only MEG/EEG channel rows
+    MatrixXd matPicked;
+    const MatrixXd* pBlock = &matData;
     if(!m_picks.isEmpty() && m_picks.size() < matData.rows()) {
-        MatrixXd matPicked(m_picks.size(), matData.cols());
+        matPicked.resize(m_picks.size(), matData.cols());
         for(int i = 0; i < m_picks.size(); i++) {
             matPicked.row(i) = matData.row(m_picks[i]);
         }
-        m_lData.append(matPicked);
-    } else {
-        m_lData.append(matData);
+        pBlock = &matPicked;
+    }
+
+    if(pBlock->cols() == 0) {
+        return FiffCov();
+    }
+
+    switch(m_mode) {
+        case Mode::Exponential:
+            addBlock(*pBlock, std::pow(m_dLambda, static_cast<double>(pBlock->cols())));
+            break;
+
+        case Mode::SlidingWindow: {
+            addBlock(*pBlock);
+            m_qWindow.enqueue(*pBlock);
+            m_iWindowFill += pBlock->cols();
+
+            // Downdate the oldest blocks as long as the window stays full without them
+            const int iWindow = m_iWindowSamples > 0 ? m_iWindowSamples : iNewMaxSamples;
+            while(m_qWindow.size() > 1 && m_iWindowFill - m_qWindow.head().cols() >= iWindow) {
+                removeBlock(m_qWindow.head());
+                m_iWindowDowndated += m_qWindow.head().cols();
+                m_iWindowFill -= m_qWindow.dequeue().cols();
+            }
+
+            // Downdates accumulate rounding error. Rebuilding from the window once per turn bounds it at a
+            // constant amortized cost.
+            if(m_iWindowDowndated >= m_iWindowFill) {
+                rebuildWindow();
+            }
+            break;
+        }
+
+        default:
+            addBlock(*pBlock);
+            break;
     }
-    m_iSamples += matData.cols();
+    m_iSamples += pBlock->cols();
 
     if(m_iSamples < iNewMaxSamples) {
         return FiffCov();
     }
 
-    QFuture<RtCovComputeResult> result = QtConcurrent::mappedReduced(m_lData,
-                                                                     compute,
-                                                                     reduce);
+    // At most one effective sample leaves no degree of freedom for the unbiased estimate
+    if(m_dWeight * m_dWeight <= m_dWeightSquares) {
+        qWarning() << "[RtCov::estimateCovariance] Not enough samples. Regularization not possible. Returning empty covariance estimation.";
+        return FiffCov();
+    }
 
-    result.waitForFinished();
+    FiffCov computedCov = makeCovariance();
 
-    RtCovComputeResult finalResult = result.result();
+    m_iSamples = 0;
+    if(m_mode == Mode::Block) {
+        reset();
+    }
 
-    //Final computation
-    FiffCov computedCov;
-    computedCov.data = finalResult.matData;
+    return computedCov;
+}
 
-    bool doProj = true;
+//=============================================================================================================
 
-    if(m_iSamples > 0) {
-        finalResult.mu /= (float)m_iSamples;
-        computedCov.data.array() -= m_iSamples * (finalResult.mu * finalResult.mu.transpose()).array();
-        computedCov.data.array() /= (m_iSamples - 1);
+void RtCov::setMode(Mode mode)
+{
+    m_mode = mode;
+    reset();
+}
 
-        computedCov.kind = FIFFV_MNE_NOISE_COV;
-        computedCov.diag = false;
-        computedCov.dim = computedCov.data.rows();
+//=============================================================================================================
 
-        // Set names to picked channels only
-        QStringList pickedNames;
-        if(!m_picks.isEmpty() && m_picks.size() < m_fiffInfo.ch_names.size()) {
-            for(int i = 0; i < m_picks.size(); i++) {
-                pickedNames << m_fiffInfo.ch_names.at(m_picks[i]);
-            }
-        } else {
-            pickedNames = m_fiffInfo.ch_names;
-        }
-        computedCov.names = pickedNames;
-        computedCov.projs = m_fiffInfo.projs;
-        computedCov.bads = m_fiffInfo.bads;
-        computedCov.nfree = m_iSamples;
+RtCov::Mode RtCov::mode() const
+{
+    return m_mode;
+}
 
-        // regularize noise covariance
-        computedCov = computedCov.regularize(m_fiffInfo, 0.05, 0.05, 0.1, doProj, QStringList());
+//=============================================================================================================
 
-//            qint32 samples = rawSegment.cols();
-//            VectorXf mu = rawSegment.rowwise().sum().array() / (float)samples;
+void RtCov::setForgettingFactor(double dLambda)
+{
+    m_dLambda = qBound(std::numeric_limits<double>::min(), dLambda, 1.0);
+}
 
-//            MatrixXf noise_covariance = rawSegment * rawSegment.transpose();// noise_covariance == raw_covariance
-//            noise_covariance.array() -= samples * (mu * mu.transpose()).array();
-//            noise_covariance.array() /= (samples - 1);
+//=============================================================================================================
 
-//            std::cout << "Noise Covariance:\n" << noise_covariance.block(0,0,10,10) << std::endl;
+void RtCov::setWindowSamples(int iSamples)
+{
+    m_iWindowSamples = qMax(0, iSamples);
+}
 
-//            printf("%d raw buffer (%d x %d) generated\r\n", count, tmp.rows(), tmp.cols());
+//=============================================================================================================
 
-        m_lData.clear();
-        m_iSamples = 0;
+void RtCov::reset()
+{
+    m_iSamples = 0;
+    m_dWeight = 0.0;
+    m_dWeightSquares = 0.0;
+    m_vecMean.resize(0);
+    m_matScatter.resize(0, 0);
+    m_qWindow.clear();
+    m_iWindowFill = 0;
+    m_iWindowDowndated = 0;
+}
 
-        return computedCov;
-    } else {
-        qWarning() << "[RtCov::estimateCovariance] Number of samples equals zero. Regularization not possible. Returning empty covariance estimation.";
-        return FiffCov();
+//=============================================================================================================
+
+void RtCov::addBlock(const MatrixXd& matData,
+                     double dDecay)
+{
+    const int iChannels = matData.rows();
+    const double dSamples = matData.cols();
+
+    if(m_vecMean.size() != iChannels) {
+        m_dWeight = 0.0;
+        m_dWeightSquares = 0.0;
+        m_vecMean = VectorXd::Zero(iChannels);
+        m_matScatter = MatrixXd::Zero(iChannels, iChannels);
+    }
+
+    if(dDecay < 1.0) {
+        m_dWeight *= dDecay;
+        m_dWeightSquares *= dDecay * dDecay;
+        m_matScatter.triangularView<Lower>() *= dDecay;
     }
 
+    // Rank-k update with the block's own centred scatter
+    const VectorXd vecBlockMean = matData.rowwise().mean();
+    const MatrixXd matCentred = matData.colwise() - vecBlockMean;
+    m_matScatter.selfadjointView<Lower>().rankUpdate(matCentred);
+
+    // Rank-1 update for the shift between the running and the block mean
+    const double dWeight = m_dWeight + dSamples;
+    const VectorXd vecDelta = vecBlockMean - m_vecMean;
+    m_matScatter.selfadjointView<Lower>().rankUpdate(vecDelta, m_dWeight * dSamples / dWeight);
+
+    m_vecMean += vecDelta * (dSamples / dWeight);
+    m_dWeight = dWeight;
+    m_dWeightSquares += dSamples;
 }
 
 //=============================================================================================================
 
-RtCovComputeResult RtCov::compute(const MatrixXd &matData)
+void RtCov::removeBlock(const MatrixXd& matData)
 {
-    RtCovComputeResult result;
-    result.mu = matData.rowwise().sum();
-    result.matData = matData * matData.transpose();
-    return result;
+    const double dSamples = matData.cols();
+    const double dWeight = m_dWeight - dSamples;
+
+    if(dWeight < 0.5) {
+        m_dWeight = 0.0;
+        m_dWeightSquares = 0.0;
+        m_vecMean.setZero();
+        m_matScatter.setZero();
+        return;
+    }
+
+    // Inverse of addBlock: mean without the block, then both downdates
+    const VectorXd vecBlockMean = matData.rowwise().mean();
+    const MatrixXd matCentred = matData.colwise() - vecBlockMean;
+    const VectorXd vecMean = (m_dWeight * m_vecMean - dSamples * vecBlockMean) / dWeight;
+    const VectorXd vecDelta = vecBlockMean - vecMean;
+
+    m_matScatter.selfadjointView<Lower>().rankUpdate(matCentred, -1.0);
+    m_matScatter.selfadjointView<Lower>().rankUpdate(vecDelta, -dWeight * dSamples / m_dWeight);
+
+    m_vecMean = vecMean;
+    m_dWeight = dWeight;
+    m_dWeightSquares -= dSamples;
 }
 
 //=============================================================================================================
 
-void RtCov::reduce(RtCovComputeResult& finalResult, const RtCovComputeResult &tempResult)
+void RtCov::rebuildWindow()
 {
-    if(finalResult.matData.size() == 0 || finalResult.mu.size() == 0) {
-        finalResult.mu = tempResult.mu;
-        finalResult.matData = tempResult.matData;
+    m_dWeight = 0.0;
+    m_dWeightSquares = 0.0;
+    m_vecMean.setZero();
+    m_matScatter.setZero();
+
+    for(const MatrixXd& matBlock : std::as_const(m_qWindow)) {
+        addBlock(matBlock);
+    }
+
+    m_iWindowDowndated = 0;
+}
+
+//=============================================================================================================
+
+FiffCov RtCov::makeCovariance()
+{
+    // Unbiased weighted estimate: with unit weights W - sum(w^2)/W is W - 1 and W^2/sum(w^2) is W
+    const double dEffectiveSamples = m_dWeight * m_dWeight / m_dWeightSquares;
+
+    FiffCov computedCov;
+    computedCov.data = m_matScatter.selfadjointView<Lower>();
+    computedCov.data /= (m_dWeight - m_dWeightSquares / m_dWeight);
+
+    computedCov.kind = FIFFV_MNE_NOISE_COV;
+    computedCov.diag = false;
+    computedCov.dim = computedCov.data.rows();
+
+    // Set names to picked channels only
+    QStringList pickedNames;
+    if(!m_picks.isEmpty() && m_picks.size() < m_fiffInfo.ch_names.size()) {
+        for(int i = 0; i < m_picks.size(); i++) {
+            pickedNames << m_fiffInfo.ch_names.at(m_picks[i]);
+        }
     } else {
-        finalResult.mu += tempResult.mu;
-        finalResult.matData += tempResult.matData;
+        pickedNames = m_fiffInfo.ch_names;
     }
+    computedCov.names = pickedNames;
+    computedCov.projs = m_fiffInfo.projs;
+    computedCov.bads = m_fiffInfo.bads;
+    computedCov.nfree = qRound(dEffectiveSamples);
+
+    // regularize noise covariance
+    bool doProj = true;
+    return computedCov.regularize(m_fiffInfo, 0.05, 0.05, 0.1, doProj, QStringList());
 }
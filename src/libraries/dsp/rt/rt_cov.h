@@ -9,18 +9,25 @@
  * @date     March 2026
  * @brief    Real-time noise covariance estimation from streaming MEG / EEG data blocks.
  *
- * RtCov maintains a running unbiased estimate of the channel–channel
- * covariance matrix used by linear inverse operators (MNE, dSPM, sLORETA,
- * beamformers). Every incoming block contributes its centred outer product
- * @c X⋅Xᵀ to the accumulator together with the per-block sample count;
- * the final covariance is the weighted sum divided by the total number of
- * samples minus one. Computation is offloaded to a worker @c QThread so
- * the acquisition pipeline never blocks on the dense matrix multiply.
+ * RtCov maintains a running estimate of the channel–channel covariance
+ * matrix used by linear inverse operators (MNE, dSPM, sLORETA,
+ * beamformers). Every incoming block is folded into a running mean and
+ * scatter matrix with the block-wise Welford (Chan et al.) update: the
+ * block's own centred scatter @c Xc⋅Xcᵀ is added as a rank-k update and
+ * the shift between the block mean and the running mean as a rank-1
+ * update. No data is stored, so memory stays at one channels×channels
+ * matrix and a regularized @ref FIFFLIB::FiffCov is produced every
+ * @c iNewMaxSamples samples without a batch recompute.
  *
- * The @ref RtCovComputeResult bundle carries both the matrix and the
- * sample count, which lets downstream consumers combine partial estimates,
- * apply rank-corrections, or convert to a @ref FIFFLIB::FiffCov for
- * persistence and inverse-operator construction.
+ * Three estimation modes are available. @c Block restarts the estimate
+ * after each result (the classic tumbling window). @c Exponential keeps
+ * the estimate running and discounts older samples by a per-sample
+ * forgetting factor. @c SlidingWindow keeps the blocks of the last
+ * window and downdates the oldest ones as they leave it; once per
+ * window turn it recomputes the estimate from these blocks, so the
+ * rounding error of the downdates cannot build up. The last two
+ * modes allow downstream consumers such as @ref RtInvOp to refresh
+ * continuously.
  */
 
 #ifndef RT_COV_RTPROCESSING_H
@@ -39,6 +46,7 @@
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QQueue>
 #include <QSharedPointer>
 #include <QThread>
 
@@ -67,14 +75,6 @@ namespace RTPROCESSINGLIB
 // RTPROCESSINGLIB FORWARD DECLARATIONS
 //=============================================================================================================
 
-/**
- * @brief Bundled output of a real-time covariance computation step containing the covariance matrix and sample count.
- */
-struct RtCovComputeResult {
-    Eigen::VectorXd mu;
-    Eigen::MatrixXd matData;
-};
-
 //=============================================================================================================
 /**
  * Real-time covariance worker.
@@ -86,40 +86,115 @@ class DSPSHARED_EXPORT RtCov : public QObject
     Q_OBJECT
 
 public:
+    /** How past blocks contribute to the estimate. */
+    enum class Mode {
+        Block,              /**< Estimate over iNewMaxSamples samples, then start over. */
+        Exponential,        /**< Running estimate, older samples discounted by the forgetting factor. */
+        SlidingWindow       /**< Running estimate over the most recent window samples. */
+    };
+
     RtCov(QSharedPointer<FIFFLIB::FiffInfo> pFiffInfo);
 
     //=========================================================================================================
     /**
-     * Perform actual covariance estimation.
+     * Adds a data block to the running estimate and returns a regularized covariance every iNewMaxSamples
+     * samples.
      *
-     * @param[in] inputData  Data to estimate the covariance from.
+     * @param[in] matData            Data block (channels x samples) to update the estimate with.
+     * @param[in] iNewMaxSamples     Number of samples between two returned estimates.
+     *
+     * @return The regularized covariance, or an empty FiffCov if no estimate is due.
      */
     FIFFLIB::FiffCov estimateCovariance(const Eigen::MatrixXd& matData,
                                         int iNewMaxSamples);
 
+    //=========================================================================================================
+    /**
+     * Sets the estimation mode and restarts the estimate. Default is Mode::Block.
+     *
+     * @param[in] mode   The estimation mode.
+     */
+    void setMode(Mode mode);
+
+    //=========================================================================================================
+    /**
+     * Returns the estimation mode.
+     *
+     * @return The estimation mode.
+     */
+    Mode mode() const;
+
+    //=========================================================================================================
+    /**
+     * Sets the per-sample forgetting factor used in Mode::Exponential. A block of n samples scales the weight
+     * of everything before it by dLambda^n, giving an effective memory of about 1/(1 - dLambda) samples. The
+     * estimate is bias-corrected and its nfree set with the effective number of samples W^2 / sum(w^2).
+     *
+     * @param[in] dLambda    Forgetting factor in (0, 1]. 1 keeps all samples.
+     */
+    void setForgettingFactor(double dLambda);
+
+    //=========================================================================================================
+    /**
+     * Sets the window length used in Mode::SlidingWindow. 0 uses iNewMaxSamples.
+     *
+     * @param[in] iSamples   Window length in samples.
+     */
+    void setWindowSamples(int iSamples);
+
+    //=========================================================================================================
+    /**
+     * Discards the running estimate.
+     */
+    void reset();
+
 protected:
     //=========================================================================================================
     /**
-     * Computer multiplication with transposed.
+     * Folds a block into the running mean and scatter. The weight so far is first scaled by dDecay.
      *
-     * @param[in] matData  Data to self multiply with.
+     * @param[in] matData    Picked data block (channels x samples).
+     * @param[in] dDecay     Factor applied to the previous weight and scatter.
+     */
+    void addBlock(const Eigen::MatrixXd& matData,
+                  double dDecay = 1.0);
+
+    //=========================================================================================================
+    /**
+     * Removes a block that was previously added with addBlock() and no decay from the running mean and scatter.
      *
-     * @return   The multiplication result.
+     * @param[in] matData    Picked data block (channels x samples).
      */
-    static RtCovComputeResult compute(const Eigen::MatrixXd &matData);
+    void removeBlock(const Eigen::MatrixXd& matData);
 
     //=========================================================================================================
     /**
-     * Computer multiplication with transposed.
+     * Recomputes the running mean and scatter from the blocks in the window of Mode::SlidingWindow, which
+     * discards the rounding error the downdates have accumulated.
+     */
+    void rebuildWindow();
+
+    //=========================================================================================================
+    /**
+     * Builds the regularized FiffCov from the running mean and scatter.
      *
-     * @param[out]   finalResult     The final covariance estimation.
-     * @param[in]   tempResult      The intermediate result from the compute function.
+     * @return The regularized covariance.
      */
-    static void reduce(RtCovComputeResult& finalResult, const RtCovComputeResult &tempResult);
+    FIFFLIB::FiffCov makeCovariance();
+
+    Mode                    m_mode;                     /**< The estimation mode. */
+    double                  m_dLambda;                  /**< Per-sample forgetting factor of Mode::Exponential. */
+    int                     m_iWindowSamples;           /**< Window length of Mode::SlidingWindow, 0 for iNewMaxSamples. */
 
-    int                     m_iSamples;                 /**< The number of stored samples. */
+    int                     m_iSamples;                 /**< The number of samples since the last estimate. */
+    double                  m_dWeight;                  /**< Total (decayed) sample weight of the running estimate. */
+    double                  m_dWeightSquares;           /**< Sum of the squared sample weights, for the effective number of samples. */
+    Eigen::VectorXd         m_vecMean;                  /**< The running channel means. */
+    Eigen::MatrixXd         m_matScatter;               /**< The running centred scatter matrix, lower triangle only. */
 
-    QList<Eigen::MatrixXd>  m_lData;                    /**< The stored data blocks. */
+    QQueue<Eigen::MatrixXd> m_qWindow;                  /**< The picked blocks inside the window of Mode::SlidingWindow. */
+    int                     m_iWindowFill;              /**< Number of samples in m_qWindow. */
+    int                     m_iWindowDowndated;         /**< Number of samples downdated since the last rebuildWindow(). */
 
     FIFFLIB::FiffInfo       m_fiffInfo;                 /**< Holds the fiff measurement information. */
 
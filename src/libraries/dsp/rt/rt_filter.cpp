@@ -21,11 +21,15 @@
 #include <mne/mne_epoch_data.h>
 #include <mne/mne_epoch_data_list.h>
 
+#include <algorithm>
+#include <functional>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QDebug>
+#include <QThreadPool>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -220,7 +224,24 @@ MatrixXd RTPROCESSINGLIB::filterData(const MatrixXd& matData,
                                      bool bUseThreads,
                                      bool bKeepOverhead)
 {
-    int iOrder = filterKernel.getFilterOrder();
+    FftFilterEngine filterEngine(filterKernel);
+
+    return filterData(matData,
+                      filterEngine,
+                      vecPicks,
+                      bUseThreads,
+                      bKeepOverhead);
+}
+
+//=============================================================================================================
+
+MatrixXd RTPROCESSINGLIB::filterData(const MatrixXd& matData,
+                                     FftFilterEngine& filterEngine,
+                                     const RowVectorXi& vecPicks,
+                                     bool bUseThreads,
+                                     bool bKeepOverhead)
+{
+    int iOrder = filterEngine.filterOrder();
 
     // Check for size of data
     if(matData.cols() < iOrder){
@@ -258,26 +279,23 @@ MatrixXd RTPROCESSINGLIB::filterData(const MatrixXd& matData,
                 iSize = matData.cols() - (iSize * (numSlices -1));
             }
 
-            // Filter the data block. This will return data with a fitler delay of iOrder/2 in front and back
-            sliceFiltered = filterDataBlock(matData.block(0,from,matData.rows(),iSize),
-                                            vecPicks,
-                                            filterKernel,
-                                            bUseThreads);
+            // Filter the data block. This will return data with a fitler delay of iOrder/2 in front and back.
+            // sliceFiltered keeps its memory between slices of equal size.
+            filterEngine.filterBlock(matData.block(0,from,matData.rows(),iSize),
+                                     sliceFiltered,
+                                     vecPicks,
+                                     bUseThreads);
 
             // Perform overlap add
-            if(i == 0) {
-                matDataOut.block(0,0,matData.rows(),sliceFiltered.cols()) += sliceFiltered;
-            } else {
-                matDataOut.block(0,from,matData.rows(),sliceFiltered.cols()) += sliceFiltered;
-            }
+            matDataOut.block(0,from,matData.rows(),sliceFiltered.cols()) += sliceFiltered;
 
             from += iSize;
         }
     } else {
-        matDataOut = filterDataBlock(matData,
-                                     vecPicks,
-                                     filterKernel,
-                                     bUseThreads);
+        filterEngine.filterBlock(matData,
+                                 matDataOut,
+                                 vecPicks,
+                                 bUseThreads);
     }
 
     if(bKeepOverhead) {
@@ -302,50 +320,14 @@ MatrixXd RTPROCESSINGLIB::filterDataBlock(const MatrixXd& matData,
         return matData;
     }
 
-    // Setup filters to the correct length, so we do not have to do this everytime we call the FFT filter function
-    FilterKernel filterKernelSetup = filterKernel;
-    filterKernelSetup.prepareFilter(matData.cols());
-
-    // Do the concurrent filtering
-    RowVectorXi vecPicksNew = vecPicks;
-    if(vecPicksNew.cols() == 0) {
-        vecPicksNew = RowVectorXi::LinSpaced(matData.rows(), 0, matData.rows());
-    }
-
-    // Generate QList structure which can be handled by the QConcurrent framework
-    QList<FilterObject> timeData;
-
-    // Only select channels specified in vecPicksNew
-    FilterObject data;
-    for(qint32 i = 0; i < vecPicksNew.cols(); ++i) {
-        data.filterKernel = filterKernelSetup;
-        data.iRow = vecPicksNew[i];
-        data.vecData = matData.row(vecPicksNew[i]);
-        timeData.append(data);
-    }
+    // Filter all picked rows in one batched pass instead of copying the kernel for every channel
+    FftFilterEngine filterEngine(filterKernel);
 
-    // Copy in data from last data block. This is necessary in order to also delay channels which are not filtered
-    MatrixXd matDataOut(matData.rows(), matData.cols()+iOrder);
-    matDataOut.setZero();
-    matDataOut.block(0, iOrder/2, matData.rows(), matData.cols()) = matData;
-
-    if(bUseThreads) {
-        QFuture<void> future = QtConcurrent::map(timeData,
-                                                 filterChannel);
-        future.waitForFinished();
-    } else {
-        for(int i = 0; i < timeData.size(); ++i) {
-            filterChannel(timeData[i]);
-        }
-    }
-
-    // Do the overlap add method and store in matDataOut
-    RowVectorXd tempData;
-
-    for(int r = 0; r < timeData.size(); r++) {
-        // Write the newly calculated filtered data to the filter data matrix. This data has a delay of iOrder/2 in front and back
-        matDataOut.row(timeData.at(r).iRow) = timeData.at(r).vecData;
-    }
+    MatrixXd matDataOut;
+    filterEngine.filterBlock(matData,
+                             matDataOut,
+                             vecPicks,
+                             bUseThreads);
 
     return matDataOut;
 }
@@ -432,10 +414,14 @@ MatrixXd FilterOverlapAdd::calculate(const MatrixXd& matData,
         m_matOverlapFront.setZero();
     }
 
+    // Keep the FFT plans and coefficient spectra between blocks as long as the filter does not change
+    if(!m_pFilterEngine || !m_pFilterEngine->matches(filterKernel)) {
+        m_pFilterEngine = FftFilterEngine::SPtr::create(filterKernel);
+    }
+
     // Create output matrix with size of input matrix
     MatrixXd matDataOut(matData.rows(), matData.cols()+iOrder);
     matDataOut.setZero();
-    MatrixXd sliceFiltered;
 
     // slice input data into data junks with proper length so that the slices are always >= the filter order
     float fFactor = 2.0f;
@@ -463,16 +449,12 @@ MatrixXd FilterOverlapAdd::calculate(const MatrixXd& matData,
             }
 
             // Filter the data block. This will return data with a fitler delay of iOrder/2 in front and back
-            sliceFiltered = filterDataBlock(matData.block(0,from,matData.rows(),iSize),
-                                            vecPicks,
-                                            filterKernel,
-                                            bUseThreads);
+            m_pFilterEngine->filterBlock(matData.block(0,from,matData.rows(),iSize),
+                                         m_matSliceFiltered,
+                                         vecPicks,
+                                         bUseThreads);
 
-            if(i == 0) {
-                matDataOut.block(0,0,matData.rows(),sliceFiltered.cols()) += sliceFiltered;
-            } else {
-                matDataOut.block(0,from,matData.rows(),sliceFiltered.cols()) += sliceFiltered;
-            }
+            matDataOut.block(0,from,matData.rows(),m_matSliceFiltered.cols()) += m_matSliceFiltered;
 
             if(bFilterEnd && (i == 0)) {
                 matDataOut.block(0,0,matDataOut.rows(),iOrder) += m_matOverlapBack;
@@ -483,9 +465,9 @@ MatrixXd FilterOverlapAdd::calculate(const MatrixXd& matData,
             from += iSize;
         }
     } else {
-        matDataOut = filterDataBlock(matData,
+        m_pFilterEngine->filterBlock(matData,
+                                     matDataOut,
                                      vecPicks,
-                                     filterKernel,
                                      bUseThreads);
 
         if(bFilterEnd) {
@@ -514,6 +496,246 @@ void FilterOverlapAdd::reset()
     m_matOverlapFront.resize(0,0);
 }
 
+//=============================================================================================================
+// DEFINE FilterOverlapSave
+//=============================================================================================================
+
+/**
+ * FFT plan and scratch vectors of one worker, together with the range of picks it owns.
+ */
+struct FilterOverlapSave::Workspace
+{
+    Eigen::FFT<double>  fft;        /**< The FFT object of length 2B. */
+    VectorXd            vecTime;    /**< Previous and current input block, later the inverse transform. */
+    VectorXcd           vecFreq;    /**< Half spectrum of vecTime. */
+    VectorXcd           vecAcc;     /**< Accumulated output spectrum. */
+    int                 iBegin;     /**< First owned index into the picks. */
+    int                 iEnd;       /**< One past the last owned index into the picks. */
+
+    Workspace(int iBlockSize, int iBeginPick, int iEndPick)
+    : vecTime(VectorXd::Zero(2 * iBlockSize))
+    , vecFreq(iBlockSize + 1)
+    , vecAcc(iBlockSize + 1)
+    , iBegin(iBeginPick)
+    , iEnd(iEndPick)
+    {
+        fft.SetFlag(fft.HalfSpectrum);
+
+        // Build the plans now rather than on the first block
+        fft.fwd(vecFreq.data(), vecTime.data(), vecTime.size());
+        fft.inv(vecTime.data(), vecFreq.data(), vecTime.size());
+    }
+};
+
+//=============================================================================================================
+
+FilterOverlapSave::FilterOverlapSave(const FilterKernel& filterKernel,
+                                     int iNumChannels,
+                                     int iBlockSize,
+                                     const RowVectorXi& vecPicks,
+                                     bool bUseThreads)
+: m_iBlockSize(std::max(iBlockSize, 1))
+, m_iNumPartitions(1)
+, m_iNumChannels(std::max(iNumChannels, 0))
+, m_iDelay(filterKernel.getFilterOrder()/2)
+, m_iFill(0)
+, m_iFdlPos(0)
+{
+    #ifdef EIGEN_FFTW_DEFAULT
+    fftw_make_planner_thread_safe();
+    #endif
+
+    const int iB = m_iBlockSize;
+    const RowVectorXd vecCoeff = filterKernel.getCoefficients();
+    m_iNumPartitions = std::max<int>(1, (vecCoeff.cols() + iB - 1) / iB);
+
+    // Split the rows into filtered and delayed-only ones
+    QVector<bool> vecIsPicked(m_iNumChannels, vecPicks.cols() == 0);
+    for(int i = 0; i < vecPicks.cols(); ++i) {
+        if(vecPicks[i] >= 0 && vecPicks[i] < m_iNumChannels) {
+            vecIsPicked[vecPicks[i]] = true;
+        }
+    }
+
+    const int iNumPicks = vecIsPicked.count(true);
+    m_vecPicks.resize(iNumPicks);
+    m_vecUnpicked.resize(m_iNumChannels - iNumPicks);
+    for(int i = 0, p = 0, u = 0; i < m_iNumChannels; ++i) {
+        if(vecIsPicked[i]) {
+            m_vecPicks[p++] = i;
+        } else {
+            m_vecUnpicked[u++] = i;
+        }
+    }
+
+    // Transform the zero-padded filter partitions once
+    Eigen::FFT<double> fft;
+    fft.SetFlag(fft.HalfSpectrum);
+
+    VectorXd vecPadded(2 * iB);
+    m_matPartitions.resize(iB + 1, m_iNumPartitions);
+    for(int p = 0; p < m_iNumPartitions; ++p) {
+        const int iTaps = std::min<int>(iB, vecCoeff.cols() - p * iB);
+        vecPadded.setZero();
+        if(iTaps > 0) {
+            vecPadded.head(iTaps) = vecCoeff.segment(p * iB, iTaps).transpose();
+        }
+        fft.fwd(m_matPartitions.col(p).data(), vecPadded.data(), 2 * iB);
+    }
+
+    m_matFdl = MatrixXcd::Zero(iB + 1, static_cast<Index>(m_iNumPartitions) * iNumPicks);
+    m_matPrevious = MatrixXd::Zero(iB, iNumPicks);
+    m_matDelayLine = MatrixXd::Zero(m_vecUnpicked.size(), m_iDelay + iB);
+    m_matInBlock = MatrixXd::Zero(m_iNumChannels, iB);
+    m_matOutBlock = MatrixXd::Zero(m_iNumChannels, iB);
+
+    // One fixed range of picks per thread
+    if(iNumPicks > 0) {
+        const int iNumThreads = bUseThreads ? std::max(1, std::min(QThreadPool::globalInstance()->maxThreadCount(), iNumPicks)) : 1;
+        const int iStep = (iNumPicks + iNumThreads - 1) / iNumThreads;
+        for(int i = 0; i < iNumPicks; i += iStep) {
+            m_lWorkspaces.append(QSharedPointer<Workspace>::create(iB, i, std::min(i + iStep, iNumPicks)));
+        }
+    }
+}
+
+//=============================================================================================================
+
+FilterOverlapSave::~FilterOverlapSave()
+{
+}
+
+//=============================================================================================================
+
+void FilterOverlapSave::calculate(const Ref<const MatrixXd>& matData,
+                                  Ref<MatrixXd> matDataOut)
+{
+    if(matData.rows() != m_iNumChannels || matDataOut.rows() != matData.rows() || matDataOut.cols() != matData.cols()) {
+        qWarning() << "[FilterOverlapSave::calculate] Data dimensions do not match the filter setup. Returning.";
+        return;
+    }
+
+    // Input sample j of a block is answered with sample j+1 of the previous output block, and the last one with
+    // sample 0 of the block it completes. This gives a constant latency of B-1 samples however the stream is chunked.
+    Index iPos = 0;
+    while(iPos < matData.cols()) {
+        const int iNum = static_cast<int>(std::min<Index>(m_iBlockSize - m_iFill, matData.cols() - iPos));
+
+        m_matInBlock.middleCols(m_iFill, iNum) = matData.middleCols(iPos, iNum);
+
+        if(m_iFill + iNum == m_iBlockSize) {
+            matDataOut.middleCols(iPos, iNum - 1) = m_matOutBlock.middleCols(m_iFill + 1, iNum - 1);
+            processBlock();
+            matDataOut.col(iPos + iNum - 1) = m_matOutBlock.col(0);
+            m_iFill = 0;
+        } else {
+            matDataOut.middleCols(iPos, iNum) = m_matOutBlock.middleCols(m_iFill + 1, iNum);
+            m_iFill += iNum;
+        }
+
+        iPos += iNum;
+    }
+}
+
+//=============================================================================================================
+
+MatrixXd FilterOverlapSave::calculate(const MatrixXd& matData)
+{
+    MatrixXd matDataOut(matData.rows(), matData.cols());
+    calculate(matData, matDataOut);
+    return matDataOut;
+}
+
+//=============================================================================================================
+
+int FilterOverlapSave::blockSize() const
+{
+    return m_iBlockSize;
+}
+
+//=============================================================================================================
+
+int FilterOverlapSave::latency() const
+{
+    return m_iBlockSize - 1;
+}
+
+//=============================================================================================================
+
+void FilterOverlapSave::reset()
+{
+    m_matFdl.setZero();
+    m_matPrevious.setZero();
+    m_matDelayLine.setZero();
+    m_matInBlock.setZero();
+    m_matOutBlock.setZero();
+    m_iFill = 0;
+    m_iFdlPos = 0;
+}
+
+//=============================================================================================================
+
+void FilterOverlapSave::processBlock()
+{
+    m_iFdlPos = (m_iFdlPos + 1) % m_iNumPartitions;
+
+    if(m_lWorkspaces.size() == 1) {
+        processChannels(*m_lWorkspaces.first(), m_lWorkspaces.first()->iBegin, m_lWorkspaces.first()->iEnd);
+    } else if(m_lWorkspaces.size() > 1) {
+        std::function<void(QSharedPointer<Workspace>&)> processWorkspace = [this](QSharedPointer<Workspace>& pWorkspace) {
+            processChannels(*pWorkspace, pWorkspace->iBegin, pWorkspace->iEnd);
+        };
+
+        QtConcurrent::blockingMap(m_lWorkspaces, processWorkspace);
+    }
+
+    // Rows which are not filtered are only delayed by half the filter order, like filterData does
+    if(m_vecUnpicked.size() > 0) {
+        for(int i = 0; i < m_vecUnpicked.size(); ++i) {
+            m_matDelayLine.row(i).tail(m_iBlockSize) = m_matInBlock.row(m_vecUnpicked[i]);
+            m_matOutBlock.row(m_vecUnpicked[i]) = m_matDelayLine.row(i).head(m_iBlockSize);
+        }
+
+        for(int c = 0; c < m_iDelay; ++c) {
+            m_matDelayLine.col(c) = m_matDelayLine.col(c + m_iBlockSize);
+        }
+    }
+}
+
+//=============================================================================================================
+
+void FilterOverlapSave::processChannels(Workspace& workspace,
+                                        int iBegin,
+                                        int iEnd)
+{
+    const int iB = m_iBlockSize;
+    const int iP = m_iNumPartitions;
+
+    for(int i = iBegin; i < iEnd; ++i) {
+        const int iRow = m_vecPicks[i];
+        const Index iBase = static_cast<Index>(i) * iP;
+
+        // Overlap-save input: previous block followed by the current one
+        workspace.vecTime.head(iB) = m_matPrevious.col(i);
+        workspace.vecTime.tail(iB) = m_matInBlock.row(iRow).transpose();
+        m_matPrevious.col(i) = workspace.vecTime.tail(iB);
+
+        workspace.fft.fwd(workspace.vecFreq.data(), workspace.vecTime.data(), 2 * iB);
+        m_matFdl.col(iBase + m_iFdlPos) = workspace.vecFreq;
+
+        // Partition p sees the spectrum of p blocks ago
+        workspace.vecAcc.setZero();
+        for(int p = 0; p < iP; ++p) {
+            const int iSlot = (m_iFdlPos - p + iP) % iP;
+            workspace.vecAcc.array() += m_matPartitions.col(p).array() * m_matFdl.col(iBase + iSlot).array();
+        }
+
+        // The second half is free of circular wrap-around
+        workspace.fft.inv(workspace.vecTime.data(), workspace.vecAcc.data(), 2 * iB);
+        m_matOutBlock.row(iRow) = workspace.vecTime.tail(iB).transpose();
+    }
+}
+
 //=============================================================================================================
 
 FiffEvoked RTPROCESSINGLIB::computeFilteredAverage(const FiffRawData& raw,
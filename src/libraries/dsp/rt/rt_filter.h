@@ -34,6 +34,7 @@
 #include "../dsp_global.h"
 
 #include "../filterkernel.h"
+#include "../fft_filter_engine.h"
 
 #include <fiff/fiff_info.h>
 #include <fiff/fiff_evoked.h>
@@ -175,6 +176,26 @@ DSPSHARED_EXPORT Eigen::MatrixXd filterData(const Eigen::MatrixXd& matData,
                                                     bool bUseThreads = true,
                                                     bool bKeepOverhead = false);
 
+//=========================================================================================================
+/**
+ * Calculates the filtered version of the raw input data with a prepared filter engine. The engine keeps its FFT
+ * plans, coefficient spectra and scratch buffers between calls, so repeated filtering with the same kernel only
+ * pays for the transforms themselves.
+ *
+ * @param[in] matData          The data which is to be filtered.
+ * @param[in] filterEngine     The filter engine to use.
+ * @param[in] vecPicks         Channel indexes to filter. Default is filter all channels.
+ * @param[in] bUseThreads      Whether to use multiple threads. Default is set to true.
+ * @param[in] bKeepOverhead    Whether to keep the delayed part of the data after filtering. Default is set to false .
+ *
+ * @return The filtered data in form of a matrix.
+ */
+DSPSHARED_EXPORT Eigen::MatrixXd filterData(const Eigen::MatrixXd& matData,
+                                                    UTILSLIB::FftFilterEngine& filterEngine,
+                                                    const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi(),
+                                                    bool bUseThreads = true,
+                                                    bool bKeepOverhead = false);
+
 //=========================================================================================================
 /**
  * Calculates the filtered version of the raw input data block.
@@ -308,6 +329,132 @@ public:
 private:
     Eigen::MatrixXd                 m_matOverlapBack;                   /**< Overlap block for the end of the data block. */
     Eigen::MatrixXd                 m_matOverlapFront;                  /**< Overlap block for the beginning of the data block. */
+    Eigen::MatrixXd                 m_matSliceFiltered;                 /**< Reused output of the per-slice filtering. */
+    UTILSLIB::FftFilterEngine::SPtr m_pFilterEngine;                    /**< Engine of the last used filter kernel. */
+};
+
+//=============================================================================================================
+/**
+ * Streaming FIR filtering with uniformly partitioned overlap-save convolution. The filter is split into
+ * partitions of iBlockSize taps whose spectra are computed once; every full block of iBlockSize input samples
+ * costs one forward FFT, one multiply-accumulate over the frequency-domain delay line and one inverse FFT per
+ * filtered channel, independent of how the caller chunks the stream. All state is allocated in the constructor.
+ *
+ * The block size is the latency/throughput trade-off: the output lags the input by latency() = iBlockSize - 1
+ * samples on top of the filter's own group delay of order/2 samples, while the work per sample shrinks roughly
+ * with order / iBlockSize. Concatenating the outputs of consecutive calls yields the same samples as
+ * filterData(..., bKeepOverhead = true) on the whole recording, delayed by latency().
+ *
+ * @brief Low-latency streaming FIR filter based on partitioned overlap-save convolution.
+ */
+class DSPSHARED_EXPORT FilterOverlapSave
+{
+public:
+    typedef QSharedPointer<FilterOverlapSave> SPtr;             /**< Shared pointer type for FilterOverlapSave. */
+    typedef QSharedPointer<const FilterOverlapSave> ConstSPtr;  /**< Const shared pointer type for FilterOverlapSave. */
+
+    //=========================================================================================================
+    /**
+     * Constructs the streaming filter and allocates all of its state.
+     *
+     * @param[in] filterKernel     The filter to apply.
+     * @param[in] iNumChannels     Number of rows of the data blocks.
+     * @param[in] iBlockSize       Partition and FFT block size in samples. Default is 64.
+     * @param[in] vecPicks         Channel indexes to filter. Default is filter all channels.
+     * @param[in] bUseThreads      Whether to spread the channels over the global thread pool. Default is false.
+     */
+    FilterOverlapSave(const UTILSLIB::FilterKernel& filterKernel,
+                      int iNumChannels,
+                      int iBlockSize = 64,
+                      const Eigen::RowVectorXi& vecPicks = Eigen::RowVectorXi(),
+                      bool bUseThreads = false);
+
+    //=========================================================================================================
+    /**
+     * Destroys the filter.
+     */
+    ~FilterOverlapSave();
+
+    FilterOverlapSave(const FilterOverlapSave&) = delete;
+    FilterOverlapSave& operator=(const FilterOverlapSave&) = delete;
+
+    //=========================================================================================================
+    /**
+     * Filters the next chunk of the stream. The chunk may have any number of columns.
+     *
+     * @param[in] matData          The next samples (iNumChannels x n).
+     * @param[out] matDataOut      The filtered samples (iNumChannels x n), delayed by latency() + order/2.
+     */
+    void calculate(const Eigen::Ref<const Eigen::MatrixXd>& matData,
+                   Eigen::Ref<Eigen::MatrixXd> matDataOut);
+
+    //=========================================================================================================
+    /**
+     * Filters the next chunk of the stream.
+     *
+     * @param[in] matData          The next samples (iNumChannels x n).
+     *
+     * @return The filtered samples (iNumChannels x n), delayed by latency() + order/2.
+     */
+    Eigen::MatrixXd calculate(const Eigen::MatrixXd& matData);
+
+    //=========================================================================================================
+    /**
+     * Returns the block size.
+     *
+     * @return The block size in samples.
+     */
+    int blockSize() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the buffering latency, not counting the group delay of the filter.
+     *
+     * @return The latency in samples.
+     */
+    int latency() const;
+
+    //=========================================================================================================
+    /**
+     * Clears the stream history, as if no data had been filtered yet.
+     */
+    void reset();
+
+private:
+    struct Workspace;
+
+    //=========================================================================================================
+    /**
+     * Filters the buffered full input block into m_matOutBlock.
+     */
+    void processBlock();
+
+    //=========================================================================================================
+    /**
+     * Runs the overlap-save step for the picked channels [iBegin, iEnd).
+     */
+    void processChannels(Workspace& workspace,
+                         int iBegin,
+                         int iEnd);
+
+    int                             m_iBlockSize;           /**< Block size B, also the partition length. */
+    int                             m_iNumPartitions;       /**< Number of filter partitions P. */
+    int                             m_iNumChannels;         /**< Number of rows of the stream. */
+    int                             m_iDelay;               /**< Delay of the unfiltered rows (order/2). */
+    int                             m_iFill;                /**< Number of samples in the current input block. */
+    int                             m_iFdlPos;              /**< Ring position of the newest spectrum in the delay line. */
+
+    Eigen::VectorXi                 m_vecPicks;             /**< Filtered rows. */
+    Eigen::VectorXi                 m_vecUnpicked;          /**< Rows which are only delayed. */
+
+    Eigen::MatrixXcd                m_matPartitions;        /**< (B+1) x P half spectra of the zero-padded filter partitions. */
+    Eigen::MatrixXcd                m_matFdl;               /**< (B+1) x (P * picks) frequency-domain delay line. */
+    Eigen::MatrixXd                 m_matPrevious;          /**< B x picks previous input block of every filtered row. */
+    Eigen::MatrixXd                 m_matDelayLine;         /**< Unpicked rows x (order/2 + B) history of the delayed rows. */
+    Eigen::MatrixXd                 m_matInBlock;           /**< Rows x B input block being filled. */
+    Eigen::MatrixXd                 m_matOutBlock;          /**< Rows x B last filtered block. */
+
+    QVector<QSharedPointer<Workspace> > m_lWorkspaces;      /**< One workspace per thread, each owning a range of picks. */
 };
 
 //=============================================================================================================
@@ -59,7 +59,10 @@ void RtInvOpWorker::doWork(const RtInvOpInput &inputData)
                                 forwardMeg,
                                 inputData.noiseCov,
                                 0.2f,
-                                0.8f);
+                                0.8f,
+                                false,
+                                true,
+                                MNEInverseOperator::SvdGram);
 
     emit resultReady(invOpMeg);
 }
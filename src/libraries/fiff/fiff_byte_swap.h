@@ -53,6 +53,17 @@ inline qint16 swap_short(qint16 source)
     return result;
 }
 
+//=============================================================================================================
+/**
+ * Swap a 16-bit short in place.
+ */
+inline void swap_shortp(qint16 *source)
+{
+    auto *csource = reinterpret_cast<unsigned char *>(source);
+    unsigned char c;
+    c = csource[1]; csource[1] = csource[0]; csource[0] = c;
+}
+
 //=============================================================================================================
 /**
  * Swap a 32-bit integer.
@@ -0,0 +1,191 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     fiff_raw_buffer_map.cpp
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Implementation of @ref FiffRawBufferMap: private file mapping with lazy in-place byte swapping of the raw data buffers.
+ *
+ * The whole file is mapped once with @c QFileDevice::MapPrivateOption so
+ * that the swap to native byte order can happen in place without touching
+ * the file on disk; only the pages of buffers that were actually read
+ * become private copies.
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_raw_buffer_map.h"
+#include "fiff_byte_swap.h"
+#include "fiff_file.h"
+#include "fiff_tag.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
+#include <QDebug>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRawBufferMap::FiffRawBufferMap(const QString& fileName,
+                                   const QList<FiffRawDir>& rawdir,
+                                   fiff_int_t nchan,
+                                   bool b_littleEndian)
+: m_file(fileName)
+, m_pData(nullptr)
+, m_iSize(0)
+, m_iNChan(nchan)
+, m_bSwap(b_littleEndian != (Q_BYTE_ORDER == Q_LITTLE_ENDIAN))
+, m_rawDir(rawdir)
+, m_pSwapOnce(new std::once_flag[rawdir.size() > 0 ? rawdir.size() : 1])
+{
+    if(!m_file.open(QIODevice::ReadOnly)) {
+        qWarning("[FiffRawBufferMap::FiffRawBufferMap] Cannot open %s", fileName.toUtf8().constData());
+        return;
+    }
+
+    m_iSize = m_file.size();
+    m_pData = m_file.map(0, m_iSize, QFileDevice::MapPrivateOption);
+
+    if(!m_pData) {
+        qWarning("[FiffRawBufferMap::FiffRawBufferMap] Cannot map %s: %s",
+                 fileName.toUtf8().constData(),
+                 m_file.errorString().toUtf8().constData());
+        m_iSize = 0;
+    }
+
+    // The mapping stays valid after the file handle is closed
+    m_file.close();
+}
+
+//=============================================================================================================
+
+FiffRawBufferMap::~FiffRawBufferMap()
+{
+    if(m_pData) {
+        m_file.unmap(m_pData);
+    }
+}
+
+//=============================================================================================================
+
+bool FiffRawBufferMap::isValid() const
+{
+    return m_pData != nullptr;
+}
+
+//=============================================================================================================
+
+qint32 FiffRawBufferMap::size() const
+{
+    return m_rawDir.size();
+}
+
+//=============================================================================================================
+
+bool FiffRawBufferMap::buffer(qint32 k, FiffRawBuffer& buffer) const
+{
+    if(!m_pData || k < 0 || k >= m_rawDir.size()) {
+        return false;
+    }
+
+    const FiffRawDir& dir = m_rawDir[k];
+
+    // Skips have no data buffer behind them
+    if(!dir.ent || dir.ent->kind == -1) {
+        return false;
+    }
+
+    const qint64 payloadPos = static_cast<qint64>(dir.ent->pos) + FiffTag::storageSize();
+
+    if(dir.ent->pos < 0 || dir.ent->size < 0 || payloadPos + dir.ent->size > m_iSize) {
+        qWarning("[FiffRawBufferMap::buffer] Buffer %d lies outside of the mapped file.", k);
+        return false;
+    }
+
+    // The tag has to hold nchan x nsamp samples, otherwise swapping and reading would run into the next tag
+    qint64 iSampleSize = 0;
+    switch(dir.ent->type) {
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT:
+            iSampleSize = sizeof(qint16);
+            break;
+        case FIFFT_INT:
+            iSampleSize = sizeof(qint32);
+            break;
+        case FIFFT_FLOAT:
+            iSampleSize = sizeof(float);
+            break;
+        default:
+            qWarning("[FiffRawBufferMap::buffer] Buffer %d has unsupported data type %d.", k, dir.ent->type);
+            return false;
+    }
+
+    if(m_iNChan <= 0 || dir.nsamp <= 0
+       || static_cast<qint64>(dir.ent->size) < static_cast<qint64>(m_iNChan) * dir.nsamp * iSampleSize) {
+        qWarning("[FiffRawBufferMap::buffer] Buffer %d holds %d bytes, fewer than %d channels x %d samples.",
+                 k, dir.ent->size, m_iNChan, dir.nsamp);
+        return false;
+    }
+
+    buffer.type = dir.ent->type;
+    buffer.nchan = m_iNChan;
+    buffer.nsamp = dir.nsamp;
+    buffer.data = reinterpret_cast<const char*>(m_pData + payloadPos);
+
+    if(m_bSwap) {
+        std::call_once(m_pSwapOnce[k], &FiffRawBufferMap::swapPayload, buffer);
+    }
+
+    return true;
+}
+
+//=============================================================================================================
+
+void FiffRawBufferMap::swapPayload(const FiffRawBuffer& buffer)
+{
+    const qint64 nel = static_cast<qint64>(buffer.nchan) * buffer.nsamp;
+    char* data = const_cast<char*>(buffer.data);
+
+    switch(buffer.type) {
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT: {
+            qint16* p = reinterpret_cast<qint16*>(data);
+            for(qint64 i = 0; i < nel; ++i) {
+                swap_shortp(p + i);
+            }
+            break;
+        }
+        case FIFFT_INT: {
+            qint32* p = reinterpret_cast<qint32*>(data);
+            for(qint64 i = 0; i < nel; ++i) {
+                swap_intp(p + i);
+            }
+            break;
+        }
+        case FIFFT_FLOAT: {
+            float* p = reinterpret_cast<float*>(data);
+            for(qint64 i = 0; i < nel; ++i) {
+                swap_floatp(p + i);
+            }
+            break;
+        }
+        default:
+            qWarning("[FiffRawBufferMap::swapPayload] Cannot handle data buffers of type %d", buffer.type);
+            break;
+    }
+}
@@ -0,0 +1,195 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     fiff_raw_buffer_map.h
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Memory-mapped, zero-copy access to the FIFF_DATA_BUFFER payloads of a continuous raw recording.
+ *
+ * @ref FiffRawBufferMap maps a raw FIFF file once and hands out
+ * @ref FiffRawBuffer views that point straight at the on-disk
+ * @c FIFFT_DAU_PACK16 / @c FIFFT_SHORT / @c FIFFT_INT / @c FIFFT_FLOAT
+ * payload of each @ref FiffRawDir entry. The mapping is private
+ * (copy-on-write), so the big-endian payload of a buffer is byte-swapped
+ * in place the first time it is requested and served as-is afterwards.
+ * This replaces the @c read_tag → @c QByteArray → swap → @c Eigen::Map
+ * chain that @ref FiffRawData::read_raw_segment otherwise runs per buffer.
+ */
+
+#ifndef FIFF_RAW_BUFFER_MAP_H
+#define FIFF_RAW_BUFFER_MAP_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_types.h"
+#include "fiff_raw_dir.h"
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QFile>
+#include <QList>
+#include <QSharedPointer>
+#include <QString>
+
+#include <memory>
+#include <mutex>
+
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+//=============================================================================================================
+/**
+ * @brief Native-endian view onto the payload of one @c FIFF_DATA_BUFFER (channels × samples, column-major).
+ *
+ * The view does not own its data: it points either into a
+ * @ref FiffRawBufferMap or into the payload of a @ref FiffTag and is valid
+ * for as long as that owner is.
+ */
+struct FIFFSHARED_EXPORT FiffRawBuffer
+{
+    fiff_int_t  type = -1;          /**< FIFF data type of the payload (FIFFT_DAU_PACK16, FIFFT_SHORT, FIFFT_INT or FIFFT_FLOAT). */
+    fiff_int_t  nchan = 0;          /**< Number of channels (rows). */
+    fiff_int_t  nsamp = 0;          /**< Number of samples (columns). */
+    const char* data = nullptr;     /**< Native-endian payload. */
+
+    //=========================================================================================================
+    /**
+     * Returns the payload as 16-bit packed DAU matrix. Only valid if type is FIFFT_DAU_PACK16.
+     */
+    inline Eigen::Map<const MatrixDau16> toDauPack16() const
+    {
+        return Eigen::Map<const MatrixDau16>(reinterpret_cast<const qint16*>(data), nchan, nsamp);
+    }
+
+    //=========================================================================================================
+    /**
+     * Returns the payload as short matrix. Only valid if type is FIFFT_SHORT.
+     */
+    inline Eigen::Map<const MatrixShort> toShort() const
+    {
+        return Eigen::Map<const MatrixShort>(reinterpret_cast<const short*>(data), nchan, nsamp);
+    }
+
+    //=========================================================================================================
+    /**
+     * Returns the payload as integer matrix. Only valid if type is FIFFT_INT.
+     */
+    inline Eigen::Map<const Eigen::MatrixXi> toInt() const
+    {
+        return Eigen::Map<const Eigen::MatrixXi>(reinterpret_cast<const int*>(data), nchan, nsamp);
+    }
+
+    //=========================================================================================================
+    /**
+     * Returns the payload as float matrix. Only valid if type is FIFFT_FLOAT.
+     */
+    inline Eigen::Map<const Eigen::MatrixXf> toFloat() const
+    {
+        return Eigen::Map<const Eigen::MatrixXf>(reinterpret_cast<const float*>(data), nchan, nsamp);
+    }
+};
+
+//=============================================================================================================
+/**
+ * @brief Private (copy-on-write) memory map of a raw FIFF file with lazily byte-swapped data buffers.
+ *
+ * Built from the @ref FiffRawDir directory of a @ref FiffRawData. Each
+ * buffer is swapped to native byte order exactly once, guarded by a
+ * per-buffer @c std::once_flag, so concurrent readers may request
+ * buffers from the same map.
+ */
+class FIFFSHARED_EXPORT FiffRawBufferMap
+{
+public:
+    using SPtr = QSharedPointer<FiffRawBufferMap>;            /**< Shared pointer type for FiffRawBufferMap. */
+    using ConstSPtr = QSharedPointer<const FiffRawBufferMap>; /**< Const shared pointer type for FiffRawBufferMap. */
+
+    //=========================================================================================================
+    /**
+     * Opens and maps the given raw FIFF file.
+     *
+     * @param[in] fileName         Path to the raw FIFF file.
+     * @param[in] rawdir           Raw data directory as built by FiffStream::setup_read_raw.
+     * @param[in] nchan            Number of channels per buffer.
+     * @param[in] b_littleEndian   If true, the file is stored little-endian instead of the FIFF default big-endian.
+     */
+    FiffRawBufferMap(const QString& fileName,
+                     const QList<FiffRawDir>& rawdir,
+                     fiff_int_t nchan,
+                     bool b_littleEndian = false);
+
+    //=========================================================================================================
+    /**
+     * Unmaps and closes the file.
+     */
+    ~FiffRawBufferMap();
+
+    FiffRawBufferMap(const FiffRawBufferMap&) = delete;
+    FiffRawBufferMap& operator=(const FiffRawBufferMap&) = delete;
+
+    //=========================================================================================================
+    /**
+     * True if the file could be opened and mapped.
+     *
+     * @return true if the map is usable.
+     */
+    bool isValid() const;
+
+    //=========================================================================================================
+    /**
+     * Number of raw directory entries covered by this map.
+     *
+     * @return Number of buffers.
+     */
+    qint32 size() const;
+
+    //=========================================================================================================
+    /**
+     * Returns a native-endian view onto the payload of raw directory entry k. The payload is byte-swapped in
+     * place on first access.
+     *
+     * @param[in] k        Index into the raw directory.
+     * @param[out] buffer  View onto the mapped payload.
+     *
+     * @return true if entry k is a data buffer inside the mapped file, false for skips or on error.
+     */
+    bool buffer(qint32 k, FiffRawBuffer& buffer) const;
+
+private:
+    //=========================================================================================================
+    /**
+     * Swaps the payload of a buffer from file to native byte order.
+     *
+     * @param[in] buffer   Buffer whose payload is swapped in place.
+     */
+    static void swapPayload(const FiffRawBuffer& buffer);
+
+    QFile                               m_file;         /**< The mapped file. */
+    uchar*                              m_pData;        /**< Start of the mapping. */
+    qint64                              m_iSize;        /**< Size of the mapping in bytes. */
+    fiff_int_t                          m_iNChan;       /**< Number of channels per buffer. */
+    bool                                m_bSwap;        /**< Whether payloads need swapping to native byte order. */
+    QList<FiffRawDir>                   m_rawDir;       /**< Raw directory entries. */
+    std::unique_ptr<std::once_flag[]>   m_pSwapOnce;    /**< One flag per buffer guarding the in-place swap. */
+};
+} // NAMESPACE
+
+#endif // FIFF_RAW_BUFFER_MAP_H
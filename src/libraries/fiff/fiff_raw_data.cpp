@@ -29,7 +29,20 @@
 #include "fiff_stream.h"
 #include "cstdlib"
 
+#include <functional>
 #include <stdexcept>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+#include <QFile>
+#include <QMutexLocker>
+#include <QThread>
+#include <QVector>
+#include <QtConcurrent>
+
 //=============================================================================================================
 // USED NAMESPACES
 //=============================================================================================================
@@ -37,6 +50,112 @@
 using namespace FIFFLIB;
 using namespace Eigen;
 
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+constexpr qint32 MAX_READ_OPERATORS = 4;   /**< Number of read operators kept per FiffRawData (eg. with and without picks). */
+
+//=============================================================================================================
+/**
+ * The part of one raw directory entry that goes into the segment: samples [first_pick, first_pick + picksamp)
+ * of buffer k are written to the columns [dest, dest + picksamp) of the output.
+ */
+struct RawBufferJob
+{
+    qint32      k;
+    fiff_int_t  first_pick;
+    fiff_int_t  picksamp;
+    qint32      dest;
+};
+
+//=============================================================================================================
+/**
+ * A contiguous range [begin, end) of jobs handled by one reader thread.
+ */
+struct RawBufferChunk
+{
+    int     begin;
+    int     end;
+    bool    ok;
+};
+
+//=============================================================================================================
+/**
+ * Fetches the data buffer of raw directory entry k, either from the memory map of raw or by reading its tag
+ * from fid. The returned view points into the map or into tag and stays valid as long as those do.
+ */
+bool read_raw_buffer(const FiffRawData& raw,
+                     FiffStream* fid,
+                     qint32 k,
+                     FiffTag::UPtr& tag,
+                     FiffRawBuffer& buffer)
+{
+    if(raw.bufferMap) {
+        return raw.bufferMap->buffer(k, buffer);
+    }
+
+    if(!fid->read_tag(tag, raw.rawdir[k].ent->pos)) {
+        return false;
+    }
+
+    buffer.type = tag->type;
+    buffer.nchan = raw.info.nchan;
+    buffer.nsamp = raw.rawdir[k].nsamp;
+    buffer.data = tag->data();
+
+    return true;
+}
+
+//=============================================================================================================
+/**
+ * Reads the buffers of jobs [begin, end) and applies the read operator into the disjoint column blocks of data.
+ * Skips are translated to zeros.
+ */
+bool decode_raw_buffers(const FiffRawData& raw,
+                        FiffStream* fid,
+                        const FiffRawReadOperator& readOperator,
+                        const QVector<RawBufferJob>& jobs,
+                        int begin,
+                        int end,
+                        MatrixXd& data,
+                        bool do_debug)
+{
+    FiffTag::UPtr t_pTag;
+    FiffRawBuffer buffer;
+
+    for(int j = begin; j < end; ++j)
+    {
+        const RawBufferJob& job = jobs[j];
+        const FiffRawDir& thisRawDir = raw.rawdir[job.k];
+
+        if (!thisRawDir.ent || thisRawDir.ent->kind == -1)
+        {
+            //
+            //  Take the easy route: skip is translated to zeros
+            //
+            if(do_debug)
+                qDebug("S");
+            data.block(0, job.dest, data.rows(), job.picksamp).setZero();
+            continue;
+        }
+
+        if(!read_raw_buffer(raw, fid, job.k, t_pTag, buffer)) {
+            qWarning("Could not read raw data buffer %d", job.k);
+            return false;
+        }
+
+        if(!readOperator.apply(buffer, job.first_pick, job.picksamp, data.block(0, job.dest, data.rows(), job.picksamp)))
+            return false;
+    }
+
+    return true;
+}
+
+} // anonymous namespace
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -84,6 +203,9 @@ FiffRawData::FiffRawData(const FiffRawData &p_FiffRawData)
 , rawdir(p_FiffRawData.rawdir)
 , proj(p_FiffRawData.proj)
 , comp(p_FiffRawData.comp)
+, bufferMap(p_FiffRawData.bufferMap)
+, m_lReadOperators(p_FiffRawData.m_lReadOperators)
+, m_iReadThreads(p_FiffRawData.m_iReadThreads)
 {
 }
 
@@ -104,11 +226,38 @@ void FiffRawData::clear()
     rawdir.clear();
     proj = MatrixXd();
     comp.clear();
+    bufferMap.clear();
+
+    QMutexLocker locker(m_pReadOperatorMutex.data());
+    m_lReadOperators.clear();
 }
 
 //=============================================================================================================
-#include <QElapsedTimer>
-#include <QDebug>
+
+FiffRawReadOperator::ConstSPtr FiffRawData::read_operator(const RowVectorXi& sel) const
+{
+    QMutexLocker locker(m_pReadOperatorMutex.data());
+
+    for(qint32 i = 0; i < m_lReadOperators.size(); ++i) {
+        if(m_lReadOperators[i]->matches(this->cals, this->proj, this->comp, sel)) {
+            // Keep the most recently used operator in front
+            if(i > 0)
+                m_lReadOperators.move(i, 0);
+            return m_lReadOperators.first();
+        }
+    }
+
+    FiffRawReadOperator::ConstSPtr pOperator(new FiffRawReadOperator(this->cals, this->proj, this->comp, sel));
+
+    m_lReadOperators.prepend(pOperator);
+    while(m_lReadOperators.size() > MAX_READ_OPERATORS)
+        m_lReadOperators.removeLast();
+
+    return pOperator;
+}
+
+//=============================================================================================================
+
 bool FiffRawData::read_raw_segment(MatrixXd& data,
                                    MatrixXd& times,
                                    fiff_int_t from,
@@ -116,13 +265,38 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
                                    const RowVectorXi& sel,
                                    bool do_debug) const
 {
-    bool projAvailable = true;
+    FiffRawReadOperator::ConstSPtr pOperator;
+    return read_segment(data, times, pOperator, from, to, sel, do_debug);
+}
 
-    if (this->proj.size() == 0) {
-        //qDebug() << "FiffRawData::read_raw_segment - No projectors setup. Consider calling MNE::setup_compensators.";
-        projAvailable = false;
-    }
+//=============================================================================================================
+
+bool FiffRawData::read_raw_segment(MatrixXd& data,
+                                   MatrixXd& times,
+                                   SparseMatrix<double>& multSegment,
+                                   fiff_int_t from,
+                                   fiff_int_t to,
+                                   const RowVectorXi& sel,
+                                   bool do_debug) const
+{
+    FiffRawReadOperator::ConstSPtr pOperator;
+    if(!read_segment(data, times, pOperator, from, to, sel, do_debug))
+        return false;
 
+    multSegment = pOperator->multSegment();
+    return true;
+}
+
+//=============================================================================================================
+
+bool FiffRawData::read_segment(MatrixXd& data,
+                               MatrixXd& times,
+                               FiffRawReadOperator::ConstSPtr& pOperator,
+                               fiff_int_t from,
+                               fiff_int_t to,
+                               const RowVectorXi& sel,
+                               bool do_debug) const
+{
     if(from == -1)
         from = this->first_samp;
     if(to == -1)
@@ -142,213 +316,26 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
     }
     //printf("Reading %d ... %d  =  %9.3f ... %9.3f secs...", from, to, (static_cast<float>(from))/this->info.sfreq, (static_cast<float>(to))/this->info.sfreq);
     //
-    //  Initialize the data and calibration vector
+    //  Get the calibration, compensation and projection operator; it is only rebuilt if proj, comp or sel changed
     //
-    qint32 nchan = this->info.nchan;
-    qint32 dest  = 0;//1;
-    qint32 i, k, r;
-
-    using T = Eigen::Triplet<double>;
-    std::vector<T> tripletList;
-    tripletList.reserve(nchan);
-    for(i = 0; i < nchan; ++i)
-        tripletList.push_back(T(i, i, this->cals[i]));
-
-    SparseMatrix<double> cal(nchan, nchan);
-    cal.setFromTriplets(tripletList.begin(), tripletList.end());
-//    cal.makeCompressed();
-
-    MatrixXd mult_full;
-    //
-    if (sel.size() == 0)
-    {
-        data = MatrixXd(nchan, to-from+1);
-//            data->setZero();
-        if (projAvailable || this->comp.kind != -1)
-        {
-            if (!projAvailable)
-                mult_full = this->comp.data->data*cal;
-            else if (this->comp.kind == -1)
-                mult_full = this->proj*cal;
-            else
-                mult_full = this->proj*this->comp.data->data*cal;
-        }
-    }
-    else
-    {
-        data = MatrixXd(sel.size(),to-from+1);
-//            data->setZero();
-
-        MatrixXd selVect(sel.size(), nchan);
-
-        selVect.setZero();
-
-        if (!projAvailable && this->comp.kind == -1)
-        {
-            tripletList.clear();
-            tripletList.reserve(sel.size());
-            for(i = 0; i < sel.size(); ++i)
-                tripletList.push_back(T(i, i, this->cals[sel[i]]));
-            cal = SparseMatrix<double>(sel.size(), sel.size());
-            cal.setFromTriplets(tripletList.begin(), tripletList.end());
-        }
-        else
-        {
-            if (!projAvailable)
-            {
-                qDebug() << "This has to be debugged! #1";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->comp.data->data.block(sel[i],0,1,nchan);
-                mult_full = selVect*cal;
-            }
-            else if (this->comp.kind == -1)
-            {
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
+    pOperator = read_operator(sel);
 
-                mult_full = selVect*cal;
-            }
-            else
-            {
-                qDebug() << "This has to be debugged! #3";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
-
-                mult_full = selVect*this->comp.data->data*cal;
-            }
-        }
-    }
+    data.resize(pOperator->rows(), to-from+1);
 
     //
-    // Make mult sparse
+    //  Work out which part of which buffer goes to which columns of data
     //
-    tripletList.clear();
-    tripletList.reserve(mult_full.rows()*mult_full.cols());
-    for(i = 0; i < mult_full.rows(); ++i)
-        for(k = 0; k < mult_full.cols(); ++k)
-            if(mult_full(i,k) != 0)
-                tripletList.push_back(T(i, k, mult_full(i,k)));
-
-    SparseMatrix<double> mult(mult_full.rows(),mult_full.cols());
-    if(tripletList.size() > 0)
-        mult.setFromTriplets(tripletList.begin(), tripletList.end());
-//    mult.makeCompressed();
-
-    FiffStream::SPtr fid;
-    if (!this->file->device()->isOpen())
-    {
-        if (!this->file->device()->open(QIODevice::ReadOnly))
-        {
-            qWarning("Cannot open file %s",this->info.filename.toUtf8().constData());
-        }
-        fid = this->file;
-    }
-    else
-    {
-        fid = this->file;
-    }
-
-    MatrixXd one, newData, tmp_data;
-    FiffRawDir thisRawDir;
-    FiffTag::UPtr t_pTag;
+    QVector<RawBufferJob> jobs;
+    qint32 dest = 0;
     fiff_int_t first_pick, last_pick, picksamp;
-    for(k = 0; k < this->rawdir.size(); ++k)
+    for(qint32 k = 0; k < this->rawdir.size(); ++k)
     {
-        thisRawDir = this->rawdir[k];
+        const FiffRawDir& thisRawDir = this->rawdir[k];
         //
         //  Do we need this buffer
         //
         if (thisRawDir.last > from)
         {
-            if (thisRawDir.ent->kind == -1)
-            {
-                //
-                //  Take the easy route: skip is translated to zeros
-                //
-                if(do_debug)
-                    qDebug("S");
-                if (sel.cols() <= 0)
-                    one.resize(nchan,thisRawDir.nsamp);
-                else
-                    one.resize(sel.cols(),thisRawDir.nsamp);
-
-                one.setZero();
-            }
-            else
-            {
-                fid->read_tag(t_pTag, thisRawDir.ent->pos);
-                //
-                //   Depending on the state of the projection and selection
-                //   we proceed a little bit differently
-                //
-                if (mult.cols() == 0)
-                {
-                    if (sel.cols() == 0)
-                    {
-                        if (t_pTag->type == FIFFT_DAU_PACK16)
-                            one = cal*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_INT)
-                            one = cal*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_FLOAT)
-                            one = cal*(Map<const MatrixXf>(t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_SHORT)
-                            one = cal*(Map< MatrixShort >( t_pTag->toShort(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else
-                            qWarning("Data Storage Format not known yet [1]!! Type: %d\n", t_pTag->type);
-                    }
-                    else
-                    {
-                        //ToDo find a faster solution for this!! --> make cal and mul sparse like in MATLAB
-                        newData.resize(sel.cols(), thisRawDir.nsamp); //ToDo this can be done much faster, without newData
-
-                        if (t_pTag->type == FIFFT_DAU_PACK16)
-                        {
-                            tmp_data = (Map< MatrixDau16 > ( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_INT)
-                        {
-                            tmp_data = (Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_FLOAT)
-                        {
-                            tmp_data = (Map<const MatrixXf>(t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_SHORT)
-                        {
-                            tmp_data = (Map< MatrixShort > ( t_pTag->toShort(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else
-                        {
-                            qWarning("Data Storage Format not known yet [2]!! Type: %d\n", t_pTag->type);
-                        }
-
-                        one = cal*newData;
-                    }
-                }
-                else
-                {
-                    if (t_pTag->type == FIFFT_DAU_PACK16)
-                        one = mult*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else if(t_pTag->type == FIFFT_INT)
-                        one = mult*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else if(t_pTag->type == FIFFT_FLOAT)
-                        one = mult*(Map<const MatrixXf>(t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else
-                        qWarning("Data Storage Format not known yet [3]!! Type: %d\n", t_pTag->type);
-                }
-            }
             //
             //  The picking logic is a bit complicated
             //
@@ -357,21 +344,20 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
                 //
                 //  We need the whole buffer
                 //
-                first_pick = 0;//1;
+                first_pick = 0;
                 last_pick  = thisRawDir.nsamp - 1;
                 if (do_debug)
                     qDebug("W");
             }
             else if (from > thisRawDir.first)
             {
-                first_pick = from - thisRawDir.first;// + 1;
+                first_pick = from - thisRawDir.first;
                 if(to < thisRawDir.last)
                 {
                     //
                     //  Something from the middle
                     //
-//                    qDebug() << "This needs to be debugged!";
-                    last_pick = thisRawDir.nsamp + to - thisRawDir.last - 1;//is this alright?
+                    last_pick = thisRawDir.nsamp + to - thisRawDir.last - 1;
                     if (do_debug)
                         qDebug("M");
                 }
@@ -390,8 +376,8 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
                 //
                 //  From the beginning to the middle
                 //
-                first_pick = 0;//1;
-                last_pick  = to - thisRawDir.first;// + 1;
+                first_pick = 0;
+                last_pick  = to - thisRawDir.first;
                 if (do_debug)
                     qDebug("B");
             }
@@ -409,11 +395,7 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
 
             if (picksamp > 0)
             {
-//                    for(r = 0; r < data->rows(); ++r)
-//                        for(c = 0; c < picksamp; ++c)
-//                            (*data)(r,dest + c) = one(r,first_pick + c);
-                data.block(0,dest,data.rows(),picksamp) = one.block(0, first_pick, data.rows(), picksamp);
-
+                jobs.append(RawBufferJob{k, first_pick, picksamp, dest});
                 dest += picksamp;
             }
         }
@@ -422,358 +404,70 @@ bool FiffRawData::read_raw_segment(MatrixXd& data,
         //
         if (thisRawDir.last >= to)
         {
-            //printf(" [done]\n");
             break;
         }
     }
 
-    if (!this->file->device()->isOpen()) {
-        this->file->device()->close();
-    }
-
-    times = MatrixXd(1, to-from+1);
-
-    for (i = 0; i < times.cols(); ++i)
-        times(0, i) = static_cast<float>(from+i) / this->info.sfreq;
-
-    return true;
-}
-
-//=============================================================================================================
-
-bool FiffRawData::read_raw_segment(MatrixXd& data,
-                                   MatrixXd& times,
-                                   SparseMatrix<double>& multSegment,
-                                   fiff_int_t from,
-                                   fiff_int_t to,
-                                   const RowVectorXi& sel,
-                                   bool do_debug) const
-{
-    bool projAvailable = true;
-
-    if (this->proj.size() == 0) {
-        //qInfo() << "FiffRawData::read_raw_segment - No projectors setup. Consider calling MNE::setup_compensators.";
-        projAvailable = false;
-    }
-
-    if(from == -1)
-        from = this->first_samp;
-    if(to == -1)
-        to = this->last_samp;
     //
-    //  Initial checks
+    //  Decode, calibrate and project the buffers
     //
-    if(from < this->first_samp)
-        from = this->first_samp;
-    if(to > this->last_samp)
-        to = this->last_samp;
-    //
-    if(from > to)
-    {
-        qWarning("No data in this range\n");
-        return false;
-    }
-    //printf("Reading %d ... %d  =  %9.3f ... %9.3f secs...", from, to, (static_cast<float>(from))/this->info.sfreq, (static_cast<float>(to))/this->info.sfreq);
-    //
-    //  Initialize the data and calibration vector
-    //
-    qint32 nchan = this->info.nchan;
-    qint32 dest  = 0;//1;
-    qint32 i, k, r;
-
-    using T = Eigen::Triplet<double>;
-    std::vector<T> tripletList;
-    tripletList.reserve(nchan);
-    for(i = 0; i < nchan; ++i)
-        tripletList.push_back(T(i, i, this->cals[i]));
+    const int nThreads = qMin(m_iReadThreads, static_cast<int>(jobs.size()));
+    QFile* pFile = qobject_cast<QFile*>(this->file->device());
 
-    SparseMatrix<double> cal(nchan, nchan);
-    cal.setFromTriplets(tripletList.begin(), tripletList.end());
-//    cal.makeCompressed();
-
-    MatrixXd mult_full;
-    //
-    if (sel.size() == 0)
-    {
-        data = MatrixXd(nchan, to-from+1);
-//            data->setZero();
-        if (projAvailable || this->comp.kind != -1)
-        {
-            if (!projAvailable)
-                mult_full = this->comp.data->data*cal;
-            else if (this->comp.kind == -1)
-                mult_full = this->proj*cal;
-            else
-                mult_full = this->proj*this->comp.data->data*cal;
-        }
-    }
-    else
+    if (nThreads > 1 && (this->bufferMap || pFile))
     {
-        data = MatrixXd(sel.size(),to-from+1);
-//            data->setZero();
-
-        MatrixXd selVect(sel.size(), nchan);
-
-        selVect.setZero();
-
-        if (!projAvailable && this->comp.kind == -1)
-        {
-            tripletList.clear();
-            tripletList.reserve(sel.size());
-            for(i = 0; i < sel.size(); ++i)
-                tripletList.push_back(T(i, i, this->cals[sel[i]]));
-            cal = SparseMatrix<double>(sel.size(), sel.size());
-            cal.setFromTriplets(tripletList.begin(), tripletList.end());
+        //
+        //  Split the jobs into contiguous chunks, one per worker. Without a memory map every worker reads
+        //  through its own file handle, so the workers never share a file position.
+        //
+        QVector<RawBufferChunk> chunks;
+        for (int c = 0; c < nThreads; ++c) {
+            chunks.append(RawBufferChunk{static_cast<int>(c * jobs.size() / nThreads),
+                                         static_cast<int>((c + 1) * jobs.size() / nThreads),
+                                         false});
         }
-        else
-        {
-            if (!projAvailable)
-            {
-                qDebug() << "This has to be debugged! #1";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->comp.data->data.block(sel[i],0,1,nchan);
-                mult_full = selVect*cal;
-            }
-            else if (this->comp.kind == -1)
-            {
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
 
-                mult_full = selVect*cal;
+        const QDataStream::ByteOrder byteOrder = this->file->byteOrder();
+        std::function<void(RawBufferChunk&)> readChunk = [&](RawBufferChunk& chunk) {
+            if (this->bufferMap) {
+                chunk.ok = decode_raw_buffers(*this, nullptr, *pOperator, jobs, chunk.begin, chunk.end, data, do_debug);
+                return;
             }
-            else
-            {
-                qDebug() << "This has to be debugged! #3";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
 
-                mult_full = selVect*this->comp.data->data*cal;
+            QFile workerFile(pFile->fileName());
+            if (!workerFile.open(QIODevice::ReadOnly)) {
+                qWarning("Cannot open file %s",this->info.filename.toUtf8().constData());
+                return;
             }
-        }
-    }
+            FiffStream workerStream(&workerFile);
+            workerStream.setByteOrder(byteOrder);
+            chunk.ok = decode_raw_buffers(*this, &workerStream, *pOperator, jobs, chunk.begin, chunk.end, data, do_debug);
+        };
 
-    //
-    // Make mult sparse
-    //
-    tripletList.clear();
-    tripletList.reserve(mult_full.rows()*mult_full.cols());
-    for(i = 0; i < mult_full.rows(); ++i)
-        for(k = 0; k < mult_full.cols(); ++k)
-            if(mult_full(i,k) != 0)
-                tripletList.push_back(T(i, k, mult_full(i,k)));
-
-    SparseMatrix<double> mult(mult_full.rows(),mult_full.cols());
-    if(tripletList.size() > 0)
-        mult.setFromTriplets(tripletList.begin(), tripletList.end());
-//    mult.makeCompressed();
-
-    //
+        QtConcurrent::blockingMap(chunks, readChunk);
 
-    FiffStream::SPtr fid;
-    if (!this->file->device()->isOpen())
-    {
-        if (!this->file->device()->open(QIODevice::ReadOnly))
-        {
-            qWarning("Cannot open file %s",this->info.filename.toUtf8().constData());
+        for (const RawBufferChunk& chunk : chunks) {
+            if (!chunk.ok)
+                return false;
         }
-        fid = this->file;
     }
     else
     {
-        fid = this->file;
-    }
-
-    MatrixXd one;
-    fiff_int_t first_pick, last_pick, picksamp;
-    for(k = 0; k < this->rawdir.size(); ++k)
-    {
-        FiffRawDir thisRawDir = this->rawdir[k];
-        //
-        //  Do we need this buffer
-        //
-        if (thisRawDir.last > from)
+        if (!this->bufferMap && !this->file->device()->isOpen())
         {
-            if (thisRawDir.ent->kind == -1)
-            {
-                //
-                //  Take the easy route: skip is translated to zeros
-                //
-                if(do_debug)
-                    qDebug("S");
-                if (sel.cols() <= 0)
-                    one.resize(nchan,thisRawDir.nsamp);
-                else
-                    one.resize(sel.cols(),thisRawDir.nsamp);
-
-                one.setZero();
-            }
-            else
-            {
-                FiffTag::UPtr t_pTag;
-                fid->read_tag(t_pTag, thisRawDir.ent->pos);
-                //
-                //   Depending on the state of the projection and selection
-                //   we proceed a little bit differently
-                //
-                if (mult.cols() == 0)
-                {
-                    if (sel.cols() == 0)
-                    {
-                        if (t_pTag->type == FIFFT_DAU_PACK16)
-                            one = cal*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_INT)
-                            one = cal*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_FLOAT)
-                            one = cal*(Map<const MatrixXf>(t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_SHORT)
-                            one = cal*(Map< MatrixShort >( t_pTag->toShort(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else
-                            qWarning("Data Storage Format not known yet [1]!! Type: %d\n", t_pTag->type);
-                    }
-                    else
-                    {
-
-                        //ToDo find a faster solution for this!! --> make cal and mul sparse like in MATLAB
-                        MatrixXd newData(sel.cols(), thisRawDir.nsamp); //ToDo this can be done much faster, without newData
-
-                        if (t_pTag->type == FIFFT_DAU_PACK16)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixDau16 > ( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_INT)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_FLOAT)
-                        {
-                            MatrixXd tmp_data = (Map<const MatrixXf>(t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_SHORT)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixShort > ( t_pTag->toShort(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else
-                        {
-                            qWarning("Data Storage Format not known yet [2]!! Type: %d\n", t_pTag->type);
-                        }
-
-                        one = cal*newData;
-                    }
-                }
-                else
-                {
-                    if (t_pTag->type == FIFFT_DAU_PACK16)
-                        one = mult*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else if(t_pTag->type == FIFFT_INT)
-                        one = mult*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else if(t_pTag->type == FIFFT_FLOAT)
-                        one = mult*(Map<const MatrixXf>(t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else
-                        qWarning("Data Storage Format not known yet [3]!! Type: %d\n", t_pTag->type);
-                }
-            }
-            //
-            //  The picking logic is a bit complicated
-            //
-            if (to >= thisRawDir.last && from <= thisRawDir.first)
-            {
-                //
-                //  We need the whole buffer
-                //
-                first_pick = 0;//1;
-                last_pick  = thisRawDir.nsamp - 1;
-                if (do_debug)
-                    qDebug("W");
-            }
-            else if (from > thisRawDir.first)
-            {
-                first_pick = from - thisRawDir.first;// + 1;
-                if(to < thisRawDir.last)
-                {
-                    //
-                    //  Something from the middle
-                    //
-//                    qDebug() << "This needs to be debugged!";
-                    last_pick = thisRawDir.nsamp + to - thisRawDir.last - 1;//is this alright?
-                    if (do_debug)
-                        qDebug("M");
-                }
-                else
-                {
-                    //
-                    //  From the middle to the end
-                    //
-                    last_pick = thisRawDir.nsamp - 1;
-                    if (do_debug)
-                        qDebug("E");
-                }
-            }
-            else
-            {
-                //
-                //  From the beginning to the middle
-                //
-                first_pick = 0;//1;
-                last_pick  = to - thisRawDir.first;// + 1;
-                if (do_debug)
-                    qDebug("B");
-            }
-            //
-            //  Now we are ready to pick
-            //
-            picksamp = last_pick - first_pick + 1;
-
-            if(do_debug)
+            if (!this->file->device()->open(QIODevice::ReadOnly))
             {
-                qDebug() << "first_pick: " << first_pick;
-                qDebug() << "last_pick: " << last_pick;
-                qDebug() << "picksamp: " << picksamp;
-            }
-
-            if (picksamp > 0)
-            {
-//                    for(r = 0; r < data->rows(); ++r)
-//                        for(c = 0; c < picksamp; ++c)
-//                            (*data)(r,dest + c) = one(r,first_pick + c);
-                data.block(0,dest,data.rows(),picksamp) = one.block(0, first_pick, data.rows(), picksamp);
-
-                dest += picksamp;
+                qWarning("Cannot open file %s",this->info.filename.toUtf8().constData());
             }
         }
-        //
-        //  Done?
-        //
-        if (thisRawDir.last >= to)
-        {
-            //printf(" [done]\n");
-            break;
-        }
-    }
 
-    if(mult.cols()==0)
-        multSegment = cal;
-    else
-        multSegment = mult;
-
-    if (!this->file->device()->isOpen()) {
-        this->file->device()->close();
+        if (!decode_raw_buffers(*this, this->file.data(), *pOperator, jobs, 0, jobs.size(), data, do_debug))
+            return false;
     }
 
     times = MatrixXd(1, to-from+1);
 
-    for (i = 0; i < times.cols(); ++i)
+    for (qint32 i = 0; i < times.cols(); ++i)
         times(0, i) = static_cast<float>(from+i) / this->info.sfreq;
 
     return true;
@@ -800,6 +494,57 @@ bool FiffRawData::read_raw_segment_times(MatrixXd& data,
 
 //=============================================================================================================
 
+bool FiffRawData::map_file()
+{
+    if(this->bufferMap)
+        return true;
+
+    if(!this->file || !qobject_cast<QFile*>(this->file->device())) {
+        qWarning("[FiffRawData::map_file] Memory mapping is only supported for raw data read from a file.");
+        return false;
+    }
+
+    FiffRawBufferMap::SPtr pMap(new FiffRawBufferMap(this->info.filename,
+                                                     this->rawdir,
+                                                     this->info.nchan,
+                                                     this->file->byteOrder() == QDataStream::LittleEndian));
+    if(!pMap->isValid())
+        return false;
+
+    this->bufferMap = pMap;
+    return true;
+}
+
+//=============================================================================================================
+
+void FiffRawData::unmap_file()
+{
+    this->bufferMap.clear();
+}
+
+//=============================================================================================================
+
+bool FiffRawData::is_mapped() const
+{
+    return !this->bufferMap.isNull();
+}
+
+//=============================================================================================================
+
+void FiffRawData::set_read_threads(int nThreads)
+{
+    m_iReadThreads = nThreads > 0 ? nThreads : QThread::idealThreadCount();
+}
+
+//=============================================================================================================
+
+int FiffRawData::read_threads() const
+{
+    return m_iReadThreads;
+}
+
+//=============================================================================================================
+
 bool FiffRawData::save(QIODevice &p_IODevice,
                         const RowVectorXi &picks,
                         int decim,
@@ -35,6 +35,8 @@
 #include "fiff_global.h"
 #include "fiff_info.h"
 #include "fiff_raw_dir.h"
+#include "fiff_raw_buffer_map.h"
+#include "fiff_raw_read_operator.h"
 #include "fiff_stream.h"
 
 //=============================================================================================================
@@ -49,6 +51,7 @@
 //=============================================================================================================
 
 #include <QList>
+#include <QMutex>
 #include <QSharedPointer>
 #include <QString>
 #include <memory>
@@ -133,6 +136,18 @@ public:
         return first_samp == -1 && info.isEmpty();
     }
 
+    //=========================================================================================================
+    /**
+     * Returns the calibration, compensation and projection operator read_raw_segment applies for the current
+     * cals, proj and comp and the given channel selection. The operator is built on first use and cached, so
+     * repeated segment reads with unchanged settings do not rebuild it.
+     *
+     * @param[in] sel        channel selection vector (optional).
+     *
+     * @return The read operator.
+     */
+    FiffRawReadOperator::ConstSPtr read_operator(const Eigen::RowVectorXi& sel = defaultRowVectorXi) const;
+
     //=========================================================================================================
     /**
      * Read a specific raw data segment
@@ -210,6 +225,49 @@ public:
               int from = -1,
               int to = -1) const;
 
+    //=========================================================================================================
+    /**
+     * Memory-maps the raw data file. While mapped, read_raw_segment decodes the data buffers straight from
+     * the mapping (byte-swapped in place on first access) instead of reading a FiffTag per buffer.
+     * Only available for raw data read from a file.
+     *
+     * @return true if the file could be mapped.
+     */
+    bool map_file();
+
+    //=========================================================================================================
+    /**
+     * Releases the memory map created by map_file. Subsequent reads go through the FiffStream again.
+     */
+    void unmap_file();
+
+    //=========================================================================================================
+    /**
+     * True if the raw data buffers are read from a memory map.
+     *
+     * @return true if map_file succeeded and unmap_file was not called since.
+     */
+    bool is_mapped() const;
+
+    //=========================================================================================================
+    /**
+     * Sets the number of threads read_raw_segment uses to decode and project the data buffers of a segment.
+     * With more than one thread the buffers are split into contiguous chunks that are read and decoded
+     * concurrently, each chunk through its own file handle (or the memory map, see map_file) and into its own
+     * column block of the output. Only available for raw data read from a file; other devices are read serially.
+     *
+     * @param[in] nThreads   Number of threads; 1 (default) reads serially, values <= 0 use all cores.
+     */
+    void set_read_threads(int nThreads);
+
+    //=========================================================================================================
+    /**
+     * Number of threads read_raw_segment uses.
+     *
+     * @return The number of read threads.
+     */
+    int read_threads() const;
+
 public:
     FiffStream::SPtr file;      /**< replaces fid. */
     FiffInfo info;              /**< Fiff measurement information. */
@@ -219,6 +277,34 @@ public:
     QList<FiffRawDir> rawdir;   /**< Special fiff directory entry for raw data. */
     Eigen::MatrixXd proj;       /**< SSP operator to apply to the data. */
     FiffCtfComp comp;           /**< Compensator. */
+    FiffRawBufferMap::SPtr bufferMap;   /**< Memory map of the data buffers, set by map_file. */
+
+private:
+    //=========================================================================================================
+    /**
+     * Reads a raw data segment through the cached read operator.
+     *
+     * @param[out] data      returns the data matrix (channels x samples).
+     * @param[out] times     returns the time values corresponding to the samples.
+     * @param[out] pOperator returns the read operator which was applied.
+     * @param[in] from       first sample to include.
+     * @param[in] to         last sample to include.
+     * @param[in] sel        channel selection vector.
+     * @param[in] do_debug   print the picking decisions.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool read_segment(Eigen::MatrixXd& data,
+                      Eigen::MatrixXd& times,
+                      FiffRawReadOperator::ConstSPtr& pOperator,
+                      fiff_int_t from,
+                      fiff_int_t to,
+                      const Eigen::RowVectorXi& sel,
+                      bool do_debug) const;
+
+    mutable QList<FiffRawReadOperator::ConstSPtr> m_lReadOperators;                 /**< Most recently used read operators, newest first. */
+    QSharedPointer<QMutex> m_pReadOperatorMutex = QSharedPointer<QMutex>::create(); /**< Guards m_lReadOperators. */
+    int m_iReadThreads = 1;                                                         /**< Number of threads used by read_raw_segment. */
 
 };
 } // NAMESPACE
@@ -0,0 +1,203 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     fiff_raw_read_operator.cpp
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Implementation of @ref FiffRawReadOperator: one-time operator assembly and the fused per-buffer kernel.
+ *
+ * The operator is assembled exactly as @ref FiffRawData::read_raw_segment
+ * always did (calibration, then compensation, then projection, restricted
+ * to the selected rows) so that cached and freshly built reads are
+ * bit-identical.
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_raw_read_operator.h"
+#include "fiff_file.h"
+
+#include <atomic>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDebug>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+std::atomic<qint64> s_iVersionCounter(0);
+
+//=============================================================================================================
+
+template<typename T>
+bool same_matrix(const T& a, const T& b)
+{
+    return a.rows() == b.rows() && a.cols() == b.cols() && a == b;
+}
+
+//=============================================================================================================
+
+template<typename T>
+void apply_typed(const SparseMatrix<double, RowMajor>& op,
+                 const T* data,
+                 Index nchan,
+                 fiff_int_t first,
+                 fiff_int_t nsamp,
+                 Ref<MatrixXd> out)
+{
+    VectorXd column(nchan);
+    for(fiff_int_t s = 0; s < nsamp; ++s) {
+        column = Map<const Matrix<T, Dynamic, 1> >(data + static_cast<Index>(first + s) * nchan, nchan).template cast<double>();
+        out.col(s).noalias() = op * column;
+    }
+}
+
+} // anonymous namespace
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRawReadOperator::FiffRawReadOperator(const RowVectorXd& cals,
+                                         const MatrixXd& proj,
+                                         const FiffCtfComp& comp,
+                                         const RowVectorXi& sel)
+: m_vecCals(cals)
+, m_matProj(proj)
+, m_iCompKind(comp.kind)
+, m_vecSel(sel)
+, m_iVersion(++s_iVersionCounter)
+{
+    const qint32 nchan = cals.size();
+    const bool projAvailable = proj.size() != 0;
+
+    if(comp.kind != -1) {
+        m_matComp = comp.data->data;
+    }
+
+    using T = Eigen::Triplet<double>;
+    std::vector<T> tripletList;
+
+    MatrixXd mult_full;
+
+    if(sel.size() == 0) {
+        if(projAvailable || comp.kind != -1) {
+            if(!projAvailable)
+                mult_full = m_matComp * cals.asDiagonal();
+            else if(comp.kind == -1)
+                mult_full = proj * cals.asDiagonal();
+            else
+                mult_full = proj * m_matComp * cals.asDiagonal();
+        }
+    } else if(projAvailable || comp.kind != -1) {
+        MatrixXd selVect(sel.size(), nchan);
+
+        if(!projAvailable) {
+            for(qint32 i = 0; i < sel.size(); ++i)
+                selVect.row(i) = m_matComp.row(sel[i]);
+            mult_full = selVect * cals.asDiagonal();
+        } else if(comp.kind == -1) {
+            for(qint32 i = 0; i < sel.size(); ++i)
+                selVect.row(i) = proj.row(sel[i]);
+            mult_full = selVect * cals.asDiagonal();
+        } else {
+            for(qint32 i = 0; i < sel.size(); ++i)
+                selVect.row(i) = proj.row(sel[i]);
+            mult_full = selVect * m_matComp * cals.asDiagonal();
+        }
+    }
+
+    if(mult_full.size() > 0) {
+        //
+        // Make mult sparse
+        //
+        m_matMultSegment = mult_full.sparseView();
+        m_matOp = m_matMultSegment;
+    } else if(sel.size() == 0) {
+        tripletList.reserve(nchan);
+        for(qint32 i = 0; i < nchan; ++i)
+            tripletList.push_back(T(i, i, cals[i]));
+
+        m_matMultSegment.resize(nchan, nchan);
+        m_matMultSegment.setFromTriplets(tripletList.begin(), tripletList.end());
+        m_matOp = m_matMultSegment;
+    } else {
+        //
+        // Calibrate and pick in one go: row i reads channel sel[i]
+        //
+        tripletList.reserve(sel.size());
+        for(qint32 i = 0; i < sel.size(); ++i)
+            tripletList.push_back(T(i, i, cals[sel[i]]));
+        m_matMultSegment.resize(sel.size(), sel.size());
+        m_matMultSegment.setFromTriplets(tripletList.begin(), tripletList.end());
+
+        tripletList.clear();
+        for(qint32 i = 0; i < sel.size(); ++i)
+            tripletList.push_back(T(i, sel[i], cals[sel[i]]));
+        m_matOp.resize(sel.size(), nchan);
+        m_matOp.setFromTriplets(tripletList.begin(), tripletList.end());
+    }
+
+    m_matOp.makeCompressed();
+}
+
+//=============================================================================================================
+
+bool FiffRawReadOperator::matches(const RowVectorXd& cals,
+                                  const MatrixXd& proj,
+                                  const FiffCtfComp& comp,
+                                  const RowVectorXi& sel) const
+{
+    if(comp.kind != m_iCompKind)
+        return false;
+
+    if(!same_matrix(sel, m_vecSel) || !same_matrix(cals, m_vecCals) || !same_matrix(proj, m_matProj))
+        return false;
+
+    if(comp.kind != -1 && !same_matrix(comp.data->data, m_matComp))
+        return false;
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool FiffRawReadOperator::apply(const FiffRawBuffer& buffer,
+                                fiff_int_t first,
+                                fiff_int_t nsamp,
+                                Ref<MatrixXd> out) const
+{
+    switch(buffer.type) {
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT:
+            apply_typed(m_matOp, reinterpret_cast<const qint16*>(buffer.data), buffer.nchan, first, nsamp, out);
+            return true;
+        case FIFFT_INT:
+            apply_typed(m_matOp, reinterpret_cast<const qint32*>(buffer.data), buffer.nchan, first, nsamp, out);
+            return true;
+        case FIFFT_FLOAT:
+            apply_typed(m_matOp, reinterpret_cast<const float*>(buffer.data), buffer.nchan, first, nsamp, out);
+            return true;
+        default:
+            qWarning("Data Storage Format not known yet!! Type: %d\n", buffer.type);
+            return false;
+    }
+}
@@ -0,0 +1,176 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     fiff_raw_read_operator.h
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Cached, fused calibration / compensation / projection operator applied to raw FIFF data buffers.
+ *
+ * @ref FiffRawData::read_raw_segment turns every @c FIFF_DATA_BUFFER into
+ * physical units by multiplying it with @c proj * @c comp * @c cal (or the
+ * row-selected subset of it). @ref FiffRawReadOperator builds that sparse
+ * operator once for a given (cals, proj, comp, sel) combination, remembers
+ * the combination as its key and applies itself directly to the integer
+ * or float payload of a @ref FiffRawBuffer one sample column at a time,
+ * so no intermediate channel × sample double matrix is materialized.
+ */
+
+#ifndef FIFF_RAW_READ_OPERATOR_H
+#define FIFF_RAW_READ_OPERATOR_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_types.h"
+#include "fiff_ctf_comp.h"
+#include "fiff_raw_buffer_map.h"
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+//=============================================================================================================
+/**
+ * @brief Immutable calibration / compensation / projection operator for one (cals, proj, comp, sel) combination.
+ *
+ * Rows correspond to the selected output channels (all channels if the
+ * selection is empty), columns to the channels stored in the data
+ * buffers. Each operator carries a process-wide unique version number so
+ * that callers can detect when @ref FiffRawData had to rebuild it.
+ */
+class FIFFSHARED_EXPORT FiffRawReadOperator
+{
+public:
+    using SPtr = QSharedPointer<FiffRawReadOperator>;            /**< Shared pointer type for FiffRawReadOperator. */
+    using ConstSPtr = QSharedPointer<const FiffRawReadOperator>; /**< Const shared pointer type for FiffRawReadOperator. */
+
+    //=========================================================================================================
+    /**
+     * Builds the operator.
+     *
+     * @param[in] cals   Calibration factors of all channels.
+     * @param[in] proj   SSP operator (empty if none).
+     * @param[in] comp   Compensator (kind -1 if none).
+     * @param[in] sel    Channel selection (empty for all channels).
+     */
+    FiffRawReadOperator(const Eigen::RowVectorXd& cals,
+                        const Eigen::MatrixXd& proj,
+                        const FiffCtfComp& comp,
+                        const Eigen::RowVectorXi& sel);
+
+    //=========================================================================================================
+    /**
+     * True if this operator was built from the given combination.
+     *
+     * @param[in] cals   Calibration factors of all channels.
+     * @param[in] proj   SSP operator (empty if none).
+     * @param[in] comp   Compensator (kind -1 if none).
+     * @param[in] sel    Channel selection (empty for all channels).
+     *
+     * @return true if the operator can be reused for this combination.
+     */
+    bool matches(const Eigen::RowVectorXd& cals,
+                 const Eigen::MatrixXd& proj,
+                 const FiffCtfComp& comp,
+                 const Eigen::RowVectorXi& sel) const;
+
+    //=========================================================================================================
+    /**
+     * Number of output channels.
+     *
+     * @return Number of rows of the operator.
+     */
+    inline Eigen::Index rows() const;
+
+    //=========================================================================================================
+    /**
+     * Process-wide unique build number of this operator.
+     *
+     * @return The version.
+     */
+    inline qint64 version() const;
+
+    //=========================================================================================================
+    /**
+     * The multiplication matrix in the form read_raw_segment reports it: the (selected) calibration matrix if
+     * neither projection nor compensation is active, proj*comp*cal otherwise.
+     *
+     * @return The multiplication matrix.
+     */
+    inline const Eigen::SparseMatrix<double>& multSegment() const;
+
+    //=========================================================================================================
+    /**
+     * Applies the operator to the samples [first, first + nsamp) of a data buffer and writes the result to out.
+     * The buffer is converted to double one sample column at a time.
+     *
+     * @param[in] buffer   Data buffer (all channels).
+     * @param[in] first    First sample of the buffer to use.
+     * @param[in] nsamp    Number of samples to use.
+     * @param[out] out     Output block of size rows() x nsamp.
+     *
+     * @return false if the buffer type is not supported.
+     */
+    bool apply(const FiffRawBuffer& buffer,
+               fiff_int_t first,
+               fiff_int_t nsamp,
+               Eigen::Ref<Eigen::MatrixXd> out) const;
+
+private:
+    Eigen::RowVectorXd                              m_vecCals;      /**< Key: calibration factors. */
+    Eigen::MatrixXd                                 m_matProj;      /**< Key: SSP operator. */
+    fiff_int_t                                      m_iCompKind;    /**< Key: compensator kind. */
+    Eigen::MatrixXd                                 m_matComp;      /**< Key: compensator data. */
+    Eigen::RowVectorXi                              m_vecSel;       /**< Key: channel selection. */
+
+    Eigen::SparseMatrix<double>                     m_matMultSegment;   /**< The operator as reported by read_raw_segment. */
+    Eigen::SparseMatrix<double, Eigen::RowMajor>    m_matOp;            /**< Output channels x buffer channels. */
+    qint64                                          m_iVersion;         /**< Build number. */
+};
+
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline Eigen::Index FiffRawReadOperator::rows() const
+{
+    return m_matOp.rows();
+}
+
+//=============================================================================================================
+
+inline qint64 FiffRawReadOperator::version() const
+{
+    return m_iVersion;
+}
+
+//=============================================================================================================
+
+inline const Eigen::SparseMatrix<double>& FiffRawReadOperator::multSegment() const
+{
+    return m_matMultSegment;
+}
+} // NAMESPACE
+
+#endif // FIFF_RAW_READ_OPERATOR_H
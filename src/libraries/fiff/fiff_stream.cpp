@@ -20,7 +20,12 @@
  * Owns one @c QIODevice. Builds the directory and @ref FiffDirNode tree
  * on open; trades tag streams for typed FIFFLIB objects on read; emits
  * spec-compliant FIFF on write. Files emitted here round-trip through
- * @c mne.io.fiff unchanged.
+ * @c mne.io.fiff unchanged. The numeric writers assemble each tag in a
+ * reused staging buffer, byte-swap whole arrays at once and hand the
+ * device a single write per tag. Files without a tag directory are
+ * scanned once on open; the result can be kept in a cache keyed by
+ * path, size and modification time, and append_dir() lets writers
+ * leave a directory behind so the scan is not needed at all.
  */
 
 //=============================================================================================================
@@ -48,7 +53,9 @@
 #include <math/numerics.h>
 #include <utils/ioutils.h>
 
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <time.h>
 
 //=============================================================================================================
@@ -62,9 +69,18 @@
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
 #include <QTcpSocket>
 #include <QDebug>
+#include <QtEndian>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -74,6 +90,69 @@ using namespace FIFFLIB;
 using namespace UTILSLIB;
 using namespace Eigen;
 
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+constexpr quint32 DIR_CACHE_MAGIC   = 0x46494458;  /**< "FIDX", first word of a tag directory cache entry. */
+constexpr qint32  DIR_CACHE_VERSION = 1;           /**< Layout version of a tag directory cache entry. */
+constexpr qint64  DIR_CACHE_DEFAULT_LIMIT = qint64(64) << 20;  /**< Default size limit of the tag directory cache. */
+
+QMutex& dirCacheMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QString& dirCacheDir()
+{
+    static QString dir;
+    return dir;
+}
+
+qint64& dirCacheLimit()
+{
+    static qint64 iLimit = DIR_CACHE_DEFAULT_LIMIT;
+    return iLimit;
+}
+
+const QStringList& dirCacheEntryFilter()
+{
+    static const QStringList filter = {QStringLiteral("*.fdir")};
+    return filter;
+}
+
+//=============================================================================================================
+/**
+ * Copies n 4- or 8-byte values to dst in big-endian (FIFF) byte order. Qt swaps whole arrays with SIMD
+ * shuffles where available; src may equal dst for an in-place swap.
+ *
+ * @return Pointer behind the written bytes.
+ */
+template<typename T>
+inline char* putBigEndian(char* dst, const T* src, qint64 n)
+{
+    static_assert(sizeof(T) == 4 || sizeof(T) == 8, "FIFF numeric data is 4 or 8 bytes wide");
+    if constexpr (sizeof(T) == 4) {
+        qToBigEndian<quint32>(src, n, dst);
+    } else {
+        qToBigEndian<quint64>(src, n, dst);
+    }
+    return dst + n * qint64(sizeof(T));
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline char* putBigEndian(char* dst, T value)
+{
+    return putBigEndian(dst, &value, 1);
+}
+
+} // anonymous namespace
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -278,11 +357,20 @@ bool FiffStream::open(QIODevice::OpenModeFlag mode)
      * Do we have a directory or not?
      */
     if (dirpos <= 0) {  /* Must do it in the hard way... */
-        bool ok = false;
-        m_dir = this->make_dir(&ok);
-        if (!ok) {
-          qCritical ("Could not create tag directory!");
-          return false;
+        /*
+         * ...unless an earlier read-only open already did and cached the result
+         */
+        const bool bUseCache = (mode == QIODevice::ReadOnly);
+        if (!bUseCache || !this->read_cached_dir(m_dir)) {
+            bool ok = false;
+            m_dir = this->make_dir(&ok);
+            if (!ok) {
+              qCritical ("Could not create tag directory!");
+              return false;
+            }
+            if (bUseCache) {
+                this->write_cached_dir(m_dir);
+            }
         }
     }
     else {              /* Just read the directory */
@@ -326,11 +414,23 @@ bool FiffStream::close()
     if(this->device()->isOpen())
         this->device()->close();
 
+    if(m_appendDirOnClose) {
+        m_appendDirOnClose = false;
+        append_dir(*this->device());
+    }
+
     return true;
 }
 
 //=============================================================================================================
 
+void FiffStream::set_append_dir_on_close(bool append)
+{
+    m_appendDirOnClose = append;
+}
+
+//=============================================================================================================
+
 FiffDirNode::SPtr FiffStream::make_subtree(QList<FiffDirEntry::SPtr> &dentry)
 {
     FiffDirNode::SPtr defaultNode;
@@ -2133,6 +2233,90 @@ FiffStream::SPtr FiffStream::open_update(QIODevice &p_IODevice)
 
 //=============================================================================================================
 
+bool FiffStream::append_dir(QIODevice &p_IODevice)
+{
+    // open_update can only rewrite the directory pointer of a file
+    QFile *file = qobject_cast<QFile *>(&p_IODevice);
+    if (file == nullptr)
+        return false;
+
+    if (file->isOpen())
+        file->close();
+
+    if (file->size() > std::numeric_limits<fiff_int_t>::max()) {
+        qWarning("FiffStream::append_dir - %s exceeds the 2 GB a FIFF directory can address.",
+                 file->fileName().toUtf8().constData());
+        return false;
+    }
+
+    FiffStream::SPtr t_pStream = FiffStream::open_update(p_IODevice);
+    if (!t_pStream)
+        return false;
+
+    const QList<FiffDirEntry::SPtr>& dir = t_pStream->dir();
+    for (int i = 0; i < dir.size(); ++i) {
+        if (dir[i]->kind == FIFF_DIR_POINTER) {
+            fiff_int_t dirpos = (fiff_int_t)t_pStream->write_dir_entries(dir);
+            if (dirpos >= 0)
+                t_pStream->write_dir_pointer(dirpos, dir[i]->pos);
+            t_pStream->close();
+            return dirpos >= 0;
+        }
+    }
+
+    qWarning("FiffStream::append_dir - %s has no directory pointer.", file->fileName().toUtf8().constData());
+    t_pStream->close();
+    return false;
+}
+
+//=============================================================================================================
+
+void FiffStream::set_dir_cache_directory(const QString &dir)
+{
+    QMutexLocker locker(&dirCacheMutex());
+    dirCacheDir() = dir;
+}
+
+//=============================================================================================================
+
+QString FiffStream::dir_cache_directory()
+{
+    QMutexLocker locker(&dirCacheMutex());
+    return dirCacheDir();
+}
+
+//=============================================================================================================
+
+void FiffStream::set_dir_cache_size_limit(qint64 iBytes)
+{
+    QMutexLocker locker(&dirCacheMutex());
+    dirCacheLimit() = std::max<qint64>(iBytes, 0);
+}
+
+//=============================================================================================================
+
+qint64 FiffStream::dir_cache_size_limit()
+{
+    QMutexLocker locker(&dirCacheMutex());
+    return dirCacheLimit();
+}
+
+//=============================================================================================================
+
+void FiffStream::clear_dir_cache()
+{
+    const QString t_sCacheDir = dir_cache_directory();
+    if (t_sCacheDir.isEmpty())
+        return;
+
+    // Entries still being written are temporary QSaveFile files and are left alone
+    const QFileInfoList entries = QDir(t_sCacheDir).entryInfoList(dirCacheEntryFilter(), QDir::Files);
+    for (const QFileInfo& entry : entries)
+        QFile::remove(entry.absoluteFilePath());
+}
+
+//=============================================================================================================
+
 FiffStream::SPtr FiffStream::start_writing_raw(QIODevice &p_IODevice,
                                                const FiffInfo& info,
                                                RowVectorXd& cals,
@@ -2163,6 +2347,8 @@ FiffStream::SPtr FiffStream::start_writing_raw(QIODevice &p_IODevice,
     //  Create the file and save the essentials
     //
     FiffStream::SPtr t_pStream = start_file(p_IODevice);//1, 2, 3
+    if(!t_pStream)
+        return t_pStream;
     t_pStream->start_block(FIFFB_MEAS);//4
     t_pStream->write_id(FIFF_BLOCK_ID);//5
     if(info.meas_id.version != -1)
@@ -2348,6 +2534,23 @@ fiff_long_t FiffStream::write_tag(const FiffTag::UPtr &p_pTag, fiff_long_t pos)
 
 //=============================================================================================================
 
+char* FiffStream::stage_tag(fiff_int_t kind, fiff_int_t type, fiff_int_t datasize, fiff_int_t next)
+{
+    const qint32 header[4] = { kind, type, datasize, next };
+
+    m_stagingBuffer.resize(static_cast<int>(sizeof(header)) + qMax(datasize, 0));
+    return putBigEndian(m_stagingBuffer.data(), header, 4);
+}
+
+//=============================================================================================================
+
+void FiffStream::write_staged_tag()
+{
+    this->writeRawData(m_stagingBuffer.constData(), m_stagingBuffer.size());
+}
+
+//=============================================================================================================
+
 fiff_long_t FiffStream::write_ch_info(const FiffChInfo& ch)
 {
     fiff_long_t pos = this->device()->pos();
@@ -2727,23 +2930,15 @@ fiff_long_t FiffStream::write_double(fiff_int_t kind, const double* data, fiff_i
 
     qint32 datasize = nel * 8;
 
-    *this << (qint32)kind;
-    *this << (qint32)FIFFT_DOUBLE;
-    *this << (qint32)datasize;
-    *this << (qint32)FIFFV_NEXT_SEQ;
-
     //
     // Write doubles as raw 8-byte big-endian values.
     // FiffStream sets QDataStream::SinglePrecision, which causes
-    // operator<<(double) to write only 4 bytes. We must bypass that
-    // to emit the full 8-byte IEEE 754 representation.
+    // operator<<(double) to write only 4 bytes, so the full 8-byte
+    // IEEE 754 representation is byte-swapped directly.
     //
-    for(qint32 i = 0; i < nel; ++i)
-    {
-        qint64 bits;
-        memcpy(&bits, &data[i], sizeof(double));
-        *this << bits;
-    }
+    char* payload = stage_tag(kind, FIFFT_DOUBLE, datasize);
+    putBigEndian(payload, data, nel);
+    write_staged_tag();
 
     return pos;
 }
@@ -2756,13 +2951,9 @@ fiff_long_t FiffStream::write_float(fiff_int_t kind, const float* data, fiff_int
 
     qint32 datasize = nel * 4;
 
-    *this << (qint32)kind;
-    *this << (qint32)FIFFT_FLOAT;
-    *this << (qint32)datasize;
-    *this << (qint32)FIFFV_NEXT_SEQ;
-
-    for(qint32 i = 0; i < nel; ++i)
-        *this << data[i];
+    char* payload = stage_tag(kind, FIFFT_FLOAT, datasize);
+    putBigEndian(payload, data, nel);
+    write_staged_tag();
 
     return pos;
 }
@@ -2777,24 +2968,19 @@ fiff_long_t FiffStream::write_float_matrix(fiff_int_t kind, const MatrixXf& mat)
 
     fiff_int_t datasize = 4*numel + 4*3;
 
-     *this << (qint32)kind;
-     *this << (qint32)FIFFT_MATRIX_FLOAT;
-     *this << (qint32)datasize;
-     *this << (qint32)FIFFV_NEXT_SEQ;
+    char* payload = stage_tag(kind, FIFFT_MATRIX_FLOAT, datasize);
 
-    qint32 i, j;
-    // Storage order: row-major
-    for(i = 0; i < mat.rows(); ++i)
-        for(j = 0; j < mat.cols(); ++j)
-            *this << mat(i,j);
+    // Storage order: row-major. Transpose into the staging buffer, then swap in place.
+    Map<Matrix<float, Dynamic, Dynamic, RowMajor>>(reinterpret_cast<float*>(payload), mat.rows(), mat.cols()) = mat;
+    payload = putBigEndian(payload, reinterpret_cast<const float*>(payload), numel);
 
     qint32 dims[3];
     dims[0] = mat.cols();
     dims[1] = mat.rows();
     dims[2] = 2;
+    putBigEndian(payload, dims, 3);
 
-    for(i = 0; i < 3; ++i)
-        *this << dims[i];
+    write_staged_tag();
 
     return pos;
 }
@@ -2842,23 +3028,6 @@ fiff_long_t FiffStream::write_float_sparse_ccs(fiff_int_t kind, const SparseMatr
         }
     }
 
-     *this << (qint32)kind;
-     *this << (qint32)FIFFT_CCS_MATRIX_FLOAT;
-     *this << (qint32)datasize;
-     *this << (qint32)FIFFV_NEXT_SEQ;
-
-    //
-    //  The data values
-    //
-    for(i = 0; i < s.size(); ++i)
-        *this << s[i].value();
-
-    //
-    //  Row indices
-    //
-    for(i = 0; i < s.size(); ++i)
-        *this << s[i].row();
-
     //
     //  Pointers
     //
@@ -2874,20 +3043,37 @@ fiff_long_t FiffStream::write_float_sparse_ccs(fiff_int_t kind, const SparseMatr
     for(k = ncol; k >= 1; --k)
        if(ptrs[k-1] < 0)
           ptrs[k-1] = ptrs[k];
+
+    char* payload = stage_tag(kind, FIFFT_CCS_MATRIX_FLOAT, datasize);
+
     //
-    for(i = 0; i < (quint32)ptrs.size(); ++i)
-        *this << ptrs[i];
+    //  The data values
     //
-    //   Dimensions
+    for(i = 0; i < s.size(); ++i)
+        payload = putBigEndian(payload, s[i].value());
+
+    //
+    //  Row indices
+    //
+    for(i = 0; i < s.size(); ++i)
+        payload = putBigEndian(payload, static_cast<qint32>(s[i].row()));
+
+    //
+    //  Pointers
+    //
+    payload = putBigEndian(payload, ptrs.data(), ptrs.size());
+
+    //
+    //  Dimensions
     //
     qint32 dims[4];
     dims[0] = mat.nonZeros();
     dims[1] = mat.rows();
     dims[2] = mat.cols();
     dims[3] = 2;
+    putBigEndian(payload, dims, 4);
 
-    for(i = 0; i < 4; ++i)
-        *this << dims[i];
+    write_staged_tag();
 
     return pos;
 }
@@ -2935,26 +3121,6 @@ fiff_long_t FiffStream::write_float_sparse_rcs(fiff_int_t kind, const SparseMatr
         }
     }
 
-    //
-    // Write tag info header
-    //
-     *this << (qint32)kind;
-     *this << (qint32)FIFFT_RCS_MATRIX_FLOAT;
-     *this << (qint32)datasize;
-     *this << (qint32)FIFFV_NEXT_SEQ;
-
-    //
-    //  The data values
-    //
-    for(i = 0; i < s.size(); ++i)
-        *this << s[i].value();
-
-    //
-    //  Column indices
-    //
-    for(i = 0; i < s.size(); ++i)
-        *this << s[i].col();
-
     //
     //  Pointers
     //
@@ -2972,9 +3138,24 @@ fiff_long_t FiffStream::write_float_sparse_rcs(fiff_int_t kind, const SparseMatr
        if(ptrs[k-1] < 0)
           ptrs[k-1] = ptrs[k];
 
+    char* payload = stage_tag(kind, FIFFT_RCS_MATRIX_FLOAT, datasize);
+
+    //
+    //  The data values
     //
-    for(i = 0; i < (quint32)ptrs.size(); ++i)
-        *this << ptrs[i];
+    for(i = 0; i < s.size(); ++i)
+        payload = putBigEndian(payload, s[i].value());
+
+    //
+    //  Column indices
+    //
+    for(i = 0; i < s.size(); ++i)
+        payload = putBigEndian(payload, static_cast<qint32>(s[i].col()));
+
+    //
+    //  Pointers
+    //
+    payload = putBigEndian(payload, ptrs.data(), ptrs.size());
 
     //
     //  Dimensions
@@ -2984,9 +3165,9 @@ fiff_long_t FiffStream::write_float_sparse_rcs(fiff_int_t kind, const SparseMatr
     dims[1] = mat.rows();
     dims[2] = mat.cols();
     dims[3] = 2;
+    putBigEndian(payload, dims, 4);
 
-    for(i = 0; i < 4; ++i)
-        *this << dims[i];
+    write_staged_tag();
 
     return pos;
 }
@@ -3105,13 +3286,9 @@ fiff_long_t FiffStream::write_int(fiff_int_t kind, const fiff_int_t* data, fiff_
 
     fiff_int_t datasize = nel * 4;
 
-     *this << (qint32)kind;
-     *this << (qint32)FIFFT_INT;
-     *this << (qint32)datasize;
-     *this << (qint32)next;
-
-    for(qint32 i = 0; i < nel; ++i)
-        *this << data[i];
+    char* payload = stage_tag(kind, FIFFT_INT, datasize, next);
+    putBigEndian(payload, data, nel);
+    write_staged_tag();
 
     return pos;
 }
@@ -3122,31 +3299,23 @@ fiff_long_t FiffStream::write_int_matrix(fiff_int_t kind, const MatrixXi& mat)
 {
     fiff_long_t pos = this->device()->pos();
 
-//    qint32 FIFFT_MATRIX = 1 << 30;
-//    qint32 FIFFT_MATRIX_INT = FIFFT_INT | FIFFT_MATRIX;
-
     qint32 numel = mat.rows() * mat.cols();
 
     fiff_int_t datasize = 4*numel + 4*3;
 
-     *this << (qint32)kind;
-     *this << (qint32)FIFFT_MATRIX_INT;
-     *this << (qint32)datasize;
-     *this << (qint32)FIFFV_NEXT_SEQ;
+    char* payload = stage_tag(kind, FIFFT_MATRIX_INT, datasize);
 
-    qint32 i, j;
-    // Storage order: row-major
-    for(i = 0; i < mat.rows(); ++i)
-        for(j = 0; j < mat.cols(); ++j)
-            *this << mat(i,j);
+    // Storage order: row-major. Transpose into the staging buffer, then swap in place.
+    Map<Matrix<qint32, Dynamic, Dynamic, RowMajor>>(reinterpret_cast<qint32*>(payload), mat.rows(), mat.cols()) = mat;
+    payload = putBigEndian(payload, reinterpret_cast<const qint32*>(payload), numel);
 
     qint32 dims[3];
     dims[0] = mat.cols();
     dims[1] = mat.rows();
     dims[2] = 2;
+    putBigEndian(payload, dims, 3);
 
-    for(i = 0; i < 3; ++i)
-        *this << dims[i];
+    write_staged_tag();
 
     return pos;
 }
@@ -3307,8 +3476,7 @@ bool FiffStream::write_raw_buffer(const MatrixXd& buf,
     SparseMatrix<double> inv_calsMat(cals.cols(), cals.cols());
     inv_calsMat.setFromTriplets(tripletList.begin(), tripletList.end());
 
-    MatrixXf tmp = (inv_calsMat*buf).cast<float>();
-    this->write_float(FIFF_DATA_BUFFER,tmp.data(),tmp.rows()*tmp.cols());
+    write_raw_buffer_data(inv_calsMat*buf);
     return true;
 }
 
@@ -3327,8 +3495,7 @@ bool FiffStream::write_raw_buffer(const MatrixXd& buf,
       for (SparseMatrix<double>::InnerIterator it(mult,k); it; ++it)
         inv_mult.coeffRef(it.row(),it.col()) = 1/it.value();
 
-    MatrixXf tmp = (inv_mult*buf).cast<float>();
-    this->write_float(FIFF_DATA_BUFFER,tmp.data(),tmp.rows()*tmp.cols());
+    write_raw_buffer_data(inv_mult*buf);
     return true;
 }
 
@@ -3336,13 +3503,27 @@ bool FiffStream::write_raw_buffer(const MatrixXd& buf,
 
 bool FiffStream::write_raw_buffer(const MatrixXd& buf)
 {
-    MatrixXf tmp = buf.cast<float>();
-    this->write_float(FIFF_DATA_BUFFER,tmp.data(),tmp.rows()*tmp.cols());
+    write_raw_buffer_data(buf);
     return true;
 }
 
 //=============================================================================================================
 
+void FiffStream::write_raw_buffer_data(const MatrixXd& data)
+{
+    // Same tag as write_float(FIFF_DATA_BUFFER, ...), but the float conversion lands in the staging buffer
+    fiff_int_t nel = data.rows() * data.cols();
+    char* payload = stage_tag(FIFF_DATA_BUFFER, FIFFT_FLOAT, nel * 4);
+
+    Map<MatrixXf> staged(reinterpret_cast<float*>(payload), data.rows(), data.cols());
+    staged = data.cast<float>();
+    putBigEndian(payload, staged.data(), nel);
+
+    write_staged_tag();
+}
+
+//=============================================================================================================
+
 fiff_long_t FiffStream::write_string(fiff_int_t kind,
                                      const QString& data)
 {
@@ -3432,6 +3613,116 @@ QList<FiffDirEntry::SPtr> FiffStream::make_dir(bool *ok)
 
 //=============================================================================================================
 
+bool FiffStream::read_cached_dir(QList<FiffDirEntry::SPtr> &dir)
+{
+    const QString t_sCacheName = this->dir_cache_file_name();
+    if (t_sCacheName.isEmpty())
+        return false;
+
+    QFile t_cacheFile(t_sCacheName);
+    if (!t_cacheFile.open(QIODevice::ReadOnly))
+        return false;
+
+    // The modification time tells the eviction how recently an entry was used
+    t_cacheFile.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+
+    QDataStream in(&t_cacheFile);
+    quint32 magic = 0;
+    qint32 version = 0, nent = 0;
+    qint64 fileSize = -1;
+    in >> magic >> version >> fileSize >> nent;
+
+    const qint64 deviceSize = this->device()->size();
+    if (in.status() != QDataStream::Ok || magic != DIR_CACHE_MAGIC || version != DIR_CACHE_VERSION
+        || fileSize != deviceSize || nent < 1 || qint64(nent) * 16 > t_cacheFile.bytesAvailable())
+        return false;
+
+    QList<FiffDirEntry::SPtr> cached;
+    cached.reserve(nent);
+    for (qint32 i = 0; i < nent; ++i) {
+        FiffDirEntry::SPtr t_pFiffDirEntry(new FiffDirEntry);
+        in >> t_pFiffDirEntry->kind >> t_pFiffDirEntry->type >> t_pFiffDirEntry->size >> t_pFiffDirEntry->pos;
+        cached.append(t_pFiffDirEntry);
+    }
+
+    /*
+     * Entries have to lie inside the file and end with the terminating entry
+     */
+    if (in.status() != QDataStream::Ok || cached.last()->kind != -1)
+        return false;
+    for (qint32 i = 0; i < nent - 1; ++i) {
+        if (cached[i]->pos < 0 || cached[i]->pos >= deviceSize)
+            return false;
+    }
+
+    dir = cached;
+    return true;
+}
+
+//=============================================================================================================
+
+void FiffStream::write_cached_dir(const QList<FiffDirEntry::SPtr> &dir)
+{
+    const QString t_sCacheName = this->dir_cache_file_name();
+    if (t_sCacheName.isEmpty() || !QDir().mkpath(QFileInfo(t_sCacheName).absolutePath()))
+        return;
+
+    // Written next to the target and renamed on commit, so readers never see half an entry
+    QSaveFile t_cacheFile(t_sCacheName);
+    if (!t_cacheFile.open(QIODevice::WriteOnly))
+        return;
+
+    QDataStream out(&t_cacheFile);
+    out << DIR_CACHE_MAGIC << DIR_CACHE_VERSION << qint64(this->device()->size()) << qint32(dir.size());
+    for (const FiffDirEntry::SPtr& entry : dir)
+        out << entry->kind << entry->type << entry->size << entry->pos;
+
+    if (out.status() != QDataStream::Ok) {
+        t_cacheFile.cancelWriting();
+        return;
+    }
+
+    if (t_cacheFile.commit())
+        trim_dir_cache(QFileInfo(t_sCacheName).absolutePath(), dir_cache_size_limit());
+}
+
+//=============================================================================================================
+
+void FiffStream::trim_dir_cache(const QString &dir, qint64 iLimit)
+{
+    // Newest first, so everything past the limit was used longest ago
+    const QFileInfoList entries = QDir(dir).entryInfoList(dirCacheEntryFilter(), QDir::Files, QDir::Time);
+    qint64 iTotal = 0;
+    for (const QFileInfo& entry : entries) {
+        iTotal += entry.size();
+        if (iTotal > iLimit)
+            QFile::remove(entry.absoluteFilePath());
+    }
+}
+
+//=============================================================================================================
+
+QString FiffStream::dir_cache_file_name()
+{
+    const QString t_sCacheDir = dir_cache_directory();
+    QFile* t_pFile = qobject_cast<QFile*>(this->device());
+    if (t_sCacheDir.isEmpty() || t_pFile == nullptr)
+        return QString();
+
+    const QFileInfo t_fileInfo(t_pFile->fileName());
+    if (!t_fileInfo.exists())
+        return QString();
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(t_fileInfo.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(t_fileInfo.size()));
+    hash.addData(QByteArray::number(t_fileInfo.lastModified().toMSecsSinceEpoch()));
+
+    return QDir(t_sCacheDir).filePath(QString::fromLatin1(hash.result().toHex()) + QStringLiteral(".fdir"));
+}
+
+//=============================================================================================================
+
 bool FiffStream::copyProcessingHistory(const QString& fromPath, const QString& toPath)
 {
     // Open source file
@@ -242,11 +242,21 @@ public:
     /**
      * Close stream
      *
-     *    *
+     * If set_append_dir_on_close() was enabled, a tag directory is appended to the closed file (see append_dir()).
+     *
      * @return true if succeeded, false otherwise.
      */
     bool close();
 
+    //=========================================================================================================
+    /**
+     * Makes close() append a tag directory to the file written through this stream, so that later opens read
+     * the directory instead of scanning every tag. Meant for files the stream has written itself.
+     *
+     * @param[in] append     Whether to append the directory on close (Default is off).
+     */
+    void set_append_dir_on_close(bool append);
+
     //=========================================================================================================
     /**
      * Create the directory tree structure
@@ -494,6 +504,60 @@ public:
      */
     static FiffStream::SPtr open_update(QIODevice& p_IODevice);
 
+    //=========================================================================================================
+    /**
+     * Appends a tag directory to the end of a FIFF file and points its FIFF_DIR_POINTER at it. An existing
+     * directory is replaced. The file has to be smaller than 2 GB, since directory entries store 32-bit
+     * positions.
+     *
+     * @param[in] p_IODevice    The file to update. It is (re-)opened for update and closed again.
+     *
+     * @return true if the file carries a directory afterwards, false otherwise.
+     */
+    static bool append_dir(QIODevice& p_IODevice);
+
+    //=========================================================================================================
+    /**
+     * Sets the directory in which open() caches the tag directories it had to build by scanning a file
+     * without a directory. Entries are keyed by the file's absolute path, size and modification time, so a
+     * file that changed is scanned again. An empty directory (the default) disables the cache.
+     *
+     * @param[in] dir    The cache directory.
+     */
+    static void set_dir_cache_directory(const QString& dir);
+
+    //=========================================================================================================
+    /**
+     * Returns the tag directory cache location set with set_dir_cache_directory().
+     *
+     * @return The cache directory, empty if caching is disabled.
+     */
+    static QString dir_cache_directory();
+
+    //=========================================================================================================
+    /**
+     * Sets the total size the tag directory cache may occupy. Whenever a new entry is written, the least
+     * recently used entries are removed until the cache fits, so entries of files that were re-recorded or
+     * edited do not pile up. Default: 64 MiB.
+     *
+     * @param[in] iBytes    Size limit in bytes.
+     */
+    static void set_dir_cache_size_limit(qint64 iBytes);
+
+    //=========================================================================================================
+    /**
+     * Returns the size limit of the tag directory cache.
+     *
+     * @return The size limit in bytes.
+     */
+    static qint64 dir_cache_size_limit();
+
+    //=========================================================================================================
+    /**
+     * Removes all entries from the tag directory cache.
+     */
+    static void clear_dir_cache();
+
     //=========================================================================================================
     /**
      * fiff_start_writing_raw
@@ -874,6 +938,70 @@ private:
      */
     QList<FiffDirEntry::SPtr> make_dir(bool *ok=nullptr);
 
+    //=========================================================================================================
+    /**
+     * Loads the tag directory of the underlying file from the directory cache.
+     *
+     * @param[out] dir   The cached directory, including the terminating entry.
+     *
+     * @return true if a valid entry for the current state of the file was found, false otherwise.
+     */
+    bool read_cached_dir(QList<FiffDirEntry::SPtr>& dir);
+
+    //=========================================================================================================
+    /**
+     * Stores the tag directory of the underlying file in the directory cache.
+     *
+     * @param[in] dir    The directory built by make_dir().
+     */
+    void write_cached_dir(const QList<FiffDirEntry::SPtr>& dir);
+
+    //=========================================================================================================
+    /**
+     * Removes the least recently used entries of the directory cache until it is no larger than iLimit.
+     *
+     * @param[in] dir       The cache directory.
+     * @param[in] iLimit    The size limit in bytes.
+     */
+    static void trim_dir_cache(const QString& dir, qint64 iLimit);
+
+    //=========================================================================================================
+    /**
+     * Returns the directory cache file of the underlying file.
+     *
+     * @return The cache file name, empty if caching is disabled or the device is not a file.
+     */
+    QString dir_cache_file_name();
+
+    //=========================================================================================================
+    /**
+     * Starts a tag in the write staging buffer: stores the big-endian tag header and reserves datasize bytes
+     * of payload, which the caller fills in big-endian order before calling write_staged_tag(). Lets the
+     * numeric writers byte-swap whole arrays at once and emit each tag with a single device write.
+     *
+     * @param[in] kind       Tag kind.
+     * @param[in] type       Tag type.
+     * @param[in] datasize   Payload size in bytes.
+     * @param[in] next       Position of the next tag (default = FIFFV_NEXT_SEQ).
+     *
+     * @return Pointer to the payload area of the staging buffer.
+     */
+    char* stage_tag(fiff_int_t kind, fiff_int_t type, fiff_int_t datasize, fiff_int_t next = FIFFV_NEXT_SEQ);
+
+    //=========================================================================================================
+    /**
+     * Writes the tag prepared with stage_tag() to the device.
+     */
+    void write_staged_tag();
+
+    //=========================================================================================================
+    /**
+     * Writes a FIFF_DATA_BUFFER tag of single-precision floats, converting straight into the staging buffer.
+     *
+     * @param[in] data   The (calibrated) buffer data, channels x samples.
+     */
+    void write_raw_buffer_data(const Eigen::MatrixXd& data);
+
 private:
 
 //    char         *file_name;    /**< Name of the file. */ -> Use streamName() instead
@@ -882,6 +1010,8 @@ private:
     QList<FiffDirEntry::SPtr>   m_dir;  /**< This is the directory. If no directory exists, open automatically scans the file to create one. */
 //    int         nent;           /**< How many entries?. */ -> Use nent() instead
     FiffDirNode::SPtr           m_dirtree; /**< Directory compiled into a tree. */
+    QByteArray                  m_stagingBuffer; /**< Reused by the bulk numeric writers to assemble one tag. */
+    bool                        m_appendDirOnClose = false; /**< Whether close() appends a tag directory. */
 //    char        *ext_file_name; /**< Name of the file holding the external data. */
 //    FILE        *ext_fd;        /**< The file descriptor of the above file if open . */
 
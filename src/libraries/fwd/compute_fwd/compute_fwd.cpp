@@ -406,6 +406,7 @@ void ComputeFwd::initFwd()
             return;
         }
         qInfo("Loading the solution matrix...");
+        m_bemModel->solution_cache_dir = m_pSettings->bem_cache_dir;
         if (m_bemModel->fwd_bem_load_recompute_solution(m_pSettings->bemname.toUtf8().data(),FWD_BEM_UNKNOWN,false) == FAIL) {
             return;
         }
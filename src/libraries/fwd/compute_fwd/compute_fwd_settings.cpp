@@ -114,6 +114,7 @@ void ComputeFwdSettings::initMembers()
     scale_eeg_pos = false;    
     use_equiv_eeg = true;     
     use_threads = true;
+    bem_cache_dir = QString::fromLocal8Bit(qgetenv("MNE_BEM_CACHE_DIR"));
 
     pFiffInfo = nullptr;
     meg_head_t = FiffCoordTrans();
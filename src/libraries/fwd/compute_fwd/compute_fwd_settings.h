@@ -93,6 +93,7 @@ public:
     QString transname;          /**< head2mri transformation file. */
     bool mri_head_ident;        /**< Are the head and MRI coordinates the same?. */
     QString bemname;            /**< BEM model file. */
+    QString bem_cache_dir;      /**< Directory of cached BEM solutions (empty = no caching). */
     QString solname;            /**< Solution file. */
     QString mindistoutname;     /**< Output file for omitted source space points. */
     bool filter_spaces;         /**< Filter the source space points. */
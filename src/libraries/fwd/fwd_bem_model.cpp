@@ -36,10 +36,16 @@
 #include <fiff/fiff_named_matrix.h>
 
 #include <QFile>
+#include <QSaveFile>
+#include <QDir>
+#include <QFileInfo>
+#include <QCryptographicHash>
 #include <QList>
 #include <QThread>
 #include <QtConcurrent>
 
+#include <functional>
+
 #define _USE_MATH_DEFINES
 #include <math.h>
 
@@ -106,6 +112,34 @@ static QString strip_from(const QString& s, const QString& suffix)
     return res;
 }
 
+/*
+ * Invert a dense BEM coefficient matrix: blocked partial-pivoting LU in place,
+ * then the columns of the inverse in independent blocks on all cores
+ */
+template<typename T>
+static Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> lu_inverse(Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic>& mat)
+{
+    typedef Eigen::Matrix<T, Eigen::Dynamic, Eigen::Dynamic> MatrixT;
+
+    const Eigen::Index n = mat.rows();
+    const Eigen::PartialPivLU<Eigen::Ref<MatrixT> > lu(mat);
+
+    MatrixT result(n, n);
+
+    const Eigen::Index nthreads = std::max(1, QThread::idealThreadCount());
+    const Eigen::Index ncols = std::max<Eigen::Index>(64, (n + nthreads - 1) / nthreads);
+    QList<QPair<Eigen::Index, Eigen::Index> > blocks;
+    for (Eigen::Index c = 0; c < n; c += ncols)
+        blocks.append(qMakePair(c, std::min(ncols, n - c)));
+
+    std::function<void(const QPair<Eigen::Index, Eigen::Index>&)> solve_block = [&](const QPair<Eigen::Index, Eigen::Index>& block) {
+        result.middleCols(block.first, block.second) = lu.solve(MatrixT::Identity(n, n).middleCols(block.first, block.second));
+    };
+    QtConcurrent::blockingMap(blocks, solve_block);
+
+    return result;
+}
+
 
 namespace FWDLIB
 {
@@ -169,6 +203,8 @@ FwdBemModel::FwdBemModel()
 , head_mri_t ()
 , ip_approach_limit(FWD_BEM_IP_APPROACH_LIMIT)
 , use_ip_approach(false)
+, solution_cache_dir(QString::fromLocal8Bit(qgetenv("MNE_BEM_CACHE_DIR")))
+, solve_in_double(false)
 {
 }
 
@@ -782,7 +818,7 @@ int FwdBemModel::fwd_bem_linear_collocation_solution()
         nsol += surfs[k]->np;
 
     qInfo("\tInverting the coefficient matrix...");
-    solution = fwd_bem_multi_solution(coeff, &gamma, nsurf, np);
+    solution = fwd_bem_multi_solution(coeff, &gamma, nsurf, np, solve_in_double);
     if (solution.size() == 0) {
         fwd_bem_free_solution();
         return FAIL;
@@ -806,7 +842,7 @@ int FwdBemModel::fwd_bem_linear_collocation_solution()
         }
 
         qInfo("\tInverting the coefficient matrix (homog)...");
-        ip_solution = fwd_bem_homog_solution(coeff, surfs[nsurf-1]->np);
+        ip_solution = fwd_bem_homog_solution(coeff, surfs[nsurf-1]->np, solve_in_double);
         if (ip_solution.size() == 0) {
             fwd_bem_free_solution();
             return FAIL;
@@ -823,7 +859,7 @@ int FwdBemModel::fwd_bem_linear_collocation_solution()
 
 //=============================================================================================================
 
-Eigen::MatrixXf FwdBemModel::fwd_bem_multi_solution(Eigen::MatrixXf& solids, const Eigen::MatrixXf *gamma, int nsurf, const Eigen::VectorXi& ntri)
+Eigen::MatrixXf FwdBemModel::fwd_bem_multi_solution(Eigen::MatrixXf& solids, const Eigen::MatrixXf *gamma, int nsurf, const Eigen::VectorXi& ntri, bool use_double)
 /*
           * Invert I - solids/(2*M_PI)
           * Take deflation into account
@@ -858,13 +894,16 @@ Eigen::MatrixXf FwdBemModel::fwd_bem_multi_solution(Eigen::MatrixXf& solids, con
     for (k = 0; k < ntot; k++)
         solids(k,k) = solids(k,k) + 1.0;
 
-    Eigen::MatrixXf result = solids.inverse();
-    return result;
+    if (use_double) {
+        Eigen::MatrixXd solids_d = solids.cast<double>();
+        return lu_inverse(solids_d).cast<float>();
+    }
+    return lu_inverse(solids);
 }
 
 //=============================================================================================================
 
-Eigen::MatrixXf FwdBemModel::fwd_bem_homog_solution(Eigen::MatrixXf& solids, int ntri)
+Eigen::MatrixXf FwdBemModel::fwd_bem_homog_solution(Eigen::MatrixXf& solids, int ntri, bool use_double)
 /*
           * Invert I - solids/(2*M_PI)
           * Take deflation into account
@@ -872,7 +911,7 @@ Eigen::MatrixXf FwdBemModel::fwd_bem_homog_solution(Eigen::MatrixXf& solids, int
           * This is the homogeneous model case
           */
 {
-    return fwd_bem_multi_solution (solids,nullptr,1,Eigen::VectorXi::Constant(1,ntri));
+    return fwd_bem_multi_solution (solids,nullptr,1,Eigen::VectorXi::Constant(1,ntri),use_double);
 }
 
 //=============================================================================================================
@@ -1047,7 +1086,7 @@ int FwdBemModel::fwd_bem_constant_collocation_solution()
         nsol += surfs[k]->ntri;
 
     qInfo("\tInverting the coefficient matrix...");
-    solution = fwd_bem_multi_solution(solids, &gamma, nsurf, ntri);
+    solution = fwd_bem_multi_solution(solids, &gamma, nsurf, ntri, solve_in_double);
     if (solution.size() == 0) {
         fwd_bem_free_solution();
         return FAIL;
@@ -1070,7 +1109,7 @@ int FwdBemModel::fwd_bem_constant_collocation_solution()
         }
 
         qInfo("\tInverting the coefficient matrix (homog)...");
-        ip_solution = fwd_bem_homog_solution(solids, surfs[nsurf-1]->ntri);
+        ip_solution = fwd_bem_homog_solution(solids, surfs[nsurf-1]->ntri, solve_in_double);
         if (ip_solution.size() == 0) {
             fwd_bem_free_solution();
             return FAIL;
@@ -1130,7 +1169,121 @@ int FwdBemModel::fwd_bem_load_recompute_solution(const QString& name, int bem_me
     }
     if (bem_method == FWD_BEM_UNKNOWN)
         bem_method = FWD_BEM_LINEAR_COLL;
-    return fwd_bem_compute_solution(bem_method);
+    /*
+     * Try the solution cache before recomputing
+     */
+    QString cache_name = fwd_bem_cached_solution_name(bem_method);
+    if (!force_recompute && !cache_name.isEmpty()) {
+        if (fwd_bem_load_solution(cache_name,bem_method) == LOADED) {
+            qInfo("\nLoaded %s BEM solution from the cache %s",fwd_bem_explain_method(this->bem_method).toUtf8().constData(),cache_name.toUtf8().constData());
+            return OK;
+        }
+        fwd_bem_free_solution();
+    }
+    if (fwd_bem_compute_solution(bem_method) == FAIL)
+        return FAIL;
+    if (!cache_name.isEmpty()) {
+        if (fwd_bem_save_solution(cache_name) == OK)
+            qInfo("Cached the BEM solution in %s",cache_name.toUtf8().constData());
+        else
+            qWarning("Could not cache the BEM solution in %s",cache_name.toUtf8().constData());
+    }
+    return OK;
+}
+
+//=============================================================================================================
+
+QString FwdBemModel::fwd_bem_solution_key(int bem_method) const
+/*
+ * Hash everything the solution matrix depends on
+ */
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    const qint32 version = 1;
+
+    auto add_int = [&hash](qint32 value) {
+        hash.addData(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    auto add_float = [&hash](float value) {
+        hash.addData(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+
+    add_int(version);
+    add_int(bem_method);
+    add_int(nsurf);
+    add_int(solve_in_double ? 1 : 0);
+    add_float(ip_approach_limit);
+
+    for (int k = 0; k < nsurf; k++) {
+        const MNESurface* surf = surfs[k].get();
+        add_int(surf->id);
+        add_int(surf->np);
+        add_int(surf->ntri);
+        add_float(sigma[k]);
+        hash.addData(reinterpret_cast<const char*>(surf->rr.data()), static_cast<int>(surf->rr.size() * sizeof(float)));
+        hash.addData(reinterpret_cast<const char*>(surf->itris.data()), static_cast<int>(surf->itris.size() * sizeof(int)));
+    }
+
+    return QString::fromLatin1(hash.result().toHex());
+}
+
+//=============================================================================================================
+
+QString FwdBemModel::fwd_bem_cached_solution_name(int bem_method) const
+{
+    if (solution_cache_dir.isEmpty() || nsurf == 0)
+        return QString();
+
+    return QDir(solution_cache_dir).filePath(fwd_bem_solution_key(bem_method) + BEM_SOL_SUFFIX);
+}
+
+//=============================================================================================================
+
+int FwdBemModel::fwd_bem_save_solution(const QString& name) const
+/*
+ * Write the approximation method and the solution matrix in a FIFFB_BEM block
+ */
+{
+    int approx;
+
+    if (solution.size() == 0 || nsol == 0) {
+        qWarning("No BEM solution to save.");
+        return FAIL;
+    }
+    if (bem_method == FWD_BEM_LINEAR_COLL)
+        approx = FIFFV_BEM_APPROX_LINEAR;
+    else if (bem_method == FWD_BEM_CONSTANT_COLL)
+        approx = FIFFV_BEM_APPROX_CONST;
+    else {
+        qWarning("Cannot save a BEM solution of unknown method %d",bem_method);
+        return FAIL;
+    }
+
+    QFileInfo info(name);
+    if (!QDir().mkpath(info.absolutePath())) {
+        qWarning("Cannot create the directory %s",info.absolutePath().toUtf8().constData());
+        return FAIL;
+    }
+
+    QSaveFile file(name);
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning("Cannot write to %s",name.toUtf8().constData());
+        return FAIL;
+    }
+
+    FiffStream::SPtr stream = FiffStream::start_file(file);
+    if (!stream) {
+        file.cancelWriting();
+        return FAIL;
+    }
+
+    stream->start_block(FIFFB_BEM);
+    stream->write_int(FIFF_BEM_APPROX, &approx);
+    stream->write_float_matrix(FIFF_BEM_POT_SOLUTION, solution);
+    stream->end_block(FIFFB_BEM);
+    stream->end_file();
+
+    return file.commit() ? OK : FAIL;
 }
 
 //=============================================================================================================
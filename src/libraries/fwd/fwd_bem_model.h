@@ -343,28 +343,33 @@ public:
      * @brief Compute the multi-surface BEM solution from solid-angle coefficients.
      *
      * Applies the deflation technique and LU decomposition to produce
-     * the final BEM solution matrix for a multi-compartment model.
-     *
-     * @param[in] solids  Solid-angle coefficient matrix.
-     * @param[in] gamma   Conductivity-ratio coupling matrix (nullptr for homogeneous).
-     * @param[in] nsurf   Number of surfaces.
-     * @param[in] ntri    Triangle or node count per surface.
+     * the final BEM solution matrix for a multi-compartment model. The
+     * matrix is factored in place (blocked partial-pivoting LU) and the
+     * columns of the inverse are then solved for in parallel.
+     *
+     * @param[in] solids      Solid-angle coefficient matrix (destroyed).
+     * @param[in] gamma       Conductivity-ratio coupling matrix (nullptr for homogeneous).
+     * @param[in] nsurf       Number of surfaces.
+     * @param[in] ntri        Triangle or node count per surface.
+     * @param[in] use_double  Factor and invert in double instead of single precision.
      * @return Solution matrix, or empty matrix on error.
      */
     static Eigen::MatrixXf fwd_bem_multi_solution(Eigen::MatrixXf& solids,
                                           const Eigen::MatrixXf *gamma,
                                           int nsurf,
-                                          const Eigen::VectorXi& ntri);
+                                          const Eigen::VectorXi& ntri,
+                                          bool use_double = false);
 
     //=========================================================================================================
     /**
      * @brief Compute the homogeneous (single-layer) BEM solution.
      *
-     * @param[in] solids  Solid-angle coefficient matrix.
-     * @param[in] ntri    Number of triangles.
+     * @param[in] solids      Solid-angle coefficient matrix.
+     * @param[in] ntri        Number of triangles.
+     * @param[in] use_double  Factor and invert in double instead of single precision.
      * @return Solution matrix, or empty matrix on error.
      */
-    static Eigen::MatrixXf fwd_bem_homog_solution(Eigen::MatrixXf& solids, int ntri);
+    static Eigen::MatrixXf fwd_bem_homog_solution(Eigen::MatrixXf& solids, int ntri, bool use_double = false);
 
     //=========================================================================================================
     /**
@@ -432,7 +437,10 @@ public:
      * @brief Load a BEM solution from file, recomputing if necessary.
      *
      * Attempts to read the pre-computed solution; if it is missing or
-     * force_recompute is set, computes a fresh solution.
+     * force_recompute is set, computes a fresh solution. If
+     * solution_cache_dir is set, a solution that is not in the file is
+     * first looked up in the cache by fwd_bem_solution_key, and freshly
+     * computed solutions are stored there.
      *
      * @param[in] name             Path to the BEM model file.
      * @param[in] bem_method       Required BEM method.
@@ -443,6 +451,40 @@ public:
                                         int bem_method,
                                         int force_recompute);
 
+    //=========================================================================================================
+    /**
+     * @brief Content hash identifying the BEM solution of this model.
+     *
+     * Covers everything the solution matrix depends on: surface ids,
+     * vertex locations and triangulations, conductivities, the BEM
+     * method, the IP-approach limit and the solver precision.
+     *
+     * @param[in] bem_method  BEM method (FWD_BEM_CONSTANT_COLL or FWD_BEM_LINEAR_COLL).
+     * @return Hex-encoded SHA-256 key.
+     */
+    QString fwd_bem_solution_key(int bem_method) const;
+
+    //=========================================================================================================
+    /**
+     * @brief Path of the cached solution for this model in solution_cache_dir.
+     *
+     * @param[in] bem_method  BEM method (FWD_BEM_CONSTANT_COLL or FWD_BEM_LINEAR_COLL).
+     * @return The cache file name, or an empty string if no cache directory is set.
+     */
+    QString fwd_bem_cached_solution_name(int bem_method) const;
+
+    //=========================================================================================================
+    /**
+     * @brief Save the current solution matrix in the format read by fwd_bem_load_solution.
+     *
+     * The file is written to a temporary name and renamed on success, so
+     * concurrent readers never see a partial file.
+     *
+     * @param[in] name  Output file name.
+     * @return OK on success, FAIL on error.
+     */
+    int fwd_bem_save_solution(const QString& name) const;
+
     //============================= fwd_bem_pot.c =============================
 
     //=========================================================================================================
@@ -1049,6 +1091,9 @@ public:
 
     float           ip_approach_limit;  /**< Threshold for isolated-problem approach. */
     bool            use_ip_approach;    /**< Whether the isolated-problem approach is active. */
+
+    QString         solution_cache_dir; /**< Directory of cached solutions (empty = no caching). Defaults to $MNE_BEM_CACHE_DIR. */
+    bool            solve_in_double;    /**< Factor and invert the coefficient matrices in double precision. */
 };
 
 //=============================================================================================================
@@ -14,6 +14,11 @@
  * and assembles the per-time-point @ref InvEcd records into the output
  * @ref InvEcdSet. Refactored from @c fit_dipoles.c / @c fit_dipoles_raw
  * in the MNE-C reference implementation.
+ *
+ * The time points are fitted in batches. Within a batch, chunks of
+ * consecutive points are handed to a private thread pool whose workers
+ * each own an @ref InvDipoleFitWorkspace; the fitted dipoles are added
+ * to the set in time order once the batch is done.
  */
 
 //=============================================================================================================
@@ -23,10 +28,20 @@
 #include "inv_dipole_fit.h"
 #include <mne/mne_meas_data_set.h>
 #include "inv_guess_data.h"
+#include "inv_dipole_fit_workspace.h"
 
+#include <algorithm>
+#include <atomic>
 #include <memory>
 #include <vector>
 
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QThread>
+#include <QThreadPool>
+
 //=============================================================================================================
 // USED NAMESPACES
 //=============================================================================================================
@@ -40,6 +55,8 @@ using namespace FWDLIB;
 //=============================================================================================================
 
 static constexpr float SEG_LEN    = 10.0f;
+static constexpr int   FIT_CHUNK  = 16;     /* Consecutive time points fitted by one thread, warm start stays within */
+static constexpr int   FIT_BATCH  = 1024;   /* Time points collected from raw data before they are fitted */
 
 //=============================================================================================================
 // STATIC DEFINITIONS
@@ -160,6 +177,103 @@ static int mne_ch_selection_assign_chs(mneChSelection sel,
     return nch;
 }
 
+namespace
+{
+
+/**
+ * @brief One time point to fit and its result.
+ */
+struct FitPoint
+{
+    float           time;   /**< Time point (s). */
+    Eigen::VectorXf B;      /**< The field to fit; projected and whitened by the fit. */
+    InvEcd          dip;    /**< The fitted dipole. */
+    bool            ok;     /**< Did the fit succeed? */
+};
+
+/**
+ * @brief Fit a batch of time points and add the results to the set in time order.
+ *
+ * The points are split into chunks of FIT_CHUNK consecutive time points.
+ * With warm start, each point of a chunk may start from the dipole fitted
+ * at the previous point of the same chunk; the first point of a chunk
+ * always starts from the guess grid. The chunks are thus independent of
+ * each other and the result does not depend on the number of threads.
+ *
+ * @param[in]     fit            Precomputed fitting data.
+ * @param[in]     guess          The initial guesses.
+ * @param[in,out] points         The time points to fit.
+ * @param[in]     verbose        Verbose output flag.
+ * @param[in]     nthreads       Number of fitting threads (0 = one per core).
+ * @param[in]     warm_start     Start from the previous dipole when it fits better than the guesses.
+ * @param[in,out] set            The set the fitted dipoles are added to.
+ */
+void fit_points(InvDipoleFitData* fit,
+                InvGuessData* guess,
+                std::vector<FitPoint>& points,
+                int verbose,
+                int nthreads,
+                bool warm_start,
+                InvEcdSet& set)
+{
+    constexpr int report_interval = 10;
+    const int npoint = static_cast<int>(points.size());
+    const int nchunk = (npoint + FIT_CHUNK - 1) / FIT_CHUNK;
+
+    if (nthreads <= 0)
+        nthreads = QThread::idealThreadCount();
+    nthreads = std::max(1, std::min(nthreads, nchunk));
+    /*
+     * The simplex reports of concurrent fits would interleave
+     */
+    const int fit_verbose = nthreads > 1 ? 0 : verbose;
+
+    auto fit_chunk = [&](int c, InvDipoleFitWorkspace* work) {
+        const Eigen::Vector3f* rd_prev = nullptr;
+        for (int p = c*FIT_CHUNK; p < std::min(npoint, (c+1)*FIT_CHUNK); p++) {
+            FitPoint& point = points[p];
+            point.ok = InvDipoleFitData::fit_one(fit,guess,point.time,point.B,fit_verbose,point.dip,work,
+                                                 warm_start ? rd_prev : nullptr);
+            rd_prev = point.ok && point.dip.good > 0 ? &point.dip.rd : nullptr;
+        }
+    };
+
+    if (nthreads == 1) {
+        for (int c = 0; c < nchunk; c++)
+            fit_chunk(c,nullptr);
+    }
+    else {
+        QThreadPool pool;
+        pool.setMaxThreadCount(nthreads);
+        std::atomic<int> next(0);
+
+        for (int t = 0; t < nthreads; t++) {
+            pool.start([&]() {
+                InvDipoleFitWorkspace work(*fit);
+                for (int c = next++; c < nchunk; c = next++)
+                    fit_chunk(c,&work);
+            });
+        }
+        pool.waitForDone();
+    }
+
+    for (const FitPoint& point : points) {
+        if (!point.ok)
+            qWarning("t = %7.1f ms : fit error",1000.0f*point.time);
+        else {
+            set.addEcd(point.dip);
+            if (verbose)
+                point.dip.print();
+            else {
+                if (set.size() % report_interval == 0)
+                    qInfo("%d..",set.size());
+            }
+        }
+    }
+}
+
+} // anonymous namespace
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -287,11 +401,11 @@ InvEcdSet InvDipoleFit::calculateFit() const
           1000*settings->tmin,1000*settings->tmax,1000*settings->tstep,1000*settings->integ);
 
     if (raw) {
-        if (!fit_dipoles_raw(settings->measname,raw.get(),sel.get(),fit_data.get(),guess.get(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set))
+        if (!fit_dipoles_raw(settings->measname,raw.get(),sel.get(),fit_data.get(),guess.get(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set,settings->nthreads,settings->warm_start))
             return set;
     }
     else {
-        if (!fit_dipoles(settings->measname,data.get(),fit_data.get(),guess.get(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set))
+        if (!fit_dipoles(settings->measname,data.get(),fit_data.get(),guess.get(),settings->tmin,settings->tmax,settings->tstep,settings->integ,settings->verbose,set,settings->nthreads,settings->warm_start))
             return set;
     }
     qInfo("%d dipoles fitted",set.size());
@@ -301,36 +415,27 @@ InvEcdSet InvDipoleFit::calculateFit() const
 
 //=============================================================================================================
 
-bool InvDipoleFit::fit_dipoles( const QString& dataname, MNEMeasData* data, InvDipoleFitData* fit, InvGuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, InvEcdSet& p_set)
+bool InvDipoleFit::fit_dipoles( const QString& dataname, MNEMeasData* data, InvDipoleFitData* fit, InvGuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, InvEcdSet& p_set, int nthreads, bool warm_start)
 {
-    Eigen::VectorXf one(data->nchan);
+    std::vector<FitPoint> points;
     InvEcdSet set;
-    InvEcd   dip;
-    constexpr int report_interval = 10;
 
     set.dataname = dataname;
 
     if (verbose)
         qInfo("Fitting...");
     for (int s = 0; tmin + s*tstep < tmax; s++) {
-        float time = tmin + s*tstep;
-        if (data->current->getValuesAtTime(time, integ, data->nchan, false, one.data()) < 0) {
-            qWarning("Cannot pick time: %7.1f ms",1000.0f*time);
+        FitPoint point;
+        point.time = tmin + s*tstep;
+        point.B.resize(data->nchan);
+        point.ok   = false;
+        if (data->current->getValuesAtTime(point.time, integ, data->nchan, false, point.B.data()) < 0) {
+            qWarning("Cannot pick time: %7.1f ms",1000.0f*point.time);
             continue;
         }
-
-        if (!InvDipoleFitData::fit_one(fit,guess,time,one,verbose,dip))
-            qWarning("t = %7.1f ms : fit error",1000.0f*time);
-        else {
-            set.addEcd(dip);
-            if (verbose)
-                dip.print();
-            else {
-                if (set.size() % report_interval == 0)
-                    qInfo("%d..",set.size());
-            }
-        }
+        points.push_back(std::move(point));
     }
+    fit_points(fit,guess,points,verbose,nthreads,warm_start,set);
     if (!verbose)
         qInfo("[done]");
     p_set = set;
@@ -339,7 +444,7 @@ bool InvDipoleFit::fit_dipoles( const QString& dataname, MNEMeasData* data, InvD
 
 //=============================================================================================================
 
-bool InvDipoleFit::fit_dipoles_raw(const QString& dataname, MNERawData* raw, mneChSelection sel, InvDipoleFitData* fit, InvGuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, InvEcdSet& p_set)
+bool InvDipoleFit::fit_dipoles_raw(const QString& dataname, MNERawData* raw, mneChSelection sel, InvDipoleFitData* fit, InvGuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, InvEcdSet& p_set, int nthreads, bool warm_start)
 {
     const int   nchan   = sel->nchan;
     const float sfreq   = raw->info->sfreq;
@@ -349,9 +454,9 @@ bool InvDipoleFit::fit_dipoles_raw(const QString& dataname, MNERawData* raw, mne
     const int   step    = length - overlap;
     const int   stepo   = step + overlap/2;
     int         start   = raw->first_samp;
-    constexpr int report_interval = 10;
 
-    Eigen::VectorXf one(nchan);
+    std::vector<FitPoint> points;
+    points.reserve(FIT_BATCH);
 
     // Row-major storage compatible with float** interface
     std::vector<float> storage(static_cast<std::size_t>(nchan) * length);
@@ -360,7 +465,6 @@ bool InvDipoleFit::fit_dipoles_raw(const QString& dataname, MNERawData* raw, mne
         rows[i] = storage.data() + i * length;
     float** data = rows.data();
 
-    InvEcd    dip;
     InvEcdSet set;
     set.dataname = dataname;
 
@@ -382,22 +486,24 @@ bool InvDipoleFit::fit_dipoles_raw(const QString& dataname, MNERawData* raw, mne
             picks = time*sfreq - start;
             stime = start/sfreq;
         }
-        if (MNEMeasDataSet::getValuesFromChannelData(time, integ, data, length, nchan, stime, sfreq, false, one.data()) < 0) {
+        FitPoint point;
+        point.time = time;
+        point.B.resize(nchan);
+        point.ok   = false;
+        if (MNEMeasDataSet::getValuesFromChannelData(time, integ, data, length, nchan, stime, sfreq, false, point.B.data()) < 0) {
             qWarning("Cannot pick time: %8.3f s",time);
             continue;
         }
-        if (!InvDipoleFitData::fit_one(fit,guess,time,one,verbose,dip))
-            qWarning("t = %8.3f s : fit error",time);
-        else {
-            set.addEcd(dip);
-            if (verbose)
-                dip.print();
-            else {
-                if (set.size() % report_interval == 0)
-                    qInfo("%d..",set.size());
-            }
+        points.push_back(std::move(point));
+        /*
+         * Fit in batches to bound the memory taken by the picked data
+         */
+        if (static_cast<int>(points.size()) == FIT_BATCH) {
+            fit_points(fit,guess,points,verbose,nthreads,warm_start,set);
+            points.clear();
         }
     }
+    fit_points(fit,guess,points,verbose,nthreads,warm_start,set);
     if (!verbose)
         qInfo("[done]");
     p_set = set;
@@ -97,6 +97,9 @@ public:
     /**
      * Fit a single dipole to each time point of averaged data.
      *
+     * The time points are fitted independently, so they can be spread over
+     * several threads; the dipoles are returned in time order regardless.
+     *
      * Refactored: fit_dipoles (fit_dipoles.c)
      *
      * @param[in] dataname   Data file name.
@@ -109,10 +112,12 @@ public:
      * @param[in] integ      Integration time (s).
      * @param[in] verbose    Verbose output.
      * @param[out] p_set     The fitted dipole set.
+     * @param[in] nthreads   Number of fitting threads (0 = one per core).
+     * @param[in] warm_start Start each fit from the dipole of the previous time point when it fits better than the guesses.
      *
      * @return true when successful.
      */
-    static bool fit_dipoles(const QString& dataname, MNELIB::MNEMeasData* data, InvDipoleFitData* fit, InvGuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, InvEcdSet& p_set);
+    static bool fit_dipoles(const QString& dataname, MNELIB::MNEMeasData* data, InvDipoleFitData* fit, InvGuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, InvEcdSet& p_set, int nthreads = 1, bool warm_start = false);
 
     //=========================================================================================================
     /**
@@ -134,10 +139,12 @@ public:
      * @param[in] integ      Integration time (s).
      * @param[in] verbose    Verbose output.
      * @param[out] p_set     The fitted dipole set.
+     * @param[in] nthreads   Number of fitting threads (0 = one per core).
+     * @param[in] warm_start Start each fit from the dipole of the previous time point when it fits better than the guesses.
      *
      * @return true when successful.
      */
-    static bool fit_dipoles_raw(const QString& dataname, MNELIB::MNERawData* raw, MNELIB::mneChSelection sel, InvDipoleFitData* fit, InvGuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, InvEcdSet& p_set);
+    static bool fit_dipoles_raw(const QString& dataname, MNELIB::MNERawData* raw, MNELIB::mneChSelection sel, InvDipoleFitData* fit, InvGuessData* guess, float tmin, float tmax, float tstep, float integ, int verbose, InvEcdSet& p_set, int nthreads = 1, bool warm_start = false);
 
     //=========================================================================================================
     /**
@@ -26,6 +26,7 @@
 
 #include "inv_dipole_fit_data.h"
 #include "inv_guess_data.h"
+#include "inv_dipole_fit_workspace.h"
 #include <mne/mne_meas_data.h>
 #include <mne/mne_meas_data_set.h>
 #include <mne/mne_proj_item.h>
@@ -886,6 +887,7 @@ void print_fields(const Eigen::Vector3f& rd,
  * @brief Compute the forward solution for one or more dipoles, applying projections and whitening.
  */
 InvDipoleForward* dipole_forward(InvDipoleFitData* d,
+                              const dipoleFitFuncsRec& funcs,
                               float         **rd,
                               int           ndip,
                               InvDipoleForward* old)
@@ -921,7 +923,7 @@ InvDipoleForward* dipole_forward(InvDipoleFitData* d,
      */
         Eigen::MatrixXf this_fwd(d->nmeg + d->neeg, 3);
         Eigen::Map<const Eigen::Vector3f> rd_k(rd[k]);
-        if ((InvDipoleFitData::compute_dipole_field(*d,rd_k,true,this_fwd)) == FAIL) {
+        if ((InvDipoleFitData::compute_dipole_field(*d,funcs,rd_k,true,this_fwd)) == FAIL) {
             if (!old)
                 delete res;
             return nullptr;
@@ -987,10 +989,20 @@ InvDipoleForward* dipole_forward(InvDipoleFitData* d,
 InvDipoleForward* InvDipoleFitData::dipole_forward_one(InvDipoleFitData* d,
                                                  const Eigen::Vector3f& rd,
                                                  InvDipoleForward* old)
+{
+    return dipole_forward_one(d,*d->funcs,rd,old);
+}
+
+//=============================================================================================================
+
+InvDipoleForward* InvDipoleFitData::dipole_forward_one(InvDipoleFitData* d,
+                                                 const dipoleFitFuncsRec& funcs,
+                                                 const Eigen::Vector3f& rd,
+                                                 InvDipoleForward* old)
 {
     float *rds[1];
     rds[0] = const_cast<float*>(rd.data());
-    return dipole_forward(d,rds,1,old);
+    return dipole_forward(d,funcs,rds,1,old);
 }
 
 //=============================================================================================================
@@ -998,15 +1010,15 @@ InvDipoleForward* InvDipoleFitData::dipole_forward_one(InvDipoleFitData* d,
 /**
  * @brief Calculate the residual sum of squares for dipole fit evaluation.
  */
-static float fit_eval(const VectorXf& rd, const void *user)
+static float fit_eval(const VectorXf& rd, InvDipoleFitData* fit, FitDipUserRec* fuser)
 {
-    InvDipoleFitData* fit   = const_cast<InvDipoleFitData*>(static_cast<const InvDipoleFitData*>(user));
     InvDipoleForward* fwd;
-    FitDipUserRec*   fuser = fit->user;
     double        Bm2,one;
     int           ncomp,c;
 
-    fwd = fuser->fwd = InvDipoleFitData::dipole_forward_one(fit,rd.head<3>(),fuser->fwd);
+    fwd = fuser->fwd = InvDipoleFitData::dipole_forward_one(fit,*fuser->funcs,rd.head<3>(),fuser->fwd);
+    if (!fwd)
+        return fuser->B2;
     ncomp = fwd->sing[2]/fwd->sing[0] > fuser->limit ? 3 : 2;
     if (fuser->report_dim)
         qInfo("ncomp = %d",ncomp);
@@ -1106,6 +1118,7 @@ static bool dipole_report_func(int     loop,
  * @brief Fit the dipole moment once the location is known.
  */
 static int fit_Q(InvDipoleFitData* fit,
+                 const dipoleFitFuncsRec& funcs,
                  const Eigen::Ref<const Eigen::VectorXf>& B,
                  const Eigen::Vector3f& rd,
                  float limit,
@@ -1114,7 +1127,7 @@ static int fit_Q(InvDipoleFitData* fit,
                  float &res)
 {
     int c;
-    InvDipoleForward* fwd = InvDipoleFitData::dipole_forward_one(fit,rd,nullptr);
+    InvDipoleForward* fwd = InvDipoleFitData::dipole_forward_one(fit,funcs,rd,nullptr);
     float Bm2,one;
 
     if (!fwd)
@@ -1160,6 +1173,20 @@ bool InvDipoleFitData::fit_one(InvDipoleFitData* fit,
                     int           verbose,
                     InvEcd&          res
                     )
+{
+    return fit_one(fit,guess,time,B,verbose,res,nullptr,nullptr);
+}
+
+//=============================================================================================================
+
+bool InvDipoleFitData::fit_one(InvDipoleFitData* fit,
+                    InvGuessData*     guess,
+                    float         time,
+                    Eigen::Ref<Eigen::VectorXf> B,
+                    int           verbose,
+                    InvEcd&          res,
+                    InvDipoleFitWorkspace* work,
+                    const Eigen::Vector3f* rd_start)
 {
     VectorXf   vals(4);                        /* Values at the vertices */
     float  limit           = 0.2f;	               /* (pseudo) radial component omission limit */
@@ -1178,6 +1205,19 @@ bool InvDipoleFitData::fit_one(InvDipoleFitData* fit,
     int        k,neval,neval_tot,nchan,ncomp;
     int        fit_fail;
     Vector3f   rd_guess;
+    float      start_size;
+    /*
+     * With a workspace all forward computations go through its private clients
+     */
+    dipoleFitFuncsRec* sphere_funcs = work ? &work->sphere_funcs : fit->sphere_funcs.get();
+    dipoleFitFuncsRec* bem_funcs    = work ? &work->bem_funcs : fit->bem_funcs.get();
+    auto release_fwd = [&user,work]() {
+        if (work)
+            work->fwd.reset(user.fwd);
+        else
+            delete user.fwd;
+        user.fwd = nullptr;
+    };
 
     nchan = fit->nmeg+fit->neeg;
     user.fwd = nullptr;
@@ -1196,11 +1236,21 @@ bool InvDipoleFitData::fit_one(InvDipoleFitData* fit,
     user.limit = limit;
     user.B     = B.data();
     user.B2    = B.squaredNorm();
-    user.fwd   = nullptr;
+    user.fwd   = work ? work->fwd.release() : nullptr;
     user.report_dim = false;
-    fit->user  = &user;
+    user.funcs = sphere_funcs;
+    if (!work)
+        fit->user  = &user;
 
     rd_guess = guess->rr.row(best).transpose();
+    start_size = size;
+    /*
+     * Start from the given location instead if it explains the data at least as well as the best guess
+     */
+    if (rd_start && 1.0 - fit_eval(*rd_start,fit,&user)/user.B2 >= good) {
+        rd_guess   = *rd_start;
+        start_size = 0.5f*size;
+    }
     rd_final = rd_guess;
 
     neval_tot = 0;
@@ -1210,16 +1260,18 @@ bool InvDipoleFitData::fit_one(InvDipoleFitData* fit,
      * Do first pass with the sphere model
      */
         if (k == 0)
-            fit->funcs = fit->sphere_funcs.get();
+            user.funcs = sphere_funcs;
         else
-            fit->funcs = !fit->bemname.isEmpty() ? fit->bem_funcs.get() : fit->sphere_funcs.get();
+            user.funcs = !fit->bemname.isEmpty() ? bem_funcs : sphere_funcs;
+        if (!work)
+            fit->funcs = user.funcs;
 
-        MatrixXf simplexMat = make_initial_dipole_simplex(rd_guess,size);
+        MatrixXf simplexMat = make_initial_dipole_simplex(rd_guess,k == 0 ? start_size : size);
         for (int p = 0; p < 4; p++)
-            vals[p] = fit_eval(simplexMat.row(p),fit);
+            vals[p] = fit_eval(simplexMat.row(p),fit,&user);
 
-        // Capture fit pointer in type-safe lambda — no void* needed
-        auto cost = [fit](const VectorXf& x) -> float { return fit_eval(x, fit); };
+        // Capture fit data in type-safe lambda — no void* needed
+        auto cost = [fit,&user](const VectorXf& x) -> float { return fit_eval(x, fit, &user); };
 
         if (!UTILSLIB::SimplexAlgorithm::simplex_minimize<float>(
                              simplexMat,        /* The initial simplex */
@@ -1232,7 +1284,7 @@ bool InvDipoleFitData::fit_one(InvDipoleFitData* fit,
                              report_interval,   /* How often to report (-1 = no_reporting) */
                              dipole_report_func)) {
             if (k == 0) {
-                delete user.fwd;
+                release_fwd();
                 return false;
             }
             else {
@@ -1254,7 +1306,7 @@ bool InvDipoleFitData::fit_one(InvDipoleFitData* fit,
     /*
    * Compute the dipole moment at the final point
    */
-    if (fit_Q(fit,B,rd_final,user.limit,Q,ncomp,final_val) == OK) {
+    if (fit_Q(fit,*user.funcs,B,rd_final,user.limit,Q,ncomp,final_val) == OK) {
         res.time  = time;
         res.valid = true;
         res.rd    = rd_final;
@@ -1270,10 +1322,10 @@ bool InvDipoleFitData::fit_one(InvDipoleFitData* fit,
         res.neval = neval_tot;
     }
     else {
-        delete user.fwd;
+        release_fwd();
         return false;
     }
-    delete user.fwd;
+    release_fwd();
 
     return true;
 }
@@ -1286,6 +1338,13 @@ bool InvDipoleFitData::fit_one(InvDipoleFitData* fit,
  * The output matrix fwd is nch x 3, with columns corresponding to X, Y, Z orientations.
  */
 int InvDipoleFitData::compute_dipole_field(InvDipoleFitData& d, const Eigen::Vector3f& rd, int whiten, Eigen::Ref<Eigen::MatrixXf> fwd)
+{
+    return compute_dipole_field(d,*d.funcs,rd,whiten,fwd);
+}
+
+//=============================================================================================================
+
+int InvDipoleFitData::compute_dipole_field(InvDipoleFitData& d, const dipoleFitFuncsRec& funcs, const Eigen::Vector3f& rd, int whiten, Eigen::Ref<Eigen::MatrixXf> fwd)
 {
     static const Eigen::Vector3f Qx(1.0f, 0.0f, 0.0f);
     static const Eigen::Vector3f Qy(0.0f, 1.0f, 0.0f);
@@ -1297,48 +1356,48 @@ int InvDipoleFitData::compute_dipole_field(InvDipoleFitData& d, const Eigen::Vec
    */
     if (d.nmeg > 0) {
         int nmeg = d.meg_coils->ncoil();
-        if (d.funcs->meg_vec_field) {
+        if (funcs.meg_vec_field) {
             /*
              * Use the vector field function: computes all three dipole
              * orientations at once. Output is 3 x ncoil, we need nch x 3.
              */
             Eigen::MatrixXf vec_meg(3, nmeg);
-            if (d.funcs->meg_vec_field(rd,*d.meg_coils,vec_meg,d.funcs->meg_client) != OK)
+            if (funcs.meg_vec_field(rd,*d.meg_coils,vec_meg,funcs.meg_client) != OK)
                 return FAIL;
             fwd.topRows(nmeg) = vec_meg.transpose();
         } else {
             auto fwd0 = fwd.col(0).head(nmeg);
             auto fwd1 = fwd.col(1).head(nmeg);
             auto fwd2 = fwd.col(2).head(nmeg);
-            if (d.funcs->meg_field(rd,Qx,*d.meg_coils,fwd0,d.funcs->meg_client) != OK)
+            if (funcs.meg_field(rd,Qx,*d.meg_coils,fwd0,funcs.meg_client) != OK)
                 return FAIL;
-            if (d.funcs->meg_field(rd,Qy,*d.meg_coils,fwd1,d.funcs->meg_client) != OK)
+            if (funcs.meg_field(rd,Qy,*d.meg_coils,fwd1,funcs.meg_client) != OK)
                 return FAIL;
-            if (d.funcs->meg_field(rd,Qz,*d.meg_coils,fwd2,d.funcs->meg_client) != OK)
+            if (funcs.meg_field(rd,Qz,*d.meg_coils,fwd2,funcs.meg_client) != OK)
                 return FAIL;
         }
     }
 
     if (d.neeg > 0) {
         int neeg = d.eeg_els->ncoil();
-        if (d.funcs->eeg_vec_pot) {
+        if (funcs.eeg_vec_pot) {
             /*
              * Use the vector potential function: computes all three dipole
              * orientations at once. Output is 3 x ncoil, we need nch x 3.
              */
             Eigen::MatrixXf vec_eeg(3, neeg);
-            if (d.funcs->eeg_vec_pot(rd,*d.eeg_els,vec_eeg,d.funcs->eeg_client) != OK)
+            if (funcs.eeg_vec_pot(rd,*d.eeg_els,vec_eeg,funcs.eeg_client) != OK)
                 return FAIL;
             fwd.block(d.nmeg, 0, neeg, 3) = vec_eeg.transpose();
         } else {
             auto fwd0 = fwd.col(0).segment(d.nmeg, neeg);
             auto fwd1 = fwd.col(1).segment(d.nmeg, neeg);
             auto fwd2 = fwd.col(2).segment(d.nmeg, neeg);
-            if (d.funcs->eeg_pot(rd,Qx,*d.eeg_els,fwd0,d.funcs->eeg_client) != OK)
+            if (funcs.eeg_pot(rd,Qx,*d.eeg_els,fwd0,funcs.eeg_client) != OK)
                 return FAIL;
-            if (d.funcs->eeg_pot(rd,Qy,*d.eeg_els,fwd1,d.funcs->eeg_client) != OK)
+            if (funcs.eeg_pot(rd,Qy,*d.eeg_els,fwd1,funcs.eeg_client) != OK)
                 return FAIL;
-            if (d.funcs->eeg_pot(rd,Qz,*d.eeg_els,fwd2,d.funcs->eeg_client) != OK)
+            if (funcs.eeg_pot(rd,Qz,*d.eeg_els,fwd2,funcs.eeg_client) != OK)
                 return FAIL;
         }
     }
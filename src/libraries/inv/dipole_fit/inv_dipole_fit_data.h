@@ -101,6 +101,7 @@ struct FitDipUserRec {
     float          *B;
     double         B2;
     InvDipoleForward*  fwd;
+    dipoleFitFuncsRec* funcs;   /**< Forward functions of the current pass. */
 };
 
 //=============================================================================================================
@@ -109,6 +110,7 @@ struct FitDipUserRec {
 
 class InvGuessData;
 class InvEcd;
+class InvDipoleFitWorkspace;
 
 //=============================================================================================================
 /**
@@ -305,6 +307,39 @@ public:
      */
     static bool fit_one(InvDipoleFitData* fit, InvGuessData* guess, float time, Eigen::Ref<Eigen::VectorXf> B, int verbose, InvEcd& res);
 
+    //=========================================================================================================
+    /**
+     * @brief Fit a single dipole to the given data using thread-private forward functions.
+     *
+     * Same as the above but the forward fields are computed with the clients
+     * of @p work, and neither @c funcs nor @c user of @p fit is modified, so
+     * that several threads can fit with the same @p fit at once, each with
+     * its own workspace. If @p work is nullptr this is the serial fit above.
+     *
+     * If @p rd_start is given (typically the dipole fitted at the previous
+     * time point) and its sphere-model goodness of fit is at least that of
+     * the best guess, the search starts there with a smaller initial simplex.
+     *
+     * @param[in]     fit        Precomputed fitting data.
+     * @param[in]     guess      The initial guesses.
+     * @param[in]     time       Time point (s).
+     * @param[in,out] B          The field to fit (modified in-place by projection and whitening).
+     * @param[in]     verbose    Verbose output flag.
+     * @param[out]    res        The fitted dipole.
+     * @param[in]     work       Thread-private forward functions and scratch forward (may be nullptr).
+     * @param[in]     rd_start   Optional starting location in head coordinates (m).
+     *
+     * @return true on success, false on fitting failure.
+     */
+    static bool fit_one(InvDipoleFitData* fit,
+                        InvGuessData* guess,
+                        float time,
+                        Eigen::Ref<Eigen::VectorXf> B,
+                        int verbose,
+                        InvEcd& res,
+                        InvDipoleFitWorkspace* work,
+                        const Eigen::Vector3f* rd_start = nullptr);
+
     //=========================================================================================================
     /**
      * @brief Compute the forward field for a dipole at the given location.
@@ -323,6 +358,20 @@ public:
      */
     static int compute_dipole_field(InvDipoleFitData& d, const Eigen::Vector3f& rd, int whiten, Eigen::Ref<Eigen::MatrixXf> fwd);
 
+    //=========================================================================================================
+    /**
+     * @brief Compute the forward field for a dipole with the given forward functions instead of @c d.funcs.
+     *
+     * @param[in]     d        Dipole fit workspace.
+     * @param[in]     funcs    Forward functions and their clients.
+     * @param[in]     rd       Dipole position in head coordinates (m).
+     * @param[in]     whiten   If non-zero, whiten the result using the noise covariance.
+     * @param[in,out] fwd      Forward field matrix (nchan x 3), filled on output.
+     *
+     * @return OK on success, FAIL on error.
+     */
+    static int compute_dipole_field(InvDipoleFitData& d, const dipoleFitFuncsRec& funcs, const Eigen::Vector3f& rd, int whiten, Eigen::Ref<Eigen::MatrixXf> fwd);
+
     //=========================================================================================================
     /**
      * @brief Compute the forward solution for a single dipole position.
@@ -343,6 +392,22 @@ public:
                                      const Eigen::Vector3f& rd,
                                      InvDipoleForward* old);
 
+    //=========================================================================================================
+    /**
+     * @brief Compute the forward solution for a single dipole position with the given forward functions.
+     *
+     * @param[in]     d      Dipole fit workspace.
+     * @param[in]     funcs  Forward functions and their clients.
+     * @param[in]     rd     Dipole position in head coordinates (m).
+     * @param[in,out] old    Existing forward to recycle (may be nullptr).
+     *
+     * @return The populated forward object, or nullptr on error.
+     */
+    static InvDipoleForward* dipole_forward_one(InvDipoleFitData* d,
+                                     const dipoleFitFuncsRec& funcs,
+                                     const Eigen::Vector3f& rd,
+                                     InvDipoleForward* old);
+
 public:
       std::unique_ptr<FIFFLIB::FiffCoordTrans>    mri_head_t; /**< MRI <-> head coordinate transformation. */
       std::unique_ptr<FIFFLIB::FiffCoordTrans>    meg_head_t; /**< MEG <-> head coordinate transformation. */
@@ -106,6 +106,8 @@ void InvDipoleFitSettings::initMembers()
     scale_eeg_pos  = false;     
     mag_reg      = 0.1f;         
     fit_mag_dipoles = false;
+    nthreads     = 1;
+    warm_start   = false;
 
     grad_reg     = 0.1f;         
     eeg_reg      = 0.1f;                  
@@ -185,6 +187,10 @@ void InvDipoleFitSettings::checkIntegrity()
     }
     if (fit_mag_dipoles)
         qInfo("Fit data with magnetic dipoles");
+    if (nthreads != 1)
+        qInfo("Fitting threads : %d",nthreads);
+    if (warm_start)
+        qInfo("Fits start from the previous dipole when it is better than the guesses");
     if (!dipname.isEmpty())
         qInfo("dip output      : %s",dipname.toUtf8().data());
     if (!bdipname.isEmpty())
@@ -257,6 +263,8 @@ void InvDipoleFitSettings::usage(const char *name)
     qInfo("\t--mindist dist/mm Exclude points which are closer than this distance from the inner skull surface (default = %6.1f mm).",1000*guess_mindist);
     qInfo("\t--grid    dist/mm Source space grid size (default = %6.1f mm).",1000*guess_grid);
     qInfo("\t--magdip          Fit magnetic dipoles instead of current dipoles.");
+    qInfo("\t--threads n       Number of fitting threads, 0 = one per core (default = %d).",nthreads);
+    qInfo("\t--warmstart       Start each fit from the dipole of the previous time point if it explains the data better than the best guess.");
     qInfo("\nOutput:\n");
     qInfo("\t--dip     name    xfit dip format output file name");
     qInfo("\t--bdip    name    xfit bdip format output file name");
@@ -799,6 +807,25 @@ bool InvDipoleFitSettings::check_args (int *argc,char **argv)
             found = 1;
             fit_mag_dipoles = true;
         }
+        else if (strcmp(argv[k],"--threads") == 0) {
+            found = 2;
+            if (k == *argc - 1) {
+                qCritical ("--threads: argument required.");
+                return false;
+            }
+            if (sscanf(argv[k+1],"%d",&nthreads) != 1) {
+                qCritical() << "Incomprehensible number of threads:" << argv[k+1];
+                return false;
+            }
+            if (nthreads < 0) {
+                qCritical ("Number of threads must be >= 0");
+                return false;
+            }
+        }
+        else if (strcmp(argv[k],"--warmstart") == 0) {
+            found = 1;
+            warm_start = true;
+        }
         else if (strcmp(argv[k],"--dip") == 0) {
             found = 2;
             if (k == *argc - 1) {
@@ -148,6 +148,8 @@ public:
     bool   scale_eeg_pos;           /**< Scale the electrode locations to scalp in the sphere model. */
     float  mag_reg;                 /**< Noise-covariance matrix regularization for MEG (magnetometers and axial gradiometers). */
     bool   fit_mag_dipoles;         /**< Fit magnetic dipoles? */
+    int    nthreads;                /**< Number of fitting threads (0 = one per core). */
+    bool   warm_start;              /**< Start each fit from the dipole of the previous time point if it is better than the guesses? */
 
     float  grad_reg;                /**< Noise-covariance matrix regularization for planar gradiometers. */
     float  eeg_reg;                 /**< Noise-covariance matrix regularization for EEG. */
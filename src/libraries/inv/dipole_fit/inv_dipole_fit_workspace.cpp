@@ -0,0 +1,109 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     inv_dipole_fit_workspace.cpp
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Implementation of the @ref INVLIB::InvDipoleFitWorkspace per-thread fitting state.
+ *
+ * The clients are duplicated the way @c FwdThreadArg duplicates them
+ * for the multi-threaded forward computation: the compensation data
+ * and its work areas are copied, the BEM model is copied with an empty
+ * potential buffer, and everything else is shared with the fit set-up.
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "inv_dipole_fit_workspace.h"
+
+#include <fwd/fwd_bem_model.h>
+#include <fwd/fwd_comp_data.h>
+#include <mne/mne_ctf_comp_data_set.h>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FWDLIB;
+using namespace MNELIB;
+using namespace INVLIB;
+
+//=============================================================================================================
+// STATIC DEFINITIONS
+//=============================================================================================================
+
+namespace
+{
+
+/**
+ * Copies the forward functions but neither the clients nor their destructors.
+ */
+void copy_functions(const dipoleFitFuncsRec& from, dipoleFitFuncsRec& to)
+{
+    to.meg_field     = from.meg_field;
+    to.meg_vec_field = from.meg_vec_field;
+    to.eeg_pot       = from.eeg_pot;
+    to.eeg_vec_pot   = from.eeg_vec_pot;
+}
+
+} // anonymous namespace
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+InvDipoleFitWorkspace::InvDipoleFitWorkspace(const InvDipoleFitData& fit)
+{
+    if (fit.bem_model) {
+        m_bem = std::make_unique<FwdBemModel>();
+        *m_bem = *fit.bem_model;
+        m_bem->v0.resize(0);
+    }
+
+    if (fit.sphere_funcs) {
+        const dipoleFitFuncsRec& f = *fit.sphere_funcs;
+        copy_functions(f, sphere_funcs);
+        sphere_funcs.meg_client = f.meg_client ? duplicate_comp(f.meg_client, nullptr) : nullptr;
+        sphere_funcs.eeg_client = f.eeg_client;     /* The EEG sphere model is only read */
+    }
+
+    if (fit.bem_funcs) {
+        const dipoleFitFuncsRec& f = *fit.bem_funcs;
+        copy_functions(f, bem_funcs);
+        bem_funcs.meg_client = f.meg_client ? duplicate_comp(f.meg_client, m_bem.get()) : nullptr;
+        bem_funcs.eeg_client = f.eeg_client ? m_bem.get() : nullptr;
+    }
+}
+
+//=============================================================================================================
+
+InvDipoleFitWorkspace::~InvDipoleFitWorkspace()
+{
+    for (FwdCompData* comp : m_comps) {
+        comp->comp_coils = nullptr;     /* Shared with the fit set-up */
+        delete comp;
+    }
+}
+
+//=============================================================================================================
+
+FwdCompData* InvDipoleFitWorkspace::duplicate_comp(void* client, FwdBemModel* bem)
+{
+    const FwdCompData* orig = static_cast<const FwdCompData*>(client);
+
+    auto comp = new FwdCompData;
+    *comp = *orig;
+    comp->set = orig->set ? new MNECTFCompDataSet(*orig->set) : nullptr;
+    comp->work.resize(0);
+    comp->vec_work.resize(0, 0);
+    if (bem)
+        comp->client = bem;
+
+    m_comps.push_back(comp);
+    return comp;
+}
@@ -0,0 +1,101 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     inv_dipole_fit_workspace.h
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Per-thread forward-model clients and scratch forward for fitting dipoles concurrently.
+ *
+ * The forward functions of @ref INVLIB::InvDipoleFitData write into
+ * work areas that live in their client data (the compensation work
+ * vectors of @c FwdCompData and the infinite-medium potential buffer of
+ * @c FwdBemModel), and @ref InvDipoleFitData::fit_one switches the
+ * shared @c funcs pointer between the sphere and the BEM pass. An
+ * @ref INVLIB::InvDipoleFitWorkspace holds private copies of the
+ * sphere and BEM function records whose clients own their own work
+ * areas, plus a forward record that is recycled from one fit to the
+ * next, so that each fitting thread can run @c fit_one without touching
+ * any shared mutable state. Large read-only data (coil definitions,
+ * sphere models) stays shared; the BEM model is copied once per
+ * workspace, as in @c FwdThreadArg.
+ */
+
+#ifndef INV_DIPOLE_FIT_WORKSPACE_H
+#define INV_DIPOLE_FIT_WORKSPACE_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../inv_global.h"
+#include "inv_dipole_fit_data.h"
+#include "inv_dipole_forward.h"
+
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <memory>
+#include <vector>
+
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+namespace FWDLIB
+{
+    class FwdBemModel;
+    class FwdCompData;
+}
+
+//=============================================================================================================
+// DEFINE NAMESPACE INVLIB
+//=============================================================================================================
+
+namespace INVLIB
+{
+
+//=============================================================================================================
+/**
+ * @brief Thread-private forward functions and scratch forward record for InvDipoleFitData::fit_one.
+ */
+class INVSHARED_EXPORT InvDipoleFitWorkspace
+{
+public:
+    typedef std::unique_ptr<InvDipoleFitWorkspace> UPtr;    /**< Unique pointer type for InvDipoleFitWorkspace. */
+
+    //=========================================================================================================
+    /**
+     * Creates the thread-private copies of the forward functions of a fit set-up.
+     *
+     * @param[in] fit    The fit set-up, as returned by InvDipoleFitData::setup_dipole_fit_data.
+     */
+    explicit InvDipoleFitWorkspace(const InvDipoleFitData& fit);
+
+    //=========================================================================================================
+    /**
+     * Releases the copied clients.
+     */
+    ~InvDipoleFitWorkspace();
+
+    InvDipoleFitWorkspace(const InvDipoleFitWorkspace&) = delete;
+    InvDipoleFitWorkspace& operator=(const InvDipoleFitWorkspace&) = delete;
+
+public:
+    dipoleFitFuncsRec           sphere_funcs;   /**< Sphere model forward functions with private clients. */
+    dipoleFitFuncsRec           bem_funcs;      /**< BEM forward functions with private clients (empty without a BEM). */
+    InvDipoleForward::UPtr      fwd;            /**< Forward record recycled between fits. */
+
+private:
+    FWDLIB::FwdCompData* duplicate_comp(void* client, FWDLIB::FwdBemModel* bem);
+
+    std::vector<FWDLIB::FwdCompData*>       m_comps;    /**< Copied compensation clients; coil sets stay shared. */
+    std::unique_ptr<FWDLIB::FwdBemModel>    m_bem;      /**< Copied BEM model with its own potential buffer. */
+};
+
+} //NAMESPACE
+
+#endif // INV_DIPOLE_FIT_WORKSPACE_H
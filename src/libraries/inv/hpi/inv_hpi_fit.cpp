@@ -15,7 +15,9 @@
  * unknown, the rigid-body @c devHeadTrans solver via Procrustes
  * alignment, the head-movement-threshold check and the quaternion-
  * formatted position storage compatible with Neuromag MaxFilter
- * @c .pos files.
+ * @c .pos files. With @c CoilFitMethod::LevenbergMarquardt the
+ * Procrustes transform is only the starting point of a joint fit of all
+ * coils in which the six rigid-body parameters are the unknowns.
  */
 
 //=============================================================================================================
@@ -93,6 +95,20 @@ void InvHpiFit::checkForUpdate(const InvSensorSet &sensorSet)
 
 //=============================================================================================================
 
+void InvHpiFit::setCoilFitMethod(CoilFitMethod method)
+{
+    m_coilFitMethod = method;
+}
+
+//=============================================================================================================
+
+CoilFitMethod InvHpiFit::coilFitMethod() const
+{
+    return m_coilFitMethod;
+}
+
+//=============================================================================================================
+
 void InvHpiFit::fit(const MatrixXd& matProjectedData,
                  const MatrixXd& matProjectors,
                  const InvHpiModelParameters& hpiModelParameters,
@@ -133,6 +149,7 @@ void InvHpiFit::fit(const MatrixXd& matProjectedData,
                                                     hpiFitResult.errorDistances,
                                                     matCoilsHead);
 
+    // The seeds start from the last transformation if it was good, which warm-starts both optimizers
     CoilParam fittedCoilParams = dipfit(matCoilsSeed,
                                         m_sensors,
                                         matAmplitudes,
@@ -141,20 +158,47 @@ void InvHpiFit::fit(const MatrixXd& matProjectedData,
                                         500,
                                         1e-9f);
 
+    hpiFitResult.vecNumIterations = fittedCoilParams.dpfitnumitr.cast<int>();
+    hpiFitResult.iNumJointIterations = 0;
+
+    std::vector<int> vecOrder(matCoilsHead.rows());
+    std::iota(vecOrder.begin(), vecOrder.end(), 0);
+
     if(bOrderFrequencies) {
-        const std::vector<int> vecOrder = findCoilOrder(fittedCoilParams.pos,
-                                                        matCoilsHead);
+        vecOrder = findCoilOrder(fittedCoilParams.pos,
+                                 matCoilsHead);
 
         fittedCoilParams.pos = order(vecOrder,fittedCoilParams.pos);
         hpiFitResult.hpiFreqs = order(vecOrder,hpiModelParameters.vecHpiFreqs());
+        hpiFitResult.vecNumIterations = order(vecOrder,MatrixXd(fittedCoilParams.dpfitnumitr)).col(0).cast<int>();
     }
 
     hpiFitResult.GoF = computeGoF(fittedCoilParams.dpfiterror);
 
     hpiFitResult.fittedCoils = getFittedPointSet(fittedCoilParams.pos);
 
-    hpiFitResult.devHeadTrans = computeDeviceHeadTransformation(fittedCoilParams.pos,
-                                                                matCoilsHead);
+    if(m_coilFitMethod == CoilFitMethod::LevenbergMarquardt) {
+        // Refine the Procrustes solution with all coils at once: the coil positions are tied to the digitizers
+        MatrixXd matDataOrdered(matAmplitudes.rows(), matAmplitudes.cols());
+        for(int i = 0; i < matDataOrdered.cols(); ++i) {
+            matDataOrdered.col(i) = matAmplitudes.col(vecOrder[i]);
+        }
+
+        Matrix4d matTrans = computeTransformation(matCoilsHead, fittedCoilParams.pos);
+        const DipFitError jointError = InvHpiFitData::fitRigidBody(matCoilsHead,
+                                                                   matDataOrdered,
+                                                                   m_sensors,
+                                                                   matProjectors,
+                                                                   matTrans,
+                                                                   100,
+                                                                   1e-9f);
+
+        hpiFitResult.devHeadTrans = FiffCoordTrans(1,4,matTrans.cast<float>(),true);
+        hpiFitResult.iNumJointIterations = jointError.numIterations;
+    } else {
+        hpiFitResult.devHeadTrans = computeDeviceHeadTransformation(fittedCoilParams.pos,
+                                                                    matCoilsHead);
+    }
 
     hpiFitResult.errorDistances = computeEstimationError(fittedCoilParams.pos,
                                                          matCoilsHead,
@@ -268,8 +312,11 @@ CoilParam InvHpiFit::dipfit(const MatrixXd matCoilsSeed,
         //        }
 
         //Do concurrent
+        void (InvHpiFitData::*pFitCoil)() = m_coilFitMethod == CoilFitMethod::LevenbergMarquardt
+                                            ? &InvHpiFitData::doDipfitLevenbergMarquardt
+                                            : &InvHpiFitData::doDipfitConcurrent;
         QFuture<void> future = QtConcurrent::map(lCoilData,
-                                                 &InvHpiFitData::doDipfitConcurrent);
+                                                 pFitCoil);
         future.waitForFinished();
 
         //Transform results to final coil information
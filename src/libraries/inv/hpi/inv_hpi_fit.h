@@ -77,6 +77,14 @@ namespace INVLIB
 // Declare all structures to be used
 //=============================================================================================================
 
+/**
+ * The optimizer used to localize the HPI coils.
+ */
+enum class CoilFitMethod : int {
+    Simplex = 0,                /**< Nelder-Mead simplex search per coil on the dipole fit error. */
+    LevenbergMarquardt = 1      /**< Levenberg-Marquardt per coil with analytic Jacobians, followed by a joint rigid-body fit of all coils. */
+};
+
 /**
  * The strucut specifing the coil parameters.
  *
@@ -111,6 +119,8 @@ struct HpiFitResult {
     bool                        bIsLargeHeadMovement;
     float                       fHeadMovementDistance;
     float                       fHeadMovementAngle;
+    Eigen::VectorXi             vecNumIterations;
+    int                         iNumJointIterations = 0;
 };
 
 //=============================================================================================================
@@ -216,6 +226,24 @@ public:
                                       const float& fThreshRot,
                                       const float& fThreshTrans);
 
+    //=========================================================================================================
+    /**
+     * Sets the optimizer used to localize the coils. With CoilFitMethod::LevenbergMarquardt the device to head
+     * transformation is refined by a joint fit of all coils with the rigid-body parameters as unknowns.
+     * Default is CoilFitMethod::Simplex.
+     *
+     * @param[in] method    The coil fit method.
+     */
+    void setCoilFitMethod(CoilFitMethod method);
+
+    //=========================================================================================================
+    /**
+     * Returns the optimizer used to localize the coils.
+     *
+     * @return The coil fit method.
+     */
+    CoilFitMethod coilFitMethod() const;
+
 private:
 
     //=========================================================================================================
@@ -368,6 +396,7 @@ private:
 
     InvSensorSet m_sensors;            /**< The sensor struct that contains information about all sensors. */
     InvSignalModel m_signalModel;      /**< The signal model for the Hpi signals used to compute extract the coil amplitudes */
+    CoilFitMethod m_coilFitMethod{CoilFitMethod::Simplex};     /**< The optimizer used to localize the coils. */
 
 };
 
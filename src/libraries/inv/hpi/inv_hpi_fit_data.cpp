@@ -13,7 +13,10 @@
  * the per-iteration residual / error functional, the Nelder-Mead
  * simplex search (@c fminsearch), the concurrent dispatcher
  * (@c doDipfitConcurrent) and the @c HPISortStruct comparator used to
- * match fitted coils to the digitised reference layout.
+ * match fitted coils to the digitised reference layout. The
+ * Levenberg-Marquardt alternatives (@c doDipfitLevenbergMarquardt and
+ * the joint rigid-body fit @c fitRigidBody) use the field gradient of
+ * @c magneticDipoleField as analytic Jacobian.
  */
 
 //=============================================================================================================
@@ -33,6 +36,9 @@
 // EIGEN INCLUDES
 //=============================================================================================================
 
+#include <Eigen/Dense>
+#include <Eigen/Geometry>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
@@ -49,6 +55,26 @@ using namespace INVLIB;
 // DEFINE GLOBAL METHODS
 //=============================================================================================================
 
+namespace {
+
+const double LM_LAMBDA_START = 1e-3;    /**< Initial Levenberg-Marquardt damping. */
+const double LM_LAMBDA_MAX   = 1e12;    /**< Damping at which no descent step is left and the search stops. */
+const double LM_STEP_TOL     = 1e-7;    /**< Stop when the coil positions move less than this (m). */
+
+/**
+ * Cross-product matrix [u]x, so that [u]x * v = u x v.
+ */
+Eigen::Matrix3d crossMatrix(const Eigen::Vector3d& u)
+{
+    Eigen::Matrix3d mat;
+    mat <<     0, -u(2),  u(1),
+            u(2),     0, -u(0),
+           -u(1),  u(0),     0;
+    return mat;
+}
+
+} // anonymous namespace
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -90,6 +116,234 @@ void InvHpiFitData::doDipfitConcurrent()
 
 //=============================================================================================================
 
+void InvHpiFitData::doDipfitLevenbergMarquardt()
+{
+    const Eigen::VectorXd vecData = this->m_sensorData.transpose();
+    const Eigen::MatrixXd& matProj = this->m_matProjector;
+    const double dData2 = vecData.squaredNorm();
+
+    Eigen::Vector3d vecPos = this->m_coilPos.row(0).transpose();
+    Eigen::MatrixXd matLf, matGrad;
+
+    // The moment enters linearly, start with its least-squares estimate at the seed
+    magneticDipoleField(vecPos, Eigen::Vector3d::Zero(), m_sensors, matLf);
+    Eigen::MatrixXd matA = matProj * matLf;
+    Eigen::Vector3d vecMom = matA.colPivHouseholderQr().solve(vecData);
+    Eigen::VectorXd vecRes = vecData - matA * vecMom;
+    double dCost = vecRes.squaredNorm();
+
+    double dLambda = LM_LAMBDA_START;
+    Eigen::MatrixXd matJ(vecData.size(), 6);
+    int iItr = 0;
+
+    while(iItr < m_iMaxIterations) {
+        ++iItr;
+
+        // Residual r = d - P * L(pos) * mom, Jacobian with respect to (pos, mom)
+        magneticDipoleField(vecPos, vecMom, m_sensors, matLf, &matGrad);
+        matJ.leftCols(3).noalias() = -matProj * matGrad;
+        matJ.rightCols(3).noalias() = -matProj * matLf;
+        const Eigen::Matrix<double,6,6> matH = matJ.transpose() * matJ;
+        const Eigen::Matrix<double,6,1> vecG = matJ.transpose() * vecRes;
+
+        bool bAccepted = false;
+        Eigen::Matrix<double,6,1> vecDelta;
+        while(dLambda < LM_LAMBDA_MAX) {
+            Eigen::Matrix<double,6,6> matHd = matH;
+            matHd.diagonal() *= 1.0 + dLambda;
+            vecDelta = matHd.ldlt().solve(-vecG);
+
+            const Eigen::Vector3d vecPosNew = vecPos + vecDelta.head<3>();
+            const Eigen::Vector3d vecMomNew = vecMom + vecDelta.tail<3>();
+            magneticDipoleField(vecPosNew, vecMomNew, m_sensors, matLf);
+            Eigen::VectorXd vecResNew = vecData - matProj * (matLf * vecMomNew);
+            const double dCostNew = vecResNew.squaredNorm();
+
+            if(dCostNew < dCost) {
+                const double dImprovement = (dCost - dCostNew) / dData2;
+                vecPos = vecPosNew;
+                vecMom = vecMomNew;
+                vecRes.swap(vecResNew);
+                dCost = dCostNew;
+                dLambda = std::max(0.1 * dLambda, 1e-12);
+                bAccepted = dImprovement >= m_fAbortError && vecDelta.head<3>().cwiseAbs().maxCoeff() >= LM_STEP_TOL;
+                break;
+            }
+            dLambda *= 10.0;
+        }
+
+        // Either converged or no further descent step
+        if(!bAccepted) {
+            break;
+        }
+    }
+
+    this->m_coilPos = vecPos.transpose();
+    this->m_errorInfo.error = dCost / dData2;
+    this->m_errorInfo.moment = vecMom;
+    this->m_errorInfo.numIterations = iItr;
+}
+
+//=============================================================================================================
+
+void InvHpiFitData::magneticDipoleField(const Eigen::Vector3d& vecPos,
+                                        const Eigen::Vector3d& vecMoment,
+                                        const InvSensorSet& sensors,
+                                        Eigen::MatrixXd& matLf,
+                                        Eigen::MatrixXd* pMatGrad)
+{
+    const double u0 = 1e-7;
+    const int iNp = sensors.np();
+    const Eigen::MatrixXd& matRmag = sensors.rmag();
+    const Eigen::MatrixXd& matCosmag = sensors.cosmag();
+    const Eigen::RowVectorXd& vecW = sensors.w();
+
+    matLf.setZero(sensors.ncoils(), 3);
+    if(pMatGrad) {
+        pMatGrad->setZero(sensors.ncoils(), 3);
+    }
+
+    for(int i = 0; i < sensors.ncoils(); ++i) {
+        for(int p = 0; p < iNp; ++p) {
+            const int k = i * iNp + p;
+            const Eigen::Vector3d r = matRmag.row(k).transpose() - vecPos;
+            const Eigen::Vector3d c = matCosmag.row(k).transpose();
+            const double dW = u0 * vecW(k);
+            const double r2 = r.squaredNorm();
+            const double dInvR5 = 1.0 / (r2 * r2 * std::sqrt(r2));
+            const double rc = r.dot(c);
+
+            // b = c' * (3 r r' - r^2 I) / r^5 * m
+            matLf.row(i) += (dW * dInvR5 * (3.0 * rc * r - r2 * c)).transpose();
+
+            if(pMatGrad) {
+                // Gradient of b with respect to r; the dipole position enters as -r
+                const double rm = r.dot(vecMoment);
+                const double cm = c.dot(vecMoment);
+                const double b = (3.0 * rc * rm - r2 * cm) * dInvR5;
+                const Eigen::Vector3d vecGradR = (3.0 * rm * c + 3.0 * rc * vecMoment - 2.0 * cm * r) * dInvR5 - (5.0 * b / r2) * r;
+                pMatGrad->row(i) -= dW * vecGradR.transpose();
+            }
+        }
+    }
+}
+
+//=============================================================================================================
+
+DipFitError InvHpiFitData::fitRigidBody(const Eigen::MatrixXd& matCoilsHead,
+                                        const Eigen::MatrixXd& matData,
+                                        const InvSensorSet& sensors,
+                                        const Eigen::MatrixXd& matProjectors,
+                                        Eigen::Matrix4d& matTrans,
+                                        int iMaxIterations,
+                                        float fAbortError)
+{
+    const int iNumCoils = matCoilsHead.rows();
+    const int iNumParams = 6 + 3 * iNumCoils;
+    const double dData2 = matData.squaredNorm();
+
+    // head = R * dev + t, so the coils sit at R' * (head - t) in device space
+    Eigen::Matrix3d matR = matTrans.block<3,3>(0,0);
+    Eigen::Vector3d vecT = matTrans.block<3,1>(0,3);
+    auto devicePos = [&matCoilsHead](const Eigen::Matrix3d& R, const Eigen::Vector3d& t, int j) {
+        return Eigen::Vector3d(R.transpose() * (matCoilsHead.row(j).transpose() - t));
+    };
+
+    Eigen::MatrixXd matLf, matGrad;
+    Eigen::MatrixXd matMom(3, iNumCoils);
+    double dCost = 0.0;
+    for(int j = 0; j < iNumCoils; ++j) {
+        magneticDipoleField(devicePos(matR, vecT, j), Eigen::Vector3d::Zero(), sensors, matLf);
+        const Eigen::MatrixXd matA = matProjectors * matLf;
+        matMom.col(j) = matA.colPivHouseholderQr().solve(matData.col(j));
+        dCost += (matData.col(j) - matA * matMom.col(j)).squaredNorm();
+    }
+
+    auto cost = [&](const Eigen::Matrix3d& R, const Eigen::Vector3d& t, const Eigen::MatrixXd& matM) {
+        double dSum = 0.0;
+        Eigen::MatrixXd matL;
+        for(int j = 0; j < iNumCoils; ++j) {
+            magneticDipoleField(devicePos(R, t, j), matM.col(j), sensors, matL);
+            dSum += (matData.col(j) - matProjectors * (matL * matM.col(j))).squaredNorm();
+        }
+        return dSum;
+    };
+
+    double dLambda = LM_LAMBDA_START;
+    Eigen::MatrixXd matJ(matData.rows(), iNumParams);
+    int iItr = 0;
+
+    while(iItr < iMaxIterations) {
+        ++iItr;
+
+        // Parameters: small rotation w (R <- exp([w]x) R), translation step, moment steps
+        Eigen::MatrixXd matH = Eigen::MatrixXd::Zero(iNumParams, iNumParams);
+        Eigen::VectorXd vecG = Eigen::VectorXd::Zero(iNumParams);
+        for(int j = 0; j < iNumCoils; ++j) {
+            const Eigen::Vector3d vecMom = matMom.col(j);
+            magneticDipoleField(devicePos(matR, vecT, j), vecMom, sensors, matLf, &matGrad);
+            const Eigen::MatrixXd matA = matProjectors * matLf;
+            const Eigen::MatrixXd matB = matProjectors * matGrad;
+            const Eigen::VectorXd vecRes = matData.col(j) - matA * vecMom;
+            const Eigen::Vector3d vecU = matCoilsHead.row(j).transpose() - vecT;
+
+            matJ.setZero();
+            matJ.leftCols(3).noalias() = -matB * (matR.transpose() * crossMatrix(vecU));
+            matJ.middleCols(3,3).noalias() = matB * matR.transpose();
+            matJ.middleCols(6 + 3 * j, 3) = -matA;
+            matH.noalias() += matJ.transpose() * matJ;
+            vecG.noalias() += matJ.transpose() * vecRes;
+        }
+
+        bool bAccepted = false;
+        while(dLambda < LM_LAMBDA_MAX) {
+            Eigen::MatrixXd matHd = matH;
+            matHd.diagonal() *= 1.0 + dLambda;
+            const Eigen::VectorXd vecDelta = matHd.ldlt().solve(-vecG);
+
+            const Eigen::Vector3d vecW = vecDelta.head<3>();
+            const double dAngle = vecW.norm();
+            const Eigen::Matrix3d matRNew = dAngle > 0.0 ? Eigen::Matrix3d(Eigen::AngleAxisd(dAngle, vecW / dAngle) * matR) : matR;
+            const Eigen::Vector3d vecTNew = vecT + vecDelta.segment<3>(3);
+            Eigen::MatrixXd matMomNew = matMom;
+            for(int j = 0; j < iNumCoils; ++j) {
+                matMomNew.col(j) += vecDelta.segment<3>(6 + 3 * j);
+            }
+
+            const double dCostNew = cost(matRNew, vecTNew, matMomNew);
+            if(dCostNew < dCost) {
+                // Largest coil displacement of this step, the coils are about 0.1 m from the origin
+                const double dStep = std::max(vecDelta.segment<3>(3).cwiseAbs().maxCoeff(), 0.1 * vecW.cwiseAbs().maxCoeff());
+                const double dImprovement = (dCost - dCostNew) / dData2;
+                matR = matRNew;
+                vecT = vecTNew;
+                matMom.swap(matMomNew);
+                dCost = dCostNew;
+                dLambda = std::max(0.1 * dLambda, 1e-12);
+                bAccepted = dImprovement >= fAbortError && dStep >= LM_STEP_TOL;
+                break;
+            }
+            dLambda *= 10.0;
+        }
+
+        if(!bAccepted) {
+            break;
+        }
+    }
+
+    matTrans.setIdentity();
+    matTrans.block<3,3>(0,0) = matR;
+    matTrans.block<3,1>(0,3) = vecT;
+
+    DipFitError e;
+    e.error = dCost / dData2;
+    e.moment = matMom;
+    e.numIterations = iItr;
+    return e;
+}
+
+//=============================================================================================================
+
 Eigen::MatrixXd InvHpiFitData::magnetic_dipole(Eigen::MatrixXd matPos,
                                             Eigen::MatrixXd matPnt,
                                             Eigen::MatrixXd matOri)
@@ -14,7 +14,9 @@
  * leadfield in an infinite homogeneous medium, evaluates the residual
  * between the model field and the measured projection, and runs a
  * Nelder-Mead simplex search (@c fminsearch) to refine the coil
- * position. Helper structs @ref DipFitError and @ref HPISortStruct
+ * position; alternatively a Levenberg-Marquardt search with analytic
+ * Jacobians refines each coil, or all coils at once through the rigid
+ * device-to-head transformation. Helper structs @ref DipFitError and @ref HPISortStruct
  * carry per-iteration diagnostics and the post-fit coil-ordering
  * metadata. The leadfield and fit-error routines are validated against
  * the FieldTrip @c magnetic_dipole / @c ft_compute_leadfield reference
@@ -119,6 +121,56 @@ public:
      */
     void doDipfitConcurrent();
 
+    //=========================================================================================================
+    /**
+     * Fits position and moment of the coil dipole with Levenberg-Marquardt iterations on the analytic Jacobian.
+     * Uses the same members as doDipfitConcurrent: starts at m_coilPos and stores the fitted position, the
+     * residual error and the number of iterations.
+     */
+    void doDipfitLevenbergMarquardt();
+
+    //=========================================================================================================
+    /**
+     * Computes the leadfield of a magnetic dipole in an infinite medium, integrated over the integration points
+     * of each sensor, and optionally the derivative of the field of a given moment with respect to the dipole
+     * position.
+     *
+     * @param[in]  vecPos       The dipole position.
+     * @param[in]  vecMoment    The dipole moment, only used for the derivative.
+     * @param[in]  sensors      The sensors.
+     * @param[out] matLf        The leadfield (n_sensors x 3).
+     * @param[out] pMatGrad     If not nullptr, the derivative of matLf * vecMoment with respect to vecPos (n_sensors x 3).
+     */
+    static void magneticDipoleField(const Eigen::Vector3d& vecPos,
+                                    const Eigen::Vector3d& vecMoment,
+                                    const InvSensorSet& sensors,
+                                    Eigen::MatrixXd& matLf,
+                                    Eigen::MatrixXd* pMatGrad = nullptr);
+
+    //=========================================================================================================
+    /**
+     * Fits the device to head transformation jointly to the data of all coils with Levenberg-Marquardt
+     * iterations. The coil positions in device space follow from the digitized positions through the
+     * transformation, so the parameters are the six rigid-body parameters plus one moment per coil.
+     *
+     * @param[in]     matCoilsHead      The digitized coil positions in head space (n_coils x 3).
+     * @param[in]     matData           The coil amplitudes, one column per digitized coil (n_sensors x n_coils).
+     * @param[in]     sensors           The sensors.
+     * @param[in]     matProjectors     The projectors to apply.
+     * @param[in,out] matTrans          The device to head transformation: the initial value on input, the fit on output.
+     * @param[in]     iMaxIterations    The maximum number of iterations.
+     * @param[in]     fAbortError       Stop when the relative residual error improves by less than this.
+     *
+     * @return The relative residual error over all coils, the moments (3 x n_coils) and the number of iterations.
+     */
+    static DipFitError fitRigidBody(const Eigen::MatrixXd& matCoilsHead,
+                                    const Eigen::MatrixXd& matData,
+                                    const InvSensorSet& sensors,
+                                    const Eigen::MatrixXd& matProjectors,
+                                    Eigen::Matrix4d& matTrans,
+                                    int iMaxIterations,
+                                    float fAbortError);
+
     Eigen::MatrixXd         m_coilPos;
     Eigen::RowVectorXd      m_sensorData;
     DipFitError             m_errorInfo;
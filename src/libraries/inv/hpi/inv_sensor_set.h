@@ -99,16 +99,16 @@ public:
     inline Eigen::MatrixXd r0() const;
 
     inline Eigen::MatrixXd rmag(int iSensor) const;
-    inline Eigen::MatrixXd rmag() const;
+    inline const Eigen::MatrixXd& rmag() const;
 
     inline Eigen::MatrixXd cosmag(int iSensor) const;
-    inline Eigen::MatrixXd cosmag() const;
+    inline const Eigen::MatrixXd& cosmag() const;
 
     inline Eigen::MatrixXd tra(int iSensor) const;
     inline Eigen::MatrixXd tra() const;
 
     inline Eigen::RowVectorXd w(int iSensor) const;
-    inline Eigen::RowVectorXd w() const;
+    inline const Eigen::RowVectorXd& w() const;
 
     inline bool operator== (const InvSensorSet &b) const;
     inline bool operator!= (const InvSensorSet &b) const;
@@ -179,7 +179,7 @@ inline Eigen::RowVectorXd InvSensorSet::w(int iSensor) const
     return m_w.segment(iSensor*m_np,m_np);
 }
 
-inline Eigen::RowVectorXd InvSensorSet::w() const
+inline const Eigen::RowVectorXd& InvSensorSet::w() const
 {
     return m_w;
 }
@@ -189,7 +189,7 @@ inline Eigen::MatrixXd InvSensorSet::rmag(int iSensor) const
     return m_rmag.block(iSensor*m_np,0,m_np,3);
 }
 
-inline Eigen::MatrixXd InvSensorSet::rmag() const
+inline const Eigen::MatrixXd& InvSensorSet::rmag() const
 {
     return m_rmag;
 }
@@ -199,7 +199,7 @@ inline Eigen::MatrixXd InvSensorSet::cosmag(int iSensor) const
     return m_cosmag.block(iSensor*m_np,0,m_np,3);
 }
 
-inline Eigen::MatrixXd InvSensorSet::cosmag() const
+inline const Eigen::MatrixXd& InvSensorSet::cosmag() const
 {
     return m_cosmag;
 }
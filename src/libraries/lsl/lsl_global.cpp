@@ -25,6 +25,12 @@
 
 #include "lsl_global.h"
 
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <chrono>
+
 //=============================================================================================================
 // DEFINE METHODS
 //=============================================================================================================
@@ -38,3 +44,10 @@ const char* LSLLIB::buildHash(){ return UTILSLIB::gitHash();}
 //=============================================================================================================
 
 const char* LSLLIB::buildHashLong(){ return UTILSLIB::gitHashLong();}
+
+//=============================================================================================================
+
+double LSLLIB::local_clock()
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
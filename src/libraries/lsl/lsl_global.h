@@ -80,6 +80,13 @@ LSLSHARED_EXPORT const char* buildHash();
  */
 LSLSHARED_EXPORT const char* buildHashLong();
 
+//=============================================================================================================
+/**
+ * Returns the local monotonic clock in seconds, the time base of the receive time stamps of stream_inlet.
+ * The origin is arbitrary; only differences between two readings are meaningful.
+ */
+LSLSHARED_EXPORT double local_clock();
+
 } // namespace LSLLIB
 
 #endif // LSL_GLOBAL_H
@@ -14,9 +14,13 @@
  * stored in the @ref LSLLIB::stream_info, draining pending bytes on
  * every @c samples_available probe, and reassembling them into
  * fixed-width multichannel samples sized by @c channel_count *
- * @c sizeof(float). Partial samples observed at the end of a
- * @c readAll buffer are kept in a residual byte buffer and prepended
- * to the next read so that no sample is ever split across calls.
+ * @c sizeof(float). The socket is read straight into a power-of-two
+ * byte ring that is allocated once and only grows when a burst
+ * exceeds its capacity; partial samples at the write end simply stay
+ * in the ring until the rest arrives, so no sample is ever split
+ * across calls and consumed bytes are never moved. Every socket read
+ * records its local_clock() time against the ring position it
+ * reached, which yields the receive time stamp of each sample.
  *
  * The public @ref LSLLIB::stream_inlet methods are thin forwarding
  * shims that delegate to the PIMPL, which lets the public header
@@ -38,12 +42,16 @@
 #include <QTcpSocket>
 #include <QByteArray>
 #include <QDebug>
+#include <QtGlobal>
 
 //=============================================================================================================
 // STL INCLUDES
 //=============================================================================================================
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
+#include <deque>
 #include <stdexcept>
 
 //=============================================================================================================
@@ -52,6 +60,125 @@
 
 using namespace LSLLIB;
 
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+/**
+ * Initial capacity of the receive ring: 64 KiB holds e.g. 64 samples of 256 channels.
+ */
+constexpr std::size_t RING_INITIAL_CAPACITY = 64 * 1024;
+
+//=============================================================================================================
+/**
+ * @internal
+ * @brief Growable power-of-two byte ring addressed by monotonically increasing read and write positions.
+ */
+class ByteRing
+{
+public:
+    std::size_t size() const { return static_cast<std::size_t>(m_iWritePos - m_iReadPos); }
+
+    quint64 readPos() const { return m_iReadPos; }
+
+    quint64 writePos() const { return m_iWritePos; }
+
+    //=========================================================================================================
+    /**
+     * Makes room for iBytes more bytes, keeping the buffered ones. Only reallocates if the ring is too small.
+     */
+    void reserve(std::size_t iBytes)
+    {
+        const std::size_t iNeeded = size() + iBytes;
+        if (iNeeded <= m_vData.size()) {
+            return;
+        }
+
+        std::size_t iCapacity = std::max(m_vData.size(), RING_INITIAL_CAPACITY);
+        while (iCapacity < iNeeded) {
+            iCapacity *= 2;
+        }
+
+        // The positions stay totals, so the buffered bytes move to where the larger capacity maps them. Ring
+        // positions remembered elsewhere, e.g. those of the arrivals, remain valid.
+        std::vector<char> vData(iCapacity);
+        const std::size_t iSize = size();
+        const std::size_t iOffset = static_cast<std::size_t>(m_iReadPos) & (iCapacity - 1);
+        const std::size_t iFirst = std::min(iSize, iCapacity - iOffset);
+        copy(m_iReadPos, vData.data() + iOffset, iFirst);
+        copy(m_iReadPos + iFirst, vData.data(), iSize - iFirst);
+        m_vData.swap(vData);
+    }
+
+    //=========================================================================================================
+    /**
+     * Contiguous free space at the write position. Its length is 0 only if the ring is full.
+     */
+    char* writePtr(std::size_t& iLength)
+    {
+        const std::size_t iCapacity = m_vData.size();
+        const std::size_t iOffset = static_cast<std::size_t>(m_iWritePos) & (iCapacity - 1);
+        iLength = std::min(iCapacity - iOffset, iCapacity - size());
+        return m_vData.data() + iOffset;
+    }
+
+    void commit(std::size_t iBytes) { m_iWritePos += iBytes; }
+
+    //=========================================================================================================
+    /**
+     * Copies iBytes from the read position into pDst (if not nullptr) and releases them.
+     */
+    void read(char* pDst, std::size_t iBytes)
+    {
+        if (pDst) {
+            copy(m_iReadPos, pDst, iBytes);
+        }
+        m_iReadPos += iBytes;
+    }
+
+    void clear()
+    {
+        m_iReadPos = 0;
+        m_iWritePos = 0;
+    }
+
+private:
+    //=========================================================================================================
+    /**
+     * Copies the iBytes buffered bytes starting at the total position iPos into pDst.
+     */
+    void copy(quint64 iPos, char* pDst, std::size_t iBytes) const
+    {
+        if (iBytes == 0) {
+            return;
+        }
+        const std::size_t iCapacity = m_vData.size();
+        const std::size_t iOffset = static_cast<std::size_t>(iPos) & (iCapacity - 1);
+        const std::size_t iFirst = std::min(iBytes, iCapacity - iOffset);
+        std::memcpy(pDst, m_vData.data() + iOffset, iFirst);
+        std::memcpy(pDst + iFirst, m_vData.data(), iBytes - iFirst);
+    }
+
+    std::vector<char>   m_vData;            /**< Storage, empty or a power of two in size. */
+    quint64             m_iReadPos = 0;     /**< Total number of bytes consumed. */
+    quint64             m_iWritePos = 0;    /**< Total number of bytes received. */
+};
+
+//=============================================================================================================
+/**
+ * @internal
+ * @brief Ring position reached by one socket read and the time at which the read returned.
+ */
+struct Arrival
+{
+    quint64 iEndPos;    /**< Write position after the read. */
+    double  dTime;      /**< local_clock() after the read. */
+};
+
+} // anonymous namespace
+
 //=============================================================================================================
 // PRIVATE IMPLEMENTATION
 //=============================================================================================================
@@ -162,34 +289,53 @@ public:
             m_pSocket = nullptr;
         }
         m_bIsOpen = false;
-        m_rawBuffer.clear();
+        m_ring.clear();
+        m_arrivals.clear();
     }
 
     //=========================================================================================================
     /**
-     * Try to read pending data from the TCP socket into the raw byte buffer (non-blocking).
+     * Read all pending data from the TCP socket into the ring buffer.
+     *
+     * @param[in] iTimeoutMs    Time to wait for data if none is pending. Default: 0 (non-blocking).
      *
      * @return True if at least one complete sample is available in the buffer.
      */
-    bool readPending()
+    bool readPending(int iTimeoutMs = 0)
     {
         if (!m_bIsOpen || !m_pSocket) {
             return false;
         }
 
-        // Non-blocking check for available data
-        if (m_pSocket->bytesAvailable() > 0 || m_pSocket->waitForReadyRead(0)) {
-            QByteArray data = m_pSocket->readAll();
-            m_rawBuffer.append(data);
+        qint64 iAvailable = m_pSocket->bytesAvailable();
+        if (iAvailable == 0 && m_pSocket->waitForReadyRead(iTimeoutMs)) {
+            iAvailable = m_pSocket->bytesAvailable();
+        }
+
+        if (iAvailable > 0) {
+            m_ring.reserve(static_cast<std::size_t>(iAvailable));
+
+            while (iAvailable > 0) {
+                std::size_t iLength = 0;
+                char* pDst = m_ring.writePtr(iLength);
+                const qint64 iRead = m_pSocket->read(pDst, std::min<qint64>(static_cast<qint64>(iLength), iAvailable));
+                if (iRead <= 0) {
+                    break;
+                }
+                m_ring.commit(static_cast<std::size_t>(iRead));
+                iAvailable -= iRead;
+            }
+
+            m_arrivals.push_back({m_ring.writePos(), local_clock()});
         }
 
         // A complete sample requires m_iBytesPerSample bytes
-        return (m_iBytesPerSample > 0) && (m_rawBuffer.size() >= m_iBytesPerSample);
+        return (m_iBytesPerSample > 0) && (m_ring.size() >= static_cast<std::size_t>(m_iBytesPerSample));
     }
 
     //=========================================================================================================
     /**
-     * Extract all complete samples from the byte buffer as a chunk.
+     * Extract all complete samples from the ring buffer as a chunk.
      *
      * @return Vector of samples, each sample is a vector of float channel values.
      */
@@ -208,34 +354,95 @@ public:
             return chunk;
         }
 
-        // Extract complete samples from the buffer
-        int nCompleteSamples = m_rawBuffer.size() / m_iBytesPerSample;
-        if (nCompleteSamples == 0) {
-            return chunk;
-        }
-
+        const std::size_t iBytesPerSample = static_cast<std::size_t>(m_iBytesPerSample);
+        const std::size_t nCompleteSamples = m_ring.size() / iBytesPerSample;
         chunk.reserve(nCompleteSamples);
-        const char* ptr = m_rawBuffer.constData();
 
-        for (int s = 0; s < nCompleteSamples; ++s) {
+        for (std::size_t s = 0; s < nCompleteSamples; ++s) {
             std::vector<float> sample(m_iChannelCount);
-            std::memcpy(sample.data(), ptr + s * m_iBytesPerSample, m_iBytesPerSample);
+            m_ring.read(reinterpret_cast<char*>(sample.data()), iBytesPerSample);
             chunk.push_back(std::move(sample));
         }
-
-        // Remove consumed bytes from the buffer
-        int consumedBytes = nCompleteSamples * m_iBytesPerSample;
-        m_rawBuffer.remove(0, consumedBytes);
+        releaseArrivals();
 
         return chunk;
     }
 
+    //=========================================================================================================
+    /**
+     * Copy complete samples from the ring buffer into a channel-interleaved caller buffer.
+     *
+     * @return The number of floats written.
+     */
+    std::size_t pullChunkMultiplexed(float* pData,
+                                     double* pTimestamps,
+                                     std::size_t iDataElements,
+                                     std::size_t iTimestampElements,
+                                     double dTimeout)
+    {
+        if (!m_bIsOpen || !m_pSocket || m_iChannelCount <= 0 || !pData) {
+            return 0;
+        }
+
+        const std::size_t iChannels = static_cast<std::size_t>(m_iChannelCount);
+        const std::size_t iBytesPerSample = static_cast<std::size_t>(m_iBytesPerSample);
+        if (iDataElements % iChannels != 0) {
+            throw std::runtime_error("[lsl::stream_inlet] The data buffer size is not a multiple of the channel count");
+        }
+        if (pTimestamps && iTimestampElements != iDataElements / iChannels) {
+            throw std::runtime_error("[lsl::stream_inlet] The time stamp buffer size does not match the data buffer size");
+        }
+
+        bool bAvailable = readPending();
+        if (!bAvailable && dTimeout > 0.0) {
+            const double dDeadline = local_clock() + dTimeout;
+            for (double dNow = local_clock(); !bAvailable && dNow < dDeadline; dNow = local_clock()) {
+                bAvailable = readPending(std::max(1, static_cast<int>(std::ceil((dDeadline - dNow) * 1000.0))));
+            }
+        }
+
+        const std::size_t nSamples = std::min(m_ring.size() / iBytesPerSample, iDataElements / iChannels);
+        if (nSamples == 0) {
+            return 0;
+        }
+
+        if (pTimestamps) {
+            // Arrivals are ordered by ring position; each sample takes the time of the read that completed it
+            auto itArrival = m_arrivals.cbegin();
+            quint64 iEndPos = m_ring.readPos();
+            for (std::size_t s = 0; s < nSamples; ++s) {
+                iEndPos += iBytesPerSample;
+                while (itArrival->iEndPos < iEndPos) {
+                    ++itArrival;
+                }
+                pTimestamps[s] = itArrival->dTime;
+            }
+        }
+
+        m_ring.read(reinterpret_cast<char*>(pData), nSamples * iBytesPerSample);
+        releaseArrivals();
+
+        return nSamples * iChannels;
+    }
+
+    //=========================================================================================================
+    /**
+     * Drop the arrival records whose bytes have all been consumed.
+     */
+    void releaseArrivals()
+    {
+        while (!m_arrivals.empty() && m_arrivals.front().iEndPos <= m_ring.readPos()) {
+            m_arrivals.pop_front();
+        }
+    }
+
     stream_info     m_info;             /**< The stream info for this inlet. */
     QTcpSocket*     m_pSocket;          /**< TCP socket for data reception. */
     bool            m_bIsOpen;          /**< Whether the stream is currently open. */
     int             m_iChannelCount;    /**< Number of channels. */
     int             m_iBytesPerSample;  /**< Bytes per sample (channels * sizeof(float)). */
-    QByteArray      m_rawBuffer;        /**< Raw byte buffer for incoming TCP data. */
+    ByteRing        m_ring;             /**< Receive ring buffer for incoming TCP data. */
+    std::deque<Arrival> m_arrivals;     /**< Ring positions and times of the socket reads not yet fully consumed. */
 };
 
 //=============================================================================================================
@@ -281,3 +488,25 @@ std::vector<std::vector<float>> stream_inlet::pull_chunk_float()
 {
     return m_pImpl->pullChunkFloat();
 }
+
+//=============================================================================================================
+
+std::size_t stream_inlet::pull_chunk_multiplexed(float* data_buffer,
+                                                 double* timestamp_buffer,
+                                                 std::size_t data_buffer_elements,
+                                                 std::size_t timestamp_buffer_elements,
+                                                 double timeout)
+{
+    return m_pImpl->pullChunkMultiplexed(data_buffer,
+                                         timestamp_buffer,
+                                         data_buffer_elements,
+                                         timestamp_buffer_elements,
+                                         timeout);
+}
+
+//=============================================================================================================
+
+int stream_inlet::channel_count() const
+{
+    return m_pImpl->m_iChannelCount;
+}
@@ -28,6 +28,13 @@
  * source-level compatibility with liblsl; in this implementation
  * only the @c float specialisation is wired up, since every mne-cpp
  * acquisition path operates on 32-bit floating-point samples.
+ *
+ * For high channel counts or rates, @ref pull_chunk_multiplexed
+ * copies the received samples straight from the receive ring buffer
+ * into a caller-provided buffer in channel-interleaved order, which is
+ * the memory layout of a column-major channels x samples matrix (e.g.
+ * @c Eigen::MatrixXf::data()), and reports a receive time stamp per
+ * sample. No per-sample allocation takes place on this path.
  */
 
 #ifndef LSL_STREAM_INLET_H
@@ -44,6 +51,7 @@
 // STL INCLUDES
 //=============================================================================================================
 
+#include <cstddef>
 #include <vector>
 #include <memory>
 #include <type_traits>
@@ -59,7 +67,7 @@ namespace LSLLIB {
 //=============================================================================================================
 
 /**
- * @brief PIMPL backend of stream_inlet that owns the QTcpSocket and the per-sample reassembly buffer.
+ * @brief PIMPL backend of stream_inlet that owns the QTcpSocket and the receive ring buffer.
  */
 class StreamInletPrivate;
 
@@ -134,6 +142,43 @@ public:
      */
     [[nodiscard]] std::vector<std::vector<float>> pull_chunk_float();
 
+    //=========================================================================================================
+    /**
+     * Pull a chunk of samples into a caller-provided buffer, channel-interleaved (multiplexed).
+     *
+     * Sample k of the chunk occupies data_buffer[k * channel_count() ... (k + 1) * channel_count() - 1], so the
+     * buffer of a column-major channels x samples matrix (e.g. Eigen::MatrixXf::data()) can be passed directly.
+     * The samples are copied from the receive ring buffer without any intermediate allocation. As many complete
+     * samples as are buffered, and as fit into data_buffer, are returned.
+     *
+     * The wire protocol carries no time stamps; each sample is stamped with the local_clock() time at which the
+     * socket read that completed it returned.
+     *
+     * @param[out] data_buffer                  Destination of the samples.
+     * @param[out] timestamp_buffer             Destination of one time stamp per sample, or nullptr.
+     * @param[in] data_buffer_elements          Capacity of data_buffer in floats; a multiple of channel_count().
+     * @param[in] timestamp_buffer_elements     Capacity of timestamp_buffer; must be data_buffer_elements /
+     *                                          channel_count() if timestamp_buffer is given.
+     * @param[in] timeout                       Maximum time (in seconds) to wait if no complete sample is
+     *                                          buffered. Default: 0.0 (do not wait).
+     * @return                                  The number of floats written (samples * channel_count()).
+     *
+     * @throws std::runtime_error if the buffer sizes are inconsistent with the channel count.
+     */
+    std::size_t pull_chunk_multiplexed(float* data_buffer,
+                                       double* timestamp_buffer,
+                                       std::size_t data_buffer_elements,
+                                       std::size_t timestamp_buffer_elements,
+                                       double timeout = 0.0);
+
+    //=========================================================================================================
+    /**
+     * Number of channels per sample, as announced by the outlet on open_stream().
+     *
+     * @return The channel count.
+     */
+    [[nodiscard]] int channel_count() const;
+
 private:
     /** Opaque implementation pointer (PIMPL). */
     std::unique_ptr<StreamInletPrivate> m_pImpl;
@@ -19,12 +19,17 @@
  * incomplete at the header).
  *
  * @c load opens the file with @c GraphOptimizationLevel::ORT_ENABLE_ALL,
- * forces a single intra-op thread for deterministic output, disables
- * memory patterns to keep peak RSS small, and caches input/output node
- * names and shapes once so @c predict only pays for the actual
- * @c Session::Run call. @c predict builds a zero-copy @c Ort::Value over
- * the @ref MLLIB::MlTensor buffer, runs the session, and copies the
- * first output back into an owning tensor. @c save is intentionally a
+ * uses a single intra-op thread for deterministic output unless
+ * @c setThreadCount asks for more, disables memory patterns to keep
+ * peak RSS small, and caches input/output node names and shapes once
+ * so @c predict only pays for the actual @c Session::Run call. Every
+ * run builds a zero-copy @c Ort::Value over the @ref MLLIB::MlTensor
+ * buffer and binds it with a per-call @c Ort::IoBinding. When the
+ * output shape follows from the cached one (only the batch axis being
+ * dynamic) the caller's output buffer is bound as well, so ONNX Runtime
+ * writes into it directly; otherwise ORT allocates the output and it
+ * is copied once. @c Session::Run is thread-safe, so inference only
+ * takes the read side of the session lock. @c save is intentionally a
  * no-op: ONNX graphs are produced by their training framework, not by
  * this thin inference wrapper.
  */
@@ -45,11 +50,16 @@
 
 #include <QDebug>
 #include <QFileInfo>
+#include <QReadLocker>
+#include <QWriteLocker>
 
 //=============================================================================================================
 // STL INCLUDES
 //=============================================================================================================
 
+#include <algorithm>
+#include <functional>
+#include <numeric>
 #include <stdexcept>
 
 //=============================================================================================================
@@ -63,11 +73,104 @@ using namespace MLLIB;
 //=============================================================================================================
 
 #ifdef MNE_USE_ONNXRUNTIME
+namespace {
+
+int64_t elementCount(const std::vector<int64_t>& shape)
+{
+    return std::accumulate(shape.begin(), shape.end(), int64_t(1), std::multiplies<int64_t>());
+}
+
+} // anonymous namespace
+
+//=============================================================================================================
+
 Ort::Env& MlOnnxModel::ortEnv()
 {
     static Ort::Env env(ORT_LOGGING_LEVEL_WARNING, "mne-cpp");
     return env;
 }
+
+//=============================================================================================================
+
+std::vector<int64_t> MlOnnxModel::outputShape(const std::vector<int64_t>& inputShape) const
+{
+    // A dynamic leading axis is the batch axis and follows the input; any other dynamic axis is unknown
+    if (m_outputShapes.empty()) {
+        return {};
+    }
+
+    std::vector<int64_t> shape = m_outputShapes.front();
+    for (size_t i = 0; i < shape.size(); ++i) {
+        if (shape[i] < 0) {
+            if (i > 0 || inputShape.empty()) {
+                return {};
+            }
+            shape[0] = inputShape[0];
+        }
+    }
+    return shape;
+}
+
+//=============================================================================================================
+
+void MlOnnxModel::run(const float* pInput, const std::vector<int64_t>& inputShape, MlTensor& output) const
+{
+    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
+        *m_memoryInfo,
+        const_cast<float*>(pInput),
+        static_cast<size_t>(elementCount(inputShape)),
+        inputShape.data(),
+        inputShape.size());
+
+    // One binding per call: the session is shared, the binding is not
+    Ort::IoBinding binding(*m_session);
+    binding.BindInput(m_inputNames.front().c_str(), inputTensor);
+
+    const std::vector<int64_t> shape = outputShape(inputShape);
+    const bool bPreallocated = !shape.empty();
+    Ort::Value outputTensor(nullptr);
+
+    if (bPreallocated) {
+        if (output.empty()) {
+            output = MlTensor(std::vector<float>(static_cast<size_t>(elementCount(shape))), shape);
+        } else if (output.size() != elementCount(shape)) {
+            throw std::runtime_error("MlOnnxModel::predict – Output tensor size does not match the model output.");
+        }
+        outputTensor = Ort::Value::CreateTensor<float>(
+            *m_memoryInfo,
+            output.data(),
+            static_cast<size_t>(output.size()),
+            shape.data(),
+            shape.size());
+        binding.BindOutput(m_outputNames.front().c_str(), outputTensor);
+    } else {
+        binding.BindOutput(m_outputNames.front().c_str(), *m_memoryInfo);
+    }
+
+    Ort::RunOptions runOpts;
+    m_session->Run(runOpts, binding);
+
+    if (bPreallocated) {
+        return;
+    }
+
+    std::vector<Ort::Value> outputTensors = binding.GetOutputValues();
+    if (outputTensors.empty() || !outputTensors[0].IsTensor()) {
+        throw std::runtime_error("MlOnnxModel::predict – Model produced no valid output tensor.");
+    }
+
+    // Extract output shape and data — copy into the output tensor
+    std::vector<int64_t> resultShape = outputTensors[0].GetTensorTypeAndShapeInfo().GetShape();
+    const float* outputData = outputTensors[0].GetTensorData<float>();
+
+    if (output.empty()) {
+        output = MlTensor(outputData, std::move(resultShape));
+    } else if (output.size() == elementCount(resultShape)) {
+        std::copy(outputData, outputData + output.size(), output.data());
+    } else {
+        throw std::runtime_error("MlOnnxModel::predict – Output tensor size does not match the model output.");
+    }
+}
 #endif
 
 //=============================================================================================================
@@ -88,57 +191,151 @@ MlOnnxModel::~MlOnnxModel()
 //=============================================================================================================
 
 MlTensor MlOnnxModel::predict(const MlTensor& input) const
+{
+    MlTensor output;
+    predictInto(input, output);
+    return output;
+}
+
+//=============================================================================================================
+
+void MlOnnxModel::predictInto(const MlTensor& input, MlTensor& output) const
 {
 #ifdef MNE_USE_ONNXRUNTIME
+    QReadLocker locker(&m_sessionLock);
+
     if (!m_session) {
         throw std::runtime_error("MlOnnxModel::predict – No ONNX model loaded. Call load() first.");
     }
 
-    // Create input Ort::Value — zero-copy from MlTensor's row-major float buffer
-    auto inputShape = input.shape();
-    Ort::Value inputTensor = Ort::Value::CreateTensor<float>(
-        *m_memoryInfo,
-        const_cast<float*>(input.data()),
-        static_cast<size_t>(input.size()),
-        inputShape.data(),
-        inputShape.size());
+    run(input.data(), input.shape(), output);
+#else
+    Q_UNUSED(input);
+    Q_UNUSED(output);
+    throw std::runtime_error("ONNX Runtime not available. Build with -DUSE_ONNXRUNTIME=ON");
+#endif
+}
 
-    // Build C-string name arrays for Run()
-    std::vector<const char*> inputNamePtrs;
-    inputNamePtrs.reserve(m_inputNames.size());
-    for (const auto& n : m_inputNames)
-        inputNamePtrs.push_back(n.c_str());
+//=============================================================================================================
+
+MlTensor MlOnnxModel::predictBatch(const std::vector<MlTensor>& inputs, int iMaxBatchSize) const
+{
+    MlTensor output;
+    predictBatch(inputs, output, iMaxBatchSize);
+    return output;
+}
 
-    std::vector<const char*> outputNamePtrs;
-    outputNamePtrs.reserve(m_outputNames.size());
-    for (const auto& n : m_outputNames)
-        outputNamePtrs.push_back(n.c_str());
+//=============================================================================================================
 
-    // Run inference
-    Ort::RunOptions runOpts;
-    auto outputTensors = m_session->Run(
-        runOpts,
-        inputNamePtrs.data(), &inputTensor, inputNamePtrs.size(),
-        outputNamePtrs.data(), outputNamePtrs.size());
+void MlOnnxModel::predictBatch(const std::vector<MlTensor>& inputs, MlTensor& output, int iMaxBatchSize) const
+{
+#ifdef MNE_USE_ONNXRUNTIME
+    QReadLocker locker(&m_sessionLock);
 
-    if (outputTensors.empty() || !outputTensors[0].IsTensor()) {
-        throw std::runtime_error("MlOnnxModel::predict – Model produced no valid output tensor.");
+    if (!m_session) {
+        throw std::runtime_error("MlOnnxModel::predictBatch – No ONNX model loaded. Call load() first.");
+    }
+    if (inputs.empty()) {
+        return;
     }
 
-    // Extract output shape and data — copy into an owning MlTensor
-    auto outputInfo = outputTensors[0].GetTensorTypeAndShapeInfo();
-    std::vector<int64_t> outputShape = outputInfo.GetShape();
-    const float* outputData = outputTensors[0].GetTensorData<float>();
+    const std::vector<int64_t>& itemShape = inputs.front().shape();
+    if (itemShape.empty()) {
+        throw std::runtime_error("MlOnnxModel::predictBatch – Inputs need a leading batch axis.");
+    }
+    for (const MlTensor& input : inputs) {
+        if (input.shape() != itemShape) {
+            throw std::runtime_error("MlOnnxModel::predictBatch – All inputs must have the same shape.");
+        }
+    }
+
+    const int64_t iNumItems = static_cast<int64_t>(inputs.size());
+    const int64_t iItemSize = inputs.front().size();
+
+    // Stack everything into one run, unless the model's batch axis is fixed or the caller limits the batch
+    int64_t iItemsPerRun = iNumItems;
+    if (!m_inputShapes.empty() && !m_inputShapes.front().empty() && m_inputShapes.front()[0] >= 0) {
+        iItemsPerRun = 1;
+    }
+    if (iMaxBatchSize > 0) {
+        iItemsPerRun = std::min<int64_t>(iItemsPerRun, iMaxBatchSize);
+    }
+
+    // Output elements per input, known up front unless the output has dynamic axes besides the batch axis
+    const std::vector<int64_t> itemOutputShape = outputShape(itemShape);
+    int64_t iItemOutputSize = itemOutputShape.empty() ? 0 : elementCount(itemOutputShape);
+    if (!output.empty()) {
+        if (iItemOutputSize == 0 && output.size() % iNumItems == 0) {
+            iItemOutputSize = output.size() / iNumItems;
+        }
+        if (output.size() != iItemOutputSize * iNumItems) {
+            throw std::runtime_error("MlOnnxModel::predictBatch – Output tensor size does not match the model output.");
+        }
+    }
+
+    std::vector<float> vStacked;
+    std::vector<int64_t> runShape = itemShape;
+
+    for (int64_t iFirst = 0; iFirst < iNumItems; iFirst += iItemsPerRun) {
+        const int64_t iNum = std::min(iItemsPerRun, iNumItems - iFirst);
+        runShape[0] = itemShape[0] * iNum;
+
+        const float* pInput = inputs[iFirst].data();
+        if (iNum > 1) {
+            vStacked.resize(static_cast<size_t>(iNum * iItemSize));
+            for (int64_t i = 0; i < iNum; ++i) {
+                std::copy(inputs[iFirst + i].data(), inputs[iFirst + i].data() + iItemSize, vStacked.data() + i * iItemSize);
+            }
+            pInput = vStacked.data();
+        }
 
-    return MlTensor(outputData, std::move(outputShape));
+        if (output.empty()) {
+            // Nothing preallocated: the first run tells how large the stacked output is
+            MlTensor runOutput;
+            run(pInput, runShape, runOutput);
+
+            std::vector<int64_t> stackedShape = runOutput.shape();
+            if (stackedShape.empty() || runOutput.size() % iNum != 0 || stackedShape[0] % iNum != 0) {
+                throw std::runtime_error("MlOnnxModel::predictBatch – Model output has no batch axis to stack along.");
+            }
+            iItemOutputSize = runOutput.size() / iNum;
+
+            if (iNum == iNumItems) {
+                output = runOutput;
+            } else {
+                stackedShape[0] = stackedShape[0] / iNum * iNumItems;
+                output = MlTensor(std::vector<float>(static_cast<size_t>(iItemOutputSize * iNumItems)), stackedShape);
+                std::copy(runOutput.data(), runOutput.data() + runOutput.size(), output.data());
+            }
+        } else {
+            std::vector<int64_t> runOutputShape = outputShape(runShape);
+            if (runOutputShape.empty()) {
+                runOutputShape = {iNum * iItemOutputSize};
+            }
+            MlTensor runOutput = MlTensor::view(output.data() + iFirst * iItemOutputSize, std::move(runOutputShape));
+            run(pInput, runShape, runOutput);
+        }
+    }
 #else
-    Q_UNUSED(input);
+    Q_UNUSED(inputs);
+    Q_UNUSED(output);
+    Q_UNUSED(iMaxBatchSize);
     throw std::runtime_error("ONNX Runtime not available. Build with -DUSE_ONNXRUNTIME=ON");
 #endif
 }
 
 //=============================================================================================================
 
+void MlOnnxModel::setThreadCount(int iIntraOpThreads, int iInterOpThreads)
+{
+    QWriteLocker locker(&m_sessionLock);
+
+    m_iIntraOpThreads = std::max(iIntraOpThreads, 0);
+    m_iInterOpThreads = std::max(iInterOpThreads, 1);
+}
+
+//=============================================================================================================
+
 bool MlOnnxModel::save(const QString& path) const
 {
     Q_UNUSED(path);
@@ -151,6 +348,8 @@ bool MlOnnxModel::save(const QString& path) const
 bool MlOnnxModel::load(const QString& path)
 {
 #ifdef MNE_USE_ONNXRUNTIME
+    QWriteLocker locker(&m_sessionLock);
+
     m_modelPath = path;
 
     if (!QFileInfo::exists(path)) {
@@ -159,10 +358,14 @@ bool MlOnnxModel::load(const QString& path)
     }
 
     try {
-        // Session options — enable all graph optimizations, single intra-op thread for determinism
+        // Session options — enable all graph optimizations, a single intra-op thread (determinism) by default
         Ort::SessionOptions sessionOpts;
         sessionOpts.SetGraphOptimizationLevel(GraphOptimizationLevel::ORT_ENABLE_ALL);
-        sessionOpts.SetIntraOpNumThreads(1);
+        sessionOpts.SetIntraOpNumThreads(m_iIntraOpThreads);
+        if (m_iInterOpThreads > 1) {
+            sessionOpts.SetExecutionMode(ExecutionMode::ORT_PARALLEL);
+            sessionOpts.SetInterOpNumThreads(m_iInterOpThreads);
+        }
         sessionOpts.DisableMemPattern();  // reduces peak memory for small models
 
         // Create session from the ONNX file
@@ -191,13 +394,16 @@ bool MlOnnxModel::load(const QString& path)
             m_inputShapes.push_back(std::move(shape));
         }
 
-        // Cache output names
+        // Cache output names and shapes
         size_t numOutputs = m_session->GetOutputCount();
         m_outputNames.clear();
+        m_outputShapes.clear();
         m_outputNames.reserve(numOutputs);
+        m_outputShapes.reserve(numOutputs);
         for (size_t i = 0; i < numOutputs; ++i) {
             auto namePtr = m_session->GetOutputNameAllocated(i, allocator);
             m_outputNames.emplace_back(namePtr.get());
+            m_outputShapes.push_back(m_session->GetOutputTypeInfo(i).GetTensorTypeAndShapeInfo().GetShape());
         }
 
         qDebug() << "MlOnnxModel::load – Session created for" << path
@@ -221,6 +427,7 @@ bool MlOnnxModel::load(const QString& path)
 bool MlOnnxModel::isLoaded() const
 {
 #ifdef MNE_USE_ONNXRUNTIME
+    QReadLocker locker(&m_sessionLock);
     return m_session != nullptr;
 #else
     return false;
@@ -18,11 +18,15 @@
  * names and shapes so per-call overhead stays minimal.
  *
  * Each @c predict wraps the input tensor's row-major float buffer in
- * an @c Ort::Value zero-copy, dispatches @c Session::Run, and copies
- * the first output tensor into a fresh @ref MLLIB::MlTensor; multi-IO
- * graphs are supported by the cached name arrays but the public API
- * intentionally exposes a single-in / single-out shape until a use
- * case requires more. When mne-cpp is built without
+ * an @c Ort::Value zero-copy and runs the session through an
+ * @c Ort::IoBinding; multi-IO graphs are supported by the cached name
+ * arrays but the public API intentionally exposes a single-in /
+ * single-out shape until a use case requires more. @c predictInto
+ * binds a caller-provided output tensor (e.g. an @c MlTensor::view
+ * over a preallocated buffer) so that repeated calls allocate nothing,
+ * and @c predictBatch stacks many epochs along the batch axis into one
+ * session run. The session may be shared by concurrent callers; only
+ * @c load and the thread configuration serialise against them. When mne-cpp is built without
  * @c USE_ONNXRUNTIME the methods compile to stubs that throw
  * @c std::runtime_error or log and return, so dependent code can be
  * gated at runtime rather than via @c \#ifdef chains.
@@ -42,6 +46,7 @@
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QReadWriteLock>
 #include <QString>
 
 //=============================================================================================================
@@ -98,6 +103,57 @@ public:
     QString modelType() const override;
     MlTaskType taskType() const override;
 
+    //=========================================================================================================
+    /**
+     * Run inference writing into a preallocated output tensor (ONNX Runtime IO binding).
+     *
+     * If output is not empty, its buffer is bound as the model output and no memory is allocated, so output
+     * may be an MlTensor::view over caller-owned memory that is reused from call to call. Its size must then
+     * equal that of the model output for this input. If output is empty it is replaced by an owning tensor.
+     *
+     * May be called concurrently from several threads on the same model.
+     *
+     * @param[in] input     The input data.
+     * @param[in, out] output   Preallocated output, or an empty tensor.
+     */
+    void predictInto(const MlTensor& input, MlTensor& output) const;
+
+    //=========================================================================================================
+    /**
+     * Run inference on many inputs of identical shape in as few session runs as possible.
+     *
+     * The inputs are stacked along their first (batch) axis, e.g. N epochs of shape {1, C, T} become one input
+     * of shape {N, C, T}, and the outputs are returned stacked the same way: the output of input i occupies the
+     * i-th of N equal blocks of the result. Models whose batch axis is fixed are run once per input, still
+     * without reallocating the output.
+     *
+     * @param[in] inputs        Inputs of identical shape.
+     * @param[in] iMaxBatchSize Maximum number of inputs per session run (0: all at once).
+     * @return The stacked outputs.
+     */
+    MlTensor predictBatch(const std::vector<MlTensor>& inputs, int iMaxBatchSize = 0) const;
+
+    //=========================================================================================================
+    /**
+     * Batched inference into a preallocated output tensor, see predictBatch(const std::vector<MlTensor>&, int)
+     * and predictInto().
+     *
+     * @param[in] inputs        Inputs of identical shape.
+     * @param[in, out] output   Preallocated stacked output, or an empty tensor.
+     * @param[in] iMaxBatchSize Maximum number of inputs per session run (0: all at once).
+     */
+    void predictBatch(const std::vector<MlTensor>& inputs, MlTensor& output, int iMaxBatchSize = 0) const;
+
+    //=========================================================================================================
+    /**
+     * Sets the ONNX Runtime thread pools of the session. Takes effect at the next load(). By default both are 1,
+     * which gives bit-identical results from run to run.
+     *
+     * @param[in] iIntraOpThreads   Threads used inside an operator (0: ONNX Runtime default, one per core).
+     * @param[in] iInterOpThreads   Threads used to run independent operators in parallel (1: sequential).
+     */
+    void setThreadCount(int iIntraOpThreads, int iInterOpThreads = 1);
+
     //=========================================================================================================
     /**
      * @return True if an ONNX Runtime session has been loaded and is ready for inference.
@@ -107,10 +163,16 @@ public:
 private:
 #ifdef MNE_USE_ONNXRUNTIME
     static Ort::Env& ortEnv();
+
+    std::vector<int64_t> outputShape(const std::vector<int64_t>& inputShape) const;
+    void run(const float* pInput, const std::vector<int64_t>& inputShape, MlTensor& output) const;
 #endif
 
     QString     m_modelPath;                                /**< Path to ONNX model file. */
     MlTaskType  m_taskType = MlTaskType::Classification;    /**< Task type.               */
+    int         m_iIntraOpThreads = 1;                      /**< Intra-op threads of the session. */
+    int         m_iInterOpThreads = 1;                      /**< Inter-op threads of the session. */
+    mutable QReadWriteLock m_sessionLock;                   /**< Read-locked by inference, write-locked by load. */
 
 #ifdef MNE_USE_ONNXRUNTIME
     std::unique_ptr<Ort::Session>    m_session;              /**< ORT inference session.              */
@@ -118,6 +180,7 @@ private:
     std::vector<std::string>         m_inputNames;           /**< Cached input node names.             */
     std::vector<std::string>         m_outputNames;          /**< Cached output node names.            */
     std::vector<std::vector<int64_t>> m_inputShapes;         /**< Cached input node shapes.            */
+    std::vector<std::vector<int64_t>> m_outputShapes;        /**< Cached output node shapes.           */
 #endif
 };
 
@@ -20,6 +20,13 @@
  * back into the context map. @ref executeIncremental reuses the
  * same loop but restricts it to nodes returned by
  * @ref MnaGraph::dirtyNodes and their @ref MnaGraph::downstreamNodes.
+ * Both hand the selected nodes to @ref runNodes, which either walks
+ * them on the calling thread or, with several threads, keeps a
+ * count of unfinished upstream nodes per node and starts a node on
+ * a private @c QThreadPool the moment that count drops to zero.
+ * Op nodes are looked up in the optional @ref MnaResultCache first;
+ * their output hashes are chained from the node key, so the whole
+ * downstream key stays stable as long as nothing upstream changed.
  *
  * @ref startStream / @ref stopStream provide the MNE Scan
  * integration point: the host application supplies a
@@ -40,8 +47,16 @@
 #include "mna_graph.h"
 #include "mna_op_registry.h"
 
+#include <exception>
+
 #include <QDir>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
 #include <QTemporaryFile>
+#include <QThread>
+#include <QThreadPool>
 #ifndef WASMBUILD
 #include <QProcess>
 #endif
@@ -64,6 +79,15 @@ MnaGraphExecutor::ProgressCallback MnaGraphExecutor::s_progressCallback;
 
 MnaGraphExecutor::Context MnaGraphExecutor::execute(MnaGraph& graph,
                                                       const QVariantMap& graphInputs)
+{
+    return execute(graph, graphInputs, ExecOptions());
+}
+
+//=============================================================================================================
+
+MnaGraphExecutor::Context MnaGraphExecutor::execute(MnaGraph& graph,
+                                                      const QVariantMap& graphInputs,
+                                                      const ExecOptions& options)
 {
     Context ctx;
     ctx.graphInputs = graphInputs;
@@ -71,6 +95,10 @@ MnaGraphExecutor::Context MnaGraphExecutor::execute(MnaGraph& graph,
     // Populate context with graph-level inputs keyed as "graph::portName"
     for (auto it = graphInputs.constBegin(); it != graphInputs.constEnd(); ++it) {
         ctx.results.insert(QStringLiteral("graph::") + it.key(), it.value());
+
+        if (options.cache) {
+            ctx.resultHashes.insert(QStringLiteral("graph::") + it.key(), MnaResultCache::valueHash(it.value()));
+        }
     }
 
     // Evaluate parameter tree bindings before execution
@@ -91,38 +119,7 @@ MnaGraphExecutor::Context MnaGraphExecutor::execute(MnaGraph& graph,
         }
     }
 
-    const QStringList order = graph.topologicalSort();
-    const int total = order.size();
-
-    for (int i = 0; i < total; ++i) {
-        const QString& nodeId = order[i];
-
-        if (s_progressCallback) {
-            s_progressCallback(nodeId, i + 1, total);
-        }
-
-        MnaNode& n = graph.node(nodeId);
-
-        // Gather inputs from upstream results
-        QVariantMap inputs;
-        for (const MnaPort& p : n.inputs) {
-            if (!p.sourceNodeId.isEmpty()) {
-                QString key = p.sourceNodeId + QStringLiteral("::") + p.sourcePortName;
-                inputs.insert(p.name, ctx.results.value(key));
-            }
-        }
-
-        // Execute the node
-        QVariantMap outputs = executeNode(n, inputs);
-
-        // Store outputs in context
-        for (auto it = outputs.constBegin(); it != outputs.constEnd(); ++it) {
-            ctx.results.insert(nodeId + QStringLiteral("::") + it.key(), it.value());
-        }
-
-        n.dirty = false;
-        n.executedAt = QDateTime::currentDateTimeUtc();
-    }
+    runNodes(graph, graph.topologicalSort(), ctx, options);
 
     // Re-evaluate parameter tree after execution (for on_change bindings)
     graph.paramTree.evaluate(ctx.results);
@@ -134,6 +131,15 @@ MnaGraphExecutor::Context MnaGraphExecutor::execute(MnaGraph& graph,
 
 MnaGraphExecutor::Context MnaGraphExecutor::executeIncremental(MnaGraph& graph,
                                                                  Context& existing)
+{
+    return executeIncremental(graph, existing, ExecOptions());
+}
+
+//=============================================================================================================
+
+MnaGraphExecutor::Context MnaGraphExecutor::executeIncremental(MnaGraph& graph,
+                                                                 Context& existing,
+                                                                 const ExecOptions& options)
 {
     // Find dirty nodes and all their downstream dependents
     QStringList dirty = graph.dirtyNodes();
@@ -155,34 +161,7 @@ MnaGraphExecutor::Context MnaGraphExecutor::executeIncremental(MnaGraph& graph,
         }
     }
 
-    const int total = order.size();
-
-    for (int i = 0; i < total; ++i) {
-        const QString& nodeId = order[i];
-
-        if (s_progressCallback) {
-            s_progressCallback(nodeId, i + 1, total);
-        }
-
-        MnaNode& n = graph.node(nodeId);
-
-        QVariantMap inputs;
-        for (const MnaPort& p : n.inputs) {
-            if (!p.sourceNodeId.isEmpty()) {
-                QString key = p.sourceNodeId + QStringLiteral("::") + p.sourcePortName;
-                inputs.insert(p.name, existing.results.value(key));
-            }
-        }
-
-        QVariantMap outputs = executeNode(n, inputs);
-
-        for (auto it = outputs.constBegin(); it != outputs.constEnd(); ++it) {
-            existing.results.insert(nodeId + QStringLiteral("::") + it.key(), it.value());
-        }
-
-        n.dirty = false;
-        n.executedAt = QDateTime::currentDateTimeUtc();
-    }
+    runNodes(graph, order, existing, options);
 
     graph.paramTree.evaluate(existing.results);
 
@@ -330,6 +309,175 @@ void MnaGraphExecutor::setProgressCallback(ProgressCallback cb)
     s_progressCallback = cb;
 }
 
+//=============================================================================================================
+
+void MnaGraphExecutor::runNodes(MnaGraph& graph,
+                                const QStringList& order,
+                                Context& ctx,
+                                const ExecOptions& options)
+{
+    const int total = order.size();
+    if (total == 0) {
+        return;
+    }
+
+    // Resolve the nodes up front; the workers never touch the graph's node list
+    QHash<QString, MnaNode*> nodes;
+    for (const QString& nodeId : order) {
+        nodes.insert(nodeId, &graph.node(nodeId));
+    }
+
+    const MnaOpRegistry& registry = MnaOpRegistry::instance();
+
+    QMutex mutex;           // Guards ctx, the node flags, the dependency counts and the progress callback
+    int completed = 0;
+
+    auto runOne = [&](const QString& nodeId) {
+        MnaNode& n = *nodes.value(nodeId);
+
+        // Gather inputs and their hashes from upstream results
+        QVariantMap inputs;
+        QMap<QString, QByteArray> inputHashes;
+        {
+            QMutexLocker locker(&mutex);
+            for (const MnaPort& p : n.inputs) {
+                if (!p.sourceNodeId.isEmpty()) {
+                    QString key = p.sourceNodeId + QStringLiteral("::") + p.sourcePortName;
+                    inputs.insert(p.name, ctx.results.value(key));
+                    inputHashes.insert(p.name, ctx.resultHashes.value(key));
+                }
+            }
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        // Only in-process ops are cached; scripts and external processes may have side effects
+        QByteArray nodeKey;
+        if (options.cache && n.execMode == MnaNodeExecMode::Batch && registry.opFunc(n.opType)) {
+            for (auto it = inputHashes.begin(); it != inputHashes.end(); ++it) {
+                if (it.value().isEmpty()) {
+                    it.value() = MnaResultCache::valueHash(inputs.value(it.key()));
+                }
+            }
+            nodeKey = MnaResultCache::nodeKey(n, inputHashes);
+        }
+
+        NodeTiming timing;
+        QVariantMap outputs;
+        if (!nodeKey.isEmpty() && options.cache->lookup(nodeKey, outputs)) {
+            timing.cacheHit = true;
+        } else {
+            outputs = executeNode(n, inputs);
+            if (!nodeKey.isEmpty()) {
+                options.cache->insert(nodeKey, outputs);
+            }
+        }
+        timing.elapsedNs = timer.nsecsElapsed();
+
+        QMutexLocker locker(&mutex);
+
+        for (auto it = outputs.constBegin(); it != outputs.constEnd(); ++it) {
+            const QString key = nodeId + QStringLiteral("::") + it.key();
+            ctx.results.insert(key, it.value());
+
+            if (nodeKey.isEmpty()) {
+                ctx.resultHashes.remove(key);
+            } else {
+                ctx.resultHashes.insert(key, MnaResultCache::outputHash(nodeKey, it.key()));
+            }
+        }
+        ctx.timings.insert(nodeId, timing);
+
+        n.dirty = false;
+        n.executedAt = QDateTime::currentDateTimeUtc();
+
+        ++completed;
+        if (s_progressCallback) {
+            s_progressCallback(nodeId, completed, total, timing);
+        }
+    };
+
+    int threads = options.maxThreads > 0 ? options.maxThreads : QThread::idealThreadCount();
+    threads = qMin(threads, total);
+
+    if (threads <= 1) {
+        for (const QString& nodeId : order) {
+            runOne(nodeId);
+        }
+        return;
+    }
+
+    // Count the unfinished upstream nodes of every node. Upstream nodes outside of order already have results.
+    QHash<QString, int> pending;
+    QHash<QString, QStringList> dependents;
+    for (const QString& nodeId : order) {
+        QSet<QString> upstream;
+        for (const MnaPort& p : nodes.value(nodeId)->inputs) {
+            if (!p.sourceNodeId.isEmpty() && nodes.contains(p.sourceNodeId)) {
+                upstream.insert(p.sourceNodeId);
+            }
+        }
+        pending.insert(nodeId, upstream.size());
+        for (const QString& u : upstream) {
+            dependents[u].append(nodeId);
+        }
+    }
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(threads);
+
+    // An exception must not leave a pool thread, Qt would terminate. The first one is kept and rethrown below.
+    std::exception_ptr firstError;
+
+    // A finished node starts its dependents that became ready. The pool only drains once no task is left that
+    // could still enqueue one, so waitForDone covers the whole graph.
+    std::function<void(const QString&)> dispatch = [&](const QString& nodeId) {
+        pool.start([&, nodeId]() {
+            try {
+                runOne(nodeId);
+            } catch (...) {
+                QMutexLocker locker(&mutex);
+                if (!firstError) {
+                    firstError = std::current_exception();
+                }
+                return;
+            }
+
+            QStringList ready;
+            {
+                QMutexLocker locker(&mutex);
+
+                // After a failure only the nodes already running finish, nothing new is started
+                if (firstError) {
+                    return;
+                }
+
+                for (const QString& d : dependents.value(nodeId)) {
+                    if (--pending[d] == 0) {
+                        ready.append(d);
+                    }
+                }
+            }
+            for (const QString& d : ready) {
+                dispatch(d);
+            }
+        });
+    };
+
+    for (const QString& nodeId : order) {
+        if (pending.value(nodeId) == 0) {
+            dispatch(nodeId);
+        }
+    }
+
+    pool.waitForDone();
+
+    if (firstError) {
+        std::rethrow_exception(firstError);
+    }
+}
+
 //=============================================================================================================
 // Stream-mode execution
 //=============================================================================================================
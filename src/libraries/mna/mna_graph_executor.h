@@ -19,6 +19,17 @@
  * walk to dirty nodes and their downstream dependents so a
  * parameter tweak does not re-run the whole pipeline.
  *
+ * Both accept @ref ExecOptions. With more than one thread the
+ * executor dispatches every node as soon as all its upstream nodes
+ * are done, so independent branches (one forward model per subject,
+ * one inverse per condition) run side by side. With an
+ * @ref MnaResultCache, op nodes whose key — op type, attributes and
+ * input hashes — is already cached are not run again, which lets a
+ * rerun skip every unchanged subgraph. The progress callback reports
+ * each finished node together with its @ref NodeTiming. An exception
+ * thrown by an op reaches the caller of @ref execute in both modes;
+ * with several threads no further node is started after it.
+ *
  * Stream mode (@ref startStream / @ref stopStream) targets MNE Scan:
  * instead of calling op functions, the executor asks a host-supplied
  * @ref PluginFactory for a live @c QObject per node, applies
@@ -37,6 +48,7 @@
 
 #include "mna_global.h"
 #include "mna_node.h"
+#include "mna_result_cache.h"
 
 //=============================================================================================================
 // QT INCLUDES
@@ -75,6 +87,15 @@ namespace MNALIB
 class MNASHARED_EXPORT MnaGraphExecutor
 {
 public:
+    /**
+     * Wall time and cache state of one node execution.
+     */
+    struct NodeTiming
+    {
+        qint64 elapsedNs = 0;       ///< Time spent on the node, including the cache lookup
+        bool   cacheHit = false;    ///< Whether the outputs came from the result cache
+    };
+
     /**
      * Execution context — holds intermediate results between nodes.
      */
@@ -83,10 +104,25 @@ public:
         /// nodeId::portName → data (QVariant wrapping domain objects or file paths)
         QMap<QString, QVariant> results;
 
+        /// nodeId::portName → content hash of the result (only filled when a result cache is used)
+        QMap<QString, QByteArray> resultHashes;
+
+        /// nodeId → timing of its last execution
+        QMap<QString, NodeTiming> timings;
+
         /// Graph-level inputs (populated before execution)
         QVariantMap graphInputs;
     };
 
+    /**
+     * Options for batch execution.
+     */
+    struct ExecOptions
+    {
+        int             maxThreads = 1;     ///< Worker threads. 1 runs all nodes on the calling thread in topological order, 0 uses QThread::idealThreadCount().
+        MnaResultCache* cache = nullptr;    ///< Result cache for op nodes (owned by the caller), or nullptr to always execute
+    };
+
     //=========================================================================================================
     /**
      * Stream execution context — maps graph nodes to live plugin instances.
@@ -111,6 +147,17 @@ public:
      */
     static Context execute(MnaGraph& graph, const QVariantMap& graphInputs);
 
+    /**
+     * Execute the full graph with the given threading and caching options.
+     * @param graph         The graph to execute.
+     * @param graphInputs   Named inputs fed into graph-level input ports.
+     * @param options       Number of worker threads and result cache.
+     * @return Execution context with all results.
+     */
+    static Context execute(MnaGraph& graph,
+                           const QVariantMap& graphInputs,
+                           const ExecOptions& options);
+
     /**
      * Execute only dirty nodes and their downstream dependents.
      * @param graph     The graph to execute.
@@ -119,6 +166,17 @@ public:
      */
     static Context executeIncremental(MnaGraph& graph, Context& existing);
 
+    /**
+     * Execute only dirty nodes and their downstream dependents, with the given threading and caching options.
+     * @param graph     The graph to execute.
+     * @param existing  Existing context with prior results.
+     * @param options   Number of worker threads and result cache.
+     * @return Updated context.
+     */
+    static Context executeIncremental(MnaGraph& graph,
+                                      Context& existing,
+                                      const ExecOptions& options);
+
     /**
      * Execute a single node (for testing/debugging).
      * @param node      The node to execute.
@@ -128,12 +186,18 @@ public:
     static QVariantMap executeNode(const MnaNode& node,
                                     const QVariantMap& inputs);
 
-    /// Progress callback type.
+    /// Progress callback type. @p current counts the finished nodes, @p timing describes the node that just finished.
     using ProgressCallback = std::function<void(const QString& nodeId,
-                                                 int current, int total)>;
+                                                 int current, int total,
+                                                 const NodeTiming& timing)>;
 
     /**
-     * Set a progress callback invoked for each node execution.
+     * Set a progress callback invoked after each node execution. With several worker threads it is called from
+     * the workers, one call at a time.
+     *
+     * @note Earlier versions called it before a node started, with @p current being the node's position in the
+     * execution order, and without @p timing. It now runs once the node finished, also with a single thread, so
+     * @p current counts finished nodes and a node that throws is never reported.
      */
     static void setProgressCallback(ProgressCallback cb);
 
@@ -173,6 +237,14 @@ public:
     static void stopStream(StreamContext& ctx);
 
 private:
+    /**
+     * Run the given nodes, in topological order or in parallel as their inputs become ready.
+     */
+    static void runNodes(MnaGraph& graph,
+                         const QStringList& order,
+                         Context& ctx,
+                         const ExecOptions& options);
+
     static ProgressCallback s_progressCallback;
 };
 
@@ -0,0 +1,347 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     mna_result_cache.cpp
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Implementation of @ref MnaResultCache — SHA-256 node keys, in-memory entries and one @c QDataStream file per persistent entry.
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mna_result_cache.h"
+#include "mna_node.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDebug>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QMetaType>
+#include <QSaveFile>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNALIB;
+
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+const QByteArray kEntryMagic("MNAC1");
+const QString kEntrySuffix = QStringLiteral(".mnacache");
+
+/**
+ * Whether a value can be written with QDataStream, including the elements of nested maps and lists.
+ */
+bool isStreamable(const QVariant& value)
+{
+    if (!value.isValid()) {
+        return true;
+    }
+
+    if (value.userType() == QMetaType::QVariantMap) {
+        const QVariantMap map = value.toMap();
+        for (auto it = map.constBegin(); it != map.constEnd(); ++it) {
+            if (!isStreamable(it.value())) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    if (value.userType() == QMetaType::QVariantList) {
+        const QVariantList list = value.toList();
+        for (const QVariant& v : list) {
+            if (!isStreamable(v)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 0, 0)
+    return value.metaType().hasRegisteredDataStreamOperators();
+#else
+    return value.userType() < QMetaType::User || QMetaType::hasRegisteredDataStreamOperators(value.userType());
+#endif
+}
+
+/**
+ * Whether all outputs of a node can be written to disk.
+ */
+bool isStreamable(const QVariantMap& outputs)
+{
+    for (auto it = outputs.constBegin(); it != outputs.constEnd(); ++it) {
+        if (!isStreamable(it.value())) {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MnaResultCache::MnaResultCache(const QString& directory)
+: m_directory(directory)
+{
+    if (!m_directory.isEmpty()) {
+        QDir().mkpath(m_directory);
+    }
+}
+
+//=============================================================================================================
+
+QString MnaResultCache::directory() const
+{
+    return m_directory;
+}
+
+//=============================================================================================================
+
+bool MnaResultCache::lookup(const QByteArray& key,
+                            QVariantMap& outputs)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        auto it = m_entries.find(key);
+        if (it != m_entries.end()) {
+            it->lastUse = ++m_useCounter;
+            outputs = it->outputs;
+            ++m_hits;
+            return true;
+        }
+    }
+
+    // Disk tier — read without holding the lock, several workers may load different entries at once
+    if (!m_directory.isEmpty()) {
+        QFile file(entryPath(key));
+        if (file.open(QIODevice::ReadOnly)) {
+            QDataStream stream(&file);
+            stream.setVersion(QDataStream::Qt_5_15);
+
+            QByteArray magic;
+            QVariantMap loaded;
+            stream >> magic >> loaded;
+
+            if (stream.status() == QDataStream::Ok && magic == kEntryMagic) {
+                QMutexLocker locker(&m_mutex);
+                storeInMemory(key, loaded);
+                outputs = loaded;
+                ++m_hits;
+                return true;
+            }
+
+            qWarning() << "MnaResultCache::lookup - ignoring unreadable cache entry" << file.fileName();
+        }
+    }
+
+    QMutexLocker locker(&m_mutex);
+    ++m_misses;
+    return false;
+}
+
+//=============================================================================================================
+
+void MnaResultCache::insert(const QByteArray& key,
+                            const QVariantMap& outputs)
+{
+    {
+        QMutexLocker locker(&m_mutex);
+        storeInMemory(key, outputs);
+    }
+
+    if (m_directory.isEmpty() || !isStreamable(outputs)) {
+        return;
+    }
+
+    QSaveFile file(entryPath(key));
+    if (!file.open(QIODevice::WriteOnly)) {
+        qWarning() << "MnaResultCache::insert - cannot write" << file.fileName();
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << kEntryMagic << outputs;
+
+    if (stream.status() != QDataStream::Ok) {
+        file.cancelWriting();
+        return;
+    }
+
+    file.commit();
+}
+
+//=============================================================================================================
+
+void MnaResultCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_entries.clear();
+
+    if (!m_directory.isEmpty()) {
+        QDir dir(m_directory);
+        const QStringList files = dir.entryList({QStringLiteral("*") + kEntrySuffix}, QDir::Files);
+        for (const QString& f : files) {
+            dir.remove(f);
+        }
+    }
+}
+
+//=============================================================================================================
+
+void MnaResultCache::setMaxMemoryEntries(int count)
+{
+    QMutexLocker locker(&m_mutex);
+    m_maxMemoryEntries = qMax(count, 0);
+    trimMemory();
+}
+
+//=============================================================================================================
+
+int MnaResultCache::maxMemoryEntries() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_maxMemoryEntries;
+}
+
+//=============================================================================================================
+
+int MnaResultCache::hits() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_hits;
+}
+
+//=============================================================================================================
+
+int MnaResultCache::misses() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_misses;
+}
+
+//=============================================================================================================
+
+QByteArray MnaResultCache::nodeKey(const MnaNode& node,
+                                   const QMap<QString, QByteArray>& inputHashes)
+{
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+
+    stream << QByteArray("mna-node-v1") << node.opType << node.toolVersion;
+
+    // Both maps are ordered by key, so the key does not depend on insertion order
+    for (auto it = node.attributes.constBegin(); it != node.attributes.constEnd(); ++it) {
+        const QByteArray hash = valueHash(it.value());
+        if (hash.isEmpty()) {
+            return {};
+        }
+        stream << it.key() << hash;
+    }
+
+    for (auto it = inputHashes.constBegin(); it != inputHashes.constEnd(); ++it) {
+        if (it.value().isEmpty()) {
+            return {};
+        }
+        stream << it.key() << it.value();
+    }
+
+    return QCryptographicHash::hash(buffer, QCryptographicHash::Sha256);
+}
+
+//=============================================================================================================
+
+QByteArray MnaResultCache::outputHash(const QByteArray& nodeKey,
+                                      const QString& portName)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(nodeKey);
+    hash.addData(QByteArray(1, '\0'));
+    hash.addData(portName.toUtf8());
+    return hash.result();
+}
+
+//=============================================================================================================
+
+QByteArray MnaResultCache::valueHash(const QVariant& value)
+{
+    if (!isStreamable(value)) {
+        return {};
+    }
+
+    QByteArray buffer;
+    QDataStream stream(&buffer, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_15);
+    stream << value;
+
+    // A path stands for the file behind it — cover its size and time stamp so that edits invalidate the key
+    if (value.userType() == QMetaType::QString) {
+        const QFileInfo info(value.toString());
+        if (!value.toString().isEmpty() && info.isFile()) {
+            stream << info.size() << info.lastModified().toMSecsSinceEpoch();
+        }
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return {};
+    }
+
+    return QCryptographicHash::hash(buffer, QCryptographicHash::Sha256);
+}
+
+//=============================================================================================================
+
+QString MnaResultCache::entryPath(const QByteArray& key) const
+{
+    return m_directory + QLatin1Char('/') + QString::fromLatin1(key.toHex()) + kEntrySuffix;
+}
+
+//=============================================================================================================
+
+void MnaResultCache::storeInMemory(const QByteArray& key,
+                                   const QVariantMap& outputs)
+{
+    if (m_maxMemoryEntries == 0) {
+        return;
+    }
+
+    Entry& entry = m_entries[key];
+    entry.outputs = outputs;
+    entry.lastUse = ++m_useCounter;
+
+    trimMemory();
+}
+
+//=============================================================================================================
+
+void MnaResultCache::trimMemory()
+{
+    // Linear scan, the limit is small compared to the cost of the ops behind the entries
+    while (m_entries.size() > m_maxMemoryEntries) {
+        auto oldest = m_entries.begin();
+        for (auto it = m_entries.begin(); it != m_entries.end(); ++it) {
+            if (it->lastUse < oldest->lastUse) {
+                oldest = it;
+            }
+        }
+        m_entries.erase(oldest);
+    }
+}
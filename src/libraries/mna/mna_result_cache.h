@@ -0,0 +1,173 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     mna_result_cache.h
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Content-addressed store of node outputs, keyed by op type, attributes and input hashes, with an optional on-disk tier.
+ *
+ * @ref MnaResultCache lets @ref MnaGraphExecutor skip nodes whose
+ * result is already known. The key of a node is a SHA-256 over its
+ * @c opType, @c toolVersion, attributes and the content hashes of its
+ * inputs; the hash of an output is derived from the key of the node
+ * that produced it, so a whole unchanged subgraph is recognised
+ * without hashing the (possibly large) intermediate data again.
+ *
+ * The most recently used entries are kept in memory, up to
+ * @ref maxMemoryEntries of them. If a directory is given, outputs
+ * that can be written with @c QDataStream are also stored there as
+ * one file per key, so that a later process running the same
+ * pipeline finds them and an entry dropped from memory can be
+ * loaded again. Outputs holding types without stream operators
+ * stay memory-only and are lost once dropped.
+ */
+
+#ifndef MNA_RESULT_CACHE_H
+#define MNA_RESULT_CACHE_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mna_global.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QByteArray>
+#include <QHash>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+#include <QVariant>
+#include <QVariantMap>
+
+//=============================================================================================================
+// DEFINE NAMESPACE MNALIB
+//=============================================================================================================
+
+namespace MNALIB
+{
+
+struct MnaNode;
+
+//=============================================================================================================
+/**
+ * Thread-safe, content-addressed cache of node outputs.
+ *
+ * @brief Memory and disk cache of @ref MnaNode results for @ref MnaGraphExecutor.
+ */
+class MNASHARED_EXPORT MnaResultCache
+{
+public:
+    /**
+     * Create a cache.
+     * @param[in] directory  Directory for persistent entries. Empty keeps the cache in memory only.
+     */
+    explicit MnaResultCache(const QString& directory = QString());
+
+    /**
+     * Directory of the persistent entries (empty for a memory-only cache).
+     */
+    QString directory() const;
+
+    /**
+     * Look up the outputs stored under @p key, loading them from disk if necessary.
+     * @param[in]  key       Node key from @ref nodeKey.
+     * @param[out] outputs   The cached outputs.
+     * @return true on a hit.
+     */
+    bool lookup(const QByteArray& key, QVariantMap& outputs);
+
+    /**
+     * Store the outputs of a node under @p key.
+     * @param[in] key        Node key from @ref nodeKey.
+     * @param[in] outputs    The node outputs.
+     */
+    void insert(const QByteArray& key, const QVariantMap& outputs);
+
+    /**
+     * Drop all entries, in memory and on disk.
+     */
+    void clear();
+
+    /**
+     * Limit the number of entries held in memory. The least recently used ones are dropped first.
+     * @param[in] count      Maximum number of in-memory entries. 0 keeps nothing in memory.
+     */
+    void setMaxMemoryEntries(int count);
+
+    /**
+     * Maximum number of in-memory entries, @ref DefaultMaxMemoryEntries unless changed.
+     */
+    int maxMemoryEntries() const;
+
+    /**
+     * Number of lookups that were answered from the cache.
+     */
+    int hits() const;
+
+    /**
+     * Number of lookups that missed.
+     */
+    int misses() const;
+
+    /**
+     * Compute the key of a node from its op type, tool version, attributes and input hashes.
+     * @param[in] node          The node.
+     * @param[in] inputHashes   Port name → content hash of the value on that port.
+     * @return The key, or an empty array if an attribute cannot be hashed.
+     */
+    static QByteArray nodeKey(const MnaNode& node,
+                              const QMap<QString, QByteArray>& inputHashes);
+
+    /**
+     * Content hash of an output port of a node with the given key.
+     */
+    static QByteArray outputHash(const QByteArray& nodeKey,
+                                 const QString& portName);
+
+    /**
+     * Content hash of a value. Strings naming an existing file also cover the file size and modification time.
+     * @param[in] value      The value.
+     * @return The hash, or an empty array if the value type cannot be serialized.
+     */
+    static QByteArray valueHash(const QVariant& value);
+
+    static constexpr int DefaultMaxMemoryEntries = 64;  ///< Default limit of in-memory entries
+
+private:
+    /// An in-memory entry.
+    struct Entry {
+        QVariantMap outputs;        ///< The node outputs
+        quint64     lastUse = 0;    ///< Value of m_useCounter at the last access
+    };
+
+    QString entryPath(const QByteArray& key) const;
+
+    /**
+     * Store an entry in memory, within the limit. m_mutex must be held.
+     */
+    void storeInMemory(const QByteArray& key, const QVariantMap& outputs);
+
+    /**
+     * Drop the least recently used in-memory entries beyond the limit. m_mutex must be held.
+     */
+    void trimMemory();
+
+    QString                         m_directory;                                ///< Directory of persistent entries
+    mutable QMutex                  m_mutex;                                    ///< Guards the members below
+    QHash<QByteArray, Entry>        m_entries;                                  ///< In-memory entries
+    quint64                         m_useCounter = 0;                           ///< Counts the accesses, orders the entries by use
+    int                             m_maxMemoryEntries = DefaultMaxMemoryEntries; ///< Limit of in-memory entries
+    int                             m_hits = 0;                                 ///< Lookup hits
+    int                             m_misses = 0;                               ///< Lookup misses
+};
+
+} // namespace MNALIB
+
+#endif // MNA_RESULT_CACHE_H
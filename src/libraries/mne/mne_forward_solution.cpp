@@ -397,19 +397,7 @@ bool MNEForwardSolution::write(QIODevice& p_IODevice) const
     //
     if (auto* qf = dynamic_cast<QFile*>(&p_IODevice)) {
         QFile fileIn(qf->fileName());
-        FiffStream::SPtr t_pStreamIn = FiffStream::open_update(fileIn);
-        if (t_pStreamIn) {
-            const auto& dir = t_pStreamIn->dir();
-            for (int i = 0; i < dir.size(); ++i) {
-                if (dir[i]->kind == FIFF_DIR_POINTER) {
-                    fiff_int_t dirpos = (fiff_int_t)t_pStreamIn->write_dir_entries(dir);
-                    if (dirpos >= 0)
-                        t_pStreamIn->write_dir_pointer(dirpos, dir[i]->pos);
-                    break;
-                }
-            }
-            t_pStreamIn->close();
-        }
+        FiffStream::append_dir(fileIn);
     }
 
     return true;
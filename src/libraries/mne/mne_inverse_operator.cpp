@@ -43,6 +43,7 @@
 //=============================================================================================================
 
 #include <Eigen/SVD>
+#include <Eigen/Eigenvalues>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -55,6 +56,38 @@ using namespace FIFFLIB;
 using namespace FSLIB;
 using namespace Eigen;
 
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+/**
+ * Thin SVD of a wide matrix G (rows <= cols) from the eigen-decomposition of its small Gram matrix G*G^T.
+ * The right singular vectors follow as G^T*U; their norms give the singular values, which for the small
+ * ones is more accurate than the square root of the eigenvalues. Vectors come out in descending order.
+ */
+void gram_svd(const MatrixXd& matG,
+              const MatrixXd& matGram,
+              VectorXd& vecSing,
+              MatrixXd& matU,
+              MatrixXd& matV)
+{
+    SelfAdjointEigenSolver<MatrixXd> eig(matGram);
+    matU = eig.eigenvectors().rowwise().reverse();
+    matV.noalias() = matG.transpose() * matU;
+
+    vecSing.resize(matU.cols());
+    for(Index i = 0; i < matV.cols(); ++i) {
+        vecSing[i] = matV.col(i).norm();
+        if(vecSing[i] > 0.0) {
+            matV.col(i) /= vecSing[i];
+        }
+    }
+}
+
+} // anonymous namespace
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -96,9 +129,10 @@ MNEInverseOperator::MNEInverseOperator(const FiffInfo &info,
                                        float loose,
                                        float depth,
                                        bool fixed,
-                                       bool limit_depth_chs)
+                                       bool limit_depth_chs,
+                                       SvdMethod svdMethod)
 {
-     *this = MNEInverseOperator::make_inverse_operator(info, forward, p_noise_cov, loose, depth, fixed, limit_depth_chs);
+     *this = MNEInverseOperator::make_inverse_operator(info, forward, p_noise_cov, loose, depth, fixed, limit_depth_chs, svdMethod);
     qRegisterMetaType<QSharedPointer<MNELIB::MNEInverseOperator> >("QSharedPointer<MNELIB::MNEInverseOperator>");
     qRegisterMetaType<MNELIB::MNEInverseOperator>("MNELIB::MNEInverseOperator");
 }
@@ -624,7 +658,8 @@ MNEInverseOperator MNEInverseOperator::make_inverse_operator(const FiffInfo &inf
                                                              float loose,
                                                              float depth,
                                                              bool fixed,
-                                                             bool limit_depth_chs)
+                                                             bool limit_depth_chs,
+                                                             SvdMethod svdMethod)
 {
     bool is_fixed_ori = forward.isFixedOrient();
     MNEInverseOperator inv;
@@ -772,7 +807,8 @@ MNEInverseOperator MNEInverseOperator::make_inverse_operator(const FiffInfo &inf
     for(qint32 i = 0; i < gain.rows(); ++i)
         gain.row(i) = gain.row(i).array() * source_std.array();
 
-    double trace_GRGT = (gain * gain.transpose()).trace();
+    MatrixXd matGram = gain * gain.transpose();
+    double trace_GRGT = matGram.trace();
     double scaling_source_cov = static_cast<double>(n_nzero) / trace_GRGT;
 
     p_source_cov->data.array() *= scaling_source_cov;
@@ -782,23 +818,41 @@ MNEInverseOperator MNEInverseOperator::make_inverse_operator(const FiffInfo &inf
     //
     // 12. Decompose the combined matrix
     //
-    qInfo("Computing SVD of whitened and weighted lead field matrix.\n");
-    JacobiSVD<MatrixXd> svd(gain, ComputeThinU | ComputeThinV);
+    VectorXd p_sing;
+    MatrixXd t_U;
+    MatrixXd t_V;
+
+    if(svdMethod == SvdGram && gain.rows() <= gain.cols()) {
+        qInfo("Computing SVD of whitened and weighted lead field matrix (Gram eigen-decomposition).\n");
+        matGram *= scaling_source_cov;
+        gram_svd(gain, matGram, p_sing, t_U, t_V);
+    } else if(svdMethod == SvdJacobi) {
+        qInfo("Computing SVD of whitened and weighted lead field matrix.\n");
+        JacobiSVD<MatrixXd> svd(gain, ComputeThinU | ComputeThinV);
+        p_sing = svd.singularValues();
+        t_U = svd.matrixU();
+        t_V = svd.matrixV();
+    } else {
+        qInfo("Computing SVD of whitened and weighted lead field matrix (divide and conquer).\n");
+        BDCSVD<MatrixXd> svd(gain, ComputeThinU | ComputeThinV);
+        p_sing = svd.singularValues();
+        t_U = svd.matrixU();
+        t_V = svd.matrixV();
+    }
+    matGram.resize(0, 0);
+
     // TODO: verify whether explicit sorting is necessary
-    VectorXd p_sing = svd.singularValues();
-    MatrixXd t_U = svd.matrixU();
-    Linalg::sort<double>(p_sing, t_U);
-    FiffNamedMatrix::SDPtr p_eigen_fields = FiffNamedMatrix::SDPtr(new FiffNamedMatrix( svd.matrixU().cols(),
-                                                                                        svd.matrixU().rows(),
+    VectorXd t_sing = p_sing;
+    Linalg::sort<double>(t_sing, t_U);
+    FiffNamedMatrix::SDPtr p_eigen_fields = FiffNamedMatrix::SDPtr(new FiffNamedMatrix( t_U.cols(),
+                                                                                        t_U.rows(),
                                                                                         defaultQStringList,
                                                                                         gain_info.ch_names,
                                                                                         t_U.transpose() ));
 
-    p_sing = svd.singularValues();
-    MatrixXd t_V = svd.matrixV();
     Linalg::sort<double>(p_sing, t_V);
-    FiffNamedMatrix::SDPtr p_eigen_leads = FiffNamedMatrix::SDPtr(new FiffNamedMatrix( svd.matrixV().rows(),
-                                                                                       svd.matrixV().cols(),
+    FiffNamedMatrix::SDPtr p_eigen_leads = FiffNamedMatrix::SDPtr(new FiffNamedMatrix( t_V.rows(),
+                                                                                       t_V.cols(),
                                                                                        defaultQStringList,
                                                                                        defaultQStringList,
                                                                                        t_V ));
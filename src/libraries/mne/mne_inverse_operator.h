@@ -130,6 +130,15 @@ public:
     typedef QSharedPointer<MNEInverseOperator> SPtr;            /**< Shared pointer type for MNEInverseOperator. */
     typedef QSharedPointer<const MNEInverseOperator> ConstSPtr; /**< Const shared pointer type for MNEInverseOperator. */
 
+    /**
+     * @brief Decomposition used by make_inverse_operator for the SVD of the whitened, weighted lead field.
+     */
+    enum SvdMethod {
+        SvdJacobi,      /**< Two-sided Jacobi SVD of the lead field. Reference results, slowest. */
+        SvdBdc,         /**< Divide-and-conquer (bidiagonal) SVD of the lead field. */
+        SvdGram         /**< Eigen-decomposition of the nchan x nchan Gram matrix G*G^T. Fastest for wide lead fields. */
+    };
+
     //=========================================================================================================
     /**
      * @brief Constructs an empty inverse operator with invalid sentinel values.
@@ -155,6 +164,7 @@ public:
      * @param[in] depth              Depth-weighting exponent in [0, 1]; 0 disables depth weighting.
      * @param[in] fixed              If true, use fixed source orientations normal to the cortical mantle.
      * @param[in] limit_depth_chs    If true, restrict depth weighting to gradiometers (or magnetometers/EEG as fallback).
+     * @param[in] svdMethod          Decomposition used for the SVD of the whitened lead field.
      */
     MNEInverseOperator(const FIFFLIB::FiffInfo &info,
                        const MNEForwardSolution& forward,
@@ -162,7 +172,8 @@ public:
                        float loose = 0.2f,
                        float depth = 0.8f,
                        bool fixed = false,
-                       bool limit_depth_chs = true);
+                       bool limit_depth_chs = true,
+                       SvdMethod svdMethod = SvdJacobi);
 
     //=========================================================================================================
     /**
@@ -266,6 +277,9 @@ public:
      * @param[in] depth              Depth-weighting exponent in [0, 1]; 0 disables.
      * @param[in] fixed              Use fixed surface-normal orientations.
      * @param[in] limit_depth_chs    Restrict depth weighting to gradiometers (or fallback).
+     * @param[in] svdMethod          Decomposition used for the SVD of the whitened lead field. SvdGram and SvdBdc
+     *                               give the same kernel and noise normalisation as SvdJacobi to rounding, in a
+     *                               fraction of the time for free-orientation source spaces.
      *
      * @return Assembled inverse operator.
      */
@@ -275,7 +289,8 @@ public:
                                                     float loose = 0.2f,
                                                     float depth = 0.8f,
                                                     bool fixed = false,
-                                                    bool limit_depth_chs = true);
+                                                    bool limit_depth_chs = true,
+                                                    SvdMethod svdMethod = SvdJacobi);
 
     //=========================================================================================================
     /**
@@ -17,7 +17,9 @@
  * Implements barycentric-coordinate projection per triangle, a fast
  * broad-phase pass using vertex-to-triangle adjacency and the fallback
  * to nearest-vertex when no triangle contains the foot of the
- * projection.
+ * projection. The search for the closest triangle descends a
+ * bounding-volume hierarchy, closer box first, and skips every box that
+ * is farther away than the best triangle found so far.
  */
 
 //=============================================================================================================
@@ -32,10 +34,20 @@
 
 #include <mne/mne_bem_surface.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <unordered_map>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
+#include <QDebug>
+#include <QtConcurrent>
+
 //=============================================================================================================
 // EIGEN INCLUDES
 //=============================================================================================================
@@ -53,6 +65,22 @@ using namespace Eigen;
 // DEFINE GLOBAL METHODS
 //=============================================================================================================
 
+namespace {
+
+const int BVH_LEAF_SIZE = 4;        /**< Maximum number of triangles in a leaf. */
+const int BVH_STACK_SIZE = 128;     /**< Traversal stack; the median split keeps the depth near log2(ntri / BVH_LEAF_SIZE). */
+const int POINTS_PER_TASK = 256;    /**< Number of points projected by one concurrent task. */
+
+/**
+ * Squared distance from r to the box [boxMin, boxMax], zero inside the box.
+ */
+inline float box_distance2(const Vector3f &r, const Vector3f &boxMin, const Vector3f &boxMax)
+{
+    return (boxMin - r).cwiseMax(r - boxMax).cwiseMax(0.0f).squaredNorm();
+}
+
+} // anonymous namespace
+
 //=============================================================================================================
 // DEFINE MEMBER METHODS
 //=============================================================================================================
@@ -97,18 +125,153 @@ MNEProjectToSurface::MNEProjectToSurface(const MNEBemSurface &p_MNEBemSurf)
     }
     else
     {
+        // Unit normals, so that the distances within the triangle planes are true distances
         for (int i = 0; i < p_MNEBemSurf.ntri; ++i)
         {
-            nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).transpose();
+            nn.row(i) = r12.row(i).transpose().cross(r13.row(i).transpose()).normalized().transpose();
         }
     }
     det = (a.array()*b.array() - c.array()*c.array()).matrix();
+
+    compute_pseudo_normals(p_MNEBemSurf);
+    build_bvh();
+}
+
+//=============================================================================================================
+
+void MNEProjectToSurface::compute_pseudo_normals(const MNEBemSurface &p_MNEBemSurf)
+{
+    const int ntri = p_MNEBemSurf.ntri;
+
+    tris = p_MNEBemSurf.itris;
+    vertNn = MatrixX3f::Zero(p_MNEBemSurf.rr.rows(), 3);
+    edgeNn = MatrixXf::Zero(ntri, 9);
+
+    // Edges are keyed by their vertex pair, each shared by the two triangles on either side
+    std::unordered_map<qint64, Vector3f> edgeSum;
+    edgeSum.reserve(3 * ntri);
+    auto edgeKey = [](int v1, int v2) {
+        return (static_cast<qint64>(std::min(v1, v2)) << 32) | static_cast<qint64>(std::max(v1, v2));
+    };
+
+    for (int i = 0; i < ntri; ++i)
+    {
+        const Vector3f faceNn = r12.row(i).transpose().cross(r13.row(i).transpose()).normalized();
+        for (int j = 0; j < 3; ++j)
+        {
+            const int v0 = tris(i, j);
+            const int v1 = tris(i, (j + 1) % 3);
+            const int v2 = tris(i, (j + 2) % 3);
+
+            const Vector3f e1 = (p_MNEBemSurf.rr.row(v1) - p_MNEBemSurf.rr.row(v0)).transpose().normalized();
+            const Vector3f e2 = (p_MNEBemSurf.rr.row(v2) - p_MNEBemSurf.rr.row(v0)).transpose().normalized();
+            vertNn.row(v0) += std::acos(std::clamp(e1.dot(e2), -1.0f, 1.0f)) * faceNn.transpose();
+
+            auto it = edgeSum.find(edgeKey(v0, v1));
+            if (it == edgeSum.end())
+            {
+                edgeSum.emplace(edgeKey(v0, v1), faceNn);
+            }
+            else
+            {
+                it->second += faceNn;
+            }
+        }
+    }
+
+    // Columns 0-2: edge 1-2, 3-5: edge 2-3, 6-8: edge 3-1
+    for (int i = 0; i < ntri; ++i)
+    {
+        for (int j = 0; j < 3; ++j)
+        {
+            edgeNn.block<1,3>(i, 3 * j) = edgeSum[edgeKey(tris(i, j), tris(i, (j + 1) % 3))].transpose();
+        }
+    }
+}
+
+//=============================================================================================================
+
+void MNEProjectToSurface::build_bvh()
+{
+    const int ntri = static_cast<int>(a.size());
+
+    bvhNodes.clear();
+    bvhTris.resize(ntri);
+    std::iota(bvhTris.begin(), bvhTris.end(), 0);
+    if (ntri == 0)
+    {
+        return;
+    }
+
+    MatrixX3f triMin(ntri,3), triMax(ntri,3), triCenter(ntri,3);
+    for (int i = 0; i < ntri; ++i)
+    {
+        const RowVector3f r2 = r1.row(i) + r12.row(i);
+        const RowVector3f r3 = r1.row(i) + r13.row(i);
+        triMin.row(i) = r1.row(i).cwiseMin(r2).cwiseMin(r3);
+        triMax.row(i) = r1.row(i).cwiseMax(r2).cwiseMax(r3);
+        triCenter.row(i) = (r1.row(i) + r2 + r3) / 3.0f;
+    }
+
+    // Depth-first construction: a left child is created right after its parent, a right child reports its index back
+    struct Task { int begin; int end; int parent; };
+    std::vector<Task> tasks;
+    tasks.push_back({0, ntri, -1});
+    bvhNodes.reserve(2 * (ntri / BVH_LEAF_SIZE + 1));
+
+    while (!tasks.empty())
+    {
+        const Task task = tasks.back();
+        tasks.pop_back();
+
+        const int node = static_cast<int>(bvhNodes.size());
+        if (task.parent >= 0)
+        {
+            bvhNodes[task.parent].first = node;
+        }
+
+        BvhNode bvhNode;
+        bvhNode.boxMin = triMin.row(bvhTris[task.begin]).transpose();
+        bvhNode.boxMax = triMax.row(bvhTris[task.begin]).transpose();
+        Vector3f centerMin = triCenter.row(bvhTris[task.begin]).transpose();
+        Vector3f centerMax = centerMin;
+        for (int k = task.begin + 1; k < task.end; ++k)
+        {
+            const int tri = bvhTris[k];
+            bvhNode.boxMin = bvhNode.boxMin.cwiseMin(triMin.row(tri).transpose());
+            bvhNode.boxMax = bvhNode.boxMax.cwiseMax(triMax.row(tri).transpose());
+            centerMin = centerMin.cwiseMin(triCenter.row(tri).transpose());
+            centerMax = centerMax.cwiseMax(triCenter.row(tri).transpose());
+        }
+
+        if (task.end - task.begin <= BVH_LEAF_SIZE)
+        {
+            bvhNode.first = task.begin;
+            bvhNode.count = task.end - task.begin;
+            bvhNodes.push_back(bvhNode);
+            continue;
+        }
+
+        // Split at the median of the centers along the longest extent
+        int axis = 0;
+        (centerMax - centerMin).maxCoeff(&axis);
+        const int mid = task.begin + (task.end - task.begin) / 2;
+        std::nth_element(bvhTris.begin() + task.begin, bvhTris.begin() + mid, bvhTris.begin() + task.end,
+                         [&triCenter, axis](int t1, int t2) { return triCenter(t1, axis) < triCenter(t2, axis); });
+
+        bvhNode.first = -1;
+        bvhNode.count = 0;
+        bvhNodes.push_back(bvhNode);
+
+        tasks.push_back({mid, task.end, node});
+        tasks.push_back({task.begin, mid, -1});
+    }
 }
 
 //=============================================================================================================
 
 bool MNEProjectToSurface::find_closest_on_surface(const MatrixXf &r, const int np, MatrixXf &rTri,
-                                                      VectorXi &nearest, VectorXf &dist)
+                                                      VectorXi &nearest, VectorXf &dist) const
 {
     // resize output
     nearest.resize(np);
@@ -120,15 +283,85 @@ bool MNEProjectToSurface::find_closest_on_surface(const MatrixXf &r, const int n
         qDebug() << "No surface loaded to make the projection./n";
         return false;
     }
+
+    if (np <= POINTS_PER_TASK)
+    {
+        return this->project_range(r, 0, np, rTri, nearest, dist);
+    }
+
+    // Each task writes its own rows of the outputs
+    std::vector<int> vecFirst;
+    for (int k = 0; k < np; k += POINTS_PER_TASK)
+    {
+        vecFirst.push_back(k);
+    }
+
+    std::atomic<bool> bOk(true);
+    QtConcurrent::blockingMap(vecFirst, [&](const int iFirst) {
+        if (!this->project_range(r, iFirst, std::min(iFirst + POINTS_PER_TASK, np), rTri, nearest, dist))
+        {
+            bOk = false;
+        }
+    });
+
+    return bOk;
+}
+
+//=============================================================================================================
+
+bool MNEProjectToSurface::signed_distance_to_surface(const MatrixXf &r, VectorXf &dist, VectorXi &nearest) const
+{
+    MatrixXf rTri;
+    if (!this->find_closest_on_surface(r, static_cast<int>(r.rows()), rTri, nearest, dist))
+    {
+        return false;
+    }
+
+    const float eps = 1e-5f;
+    float p, q, dist0;
+
+    for (int k = 0; k < r.rows(); ++k)
+    {
+        const int tri = nearest[k];
+        const RowVector3f diff = r.row(k) - rTri.row(k);
+        this->nearest_triangle_point(r.row(k).transpose(), tri, p, q, dist0);
+
+        // Pseudo-normal of the feature the closest point lies on: a corner, an edge or the inside of the triangle
+        RowVector3f normal;
+        const bool onP0 = p <= eps;
+        const bool onQ0 = q <= eps;
+        const bool onPQ1 = p + q >= 1.0f - eps;
+        if (onP0 && onQ0)
+            normal = this->vertNn.row(this->tris(tri, 0));
+        else if (onQ0 && onPQ1)
+            normal = this->vertNn.row(this->tris(tri, 1));
+        else if (onP0 && onPQ1)
+            normal = this->vertNn.row(this->tris(tri, 2));
+        else if (onQ0)
+            normal = this->edgeNn.block<1,3>(tri, 0);
+        else if (onPQ1)
+            normal = this->edgeNn.block<1,3>(tri, 3);
+        else if (onP0)
+            normal = this->edgeNn.block<1,3>(tri, 6);
+        else
+            normal = this->nn.row(tri);
+
+        const float absDist = diff.norm();
+        dist[k] = (normal.dot(diff) < 0.0f) ? -absDist : absDist;
+    }
+    return true;
+}
+
+//=============================================================================================================
+
+bool MNEProjectToSurface::project_range(const MatrixXf &r, int iFirst, int iLast, MatrixXf &rTri,
+                                        VectorXi &nearest, VectorXf &dist) const
+{
     int bestTri = -1;
     float bestDist = -1;
     Vector3f rTriK;
-    for (int k = 0; k < np; ++k)
+    for (int k = iFirst; k < iLast; ++k)
     {
-        /*
-         * To do: decide_search_restriction for the use in an iterative closest point to plane algorithm
-         * For now it's OK to go through all triangles.
-         */
         if (!this->project_to_surface(r.row(k).transpose(), rTriK, bestTri, bestDist))
         {
             qDebug() << "The projection of point number " << k << " didn't work./n";
@@ -143,25 +376,62 @@ bool MNEProjectToSurface::find_closest_on_surface(const MatrixXf &r, const int n
 
 //=============================================================================================================
 
-bool MNEProjectToSurface::project_to_surface(const Vector3f &r, Vector3f &rTri, int &bestTri, float &bestDist)
+bool MNEProjectToSurface::project_to_surface(const Vector3f &r, Vector3f &rTri, int &bestTri, float &bestDist) const
 {
     float p = 0, q = 0, p0 = 0, q0 = 0, dist0 = 0;
+    float bestAbs = std::numeric_limits<float>::infinity();
     bestDist = 0.0f;
     bestTri = -1;
-    for (int tri = 0; tri < a .size(); ++tri)
+
+    int stack[BVH_STACK_SIZE];
+    int top = 0;
+    if (!bvhNodes.empty())
+    {
+        stack[top++] = 0;
+    }
+
+    while (top > 0)
     {
-        if (!this->nearest_triangle_point(r, tri, p0, q0, dist0))
+        const int node = stack[--top];
+        const BvhNode &bvhNode = bvhNodes[node];
+
+        // A little slack, so that rounding in the triangle distances cannot hide a closer triangle
+        if (box_distance2(r, bvhNode.boxMin, bvhNode.boxMax) > bestAbs * bestAbs * 1.0001f)
         {
-            qDebug() << "The projection on triangle " << tri << " didn't work./n";
-            return false;
+            continue;
+        }
+
+        if (bvhNode.count == 0)
+        {
+            const int left = node + 1;
+            const int right = bvhNode.first;
+            const float distLeft = box_distance2(r, bvhNodes[left].boxMin, bvhNodes[left].boxMax);
+            const float distRight = box_distance2(r, bvhNodes[right].boxMin, bvhNodes[right].boxMax);
+            // Visit the closer child first
+            stack[top++] = (distLeft <= distRight) ? right : left;
+            stack[top++] = (distLeft <= distRight) ? left : right;
+            continue;
         }
 
-        if ((bestTri < 0) || (std::fabs(dist0) < std::fabs(bestDist)))
+        for (int k = bvhNode.first; k < bvhNode.first + bvhNode.count; ++k)
         {
-            bestDist = dist0;
-            p = p0;
-            q = q0;
-            bestTri = tri;
+            const int tri = bvhTris[k];
+            if (!this->nearest_triangle_point(r, tri, p0, q0, dist0))
+            {
+                qDebug() << "The projection on triangle " << tri << " didn't work./n";
+                return false;
+            }
+
+            // Ties go to the lower triangle index, as in a sequential search over all triangles
+            const float absDist = std::fabs(dist0);
+            if ((bestTri < 0) || (absDist < bestAbs) || (absDist == bestAbs && tri < bestTri))
+            {
+                bestDist = dist0;
+                bestAbs = absDist;
+                p = p0;
+                q = q0;
+                bestTri = tri;
+            }
         }
     }
 
@@ -181,7 +451,7 @@ bool MNEProjectToSurface::project_to_surface(const Vector3f &r, Vector3f &rTri,
 
 //=============================================================================================================
 
-bool MNEProjectToSurface::nearest_triangle_point(const Vector3f &r, const int tri, float &p, float &q, float &dist)
+bool MNEProjectToSurface::nearest_triangle_point(const Vector3f &r, const int tri, float &p, float &q, float &dist) const
 {
     //Calculate some helpers
     Vector3f rr = r - this->r1.row(tri).transpose(); //Vector from triangle corner #1 to r
@@ -289,7 +559,7 @@ bool MNEProjectToSurface::nearest_triangle_point(const Vector3f &r, const int tr
 
 //=============================================================================================================
 
-bool MNEProjectToSurface::project_to_triangle(Vector3f &rTri, const float p, const float q, const int tri)
+bool MNEProjectToSurface::project_to_triangle(Vector3f &rTri, const float p, const float q, const int tri) const
 {
     rTri = (this->r1.row(tri) + p*this->r12.row(tri) + q*this->r13.row(tri)).transpose();
     return true;
@@ -18,6 +18,18 @@
  * surface, when mapping discrete dipole sources to the nearest cortical
  * vertex and during head-shape registration. The implementation mirrors
  * @c mne_project_to_surface in the MNE C tools.
+ *
+ * The triangles are organised once, on construction, in a bounding-volume
+ * hierarchy of axis-aligned boxes, so that a query only visits the few
+ * triangles whose boxes can still hold a closer point instead of the whole
+ * mesh. Queries do not modify the object; batches of points are projected
+ * concurrently, and one object can be shared by all users of the same
+ * surface (e.g. the outlier rejection and the iterations of the ICP).
+ *
+ * UTILSLIB::PolhemusCoregistration does not use the hierarchy: it registers
+ * the head from the three digitized fiducials alone and never projects onto
+ * a surface, and the utils library sits below this one. Head points it
+ * acquires are refined against a surface with MNELIB::performIcp.
  */
 
 #ifndef MNELIB_MNEPROJECTTOSURFACE_H
@@ -35,6 +47,12 @@
 
 #include <QSharedPointer>
 
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <vector>
+
 //=============================================================================================================
 // EIGEN INCLUDES
 //=============================================================================================================
@@ -100,7 +118,24 @@ public:
      * @return true if succeeded, false otherwise.
      */
     bool find_closest_on_surface(const Eigen::MatrixXf &r, const int np, Eigen::MatrixXf &rTri,
-                                     Eigen::VectorXi &nearest, Eigen::VectorXf &dist);
+                                     Eigen::VectorXi &nearest, Eigen::VectorXf &dist) const;
+
+    //=========================================================================================================
+    /**
+     * Computes the signed distance of a set of points r to the surface: the distance to the closest point on the
+     * surface, positive outside (on the side the triangle normals point to) and negative inside. The sign is taken
+     * from the angle-weighted pseudo-normal of the closest face, edge or vertex, which is correct for any closed,
+     * consistently oriented surface.
+     *
+     * @brief Signed point-to-surface distance and nearest triangle per point.
+     *
+     * @param[in] r         Set of points (np x 3).
+     * @param[out] dist     Signed distance per point.
+     * @param[out] nearest  Nearest triangle per point.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool signed_distance_to_surface(const Eigen::MatrixXf &r, Eigen::VectorXf &dist, Eigen::VectorXi &nearest) const;
 
 protected:
 
@@ -118,7 +153,30 @@ private:
      *
      * @return true if succeeded, false otherwise.
      */
-    bool project_to_surface(const Eigen::Vector3f &r, Eigen::Vector3f &rTri, int &bestTri, float &bestDist);
+    bool project_to_surface(const Eigen::Vector3f &r, Eigen::Vector3f &rTri, int &bestTri, float &bestDist) const;
+
+    //=========================================================================================================
+    /**
+     * Projects the points [iFirst, iLast) of r on the surface.
+     *
+     * @return true if succeeded, false otherwise.
+     */
+    bool project_range(const Eigen::MatrixXf &r, int iFirst, int iLast, Eigen::MatrixXf &rTri,
+                       Eigen::VectorXi &nearest, Eigen::VectorXf &dist) const;
+
+    //=========================================================================================================
+    /**
+     * Builds the bounding-volume hierarchy over all triangles.
+     */
+    void build_bvh();
+
+    //=========================================================================================================
+    /**
+     * Computes the angle-weighted pseudo-normals of the vertices and edges.
+     *
+     * @param[in] p_MNEBemSurf   The surface.
+     */
+    void compute_pseudo_normals(const MNELIB::MNEBemSurface &p_MNEBemSurf);
 
     //=========================================================================================================
     /**
@@ -134,7 +192,7 @@ private:
      *
      * @return true if succeeded, false otherwise.
      */
-    bool nearest_triangle_point(const Eigen::Vector3f &r, const int tri, float &p, float &q, float &dist);
+    bool nearest_triangle_point(const Eigen::Vector3f &r, const int tri, float &p, float &q, float &dist) const;
 
     //=========================================================================================================
     /**
@@ -149,7 +207,17 @@ private:
      *
      * @return true if succeeded, false otherwise.
      */
-    bool project_to_triangle(Eigen::Vector3f &rTri, const float p, const float q, const int tri);
+    bool project_to_triangle(Eigen::Vector3f &rTri, const float p, const float q, const int tri) const;
+
+    /**
+     * Node of the bounding-volume hierarchy. The left child of an inner node directly follows it.
+     */
+    struct BvhNode {
+        Eigen::Vector3f boxMin;     /**< Lower corner of the box around all triangles below this node. */
+        Eigen::Vector3f boxMax;     /**< Upper corner of the box around all triangles below this node. */
+        int first;                  /**< Leaf: first entry in bvhTris. Inner node: index of the right child. */
+        int count;                  /**< Leaf: number of triangles, 0 for inner nodes. */
+    };
 
     Eigen::MatrixX3f r1;         /**< Cartesian Vector to the first triangel corner. */
     Eigen::MatrixX3f r12;        /**< Cartesian Vector from the first to the second triangel corner. */
@@ -159,6 +227,11 @@ private:
     Eigen::VectorXf b;           /**< r13*r13. */
     Eigen::VectorXf c;           /**< r12*r13. */
     Eigen::VectorXf det;         /**< Determinant of the Matrix [a c, c b]. */
+    Eigen::MatrixX3i tris;       /**< Vertex indices of the triangles. */
+    Eigen::MatrixX3f vertNn;     /**< Angle-weighted pseudo-normals of the vertices. */
+    Eigen::MatrixXf edgeNn;      /**< Pseudo-normals of the edges 1-2, 2-3 and 1-3 of each triangle (ntri x 9). */
+    std::vector<BvhNode> bvhNodes;  /**< The bounding-volume hierarchy, root first. */
+    std::vector<int> bvhTris;       /**< Triangle indices, ordered so that each leaf holds a contiguous range. */
 };
 
 //=============================================================================================================
@@ -0,0 +1,422 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     mri_inflate_stream.cpp
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Implementation of @ref MRILIB::MriInflateStream: chunked zlib inflate into caller buffers and the decode cache.
+ *
+ * The compressed file is read in 256 KiB chunks into a fixed input
+ * buffer; @c inflate() writes straight into the caller's destination,
+ * so the only extra memory is that chunk and zlib's 32 KiB window.
+ * Cache entries are named after a SHA-1 of the absolute path, size
+ * and modification time of the source, written through a
+ * @c QSaveFile while the file is decoded, and only committed by
+ * @ref MRILIB::MriInflateStream::finish once the whole gzip stream has
+ * been inflated without error, so a half-written or stale entry is
+ * never picked up. Every use of an entry refreshes its modification
+ * time, and each new entry evicts the entries used longest ago until
+ * the cache fits its size limit.
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mri_inflate_stream.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QStringList>
+
+#include <zlib.h>
+
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MRILIB;
+
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+constexpr qint64 INPUT_CHUNK_SIZE = 256 * 1024;        /**< Compressed bytes read from the file at a time. */
+constexpr qint64 MAX_INFLATE_SIZE = 1 << 30;           /**< Largest output handed to one inflate() (uInt). */
+constexpr qint64 DEFAULT_CACHE_LIMIT = qint64(2) << 30; /**< Default size limit of the decode cache. */
+
+QMutex& cacheMutex()
+{
+    static QMutex mutex;
+    return mutex;
+}
+
+QString& cacheDir()
+{
+    static QString dir;
+    return dir;
+}
+
+qint64& cacheLimit()
+{
+    static qint64 iLimit = DEFAULT_CACHE_LIMIT;
+    return iLimit;
+}
+
+const QStringList& cacheEntryFilter()
+{
+    static const QStringList filter = {QStringLiteral("*.raw")};
+    return filter;
+}
+
+} // anonymous namespace
+
+//=============================================================================================================
+// DEFINE PRIVATE TYPES
+//=============================================================================================================
+
+/**
+ * @internal
+ * @brief Owns the zlib inflate state, so that zlib stays out of the public header.
+ */
+struct MriInflateStream::ZState
+{
+    z_stream strm = {};
+    bool     bInitialized = false;
+
+    ~ZState()
+    {
+        if (bInitialized) {
+            inflateEnd(&strm);
+        }
+    }
+};
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MriInflateStream::MriInflateStream(const QString& fileName, bool bCompressed)
+: m_sFileName(fileName)
+, m_bCompressed(bCompressed)
+{
+}
+
+//=============================================================================================================
+
+MriInflateStream::~MriInflateStream()
+{
+    if (m_pCacheFile) {
+        m_pCacheFile->cancelWriting();
+    }
+}
+
+//=============================================================================================================
+
+bool MriInflateStream::open()
+{
+    const QString cacheName = m_bCompressed ? cacheFileName() : QString();
+
+    if (!cacheName.isEmpty() && QFileInfo::exists(cacheName)) {
+        m_file.setFileName(cacheName);
+        if (m_file.open(QIODevice::ReadOnly)) {
+            // The modification time tells the eviction how recently an entry was used
+            m_file.setFileTime(QDateTime::currentDateTime(), QFileDevice::FileModificationTime);
+            m_bCompressed = false;
+            m_bFromCache = true;
+            return true;
+        }
+    }
+
+    m_file.setFileName(m_sFileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        m_sError = m_file.errorString();
+        return false;
+    }
+
+    if (!m_bCompressed) {
+        return true;
+    }
+
+    // MAX_WBITS + 16 tells zlib to detect and handle gzip headers
+    m_pZ = std::make_unique<ZState>();
+    if (inflateInit2(&m_pZ->strm, MAX_WBITS + 16) != Z_OK) {
+        m_sError = QStringLiteral("inflateInit2 failed");
+        return false;
+    }
+    m_pZ->bInitialized = true;
+    m_inBuffer.resize(INPUT_CHUNK_SIZE);
+
+    if (!cacheName.isEmpty() && QDir().mkpath(QFileInfo(cacheName).absolutePath())) {
+        m_pCacheFile = std::make_unique<QSaveFile>(cacheName);
+        if (!m_pCacheFile->open(QIODevice::WriteOnly)) {
+            m_pCacheFile.reset();
+        }
+    }
+
+    return true;
+}
+
+//=============================================================================================================
+
+bool MriInflateStream::read(char* pData, qint64 iBytes)
+{
+    return readSome(pData, iBytes) == iBytes;
+}
+
+//=============================================================================================================
+
+bool MriInflateStream::skip(qint64 iBytes)
+{
+    if (iBytes <= 0) {
+        return iBytes == 0;
+    }
+
+    if (!m_bCompressed) {
+        if (m_file.pos() + iBytes > m_file.size() || !m_file.seek(m_file.pos() + iBytes)) {
+            return false;
+        }
+        m_iPos += iBytes;
+        return true;
+    }
+
+    QByteArray scratch(static_cast<int>(std::min(iBytes, INPUT_CHUNK_SIZE)), Qt::Uninitialized);
+    while (iBytes > 0) {
+        const qint64 iChunk = std::min<qint64>(iBytes, scratch.size());
+        if (readSome(scratch.data(), iChunk) != iChunk) {
+            return false;
+        }
+        iBytes -= iChunk;
+    }
+    return true;
+}
+
+//=============================================================================================================
+
+QByteArray MriInflateStream::readAll()
+{
+    if (!m_bCompressed) {
+        QByteArray rest = m_file.readAll();
+        m_iPos += rest.size();
+        return rest;
+    }
+
+    QByteArray rest;
+    qint64 iRead = 0;
+    do {
+        rest.resize(rest.size() + static_cast<int>(INPUT_CHUNK_SIZE));
+        iRead = readSome(rest.data() + rest.size() - INPUT_CHUNK_SIZE, INPUT_CHUNK_SIZE);
+        rest.resize(rest.size() - static_cast<int>(INPUT_CHUNK_SIZE - iRead));
+    } while (iRead == INPUT_CHUNK_SIZE);
+
+    return rest;
+}
+
+//=============================================================================================================
+
+bool MriInflateStream::finish()
+{
+    if (m_pCacheFile) {
+        // The cache entry has to hold the complete stream, not just what the reader needed
+        QByteArray scratch(static_cast<int>(INPUT_CHUNK_SIZE), Qt::Uninitialized);
+        while (readSome(scratch.data(), scratch.size()) > 0) {
+        }
+
+        if (m_sError.isEmpty() && m_bStreamEnd) {
+            if (m_pCacheFile->commit()) {
+                trimCache(QFileInfo(m_pCacheFile->fileName()).absolutePath(), cacheSizeLimit());
+            }
+        } else {
+            m_pCacheFile->cancelWriting();
+        }
+        m_pCacheFile.reset();
+    }
+
+    return m_sError.isEmpty();
+}
+
+//=============================================================================================================
+
+qint64 MriInflateStream::pos() const
+{
+    return m_iPos;
+}
+
+//=============================================================================================================
+
+bool MriInflateStream::isCached() const
+{
+    return m_bFromCache;
+}
+
+//=============================================================================================================
+
+QString MriInflateStream::errorString() const
+{
+    return m_sError;
+}
+
+//=============================================================================================================
+
+void MriInflateStream::setCacheDirectory(const QString& dir)
+{
+    QMutexLocker locker(&cacheMutex());
+    cacheDir() = dir;
+}
+
+//=============================================================================================================
+
+QString MriInflateStream::cacheDirectory()
+{
+    QMutexLocker locker(&cacheMutex());
+    return cacheDir();
+}
+
+//=============================================================================================================
+
+void MriInflateStream::setCacheSizeLimit(qint64 iBytes)
+{
+    QMutexLocker locker(&cacheMutex());
+    cacheLimit() = std::max<qint64>(iBytes, 0);
+}
+
+//=============================================================================================================
+
+qint64 MriInflateStream::cacheSizeLimit()
+{
+    QMutexLocker locker(&cacheMutex());
+    return cacheLimit();
+}
+
+//=============================================================================================================
+
+void MriInflateStream::clearCache()
+{
+    const QString dir = cacheDirectory();
+    if (dir.isEmpty()) {
+        return;
+    }
+
+    // Entries still being written are temporary QSaveFile files and are left alone
+    const QFileInfoList entries = QDir(dir).entryInfoList(cacheEntryFilter(), QDir::Files);
+    for (const QFileInfo& entry : entries) {
+        QFile::remove(entry.absoluteFilePath());
+    }
+}
+
+//=============================================================================================================
+
+qint64 MriInflateStream::readSome(char* pData, qint64 iBytes)
+{
+    if (!m_sError.isEmpty() || !m_file.isOpen()) {
+        return 0;
+    }
+
+    qint64 iTotal = 0;
+    while (iTotal < iBytes) {
+        const qint64 iRead = m_bCompressed ? inflateSome(pData + iTotal, iBytes - iTotal)
+                                           : m_file.read(pData + iTotal, iBytes - iTotal);
+        if (iRead < 0) {
+            m_sError = m_file.errorString();
+        }
+        if (iRead <= 0) {
+            break;
+        }
+        iTotal += iRead;
+    }
+
+    m_iPos += iTotal;
+    return iTotal;
+}
+
+//=============================================================================================================
+
+qint64 MriInflateStream::inflateSome(char* pData, qint64 iBytes)
+{
+    z_stream& strm = m_pZ->strm;
+    const qint64 iRequested = std::min(iBytes, MAX_INFLATE_SIZE);
+
+    strm.next_out = reinterpret_cast<Bytef*>(pData);
+    strm.avail_out = static_cast<uInt>(iRequested);
+
+    while (strm.avail_out > 0 && !m_bStreamEnd) {
+        if (strm.avail_in == 0) {
+            const qint64 iRead = m_file.read(m_inBuffer.data(), m_inBuffer.size());
+            if (iRead <= 0) {
+                m_sError = iRead < 0 ? m_file.errorString()
+                                     : QStringLiteral("Unexpected end of compressed data");
+                break;
+            }
+            strm.next_in = reinterpret_cast<Bytef*>(m_inBuffer.data());
+            strm.avail_in = static_cast<uInt>(iRead);
+        }
+
+        const int ret = inflate(&strm, Z_NO_FLUSH);
+        if (ret == Z_STREAM_END) {
+            m_bStreamEnd = true;
+        } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+            m_sError = QStringLiteral("inflate failed - zlib error: %1").arg(ret);
+            break;
+        }
+    }
+
+    const qint64 iProduced = iRequested - static_cast<qint64>(strm.avail_out);
+    if (iProduced > 0 && m_pCacheFile) {
+        m_pCacheFile->write(pData, iProduced);
+    }
+    return iProduced;
+}
+
+//=============================================================================================================
+
+void MriInflateStream::trimCache(const QString& dir, qint64 iLimit)
+{
+    // Newest first, so everything past the limit was used longest ago. An entry which is open elsewhere may
+    // fail to be removed on some platforms; it is then retried on the next trim.
+    const QFileInfoList entries = QDir(dir).entryInfoList(cacheEntryFilter(), QDir::Files, QDir::Time);
+    qint64 iTotal = 0;
+    for (const QFileInfo& entry : entries) {
+        iTotal += entry.size();
+        if (iTotal > iLimit) {
+            QFile::remove(entry.absoluteFilePath());
+        }
+    }
+}
+
+//=============================================================================================================
+
+QString MriInflateStream::cacheFileName() const
+{
+    const QString dir = cacheDirectory();
+    const QFileInfo info(m_sFileName);
+    if (dir.isEmpty() || !info.exists()) {
+        return QString();
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(info.absoluteFilePath().toUtf8());
+    hash.addData(QByteArray::number(info.size()));
+    hash.addData(QByteArray::number(info.lastModified().toMSecsSinceEpoch()));
+
+    return QDir(dir).filePath(QString::fromLatin1(hash.result().toHex()) + QStringLiteral(".raw"));
+}
@@ -0,0 +1,217 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     mri_inflate_stream.h
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Sequential reader over plain or gzip-compressed volume files that inflates straight into caller buffers.
+ *
+ * @ref MriMghIO and @ref MriNiftiIO read their containers front to back:
+ * a fixed header, one slice after the other, and an optional footer.
+ * @ref MRILIB::MriInflateStream serves exactly that access pattern. For
+ * @c .mgz / @c .nii.gz inputs the compressed file is read in 256 KiB
+ * chunks and zlib inflates directly into the destination the caller
+ * passes to @ref MriInflateStream::read, typically the pixel buffer of
+ * an @ref MriSlice, so a volume never exists twice in memory.
+ *
+ * Optionally the decoded bytes are cached on disk: when a cache
+ * directory is set, the first read of a compressed file writes the
+ * inflated stream next to the decode, and later opens of the same
+ * file (same path, size and modification time) read the cached
+ * uncompressed copy instead of inflating again.
+ */
+
+#ifndef MRI_INFLATE_STREAM_H
+#define MRI_INFLATE_STREAM_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "mri_global.h"
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <memory>
+
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class QSaveFile;
+
+//=============================================================================================================
+// DEFINE NAMESPACE MRILIB
+//=============================================================================================================
+
+namespace MRILIB {
+
+//=============================================================================================================
+/**
+ * @brief Forward-only byte stream over a plain or gzip file, with an optional on-disk cache of the inflated bytes.
+ *
+ * @code
+ *   MriInflateStream stream(path, path.endsWith(".mgz"));
+ *   if (!stream.open() || !stream.read(header.data(), header.size())) { ... }
+ *   stream.read(reinterpret_cast<char*>(slice.pixels.data()), slice.pixels.size());
+ *   ...
+ *   stream.finish();       // completes and publishes the cache entry
+ * @endcode
+ */
+class MRISHARED_EXPORT MriInflateStream
+{
+public:
+    //=========================================================================================================
+    /**
+     * Constructs a stream over a file. Nothing is opened yet.
+     *
+     * @param[in] fileName      Path to the file.
+     * @param[in] bCompressed   Whether the file is gzip-compressed.
+     */
+    MriInflateStream(const QString& fileName, bool bCompressed);
+
+    //=========================================================================================================
+    /**
+     * Destructor. Discards an unfinished cache entry.
+     */
+    ~MriInflateStream();
+
+    MriInflateStream(const MriInflateStream&) = delete;
+    MriInflateStream& operator=(const MriInflateStream&) = delete;
+
+    //=========================================================================================================
+    /**
+     * Opens the file, or its cached uncompressed copy if there is one.
+     *
+     * @return True on success.
+     */
+    bool open();
+
+    //=========================================================================================================
+    /**
+     * Reads exactly iBytes bytes.
+     *
+     * @param[out] pData    Destination.
+     * @param[in] iBytes    Number of bytes.
+     *
+     * @return True if all bytes were read, false at the end of the stream or on a decode error.
+     */
+    bool read(char* pData, qint64 iBytes);
+
+    //=========================================================================================================
+    /**
+     * Skips iBytes bytes.
+     *
+     * @param[in] iBytes    Number of bytes.
+     *
+     * @return True if all bytes could be skipped.
+     */
+    bool skip(qint64 iBytes);
+
+    //=========================================================================================================
+    /**
+     * Reads the remainder of the stream.
+     *
+     * @return The remaining bytes; empty at the end of the stream.
+     */
+    QByteArray readAll();
+
+    //=========================================================================================================
+    /**
+     * Consumes the rest of the stream and, if a cache entry is being written, publishes it. Call this once
+     * the file has been read successfully.
+     *
+     * @return True if the stream ended cleanly.
+     */
+    bool finish();
+
+    //=========================================================================================================
+    /**
+     * @return Number of (uncompressed) bytes consumed so far.
+     */
+    qint64 pos() const;
+
+    //=========================================================================================================
+    /**
+     * @return Whether the stream is read from the cache rather than from the original file.
+     */
+    bool isCached() const;
+
+    //=========================================================================================================
+    /**
+     * @return Description of the last error.
+     */
+    QString errorString() const;
+
+    //=========================================================================================================
+    /**
+     * Sets the directory in which decoded copies of compressed files are cached. An empty path (the default)
+     * disables the cache. Applies to all streams opened afterwards.
+     *
+     * @param[in] dir   Cache directory; created on demand.
+     */
+    static void setCacheDirectory(const QString& dir);
+
+    //=========================================================================================================
+    /**
+     * @return The cache directory, or an empty string if caching is disabled.
+     */
+    static QString cacheDirectory();
+
+    //=========================================================================================================
+    /**
+     * Sets the total size the cache may occupy. Whenever a new entry is written, the least recently used
+     * entries are removed until the cache fits. Default: 2 GiB.
+     *
+     * @param[in] iBytes    Size limit in bytes.
+     */
+    static void setCacheSizeLimit(qint64 iBytes);
+
+    //=========================================================================================================
+    /**
+     * @return The size limit of the cache in bytes.
+     */
+    static qint64 cacheSizeLimit();
+
+    //=========================================================================================================
+    /**
+     * Removes all entries from the cache directory.
+     */
+    static void clearCache();
+
+private:
+    qint64 readSome(char* pData, qint64 iBytes);
+    qint64 inflateSome(char* pData, qint64 iBytes);
+    QString cacheFileName() const;
+    static void trimCache(const QString& dir, qint64 iLimit);
+
+    struct ZState;
+
+    QString                     m_sFileName;            /**< Path of the original file. */
+    bool                        m_bCompressed;          /**< Whether m_file has to be inflated. */
+    QFile                       m_file;                 /**< The original file or its cached copy. */
+    std::unique_ptr<ZState>     m_pZ;                   /**< Inflate state, for compressed input. */
+    QByteArray                  m_inBuffer;             /**< Compressed input chunk. */
+    bool                        m_bStreamEnd = false;   /**< Whether the gzip stream has ended. */
+    std::unique_ptr<QSaveFile>  m_pCacheFile;           /**< Cache entry being written, if any. */
+    bool                        m_bFromCache = false;   /**< Whether m_file is a cached copy. */
+    qint64                      m_iPos = 0;             /**< Uncompressed bytes consumed. */
+    QString                     m_sError;               /**< Last error. */
+};
+
+} // namespace MRILIB
+
+#endif // MRI_INFLATE_STREAM_H
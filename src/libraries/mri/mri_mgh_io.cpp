@@ -14,10 +14,11 @@
  * UCHAR / SHORT / INT / FLOAT --- so quantisation is preserved
  * instead of being eagerly promoted to float), and the optional
  * footer-tag walker that recovers TR / TE / flipAngle / FoV plus
- * the @c talairach.xfm path. MGZ inputs are routed through a
- * single zlib @c inflate() call with @c MAX_WBITS+16 (gzip
- * wrapping enabled) so the on-disk and in-memory paths share the
- * same parser. Output is materialised as the slice-of-slices
+ * the @c talairach.xfm path. Both MGH and MGZ inputs are read
+ * through @ref MriInflateStream, which inflates MGZ on the fly, so
+ * each slice is decoded straight into its native pixel buffer and
+ * the compressed and uncompressed paths share the same parser.
+ * Output is materialised as the slice-of-slices
  * @ref MriVolData representation consumed by every downstream
  * rendering and export path.
  * Ported from make_mgh_cor_set() in MNE C mne_make_cor_set by Matti Hamalainen.
@@ -28,6 +29,7 @@
 //=============================================================================================================
 
 #include "mri_mgh_io.h"
+#include "mri_inflate_stream.h"
 
 #include <fiff/fiff_coord_trans.h>
 #include <fiff/fiff_constants.h>
@@ -42,9 +44,13 @@
 #include <QDataStream>
 #include <QDebug>
 #include <QRegularExpression>
-#include <QDebug>
+#include <QtEndian>
 
-#include <zlib.h>
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cstring>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -72,33 +78,25 @@ bool MriMghIO::read(const QString& mgzFile,
 {
     volData.fileName = mgzFile;
 
-    // Step 1: Get raw (decompressed) bytes
+    // Step 1: Open the (possibly gzip-compressed) byte stream; .mgz is inflated on the fly
     bool isCompressed = mgzFile.endsWith(".mgz", Qt::CaseInsensitive);
-    QByteArray fileData;
+    MriInflateStream stream(mgzFile, isCompressed);
 
-    if (isCompressed) {
-        if (!decompress(mgzFile, fileData)) {
-            return false;
-        }
-    } else {
-        QFile file(mgzFile);
-        if (!file.open(QIODevice::ReadOnly)) {
-            qCritical() << "MriMghIO::read - Could not open" << mgzFile;
-            return false;
-        }
-        fileData = file.readAll();
-        file.close();
+    if (!stream.open()) {
+        qCritical() << "MriMghIO::read - Could not open" << mgzFile << "-" << stream.errorString();
+        return false;
     }
 
-    if (fileData.size() < MRI_MGH_DATA_OFFSET) {
+    QByteArray header(MRI_MGH_DATA_OFFSET, '\0');
+    if (!stream.read(header.data(), header.size())) {
         qCritical() << "MriMghIO::read - File" << mgzFile
                      << "is too small to be a valid MGH file ("
-                     << fileData.size() << "bytes)";
+                     << stream.pos() << "bytes)" << stream.errorString();
         return false;
     }
 
     // Step 2: Parse header
-    if (!parseHeader(fileData, volData, verbose)) {
+    if (!parseHeader(header, volData, verbose)) {
         return false;
     }
 
@@ -116,12 +114,16 @@ bool MriMghIO::read(const QString& mgzFile,
     }
 
     // Step 4: Read voxel data
-    if (!readVoxelData(fileData, volData)) {
+    if (!readVoxelData(stream, volData)) {
         return false;
     }
 
     // Step 5: Parse footer (optional)
-    parseFooter(fileData, volData, additionalTrans, subjectMriDir, verbose);
+    parseFooter(stream.readAll(), volData, additionalTrans, subjectMriDir, verbose);
+
+    if (!stream.finish()) {
+        qWarning() << "MriMghIO::read -" << mgzFile << ":" << stream.errorString();
+    }
 
     if (verbose) {
         qInfo("Read %d slices from %s (%dx%d pixels)\n",
@@ -134,60 +136,6 @@ bool MriMghIO::read(const QString& mgzFile,
 
 //=============================================================================================================
 
-bool MriMghIO::decompress(const QString& mgzFile, QByteArray& rawData)
-{
-    QFile file(mgzFile);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qCritical() << "MriMghIO::decompress - Could not open" << mgzFile;
-        return false;
-    }
-    QByteArray compressedData = file.readAll();
-    file.close();
-
-    if (compressedData.isEmpty()) {
-        qCritical() << "MriMghIO::decompress - File is empty:" << mgzFile;
-        return false;
-    }
-
-    // Use zlib to decompress gzip data in memory
-    z_stream strm = {};
-
-    // MAX_WBITS + 16 tells zlib to detect and handle gzip headers
-    int ret = inflateInit2(&strm, MAX_WBITS + 16);
-    if (ret != Z_OK) {
-        qCritical() << "MriMghIO::decompress - inflateInit2 failed";
-        return false;
-    }
-
-    strm.next_in = reinterpret_cast<Bytef*>(compressedData.data());
-    strm.avail_in = static_cast<uInt>(compressedData.size());
-
-    const int chunkSize = 256 * 1024;  // 256 KB chunks
-    rawData.clear();
-
-    do {
-        rawData.resize(rawData.size() + chunkSize);
-        strm.next_out = reinterpret_cast<Bytef*>(rawData.data() + rawData.size() - chunkSize);
-        strm.avail_out = chunkSize;
-
-        ret = inflate(&strm, Z_NO_FLUSH);
-        if (ret == Z_STREAM_ERROR || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR) {
-            qCritical() << "MriMghIO::decompress - inflate failed for" << mgzFile
-                         << "- zlib error:" << ret;
-            inflateEnd(&strm);
-            return false;
-        }
-    } while (ret != Z_STREAM_END);
-
-    // Trim to actual decompressed size
-    rawData.resize(rawData.size() - static_cast<int>(strm.avail_out));
-    inflateEnd(&strm);
-
-    return true;
-}
-
-//=============================================================================================================
-
 bool MriMghIO::parseHeader(const QByteArray& data, MriVolData& volData, bool verbose)
 {
     //
@@ -266,12 +214,13 @@ bool MriMghIO::parseHeader(const QByteArray& data, MriVolData& volData, bool ver
 
 //=============================================================================================================
 
-bool MriMghIO::readVoxelData(const QByteArray& data, MriVolData& volData)
+bool MriMghIO::readVoxelData(MriInflateStream& stream, MriVolData& volData)
 {
     //
     // Read voxel data starting at byte 284 (MRI_MGH_DATA_OFFSET).
     // Data layout in MGH: [width][height][depth][frames] in Fortran order (x fastest).
-    // Only the first frame is read.
+    // Only the first frame is read. Each slice is read straight into its native
+    // pixel buffer and byte-swapped in place.
     //
 
     int bpv = bytesPerVoxel(volData.type);
@@ -280,19 +229,9 @@ bool MriMghIO::readVoxelData(const QByteArray& data, MriVolData& volData)
         return false;
     }
 
-    qint64 frameSize = static_cast<qint64>(volData.width) * volData.height * volData.depth * bpv;
-    if (data.size() < MRI_MGH_DATA_OFFSET + frameSize) {
-        qCritical() << "MriMghIO::readVoxelData - File too small for expected data size";
-        return false;
-    }
-
-    QDataStream stream(data);
-    stream.setByteOrder(QDataStream::BigEndian);
-    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-    stream.device()->seek(MRI_MGH_DATA_OFFSET);
-
     int nslice = volData.depth;
     int nPixels = volData.width * volData.height;
+    qint64 sliceBytes = static_cast<qint64>(nPixels) * bpv;
     volData.slices.resize(nslice);
 
     // Build the vox2ras transform for per-slice transforms
@@ -304,52 +243,58 @@ bool MriMghIO::readVoxelData(const QByteArray& data, MriVolData& volData)
         slice.height = volData.height;
         slice.dimx   = volData.xsize / 1000.0f;  // mm -> meters
         slice.dimy   = volData.ysize / 1000.0f;
+        slice.scale  = 1.0f;
 
         // Read pixel data for this slice
+        char* dst = nullptr;
         switch (volData.type) {
-            case MRI_UCHAR: {
+            case MRI_UCHAR:
                 slice.pixelFormat = FIFFV_MRI_PIXEL_BYTE;
                 slice.pixels.resize(nPixels);
-                for (int p = 0; p < nPixels; ++p) {
-                    quint8 val;
-                    stream >> val;
-                    slice.pixels[p] = val;
-                }
-                slice.scale = 1.0f;
+                dst = reinterpret_cast<char*>(slice.pixels.data());
                 break;
-            }
-            case MRI_SHORT: {
+            case MRI_SHORT:
                 slice.pixelFormat = FIFFV_MRI_PIXEL_WORD;
                 slice.pixelsWord.resize(nPixels);
+                dst = reinterpret_cast<char*>(slice.pixelsWord.data());
+                break;
+            case MRI_INT:
+            case MRI_FLOAT:
+                // INT is converted to FLOAT in place (same width)
+                slice.pixelFormat = FIFFV_MRI_PIXEL_FLOAT;
+                slice.pixelsFloat.resize(nPixels);
+                dst = reinterpret_cast<char*>(slice.pixelsFloat.data());
+                break;
+        }
+
+        if (!stream.read(dst, sliceBytes)) {
+            qCritical() << "MriMghIO::readVoxelData - File too small for expected data size"
+                         << stream.errorString();
+            return false;
+        }
+
+        switch (volData.type) {
+            case MRI_SHORT: {
+                unsigned short* pix = slice.pixelsWord.data();
                 for (int p = 0; p < nPixels; ++p) {
-                    qint16 val;
-                    stream >> val;
-                    slice.pixelsWord[p] = static_cast<unsigned short>(val < 0 ? 0 : val);
+                    qint16 val = qFromBigEndian<qint16>(pix + p);
+                    pix[p] = static_cast<unsigned short>(val < 0 ? 0 : val);
                 }
-                slice.scale = 1.0f;
                 break;
             }
             case MRI_INT: {
-                // Convert INT to FLOAT
-                slice.pixelFormat = FIFFV_MRI_PIXEL_FLOAT;
-                slice.pixelsFloat.resize(nPixels);
+                float* pix = slice.pixelsFloat.data();
                 for (int p = 0; p < nPixels; ++p) {
-                    qint32 val;
-                    stream >> val;
-                    slice.pixelsFloat[p] = static_cast<float>(val);
+                    pix[p] = static_cast<float>(qFromBigEndian<qint32>(pix + p));
                 }
-                slice.scale = 1.0f;
                 break;
             }
             case MRI_FLOAT: {
-                slice.pixelFormat = FIFFV_MRI_PIXEL_FLOAT;
-                slice.pixelsFloat.resize(nPixels);
+                float* pix = slice.pixelsFloat.data();
                 for (int p = 0; p < nPixels; ++p) {
-                    float val;
-                    stream >> val;
-                    slice.pixelsFloat[p] = val;
+                    quint32 bits = qFromBigEndian<quint32>(pix + p);
+                    std::memcpy(pix + p, &bits, sizeof(float));
                 }
-                slice.scale = 1.0f;
                 break;
             }
         }
@@ -388,21 +333,13 @@ bool MriMghIO::parseFooter(const QByteArray& data,
                            bool verbose)
 {
     //
-    // The footer starts after the voxel data.
+    // The footer starts after the voxel data; data holds the bytes from there on.
     // It contains (in order):
     //   1. Scan parameters: TR(f32), flipAngle(f32), TE(f32), TI(f32), FoV(f32)
     //   2. Tags: tagType(i32) + tagLen(i32 or i64) + tagData
     //
 
-    int bpv = bytesPerVoxel(volData.type);
-    if (bpv == 0) {
-        bpv = 1; // Fallback for footer calculation
-    }
-
-    qint64 frameSize = static_cast<qint64>(volData.width) * volData.height * volData.depth * bpv;
-    qint64 footerPos = MRI_MGH_DATA_OFFSET + frameSize;
-
-    if (data.size() <= footerPos) {
+    if (data.isEmpty()) {
         // No footer — that's fine
         return true;
     }
@@ -410,12 +347,10 @@ bool MriMghIO::parseFooter(const QByteArray& data,
     QDataStream stream(data);
     stream.setByteOrder(QDataStream::BigEndian);
     stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-    stream.device()->seek(footerPos);
 
     // Read scan parameters (5 × float32 = 20 bytes)
     constexpr int kScanParamBytes = 5 * sizeof(float);
-    qint64 remainingBytes = data.size() - footerPos;
-    if (remainingBytes >= kScanParamBytes) {
+    if (data.size() >= kScanParamBytes) {
         stream >> volData.TR >> volData.flipAngle >> volData.TE >> volData.TI >> volData.FoV;
     } else {
         return true;
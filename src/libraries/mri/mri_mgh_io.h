@@ -14,8 +14,8 @@
  * optional tag footer carrying scan parameters and the path to
  * @c talairach.xfm. MGZ is the same layout wrapped in a single
  * gzip stream; this reader handles both transparently by detecting
- * the @c .mgz suffix and routing the file through zlib's
- * @c MAX_WBITS+16 inflate mode before parsing.
+ * the @c .mgz suffix and inflating the file chunk by chunk while
+ * it is parsed (see @ref MriInflateStream).
  *
  * Output is materialised into an @ref MriVolData (slice-of-slices
  * representation) using the same per-slice pixel formats the
@@ -80,6 +80,12 @@
 
 namespace MRILIB {
 
+//=============================================================================================================
+// MRILIB FORWARD DECLARATIONS
+//=============================================================================================================
+
+class MriInflateStream;
+
 //=============================================================================================================
 /**
  * @brief Stateless decoder for FreeSurfer MGH and MGZ volume containers.
@@ -87,9 +93,9 @@ namespace MRILIB {
  * Parses the 284-byte big-endian header, decodes the column-major voxel
  * buffer for every supported MRI type (uchar, int, float, short) and reads
  * the optional tag footer (scan parameters, @c talairach.xfm path) into an
- * @ref MriVolData. @c .mgz inputs are inflated in-memory through zlib's
- * @c MAX_WBITS+16 gunzip mode before parsing, so callers never need to know
- * whether they are looking at the compressed or uncompressed variant.
+ * @ref MriVolData. @c .mgz inputs are inflated on the fly straight into the
+ * slice buffers, so callers never need to know whether they are looking at
+ * the compressed or uncompressed variant, and the volume is never held twice.
  *
  * Format reference:
  * https://surfer.nmr.mgh.harvard.edu/fswiki/FsTutorial/MghFormat
@@ -108,7 +114,8 @@ public:
      * center RAS), reads voxel data into per-slice MriSlice structures, and
      * extracts footer tags including the Talairach .xfm path.
      *
-     * For .mgz files, automatic gzip decompression is performed via zlib.
+     * For .mgz files, the gzip stream is inflated while the slices are read. If a cache directory is set
+     * (MriInflateStream::setCacheDirectory), the decoded file is cached there and reused on later reads.
      *
      * @param[in]  mgzFile         Path to the .mgz or .mgh file.
      * @param[out] volData          MriVolData structure to populate.
@@ -125,22 +132,11 @@ public:
                      bool verbose = false);
 
 private:
-    //=========================================================================================================
-    /**
-     * Decompresses a .mgz file to raw MGH bytes.
-     *
-     * @param[in]  mgzFile  Path to the .mgz file.
-     * @param[out] rawData  Decompressed byte array.
-     *
-     * @return True on success.
-     */
-    static bool decompress(const QString& mgzFile, QByteArray& rawData);
-
     //=========================================================================================================
     /**
      * Parses the MGH header from raw bytes.
      *
-     * @param[in]  data     Raw MGH file data.
+     * @param[in]  data     The first MRI_MGH_DATA_OFFSET bytes of the file.
      * @param[out] volData  MriVolData to populate with header fields.
      * @param[in]  verbose  Print header info.
      *
@@ -150,20 +146,20 @@ private:
 
     //=========================================================================================================
     /**
-     * Reads voxel data and builds per-slice MriSlice structures.
+     * Reads the first frame slice by slice into native-type MriSlice buffers.
      *
-     * @param[in]  data     Raw MGH file data.
+     * @param[in]  stream   Stream positioned at MRI_MGH_DATA_OFFSET.
      * @param[out] volData  MriVolData to populate with slice data.
      *
      * @return True on success.
      */
-    static bool readVoxelData(const QByteArray& data, MriVolData& volData);
+    static bool readVoxelData(MriInflateStream& stream, MriVolData& volData);
 
     //=========================================================================================================
     /**
      * Parses the MGH footer for scan parameters and tags (Talairach .xfm path).
      *
-     * @param[in]  data             Raw MGH file data.
+     * @param[in]  data             File bytes following the first frame.
      * @param[out] volData          MriVolData to populate with footer data.
      * @param[out] additionalTrans  Coordinate transforms found in tags.
      * @param[in]  subjectMriDir   Path to subject's mri/ directory.
@@ -21,8 +21,9 @@
  * (the same ordering nibabel and FSL use) that produces a
  * single canonical voxel\u2192RAS affine regardless of how the
  * source file was authored. The @c .nii.gz path shares the
- * MGZ zlib decoder so both compressed formats route through
- * the same code.
+ * MGZ decoder (@ref MriInflateStream), which inflates into the
+ * slice buffers as they are read, so both compressed formats
+ * route through the same code and the optional decode cache.
  */
 
 //=============================================================================================================
@@ -31,6 +32,7 @@
 
 #include "mri_nifti_io.h"
 
+#include "mri_inflate_stream.h"
 #include "mri_types.h"
 #include "mri_vol_data.h"
 
@@ -41,9 +43,7 @@
 //=============================================================================================================
 
 #include <QByteArray>
-#include <QDataStream>
 #include <QDebug>
-#include <QFile>
 #include <QtEndian>
 
 //=============================================================================================================
@@ -56,8 +56,6 @@
 // SYSTEM INCLUDES
 //=============================================================================================================
 
-#include <zlib.h>
-
 #include <cmath>
 #include <cstring>
 
@@ -97,54 +95,34 @@ T readBE(const char* p)
     return qFromBigEndian(v);
 }
 
+template <typename T>
+T fromFileOrder(const void* p, bool bigEndian)
+{
+    return bigEndian ? qFromBigEndian<T>(p) : qFromLittleEndian<T>(p);
+}
+
 } // namespace
 
 //=============================================================================================================
 
 bool MriNiftiIO::decompress(const QString& gzFile, QByteArray& rawData)
 {
-    QFile file(gzFile);
-    if (!file.open(QIODevice::ReadOnly)) {
-        qCritical() << "MriNiftiIO::decompress - Could not open" << gzFile;
+    MriInflateStream stream(gzFile, true);
+    if (!stream.open()) {
+        qCritical() << "MriNiftiIO::decompress - Could not open" << gzFile << "-" << stream.errorString();
         return false;
     }
-    const QByteArray compressed = file.readAll();
-    file.close();
 
-    if (compressed.isEmpty()) {
-        qCritical() << "MriNiftiIO::decompress - File is empty:" << gzFile;
+    rawData = stream.readAll();
+    if (!stream.finish()) {
+        qCritical() << "MriNiftiIO::decompress - inflate failed for" << gzFile
+                    << "-" << stream.errorString();
         return false;
     }
-
-    z_stream strm = {};
-    if (inflateInit2(&strm, MAX_WBITS + 16) != Z_OK) {
-        qCritical() << "MriNiftiIO::decompress - inflateInit2 failed";
+    if (rawData.isEmpty()) {
+        qCritical() << "MriNiftiIO::decompress - File is empty:" << gzFile;
         return false;
     }
-
-    strm.next_in  = reinterpret_cast<Bytef*>(const_cast<char*>(compressed.data()));
-    strm.avail_in = static_cast<uInt>(compressed.size());
-
-    const int chunkSize = 256 * 1024;
-    rawData.clear();
-
-    int ret = Z_OK;
-    do {
-        rawData.resize(rawData.size() + chunkSize);
-        strm.next_out  = reinterpret_cast<Bytef*>(rawData.data() + rawData.size() - chunkSize);
-        strm.avail_out = chunkSize;
-
-        ret = inflate(&strm, Z_NO_FLUSH);
-        if (ret == Z_STREAM_ERROR || ret == Z_DATA_ERROR || ret == Z_MEM_ERROR) {
-            qCritical() << "MriNiftiIO::decompress - inflate failed for" << gzFile
-                        << "- zlib error:" << ret;
-            inflateEnd(&strm);
-            return false;
-        }
-    } while (ret != Z_STREAM_END);
-
-    rawData.resize(rawData.size() - static_cast<int>(strm.avail_out));
-    inflateEnd(&strm);
     return true;
 }
 
@@ -154,27 +132,21 @@ bool MriNiftiIO::read(const QString& niiFile, MriVolData& volData, bool verbose)
 {
     volData.fileName = niiFile;
 
-    QByteArray bytes;
     const bool compressed = niiFile.endsWith(QStringLiteral(".gz"), Qt::CaseInsensitive);
-    if (compressed) {
-        if (!decompress(niiFile, bytes)) {
-            return false;
-        }
-    } else {
-        QFile f(niiFile);
-        if (!f.open(QIODevice::ReadOnly)) {
-            qCritical() << "MriNiftiIO::read - Could not open" << niiFile;
-            return false;
-        }
-        bytes = f.readAll();
+    MriInflateStream stream(niiFile, compressed);
+    if (!stream.open()) {
+        qCritical() << "MriNiftiIO::read - Could not open" << niiFile << "-" << stream.errorString();
+        return false;
     }
 
-    if (bytes.size() < NIFTI_HDR_SIZE) {
-        qCritical() << "MriNiftiIO::read - file too small (" << bytes.size() << "bytes) :" << niiFile;
+    QByteArray header(NIFTI_HDR_SIZE, '\0');
+    if (!stream.read(header.data(), header.size())) {
+        qCritical() << "MriNiftiIO::read - file too small (" << stream.pos() << "bytes) :" << niiFile
+                    << stream.errorString();
         return false;
     }
 
-    const char* hdr = bytes.constData();
+    const char* hdr = header.constData();
 
     // Endianness detection via sizeof_hdr (must be 348).
     qint32 sizeofHdr = readLE<qint32>(hdr);
@@ -326,20 +298,15 @@ bool MriNiftiIO::read(const QString& niiFile, MriVolData& volData, bool verbose)
 
     // Read voxel data starting at vox_offset (typically 352 for single-file).
     const qint64 dataOff = static_cast<qint64>(voxOffset > 0.0f ? voxOffset : NIFTI_HDR_SIZE + 4);
-    const qint64 frameSize = static_cast<qint64>(nx) * ny * nz * bpv;
-    if (bytes.size() < dataOff + frameSize) {
-        qCritical() << "MriNiftiIO::read - data section truncated (need"
-                    << (dataOff + frameSize) << "bytes, got" << bytes.size() << ")";
+    if (!stream.skip(dataOff - NIFTI_HDR_SIZE)) {
+        qCritical() << "MriNiftiIO::read - data section truncated (vox_offset" << dataOff
+                    << "beyond end of file)";
         return false;
     }
 
-    QDataStream stream(bytes);
-    stream.setByteOrder(bigEndian ? QDataStream::BigEndian : QDataStream::LittleEndian);
-    stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
-    stream.device()->seek(dataOff);
-
     const int nslice = nz;
     const int nPixels = nx * ny;
+    const qint64 sliceBytes = static_cast<qint64>(nPixels) * bpv;
     volData.slices.resize(nslice);
 
     const Matrix4f vox2rasFinal = volData.computeVox2Ras();
@@ -353,60 +320,70 @@ bool MriNiftiIO::read(const QString& niiFile, MriVolData& volData, bool verbose)
         slice.dimy   = sy / 1000.0f;
         slice.scale  = 1.0f;
 
+        // Each slice is read straight into its native pixel buffer and converted in place
+        char* dst = nullptr;
         switch (mriType) {
-            case MRI_UCHAR: {
+            case MRI_UCHAR:
                 slice.pixelFormat = FIFFV_MRI_PIXEL_BYTE;
                 slice.pixels.resize(nPixels);
-                if (datatype == DT_INT8) {
-                    for (int p = 0; p < nPixels; ++p) {
-                        qint8 v;
-                        stream >> v;
-                        slice.pixels[p] = static_cast<unsigned char>(v < 0 ? 0 : v);
-                    }
-                } else {
-                    for (int p = 0; p < nPixels; ++p) {
-                        quint8 v;
-                        stream >> v;
-                        slice.pixels[p] = v;
-                    }
-                }
+                dst = reinterpret_cast<char*>(slice.pixels.data());
                 break;
-            }
-            case MRI_SHORT: {
+            case MRI_SHORT:
                 slice.pixelFormat = FIFFV_MRI_PIXEL_WORD;
                 slice.pixelsWord.resize(nPixels);
-                if (datatype == DT_UINT16) {
-                    for (int p = 0; p < nPixels; ++p) {
-                        quint16 v;
-                        stream >> v;
-                        slice.pixelsWord[p] = v;
-                    }
-                } else {
-                    for (int p = 0; p < nPixels; ++p) {
-                        qint16 v;
-                        stream >> v;
-                        slice.pixelsWord[p] = static_cast<unsigned short>(v < 0 ? 0 : v);
-                    }
-                }
+                dst = reinterpret_cast<char*>(slice.pixelsWord.data());
                 break;
-            }
-            case MRI_INT: {
+            case MRI_INT:
+            case MRI_FLOAT:
                 slice.pixelFormat = FIFFV_MRI_PIXEL_FLOAT;
                 slice.pixelsFloat.resize(nPixels);
+                dst = reinterpret_cast<char*>(slice.pixelsFloat.data());
+                break;
+        }
+
+        if (!stream.read(dst, sliceBytes)) {
+            qCritical() << "MriNiftiIO::read - data section truncated (need"
+                        << (dataOff + nslice * sliceBytes) << "bytes, got" << stream.pos() << ")"
+                        << stream.errorString();
+            return false;
+        }
+
+        switch (datatype) {
+            case DT_INT8: {
+                unsigned char* pix = slice.pixels.data();
                 for (int p = 0; p < nPixels; ++p) {
-                    qint32 v;
-                    stream >> v;
-                    slice.pixelsFloat[p] = static_cast<float>(v);
+                    const qint8 v = static_cast<qint8>(pix[p]);
+                    pix[p] = static_cast<unsigned char>(v < 0 ? 0 : v);
                 }
                 break;
             }
-            case MRI_FLOAT: {
-                slice.pixelFormat = FIFFV_MRI_PIXEL_FLOAT;
-                slice.pixelsFloat.resize(nPixels);
+            case DT_UINT16: {
+                unsigned short* pix = slice.pixelsWord.data();
                 for (int p = 0; p < nPixels; ++p) {
-                    float v;
-                    stream >> v;
-                    slice.pixelsFloat[p] = v;
+                    pix[p] = fromFileOrder<quint16>(pix + p, bigEndian);
+                }
+                break;
+            }
+            case DT_INT16: {
+                unsigned short* pix = slice.pixelsWord.data();
+                for (int p = 0; p < nPixels; ++p) {
+                    const qint16 v = fromFileOrder<qint16>(pix + p, bigEndian);
+                    pix[p] = static_cast<unsigned short>(v < 0 ? 0 : v);
+                }
+                break;
+            }
+            case DT_INT32: {
+                float* pix = slice.pixelsFloat.data();
+                for (int p = 0; p < nPixels; ++p) {
+                    pix[p] = static_cast<float>(fromFileOrder<qint32>(pix + p, bigEndian));
+                }
+                break;
+            }
+            case DT_FLOAT32: {
+                float* pix = slice.pixelsFloat.data();
+                for (int p = 0; p < nPixels; ++p) {
+                    const quint32 bits = fromFileOrder<quint32>(pix + p, bigEndian);
+                    std::memcpy(pix + p, &bits, sizeof(float));
                 }
                 break;
             }
@@ -434,6 +411,9 @@ bool MriNiftiIO::read(const QString& niiFile, MriVolData& volData, bool verbose)
         slice.trans = FiffCoordTrans(FIFFV_COORD_MRI_SLICE, FIFFV_COORD_MRI, sliceRot, sliceOrigin);
     }
 
+    // Only the first volume of a 4D series is read; the cache entry still needs the rest
+    stream.finish();
+
     if (verbose) {
         qInfo("NIfTI file: %dx%dx%d, datatype=%d, voxel %.3fx%.3fx%.3f mm, c_ras=(%.2f, %.2f, %.2f)",
               nx, ny, nz, datatype, sx, sy, sz,
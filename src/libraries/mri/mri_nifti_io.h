@@ -22,8 +22,8 @@
  * 352 for single-file .nii). All scalar fields are little-endian by
  * default; big-endian files are detected via the @c sizeof_hdr magic and
  * the whole header is byte-swapped up-front. The @c .nii.gz variant is
- * decompressed in memory via zlib's @c MAX_WBITS+16 mode, mirroring the
- * MGZ path.
+ * inflated on the fly while the slices are read, mirroring the MGZ path
+ * (see @ref MriInflateStream).
  *
  * Transform extraction follows the NIfTI-1 priority rule used by nibabel
  * and FSL: prefer @c sform (3 affine rows directly in voxel\u2192RAS mm),
@@ -76,8 +76,9 @@ public:
     /**
      * Reads a NIfTI-1 single-file volume.
      *
-     * For @c .nii.gz inputs the file is decompressed in memory via zlib
-     * (re-using the same @c MAX_WBITS+16 strategy as @ref MriMghIO).
+     * For @c .nii.gz inputs the gzip stream is inflated straight into the
+     * slice buffers (the same @ref MriInflateStream path as @ref MriMghIO),
+     * and served from the decode cache if one is configured.
      *
      * @param[in]  niiFile  Path to the @c .nii or @c .nii.gz file.
      * @param[out] volData  Volume to populate.
@@ -91,8 +92,8 @@ public:
     /**
      * Decompresses a @c .nii.gz file into @p rawData.
      *
-     * Exposed for direct use by tests; @ref read calls it transparently
-     * when the input path ends in @c .gz.
+     * Exposed for direct use by tests; @ref read does not materialise the
+     * whole file and inflates slice by slice instead.
      *
      * @param[in]  gzFile   Path to the gzip-compressed input.
      * @param[out] rawData  Output buffer.
@@ -19,7 +19,10 @@
  * emitted @c sliceToRas as @c volume.voxToSurfRAS() *
  * orientationAffine so any surface, source estimate or fiducial
  * overlay placed in RAS lands in the right slice without
- * recomputing the volume geometry.
+ * recomputing the volume geometry. The @ref MriVolData overloads
+ * gather the requested plane straight from the per-slice native
+ * buffers, so a slice costs O(plane) rather than a full-volume
+ * float copy.
  */
 
 //=============================================================================================================
@@ -29,6 +32,8 @@
 #include "mri_slicer.h"
 #include "mri_vol_data.h"
 
+#include <fiff/fiff_file.h>
+
 #include <Eigen/LU>
 
 #include <algorithm>
@@ -42,97 +47,73 @@ using namespace MRILIB;
 using namespace Eigen;
 
 //=============================================================================================================
-// STATIC METHODS
+// DEFINE STATIC HELPERS
 //=============================================================================================================
 
-MriSliceImage MriSlicer::extractSlice(
-    const QVector<float>& volData,
-    const QVector<int>& dims,
-    const Matrix4f& vox2ras,
-    SliceOrientation orientation,
-    int sliceIndex)
-{
-    const int dimX = dims[0];
-    const int dimY = dims[1];
-    const int dimZ = dims[2];
+namespace {
 
-    MriSliceImage result;
+//=============================================================================================================
+/**
+ * Clamps the slice index, sizes the pixel buffer and composes sliceToRas for one orientation.
+ */
+void setupSlice(MriSliceImage& result,
+                const Matrix4f& vox2ras,
+                int dimX, int dimY, int dimZ,
+                SliceOrientation orientation,
+                int sliceIndex)
+{
     result.orientation = orientation;
+    result.sliceToRas = Matrix4f::Zero();
+    Vector4f origin;
 
     switch (orientation) {
-    case SliceOrientation::Axial: {
+    case SliceOrientation::Axial:
         sliceIndex = std::clamp(sliceIndex, 0, dimZ - 1);
         result.width = dimX;
         result.height = dimY;
-        result.sliceIndex = sliceIndex;
-        result.pixels.resize(dimX, dimY);
-
-        for (int iy = 0; iy < dimY; ++iy) {
-            for (int ix = 0; ix < dimX; ++ix) {
-                result.pixels(ix, iy) = volData[ix + dimX * (iy + dimY * sliceIndex)];
-            }
-        }
 
         // sliceToRas: maps (col, row) in the 2D image to RAS
         // col -> x voxel direction, row -> y voxel direction, fixed z = sliceIndex
-        result.sliceToRas = Matrix4f::Zero();
         result.sliceToRas.col(0) = vox2ras.col(0); // x direction
         result.sliceToRas.col(1) = vox2ras.col(1); // y direction
         result.sliceToRas.col(2) = vox2ras.col(2); // z direction (unused for 2D but kept)
-        Vector4f origin;
         origin << 0.0f, 0.0f, static_cast<float>(sliceIndex), 1.0f;
-        result.sliceToRas.col(3) = vox2ras * origin;
         break;
-    }
-    case SliceOrientation::Coronal: {
+    case SliceOrientation::Coronal:
         sliceIndex = std::clamp(sliceIndex, 0, dimY - 1);
         result.width = dimX;
         result.height = dimZ;
-        result.sliceIndex = sliceIndex;
-        result.pixels.resize(dimX, dimZ);
-
-        for (int iz = 0; iz < dimZ; ++iz) {
-            for (int ix = 0; ix < dimX; ++ix) {
-                result.pixels(ix, iz) = volData[ix + dimX * (sliceIndex + dimY * iz)];
-            }
-        }
 
         // col -> x direction, row -> z direction, fixed y = sliceIndex
-        result.sliceToRas = Matrix4f::Zero();
         result.sliceToRas.col(0) = vox2ras.col(0); // x direction
         result.sliceToRas.col(1) = vox2ras.col(2); // z direction
         result.sliceToRas.col(2) = vox2ras.col(1); // y direction (unused for 2D but kept)
-        Vector4f originC;
-        originC << 0.0f, static_cast<float>(sliceIndex), 0.0f, 1.0f;
-        result.sliceToRas.col(3) = vox2ras * originC;
+        origin << 0.0f, static_cast<float>(sliceIndex), 0.0f, 1.0f;
         break;
-    }
-    case SliceOrientation::Sagittal: {
+    case SliceOrientation::Sagittal:
         sliceIndex = std::clamp(sliceIndex, 0, dimX - 1);
         result.width = dimY;
         result.height = dimZ;
-        result.sliceIndex = sliceIndex;
-        result.pixels.resize(dimY, dimZ);
-
-        for (int iz = 0; iz < dimZ; ++iz) {
-            for (int iy = 0; iy < dimY; ++iy) {
-                result.pixels(iy, iz) = volData[sliceIndex + dimX * (iy + dimY * iz)];
-            }
-        }
 
         // col -> y direction, row -> z direction, fixed x = sliceIndex
-        result.sliceToRas = Matrix4f::Zero();
         result.sliceToRas.col(0) = vox2ras.col(1); // y direction
         result.sliceToRas.col(1) = vox2ras.col(2); // z direction
         result.sliceToRas.col(2) = vox2ras.col(0); // x direction (unused for 2D but kept)
-        Vector4f originS;
-        originS << static_cast<float>(sliceIndex), 0.0f, 0.0f, 1.0f;
-        result.sliceToRas.col(3) = vox2ras * originS;
+        origin << static_cast<float>(sliceIndex), 0.0f, 0.0f, 1.0f;
         break;
     }
-    }
 
-    // Normalize pixels to [0, 1]
+    result.sliceIndex = sliceIndex;
+    result.sliceToRas.col(3) = vox2ras * origin;
+    result.pixels.resize(result.width, result.height);
+}
+
+//=============================================================================================================
+/**
+ * Normalizes the pixels of a slice image to [0, 1].
+ */
+void normalize(MriSliceImage& result)
+{
     float minVal = result.pixels.minCoeff();
     float maxVal = result.pixels.maxCoeff();
     if (maxVal > minVal) {
@@ -140,7 +121,136 @@ MriSliceImage MriSlicer::extractSlice(
     } else {
         result.pixels.setZero();
     }
+}
+
+//=============================================================================================================
+/**
+ * Copies n strided values of a native pixel buffer to float; positions past the buffer read as 0.
+ */
+template <typename T>
+void gather(const QVector<T>& src, int first, int stride, int n, float* dst)
+{
+    const T* pSrc = src.constData();
+    const int size = static_cast<int>(src.size());
+    for (int i = 0, idx = first; i < n; ++i, idx += stride) {
+        dst[i] = idx < size ? static_cast<float>(pSrc[idx]) : 0.0f;
+    }
+}
+
+//=============================================================================================================
+/**
+ * Reads one row or column of an MriSlice, in whatever pixel format it is stored, as float.
+ */
+void gatherSlice(const MriSlice* slice, int first, int stride, int n, float* dst)
+{
+    if (slice) {
+        switch (slice->pixelFormat) {
+        case FIFFV_MRI_PIXEL_BYTE:
+            gather(slice->pixels, first, stride, n, dst);
+            return;
+        case FIFFV_MRI_PIXEL_WORD:
+            gather(slice->pixelsWord, first, stride, n, dst);
+            return;
+        case FIFFV_MRI_PIXEL_FLOAT:
+            gather(slice->pixelsFloat, first, stride, n, dst);
+            return;
+        }
+    }
+    std::fill(dst, dst + n, 0.0f);
+}
+
+//=============================================================================================================
+/**
+ * Extracts a slice straight from the per-slice buffers of an MriVolData, touching only the voxels on the
+ * requested plane.
+ */
+MriSliceImage extractFromSlices(const MriVolData& vol,
+                                const Matrix4f& vox2ras,
+                                SliceOrientation orientation,
+                                int sliceIndex)
+{
+    const int dimX = vol.width;
+    const int dimY = vol.height;
+    const int dimZ = vol.depth;
 
+    auto sliceAt = [&vol](int k) -> const MriSlice* {
+        return k < vol.slices.size() ? &vol.slices[k] : nullptr;
+    };
+
+    MriSliceImage result;
+    setupSlice(result, vox2ras, dimX, dimY, dimZ, orientation, sliceIndex);
+
+    // Eigen is column-major, so every image row (fixed second index) is contiguous
+    switch (orientation) {
+    case SliceOrientation::Axial: {
+        const MriSlice* slice = sliceAt(result.sliceIndex);
+        for (int iy = 0; iy < dimY; ++iy) {
+            gatherSlice(slice, dimX * iy, 1, dimX, &result.pixels(0, iy));
+        }
+        break;
+    }
+    case SliceOrientation::Coronal:
+        for (int iz = 0; iz < dimZ; ++iz) {
+            gatherSlice(sliceAt(iz), dimX * result.sliceIndex, 1, dimX, &result.pixels(0, iz));
+        }
+        break;
+    case SliceOrientation::Sagittal:
+        for (int iz = 0; iz < dimZ; ++iz) {
+            gatherSlice(sliceAt(iz), result.sliceIndex, dimX, dimY, &result.pixels(0, iz));
+        }
+        break;
+    }
+
+    normalize(result);
+    return result;
+}
+
+} // anonymous namespace
+
+//=============================================================================================================
+// STATIC METHODS
+//=============================================================================================================
+
+MriSliceImage MriSlicer::extractSlice(
+    const QVector<float>& volData,
+    const QVector<int>& dims,
+    const Matrix4f& vox2ras,
+    SliceOrientation orientation,
+    int sliceIndex)
+{
+    const int dimX = dims[0];
+    const int dimY = dims[1];
+    const int dimZ = dims[2];
+
+    MriSliceImage result;
+    setupSlice(result, vox2ras, dimX, dimY, dimZ, orientation, sliceIndex);
+    sliceIndex = result.sliceIndex;
+
+    switch (orientation) {
+    case SliceOrientation::Axial:
+        for (int iy = 0; iy < dimY; ++iy) {
+            for (int ix = 0; ix < dimX; ++ix) {
+                result.pixels(ix, iy) = volData[ix + dimX * (iy + dimY * sliceIndex)];
+            }
+        }
+        break;
+    case SliceOrientation::Coronal:
+        for (int iz = 0; iz < dimZ; ++iz) {
+            for (int ix = 0; ix < dimX; ++ix) {
+                result.pixels(ix, iz) = volData[ix + dimX * (sliceIndex + dimY * iz)];
+            }
+        }
+        break;
+    case SliceOrientation::Sagittal:
+        for (int iz = 0; iz < dimZ; ++iz) {
+            for (int iy = 0; iy < dimY; ++iy) {
+                result.pixels(iy, iz) = volData[sliceIndex + dimX * (iy + dimY * iz)];
+            }
+        }
+        break;
+    }
+
+    normalize(result);
     return result;
 }
 
@@ -203,8 +313,7 @@ MriSliceImage MriSlicer::extractSlice(const MriVolData& vol,
                                        SliceOrientation orientation,
                                        int sliceIndex)
 {
-    return extractSlice(vol.voxelDataAsFloat(), vol.dims(),
-                        vol.computeVox2Ras(), orientation, sliceIndex);
+    return extractFromSlices(vol, vol.computeVox2Ras(), orientation, sliceIndex);
 }
 
 //=============================================================================================================
@@ -212,8 +321,16 @@ MriSliceImage MriSlicer::extractSlice(const MriVolData& vol,
 QVector<MriSliceImage> MriSlicer::extractOrthogonal(const MriVolData& vol,
                                                      const Vector3f& rasPoint)
 {
-    return extractOrthogonal(vol.voxelDataAsFloat(), vol.dims(),
-                             vol.computeVox2Ras(), rasPoint);
+    const Matrix4f vox2ras = vol.computeVox2Ras();
+    Vector3i voxel = rasToVoxel(vox2ras, rasPoint);
+
+    QVector<MriSliceImage> slices;
+    slices.reserve(3);
+    slices.append(extractFromSlices(vol, vox2ras, SliceOrientation::Axial, voxel.z()));
+    slices.append(extractFromSlices(vol, vox2ras, SliceOrientation::Coronal, voxel.y()));
+    slices.append(extractFromSlices(vol, vox2ras, SliceOrientation::Sagittal, voxel.x()));
+
+    return slices;
 }
 
 //=============================================================================================================
@@ -174,6 +174,9 @@ public:
     /**
      * Extract a 2D slice from an MriVolData volume.
      *
+     * Reads only the voxels on the requested plane straight from the per-slice
+     * pixel buffers (any pixel format); the volume is not flattened first.
+     *
      * @param[in] vol           Loaded MRI volume.
      * @param[in] orientation   Slice orientation.
      * @param[in] sliceIndex    Index along the slicing axis.
@@ -187,6 +190,9 @@ public:
     /**
      * Extract all three orthogonal slices at a given RAS point.
      *
+     * Like extractSlice(const MriVolData&, SliceOrientation, int), only the
+     * three requested planes are read.
+     *
      * @param[in] vol       Loaded MRI volume.
      * @param[in] rasPoint  RAS coordinate to slice through.
      *
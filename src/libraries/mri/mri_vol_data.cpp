@@ -129,6 +129,28 @@ QVector<float> MriVolData::voxelDataAsFloat() const
 
 //=============================================================================================================
 
+float MriVolData::voxel(int x, int y, int z) const
+{
+    if (x < 0 || y < 0 || z < 0 || x >= width || y >= height || z >= depth || z >= slices.size())
+        return 0.0f;
+
+    const MriSlice& slice = slices[z];
+    const int p = x + width * y;
+
+    switch (slice.pixelFormat) {
+        case FIFFV_MRI_PIXEL_BYTE:
+            return p < slice.pixels.size() ? static_cast<float>(slice.pixels[p]) : 0.0f;
+        case FIFFV_MRI_PIXEL_WORD:
+            return p < slice.pixelsWord.size() ? static_cast<float>(slice.pixelsWord[p]) : 0.0f;
+        case FIFFV_MRI_PIXEL_FLOAT:
+            return p < slice.pixelsFloat.size() ? slice.pixelsFloat[p] : 0.0f;
+        default:
+            return 0.0f;
+    }
+}
+
+//=============================================================================================================
+
 Matrix4f MriVolData::computeVox2Ras() const
 {
     //
@@ -205,6 +205,19 @@ public:
      */
     QVector<float> voxelDataAsFloat() const;
 
+    //=========================================================================================================
+    /**
+     * Returns a single voxel as float, read from its slice in the native pixel format. Unlike
+     * voxelDataAsFloat() this does not copy the volume.
+     *
+     * @param[in] x     Column index (0 .. width-1).
+     * @param[in] y     Row index (0 .. height-1).
+     * @param[in] z     Slice index (0 .. depth-1).
+     *
+     * @return The voxel value; 0 if the index is out of range.
+     */
+    float voxel(int x, int y, int z) const;
+
     //=========================================================================================================
     /**
      * Builds the voxel-to-surface-RAS (MRI) 4×4 transform matrix.
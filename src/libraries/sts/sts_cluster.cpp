@@ -29,8 +29,15 @@
  * TFCE follows Smith & Nichols (2009): the statistic map is swept by
  * @c nSteps thresholds and each supra-threshold connected component
  * contributes @f$\text{extent}^E \cdot h^H \cdot \Delta h@f$ to every
- * sample it covers. Positive and negative tails are handled separately
- * and recombined so signed enhancement is preserved.
+ * sample it covers. Instead of a fresh BFS per threshold, the samples are
+ * sorted once by value and added to a union-find forest as the threshold
+ * falls; each root defers its contribution until its extent changes and
+ * members hold their enhancement relative to their parent, so a whole
+ * sweep costs O(N log N + nnz) independently of @c nSteps. Positive and
+ * negative tails are handled separately and recombined so signed
+ * enhancement is preserved. @c tfcePermutationTest reuses the sign-flip
+ * scaffold of the one-sample cluster test with the maximum TFCE score as
+ * the permutation statistic.
  */
 
 //=============================================================================================================
@@ -695,76 +702,220 @@ MatrixXd StatsCluster::tfce(
 {
     const int nVertices = static_cast<int>(statMap.rows());
     const int nTimes = static_cast<int>(statMap.cols());
-    const int nTotal = nVertices * nTimes;
 
     MatrixXd tfceMap = MatrixXd::Zero(nVertices, nTimes);
 
-    // Helper: run TFCE on one polarity
-    auto runTfce = [&](const MatrixXd& absMap, bool isPositive) {
-        double maxVal = absMap.maxCoeff();
-        if (maxVal <= 0.0) return;
+    // Positive values
+    MatrixXd posMap = statMap.cwiseMax(0.0);
+    tfceMap += tfceOnePolarity(posMap, adjacency, E, H, nSteps);
 
-        double dh = maxVal / static_cast<double>(nSteps);
+    // Negative values (use absolute values, then negate contributions)
+    MatrixXd negMap = (-statMap).cwiseMax(0.0);
+    tfceMap -= tfceOnePolarity(negMap, adjacency, E, H, nSteps);
 
-        for (int step = 1; step <= nSteps; ++step) {
-            double h = dh * static_cast<double>(step);
+    return tfceMap;
+}
+
+//=============================================================================================================
+
+MatrixXd StatsCluster::tfceOnePolarity(
+    const MatrixXd& absMap,
+    const SparseMatrix<int>& adjacency,
+    double E,
+    double H,
+    int nSteps)
+{
+    const int nVertices = static_cast<int>(absMap.rows());
+    const int nTimes = static_cast<int>(absMap.cols());
+    const int nTotal = nVertices * nTimes;
 
-            // Find connected components above threshold h
-            std::vector<bool> visited(nTotal, false);
+    MatrixXd score = MatrixXd::Zero(nVertices, nTimes);
 
-            for (int idx = 0; idx < nTotal; ++idx) {
-                int v = idx / nTimes;
-                int t = idx % nTimes;
+    double maxVal = nTotal > 0 ? absMap.maxCoeff() : 0.0;
+    if (maxVal <= 0.0 || nSteps <= 0) return score;
 
-                if (absMap(v, t) < h || visited[idx]) continue;
+    double dh = maxVal / static_cast<double>(nSteps);
 
-                // BFS to find cluster
-                std::vector<int> cluster;
-                std::queue<int> queue;
-                queue.push(idx);
-                visited[idx] = true;
+    // Flat index idx = v * nTimes + t, matching the spatio-temporal adjacency
+    auto value = [&](int idx) { return absMap(idx / nTimes, idx % nTimes); };
 
-                while (!queue.empty()) {
-                    int curIdx = queue.front();
-                    queue.pop();
-                    cluster.push_back(curIdx);
-
-                    for (SparseMatrix<int>::InnerIterator it(adjacency, curIdx); it; ++it) {
-                        int nIdx = static_cast<int>(it.row());
-                        if (visited[nIdx]) continue;
-                        int nV = nIdx / nTimes;
-                        int nT = nIdx % nTimes;
-                        if (absMap(nV, nT) >= h) {
-                            visited[nIdx] = true;
-                            queue.push(nIdx);
-                        }
-                    }
-                }
+    // Contribution of one sample of a cluster of unit extent from step k up to nSteps,
+    // so that a cluster of constant extent n over steps k..s contributes
+    // n^E * (tail[k] - tail[s + 1]).
+    std::vector<double> tail(nSteps + 2, 0.0);
+    for (int step = nSteps; step >= 1; --step) {
+        double h = dh * static_cast<double>(step);
+        tail[step] = tail[step + 1] + std::pow(h, H) * dh;
+    }
 
-                // Compute contribution: e^E * h^H * dh
-                double extent = static_cast<double>(cluster.size());
-                double contribution = std::pow(extent, E) * std::pow(h, H) * dh;
-
-                for (int cIdx : cluster) {
-                    int cv = cIdx / nTimes;
-                    int ct = cIdx % nTimes;
-                    if (isPositive) {
-                        tfceMap(cv, ct) += contribution;
-                    } else {
-                        tfceMap(cv, ct) -= contribution;
-                    }
-                }
+    // Visit samples from the largest value down, so the threshold only ever decreases
+    std::vector<int> order;
+    order.reserve(nTotal);
+    for (int idx = 0; idx < nTotal; ++idx) {
+        if (value(idx) > 0.0) order.push_back(idx);
+    }
+    std::sort(order.begin(), order.end(), [&](int a, int b) { return value(a) > value(b); });
+
+    //
+    // Union-find over the active samples. Each root carries the extent of its
+    // cluster, the step from which that extent is valid, and the enhancement
+    // accumulated so far; members store their enhancement relative to their
+    // parent, so merging two clusters is O(1) and never touches the members.
+    //
+    std::vector<int> parent(nTotal, -1);     // -1 = not yet above threshold
+    std::vector<int> extent(nTotal, 0);
+    std::vector<int> since(nTotal, 0);
+    std::vector<double> acc(nTotal, 0.0);
+
+    std::vector<int> path;
+    auto find = [&](int x) {
+        while (parent[x] != x) {
+            path.push_back(x);
+            x = parent[x];
+        }
+        // Path compression: make every visited node relative to the root directly
+        for (int i = static_cast<int>(path.size()) - 2; i >= 0; --i) {
+            acc[path[i]] += acc[path[i + 1]];
+        }
+        for (int node : path) parent[node] = x;
+        path.clear();
+        return x;
+    };
+
+    // Credit a root with everything its current extent earned in steps (step, since]
+    auto flush = [&](int root, int step) {
+        acc[root] += std::pow(static_cast<double>(extent[root]), E) * (tail[step + 1] - tail[since[root] + 1]);
+        since[root] = step;
+    };
+
+    std::size_t next = 0;
+    for (int step = nSteps; step >= 1; --step) {
+        double h = dh * static_cast<double>(step);
+
+        for (; next < order.size() && value(order[next]) >= h; ++next) {
+            int idx = order[next];
+            parent[idx] = idx;
+            extent[idx] = 1;
+            since[idx] = step;
+
+            for (SparseMatrix<int>::InnerIterator it(adjacency, idx); it; ++it) {
+                int nIdx = static_cast<int>(it.row());
+                if (parent[nIdx] < 0) continue;
+
+                int ra = find(idx);
+                int rb = find(nIdx);
+                if (ra == rb) continue;
+
+                flush(ra, step);
+                flush(rb, step);
+                if (extent[ra] < extent[rb]) std::swap(ra, rb);
+                parent[rb] = ra;
+                acc[rb] -= acc[ra];
+                extent[ra] += extent[rb];
             }
         }
+    }
+
+    for (int idx : order) {
+        if (parent[idx] == idx) flush(idx, 0);
+    }
+    for (int idx : order) {
+        if (parent[idx] < 0) continue;     // never reached the lowest threshold
+        int root = find(idx);
+        score(idx / nTimes, idx % nTimes) = idx == root ? acc[root] : acc[idx] + acc[root];
+    }
+
+    return score;
+}
+
+//=============================================================================================================
+
+StatsTfceResult StatsCluster::tfcePermutationTest(
+    const QVector<MatrixXd>& data,
+    const SparseMatrix<int>& adjacency,
+    int nPermutations,
+    StatsTailType tail,
+    double E,
+    double H,
+    int nSteps)
+{
+    // Step 1: Compute observed one-sample t-map and its TFCE enhancement
+    MatrixXd tObs = computeOneSampleTMap(data);
+    MatrixXd tfceObs = tfce(tObs, adjacency, E, H, nSteps);
+    MatrixXd scoreObs = tfceTailScore(tfceObs, tail);
+
+    // Step 2: Build null distribution of the maximum TFCE score via sign-flip permutations
+    QVector<int> permIndices(nPermutations);
+    std::iota(permIndices.begin(), permIndices.end(), 0);
+
+    std::function<double(int)> permuteFunc = [&](int) -> double {
+        return permuteOnceTfce(data, adjacency, tail, E, H, nSteps);
     };
 
-    // Positive values
-    MatrixXd posMap = statMap.cwiseMax(0.0);
-    runTfce(posMap, true);
+    QFuture<double> future = QtConcurrent::mapped(permIndices, permuteFunc);
+    future.waitForFinished();
 
-    // Negative values (use absolute values, then negate contributions)
-    MatrixXd negMap = (-statMap).cwiseMax(0.0);
-    runTfce(negMap, false);
+    QVector<double> nullDist(nPermutations);
+    for (int i = 0; i < nPermutations; ++i) {
+        nullDist[i] = future.resultAt(i);
+    }
+    std::sort(nullDist.begin(), nullDist.end());
 
-    return tfceMap;
+    // Step 3: Compute per-sample p-values against the max-statistic null (FWER-corrected)
+    MatrixXd pVals = MatrixXd::Ones(tObs.rows(), tObs.cols());
+    if (nPermutations > 0) {
+        for (int c = 0; c < scoreObs.cols(); ++c) {
+            for (int r = 0; r < scoreObs.rows(); ++r) {
+                auto first = std::lower_bound(nullDist.cbegin(), nullDist.cend(), scoreObs(r, c));
+                pVals(r, c) = static_cast<double>(nullDist.cend() - first) / static_cast<double>(nPermutations);
+            }
+        }
+    }
+
+    StatsTfceResult result;
+    result.matTObs = tObs;
+    result.matTfce = tfceObs;
+    result.matPvals = pVals;
+    result.vecNullDist = nullDist;
+    return result;
+}
+
+//=============================================================================================================
+
+MatrixXd StatsCluster::tfceTailScore(const MatrixXd& tfceMap, StatsTailType tail)
+{
+    switch (tail) {
+    case StatsTailType::Right:
+        return tfceMap.cwiseMax(0.0);
+    case StatsTailType::Left:
+        return (-tfceMap).cwiseMax(0.0);
+    case StatsTailType::Both:
+    default:
+        return tfceMap.cwiseAbs();
+    }
+}
+
+//=============================================================================================================
+
+double StatsCluster::permuteOnceTfce(
+    const QVector<MatrixXd>& data,
+    const SparseMatrix<int>& adjacency,
+    StatsTailType tail,
+    double E,
+    double H,
+    int nSteps)
+{
+    const int nSubjects = data.size();
+
+    // Generate random sign flips
+    QRandomGenerator rng(QRandomGenerator::global()->generate());
+    QVector<MatrixXd> flipped(nSubjects);
+    for (int s = 0; s < nSubjects; ++s) {
+        flipped[s] = rng.bounded(2) == 0 ? data[s] : MatrixXd(-data[s]);
+    }
+
+    MatrixXd tMap = computeOneSampleTMap(flipped);
+    MatrixXd score = tfceTailScore(tfce(tMap, adjacency, E, H, nSteps), tail);
+
+    return score.size() > 0 ? score.maxCoeff() : 0.0;
 }
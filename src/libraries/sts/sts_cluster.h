@@ -26,7 +26,7 @@
  * sense at the cluster level. The module also exposes Threshold-Free
  * Cluster Enhancement (TFCE), which integrates cluster extent and height
  * over a range of thresholds and removes the arbitrary cluster-forming
- * threshold.
+ * threshold, together with a sign-flip TFCE permutation test.
  *
  * References: Maris & Oostenveld (2007), J. Neurosci. Methods 164(1);
  * Smith & Nichols (2009), NeuroImage 44(1).
@@ -77,6 +77,19 @@ struct STSSHARED_EXPORT StatsClusterResult {
     double clusterThreshold;            /**< t-threshold used for clustering. */
 };
 
+//=============================================================================================================
+/**
+ * Result structure for TFCE permutation tests.
+ *
+ * @brief Per-call output of a TFCE permutation test: observed statistic map, its TFCE enhancement and per-sample FWER-corrected p-values.
+ */
+struct STSSHARED_EXPORT StatsTfceResult {
+    Eigen::MatrixXd matTObs;            /**< Observed t-statistic map (nVertices x nTimes). */
+    Eigen::MatrixXd matTfce;            /**< Signed TFCE score of the observed map (nVertices x nTimes). */
+    Eigen::MatrixXd matPvals;           /**< p-value of each (vertex, time) sample against the max-TFCE null. */
+    QVector<double> vecNullDist;        /**< Sorted maximum TFCE score of each permutation. */
+};
+
 //=============================================================================================================
 /**
  * Cluster-based permutation test for comparing two conditions.
@@ -161,6 +174,8 @@ public:
      *
      * Enhances a statistic map by integrating cluster extent and height over a range
      * of thresholds (Smith & Nichols 2009). Handles both positive and negative values.
+     * Components are tracked incrementally with a union-find as the threshold decreases,
+     * so the cost does not grow with nSteps.
      *
      * @param[in] statMap     Statistic map (nVertices x nTimes).
      * @param[in] adjacency   Spatio-temporal adjacency matrix (nVertices*nTimes x nVertices*nTimes).
@@ -179,6 +194,35 @@ public:
         double H = 2.0,
         int nSteps = 100);
 
+    //=========================================================================================================
+    /**
+     * One-sample TFCE permutation test.
+     *
+     * Enhances the one-sample t-map with tfce() and builds the null distribution of the maximum TFCE
+     * score from sign-flip permutations; each (vertex, time) sample gets the fraction of permutations
+     * whose maximum reaches its own score, which controls the family-wise error rate.
+     *
+     * @param[in] data            Per-subject data. Each matrix is nVertices x nTimes.
+     * @param[in] adjacency       Spatio-temporal adjacency matrix (nVertices*nTimes x nVertices*nTimes).
+     * @param[in] nPermutations   Number of sign-flip permutations (default 1024).
+     * @param[in] tail            Tail type for the test.
+     * @param[in] E               Extent exponent (default 0.5).
+     * @param[in] H               Height exponent (default 2.0).
+     * @param[in] nSteps          Number of threshold steps (default 100).
+     *
+     * @return StatsTfceResult with observed t-map, TFCE map, p-values and null distribution.
+     *
+     * @since 2.2.1
+     */
+    static StatsTfceResult tfcePermutationTest(
+        const QVector<Eigen::MatrixXd>& data,
+        const Eigen::SparseMatrix<int>& adjacency,
+        int nPermutations = 1024,
+        StatsTailType tail = StatsTailType::Both,
+        double E = 0.5,
+        double H = 2.0,
+        int nSteps = 100);
+
 private:
     //=========================================================================================================
     /**
@@ -262,6 +306,37 @@ private:
         const QVector<int>& groupSizes,
         const Eigen::SparseMatrix<int>& adjacency,
         double threshold);
+
+    //=========================================================================================================
+    /**
+     * TFCE of one polarity of a non-negative map, via a union-find sweep over decreasing thresholds.
+     */
+    static Eigen::MatrixXd tfceOnePolarity(
+        const Eigen::MatrixXd& absMap,
+        const Eigen::SparseMatrix<int>& adjacency,
+        double E,
+        double H,
+        int nSteps);
+
+    //=========================================================================================================
+    /**
+     * Map a signed TFCE map to the non-negative score tested for the given tail.
+     */
+    static Eigen::MatrixXd tfceTailScore(
+        const Eigen::MatrixXd& tfceMap,
+        StatsTailType tail);
+
+    //=========================================================================================================
+    /**
+     * Perform one sign-flip permutation for the TFCE test, return the maximum TFCE score.
+     */
+    static double permuteOnceTfce(
+        const QVector<Eigen::MatrixXd>& data,
+        const Eigen::SparseMatrix<int>& adjacency,
+        StatsTailType tail,
+        double E,
+        double H,
+        int nSteps);
 };
 
 } // namespace STSLIB
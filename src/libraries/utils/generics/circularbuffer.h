@@ -26,6 +26,10 @@
  * an explicit instantiation in UTILSLIB. @c pause() lets the
  * downstream consumer drop incoming data temporarily without
  * tearing down the producer thread.
+ *
+ * For exactly one producer and one consumer thread,
+ * @ref UTILSLIB::SpscRingBuffer offers the same interface without
+ * semaphores and with move semantics.
  */
 
 #ifndef CIRCULARBUFFER_H
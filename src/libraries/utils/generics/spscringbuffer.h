@@ -0,0 +1,789 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     spscringbuffer.h
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Lock-free single-producer / single-consumer ring buffer, plus a variant with preallocated matrix slots.
+ *
+ * @ref UTILSLIB::CircularBuffer serialises every push and pop through
+ * two @c QSemaphore objects and copy-assigns the element into and out of
+ * its slot. @ref UTILSLIB::SpscRingBuffer replaces that with two atomic
+ * counters: the producer only ever writes the head and the consumer only
+ * ever writes the tail, so @c try_push and @c try_pop are wait-free and
+ * touch no kernel object. Elements are moved in and out.
+ *
+ * The blocking @c push / @c pop keep the signature and the timeout
+ * semantics of @ref UTILSLIB::CircularBuffer, so a plugin with one
+ * producer and one consumer thread can switch by changing the type. They
+ * first spin for a short while and only then park the thread on a wait
+ * condition, which the other side signals only if somebody is parked.
+ *
+ * @ref UTILSLIB::SpscMatrixRingBuffer preallocates every slot with a fixed
+ * matrix shape. Producers copy into (or, via @c beginWrite, compute
+ * directly into) a slot, and consumers swap their matrix with the slot,
+ * so a stream of equally sized blocks runs without any allocation.
+ */
+
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../utils_global.h"
+
+#include <atomic>
+#include <utility>
+#include <vector>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDeadlineTimer>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThread>
+#include <QWaitCondition>
+
+//=============================================================================================================
+// EIGEN INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+//=============================================================================================================
+// DEFINE NAMESPACE UTILSLIB
+//=============================================================================================================
+
+namespace UTILSLIB
+{
+
+//=============================================================================================================
+/**
+ * TEMPLATE SPSC RING BUFFER
+ *
+ * @brief Bounded lock-free ring buffer for exactly one producer thread and one consumer thread.
+ *
+ * @code
+ *   SpscRingBuffer<FiffEvokedSet> buffer(40);
+ *
+ *   // producer thread                      // consumer thread
+ *   buffer.try_push(std::move(evokedSet));  FiffEvokedSet evokedSet;
+ *                                           if(buffer.pop(evokedSet)) { ... }
+ * @endcode
+ */
+template<typename T>
+class SpscRingBuffer
+{
+public:
+    typedef QSharedPointer<SpscRingBuffer> SPtr;              /**< Shared pointer type for SpscRingBuffer. */
+    typedef QSharedPointer<const SpscRingBuffer> ConstSPtr;   /**< Const shared pointer type for SpscRingBuffer. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a SpscRingBuffer.
+     *
+     * @param[in] uiMaxNumElements   Length of the buffer.
+     * @param[in] prototype          Value every slot is initialised with.
+     */
+    explicit SpscRingBuffer(unsigned int uiMaxNumElements,
+                            const T& prototype = T());
+
+    SpscRingBuffer(const SpscRingBuffer&) = delete;
+    SpscRingBuffer& operator=(const SpscRingBuffer&) = delete;
+
+    //=========================================================================================================
+    /**
+     * Copies an element to the end of the buffer without waiting. Producer only.
+     *
+     * @param[in] element    The element.
+     *
+     * @return false if the buffer is full or paused.
+     */
+    inline bool try_push(const T& element);
+
+    //=========================================================================================================
+    /**
+     * Moves an element to the end of the buffer without waiting. Producer only.
+     *
+     * @param[in] element    The element. Left in a moved-from state on success.
+     *
+     * @return false if the buffer is full or paused.
+     */
+    inline bool try_push(T&& element);
+
+    //=========================================================================================================
+    /**
+     * Moves the first element out of the buffer without waiting. Consumer only.
+     *
+     * @param[out] element   The element.
+     *
+     * @return false if the buffer is empty or paused.
+     */
+    inline bool try_pop(T& element);
+
+    //=========================================================================================================
+    /**
+     * Adds an element at the end of the buffer. In blocking mode waits up to the timeout for a free slot.
+     *
+     * @param[in] element    The element.
+     *
+     * @return false if no slot became free in time or the buffer is paused.
+     */
+    inline bool push(const T& element);
+
+    //=========================================================================================================
+    /**
+     * Moves an element to the end of the buffer. In blocking mode waits up to the timeout for a free slot.
+     *
+     * @param[in] element    The element.
+     *
+     * @return false if no slot became free in time or the buffer is paused.
+     */
+    inline bool push(T&& element);
+
+    //=========================================================================================================
+    /**
+     * Adds a whole array at the end of the buffer, either all elements or none.
+     *
+     * @param[in] pArray     Pointer to the array.
+     * @param[in] size       Number of elements in the array.
+     *
+     * @return false if not enough slots became free in time or the buffer is paused.
+     */
+    inline bool push(const T* pArray, unsigned int size);
+
+    //=========================================================================================================
+    /**
+     * Takes the first element (first in first out). In blocking mode waits up to the timeout for an element.
+     *
+     * @param[out] element   The element.
+     *
+     * @return false if no element arrived in time or the buffer is paused.
+     */
+    inline bool pop(T& element);
+
+    //=========================================================================================================
+    /**
+     * Returns the slot the next element goes to, for filling it in place, or nullptr if the buffer is full.
+     * The element becomes visible to the consumer with endWrite(). Producer only.
+     *
+     * @return The free slot.
+     */
+    inline T* beginWrite();
+
+    //=========================================================================================================
+    /**
+     * Publishes the slot returned by beginWrite(). Producer only.
+     */
+    inline void endWrite();
+
+    //=========================================================================================================
+    /**
+     * Returns the first element for reading it in place, or nullptr if the buffer is empty. The slot is given
+     * back to the producer with endRead(). Consumer only.
+     *
+     * @return The first element.
+     */
+    inline T* beginRead();
+
+    //=========================================================================================================
+    /**
+     * Releases the slot returned by beginRead(). Consumer only.
+     */
+    inline void endRead();
+
+    //=========================================================================================================
+    /**
+     * Drops all elements. Must be called from the consumer side or while the producer is idle.
+     */
+    inline void clear();
+
+    //=========================================================================================================
+    /**
+     * Pauses the buffer. While paused all pushes and pops fail immediately.
+     *
+     * @param[in] bPause     Whether to pause.
+     */
+    inline void pause(bool bPause);
+
+    //=========================================================================================================
+    /**
+     * Sets whether push() and pop() wait for free slots or elements. If not, they behave like try_push() and
+     * try_pop(). Default is true.
+     *
+     * @param[in] bBlocking      Whether to block.
+     */
+    inline void setBlocking(bool bBlocking);
+
+    //=========================================================================================================
+    /**
+     * Sets the time after which a blocking push() or pop() gives up. Default is 1000 ms.
+     *
+     * @param[in] iTimeoutMsecs  The timeout in milliseconds.
+     */
+    inline void setTimeout(int iTimeoutMsecs);
+
+    //=========================================================================================================
+    /**
+     * Returns the number of elements ready for reading.
+     */
+    inline int getFreeElementsRead() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the number of free slots for writing.
+     */
+    inline int getFreeElementsWrite() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the length of the buffer.
+     */
+    inline unsigned int capacity() const;
+
+protected:
+    //=========================================================================================================
+    /**
+     * Runs writer on the next free slot and publishes it.
+     *
+     * @param[in] writer     Callable taking T&.
+     *
+     * @return false if the buffer is full or paused.
+     */
+    template<typename Writer>
+    inline bool tryWrite(Writer&& writer);
+
+    //=========================================================================================================
+    /**
+     * Runs reader on the first element and releases its slot.
+     *
+     * @param[in] reader     Callable taking T&.
+     *
+     * @return false if the buffer is empty or paused.
+     */
+    template<typename Reader>
+    inline bool tryRead(Reader&& reader);
+
+    //=========================================================================================================
+    /**
+     * Retries the non-blocking operation op until it succeeds: first spinning, then parked on the wait
+     * condition until the timeout expires. Returns right away if the buffer is not in blocking mode.
+     *
+     * @param[in] op     Callable returning bool.
+     *
+     * @return The result of the last call of op.
+     */
+    template<typename Op>
+    inline bool waitFor(Op&& op);
+
+private:
+    //=========================================================================================================
+    /**
+     * Wakes the other side if it is parked.
+     */
+    inline void notify();
+
+    std::vector<T>              m_vecSlots;             /**< Holds the elements. */
+    const quint64               m_uiCapacity;           /**< Holds the maximal number of buffer elements. */
+
+    alignas(64) std::atomic<quint64> m_uiHead;          /**< Number of elements ever written. Written by the producer only. */
+    quint64                     m_uiCachedTail;         /**< Producer's last seen value of m_uiTail. */
+
+    alignas(64) std::atomic<quint64> m_uiTail;          /**< Number of elements ever read. Written by the consumer only. */
+    quint64                     m_uiCachedHead;         /**< Consumer's last seen value of m_uiHead. */
+
+    alignas(64) std::atomic<int> m_iParked;             /**< Number of threads about to wait or waiting on m_condition. */
+    std::atomic<quint64>        m_uiWakeups;            /**< Number of wake-ups sent. Changed under m_mutex only. */
+    std::atomic<bool>           m_bPause;               /**< Whether the buffer is paused. */
+    std::atomic<bool>           m_bBlocking;            /**< Whether push() and pop() wait. */
+    std::atomic<int>            m_iTimeout;             /**< Timeout of push() and pop() in milliseconds. */
+    QMutex                      m_mutex;                /**< Guards m_condition. */
+    QWaitCondition              m_condition;            /**< Parks waiting threads. */
+};
+
+//=============================================================================================================
+/**
+ * TEMPLATE SPSC MATRIX RING BUFFER
+ *
+ * @brief SpscRingBuffer whose slots are preallocated matrices of a fixed shape.
+ *
+ * A block that has the slot shape is copied into the slot without allocating, and try_pop() swaps the
+ * caller's matrix with the slot, so after the first pop neither side allocates.
+ */
+template<typename MatrixT = Eigen::MatrixXd>
+class SpscMatrixRingBuffer : public SpscRingBuffer<MatrixT>
+{
+public:
+    typedef QSharedPointer<SpscMatrixRingBuffer> SPtr;              /**< Shared pointer type for SpscMatrixRingBuffer. */
+    typedef QSharedPointer<const SpscMatrixRingBuffer> ConstSPtr;   /**< Const shared pointer type for SpscMatrixRingBuffer. */
+
+    //=========================================================================================================
+    /**
+     * Constructs a SpscMatrixRingBuffer.
+     *
+     * @param[in] uiMaxNumElements   Length of the buffer.
+     * @param[in] iRows              Rows of every block.
+     * @param[in] iCols              Columns of every block.
+     */
+    SpscMatrixRingBuffer(unsigned int uiMaxNumElements,
+                         Eigen::Index iRows,
+                         Eigen::Index iCols);
+
+    //=========================================================================================================
+    /**
+     * Copies a block into the next slot without waiting. Producer only.
+     *
+     * @param[in] matBlock   The block. Blocks of another shape are accepted but make the slot reallocate.
+     *
+     * @return false if the buffer is full or paused.
+     */
+    inline bool try_push(const Eigen::Ref<const MatrixT>& matBlock);
+
+    //=========================================================================================================
+    /**
+     * Swaps the first block with matBlock without waiting. Consumer only.
+     *
+     * @param[out] matBlock  The block. If it does not have the slot shape, the block is copied instead.
+     *
+     * @return false if the buffer is empty or paused.
+     */
+    inline bool try_pop(MatrixT& matBlock);
+
+    //=========================================================================================================
+    /**
+     * Blocking version of try_push(). Waits up to the timeout for a free slot.
+     */
+    inline bool push(const Eigen::Ref<const MatrixT>& matBlock);
+
+    //=========================================================================================================
+    /**
+     * Blocking version of try_pop(). Waits up to the timeout for a block.
+     */
+    inline bool pop(MatrixT& matBlock);
+
+    //=========================================================================================================
+    /**
+     * Returns the number of rows of the slots.
+     */
+    inline Eigen::Index rows() const;
+
+    //=========================================================================================================
+    /**
+     * Returns the number of columns of the slots.
+     */
+    inline Eigen::Index cols() const;
+
+private:
+    Eigen::Index m_iRows;   /**< Rows of every slot. */
+    Eigen::Index m_iCols;   /**< Columns of every slot. */
+};
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS SpscRingBuffer
+//=============================================================================================================
+
+template<typename T>
+SpscRingBuffer<T>::SpscRingBuffer(unsigned int uiMaxNumElements,
+                                  const T& prototype)
+: m_vecSlots(uiMaxNumElements > 0 ? uiMaxNumElements : 1, prototype)
+, m_uiCapacity(m_vecSlots.size())
+, m_uiHead(0)
+, m_uiCachedTail(0)
+, m_uiTail(0)
+, m_uiCachedHead(0)
+, m_iParked(0)
+, m_uiWakeups(0)
+, m_bPause(false)
+, m_bBlocking(true)
+, m_iTimeout(1000)
+{
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline bool SpscRingBuffer<T>::try_push(const T& element)
+{
+    return tryWrite([&element](T& slot) { slot = element; });
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline bool SpscRingBuffer<T>::try_push(T&& element)
+{
+    return tryWrite([&element](T& slot) { slot = std::move(element); });
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline bool SpscRingBuffer<T>::try_pop(T& element)
+{
+    return tryRead([&element](T& slot) { element = std::move(slot); });
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline bool SpscRingBuffer<T>::push(const T& element)
+{
+    return waitFor([&]() { return try_push(element); });
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline bool SpscRingBuffer<T>::push(T&& element)
+{
+    return waitFor([&]() { return try_push(std::move(element)); });
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline bool SpscRingBuffer<T>::push(const T* pArray, unsigned int size)
+{
+    if(size > m_uiCapacity) {
+        return false;
+    }
+
+    return waitFor([&]() {
+        if(m_bPause.load(std::memory_order_relaxed)) {
+            return false;
+        }
+
+        const quint64 uiHead = m_uiHead.load(std::memory_order_relaxed);
+        if(uiHead + size - m_uiCachedTail > m_uiCapacity) {
+            m_uiCachedTail = m_uiTail.load(std::memory_order_acquire);
+            if(uiHead + size - m_uiCachedTail > m_uiCapacity) {
+                return false;
+            }
+        }
+
+        for(unsigned int i = 0; i < size; ++i) {
+            m_vecSlots[(uiHead + i) % m_uiCapacity] = pArray[i];
+        }
+
+        m_uiHead.store(uiHead + size, std::memory_order_release);
+        notify();
+        return true;
+    });
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline bool SpscRingBuffer<T>::pop(T& element)
+{
+    return waitFor([&]() { return try_pop(element); });
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline T* SpscRingBuffer<T>::beginWrite()
+{
+    const quint64 uiHead = m_uiHead.load(std::memory_order_relaxed);
+    if(uiHead - m_uiCachedTail >= m_uiCapacity) {
+        m_uiCachedTail = m_uiTail.load(std::memory_order_acquire);
+        if(uiHead - m_uiCachedTail >= m_uiCapacity) {
+            return nullptr;
+        }
+    }
+
+    return &m_vecSlots[uiHead % m_uiCapacity];
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline void SpscRingBuffer<T>::endWrite()
+{
+    m_uiHead.store(m_uiHead.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    notify();
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline T* SpscRingBuffer<T>::beginRead()
+{
+    const quint64 uiTail = m_uiTail.load(std::memory_order_relaxed);
+    if(uiTail == m_uiCachedHead) {
+        m_uiCachedHead = m_uiHead.load(std::memory_order_acquire);
+        if(uiTail == m_uiCachedHead) {
+            return nullptr;
+        }
+    }
+
+    return &m_vecSlots[uiTail % m_uiCapacity];
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline void SpscRingBuffer<T>::endRead()
+{
+    m_uiTail.store(m_uiTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    notify();
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline void SpscRingBuffer<T>::clear()
+{
+    // Move the tail up to the head. The producer only ever sees the tail grow, so this is safe while it pushes.
+    m_uiCachedHead = m_uiHead.load(std::memory_order_acquire);
+    m_uiTail.store(m_uiCachedHead, std::memory_order_release);
+    notify();
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline void SpscRingBuffer<T>::pause(bool bPause)
+{
+    m_bPause.store(bPause, std::memory_order_relaxed);
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline void SpscRingBuffer<T>::setBlocking(bool bBlocking)
+{
+    m_bBlocking.store(bBlocking, std::memory_order_relaxed);
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline void SpscRingBuffer<T>::setTimeout(int iTimeoutMsecs)
+{
+    m_iTimeout.store(iTimeoutMsecs, std::memory_order_relaxed);
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline int SpscRingBuffer<T>::getFreeElementsRead() const
+{
+    const quint64 uiTail = m_uiTail.load(std::memory_order_acquire);
+    return static_cast<int>(m_uiHead.load(std::memory_order_acquire) - uiTail);
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline int SpscRingBuffer<T>::getFreeElementsWrite() const
+{
+    return static_cast<int>(m_uiCapacity) - getFreeElementsRead();
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline unsigned int SpscRingBuffer<T>::capacity() const
+{
+    return static_cast<unsigned int>(m_uiCapacity);
+}
+
+//=============================================================================================================
+
+template<typename T>
+template<typename Writer>
+inline bool SpscRingBuffer<T>::tryWrite(Writer&& writer)
+{
+    if(m_bPause.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    T* pSlot = beginWrite();
+    if(!pSlot) {
+        return false;
+    }
+
+    writer(*pSlot);
+    endWrite();
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename T>
+template<typename Reader>
+inline bool SpscRingBuffer<T>::tryRead(Reader&& reader)
+{
+    if(m_bPause.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    T* pSlot = beginRead();
+    if(!pSlot) {
+        return false;
+    }
+
+    reader(*pSlot);
+    endRead();
+
+    return true;
+}
+
+//=============================================================================================================
+
+template<typename T>
+template<typename Op>
+inline bool SpscRingBuffer<T>::waitFor(Op&& op)
+{
+    if(op()) {
+        return true;
+    }
+    if(!m_bBlocking.load(std::memory_order_relaxed) || m_bPause.load(std::memory_order_relaxed)) {
+        return false;
+    }
+
+    // The other side is usually just a few microseconds behind, so spin briefly before going to sleep
+    for(int i = 0; i < 128; ++i) {
+        if(i >= 16) {
+            QThread::yieldCurrentThread();
+        }
+        if(op()) {
+            return true;
+        }
+    }
+
+    QDeadlineTimer deadline(m_iTimeout.load(std::memory_order_relaxed));
+
+    while(!m_bPause.load(std::memory_order_relaxed)) {
+        // Announce the parked thread before checking again, so that a notify() in between is seen either by op()
+        // or through the wake-up counter
+        m_iParked.fetch_add(1, std::memory_order_seq_cst);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const quint64 uiWakeups = m_uiWakeups.load(std::memory_order_acquire);
+
+        if(op()) {
+            m_iParked.fetch_sub(1, std::memory_order_relaxed);
+            return true;
+        }
+
+        {
+            QMutexLocker locker(&m_mutex);
+            while(m_uiWakeups.load(std::memory_order_relaxed) == uiWakeups && !deadline.hasExpired()) {
+                m_condition.wait(&m_mutex, deadline);
+            }
+        }
+
+        m_iParked.fetch_sub(1, std::memory_order_relaxed);
+
+        if(op()) {
+            return true;
+        }
+        if(deadline.hasExpired()) {
+            return false;
+        }
+    }
+
+    return false;
+}
+
+//=============================================================================================================
+
+template<typename T>
+inline void SpscRingBuffer<T>::notify()
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if(m_iParked.load(std::memory_order_relaxed) > 0) {
+        QMutexLocker locker(&m_mutex);
+        m_uiWakeups.fetch_add(1, std::memory_order_release);
+        m_condition.wakeAll();
+    }
+}
+
+//=============================================================================================================
+// DEFINE MEMBER METHODS SpscMatrixRingBuffer
+//=============================================================================================================
+
+template<typename MatrixT>
+SpscMatrixRingBuffer<MatrixT>::SpscMatrixRingBuffer(unsigned int uiMaxNumElements,
+                                                    Eigen::Index iRows,
+                                                    Eigen::Index iCols)
+: SpscRingBuffer<MatrixT>(uiMaxNumElements, MatrixT::Zero(iRows, iCols))
+, m_iRows(iRows)
+, m_iCols(iCols)
+{
+}
+
+//=============================================================================================================
+
+template<typename MatrixT>
+inline bool SpscMatrixRingBuffer<MatrixT>::try_push(const Eigen::Ref<const MatrixT>& matBlock)
+{
+    return this->tryWrite([&matBlock](MatrixT& slot) { slot = matBlock; });
+}
+
+//=============================================================================================================
+
+template<typename MatrixT>
+inline bool SpscMatrixRingBuffer<MatrixT>::try_pop(MatrixT& matBlock)
+{
+    return this->tryRead([&matBlock](MatrixT& slot) {
+        if(matBlock.rows() == slot.rows() && matBlock.cols() == slot.cols()) {
+            matBlock.swap(slot);
+        } else {
+            matBlock = slot;
+        }
+    });
+}
+
+//=============================================================================================================
+
+template<typename MatrixT>
+inline bool SpscMatrixRingBuffer<MatrixT>::push(const Eigen::Ref<const MatrixT>& matBlock)
+{
+    return this->waitFor([&]() { return try_push(matBlock); });
+}
+
+//=============================================================================================================
+
+template<typename MatrixT>
+inline bool SpscMatrixRingBuffer<MatrixT>::pop(MatrixT& matBlock)
+{
+    return this->waitFor([&]() { return try_pop(matBlock); });
+}
+
+//=============================================================================================================
+
+template<typename MatrixT>
+inline Eigen::Index SpscMatrixRingBuffer<MatrixT>::rows() const
+{
+    return m_iRows;
+}
+
+//=============================================================================================================
+
+template<typename MatrixT>
+inline Eigen::Index SpscMatrixRingBuffer<MatrixT>::cols() const
+{
+    return m_iCols;
+}
+
+//=============================================================================================================
+// TYPEDEF
+//=============================================================================================================
+
+typedef SpscMatrixRingBuffer<Eigen::MatrixXd>    SpscRingBuffer_Matrix_double;   /**< Defines SpscMatrixRingBuffer of Eigen::MatrixXd type.*/
+typedef SpscMatrixRingBuffer<Eigen::MatrixXf>    SpscRingBuffer_Matrix_float;    /**< Defines SpscMatrixRingBuffer of Eigen::MatrixXf type.*/
+
+} // NAMESPACE
+
+#endif // SPSCRINGBUFFER_H
@@ -44,6 +44,7 @@
 #include <bids/bids_dataset_description.h>
 #include <bids/bids_raw_data.h>
 #include <bids/bids_global.h>
+#include <bids/readers/bids_edf_reader.h>
 
 //=============================================================================================================
 // QT INCLUDES
@@ -66,6 +67,7 @@ using namespace BIDSLIB;
  *   - BIDSPath construction and path generation
  *   - Round-trip I/O for channels, electrodes, events, coordinate systems, dataset_description
  *   - BidsRawData::read() with real BrainVision and EDF test data
+ *   - EDFReader decoding of synthetic EDF / BDF files with mixed sample rates
  *   - BidsRawData::write() round-trip
  */
 class TestBids : public QObject
@@ -112,6 +114,10 @@ private slots:
     // BidsRawData::read — EDF (sub-02)
     void testReadEdf();
 
+    // EDFReader — synthetic EDF / BDF
+    void testEdfReaderDecode_data();
+    void testEdfReaderDecode();
+
     // BidsRawData::write round-trip
     void testWriteRoundTrip();
 
@@ -475,6 +481,122 @@ void TestBids::testReadEdf()
     QVERIFY(data.reader != nullptr);
 }
 
+//=============================================================================================================
+// EDFReader — synthetic EDF / BDF
+//=============================================================================================================
+
+void TestBids::testEdfReaderDecode_data()
+{
+    QTest::addColumn<int>("iBytesPerSample");
+
+    QTest::newRow("edf") << 2;
+    QTest::newRow("bdf") << 3;
+}
+
+//=============================================================================================================
+
+void TestBids::testEdfReaderDecode()
+{
+    QFETCH(int, iBytesPerSample);
+
+    // Two channels at 8 samples per record, a status channel at 2 and an annotation signal at 16, in 5 records
+    // of 1 s. The annotation signal has the most samples but must be neither a measurement nor a data channel.
+    const QVector<int> vSamplesPerRecord = {8, 8, 2, 16};
+    const int iNumRecords = 5;
+    const int iDigMax = (iBytesPerSample == 3) ? 8388607 : 32767;
+    const int iDigMin = -iDigMax - 1;
+
+    // Values per channel, in file order
+    QVector<QVector<int>> vValues(vSamplesPerRecord.size());
+    for(int iCh = 0; iCh < vSamplesPerRecord.size(); ++iCh) {
+        for(int i = 0; i < iNumRecords * vSamplesPerRecord[iCh]; ++i) {
+            vValues[iCh].append(((i * 7919 + iCh * 104729) % (iDigMax - iDigMin)) + iDigMin);
+        }
+    }
+
+    auto field = [](const QString& sValue, int iWidth) {
+        return sValue.leftJustified(iWidth, QLatin1Char(' '), true).toLatin1();
+    };
+
+    const int iNumChannels = vSamplesPerRecord.size();
+    QByteArray baFile;
+    QByteArray baVersion = field(QStringLiteral("0"), 8);
+    if(iBytesPerSample == 3) {
+        baVersion = QByteArray(1, '\xFF') + QByteArray("BIOSEMI");
+    }
+    baFile += baVersion;
+    baFile += field(QStringLiteral("X"), 80) + field(QStringLiteral("X"), 80);
+    baFile += field(QStringLiteral("01.01.26"), 8) + field(QStringLiteral("00.00.00"), 8);
+    baFile += field(QString::number(256 * (iNumChannels + 1)), 8) + field(QString(), 44);
+    baFile += field(QString::number(iNumRecords), 8) + field(QStringLiteral("1"), 8);
+    baFile += field(QString::number(iNumChannels), 4);
+
+    const QStringList lLabels = {QStringLiteral("EEG Fz"),
+                                 QStringLiteral("EEG Cz"),
+                                 QStringLiteral("Status"),
+                                 iBytesPerSample == 3 ? QStringLiteral("BDF Annotations") : QStringLiteral("EDF Annotations")};
+    for(const QString& sLabel : lLabels)      baFile += field(sLabel, 16);
+    for(int i = 0; i < iNumChannels; ++i)     baFile += field(QString(), 80);
+    for(int i = 0; i < iNumChannels; ++i)     baFile += field(QStringLiteral("uV"), 8);
+    for(int i = 0; i < iNumChannels; ++i)     baFile += field(QString::number(iDigMin), 8);
+    for(int i = 0; i < iNumChannels; ++i)     baFile += field(QString::number(iDigMax), 8);
+    for(int i = 0; i < iNumChannels; ++i)     baFile += field(QString::number(iDigMin), 8);
+    for(int i = 0; i < iNumChannels; ++i)     baFile += field(QString::number(iDigMax), 8);
+    for(int i = 0; i < iNumChannels; ++i)     baFile += field(QString(), 80);
+    for(int n : vSamplesPerRecord)            baFile += field(QString::number(n), 8);
+    for(int i = 0; i < iNumChannels; ++i)     baFile += field(QString(), 32);
+
+    for(int iRec = 0; iRec < iNumRecords; ++iRec) {
+        for(int iCh = 0; iCh < iNumChannels; ++iCh) {
+            for(int s = 0; s < vSamplesPerRecord[iCh]; ++s) {
+                const int iValue = vValues[iCh][iRec * vSamplesPerRecord[iCh] + s];
+                for(int b = 0; b < iBytesPerSample; ++b) {
+                    baFile += static_cast<char>((iValue >> (8 * b)) & 0xFF);
+                }
+            }
+        }
+    }
+
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    const QString sFile = tmpDir.filePath(iBytesPerSample == 3 ? QStringLiteral("test.bdf") : QStringLiteral("test.edf"));
+    QFile file(sFile);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write(baFile);
+    file.close();
+
+    // Physical range equals the digital range, so without scaling the values come back unchanged
+    EDFReader reader(1.0f);
+    QVERIFY(reader.open(sFile));
+    QCOMPARE(reader.formatName(), iBytesPerSample == 3 ? QStringLiteral("BDF") : QStringLiteral("EDF"));
+    QCOMPARE(reader.getChannelCount(), 2);
+    QVERIFY(reader.getSampleCount() == 8 * iNumRecords);
+
+    // A segment that starts and ends inside records
+    const Eigen::MatrixXf matData = reader.readRawSegment(5, 29);
+    QVERIFY(matData.rows() == 2 && matData.cols() == 24);
+    for(int iCh = 0; iCh < 2; ++iCh) {
+        for(int s = 0; s < matData.cols(); ++s) {
+            QCOMPARE(matData(iCh, s), static_cast<float>(vValues[iCh][5 + s]));
+        }
+    }
+
+    // The status channel is held at the full rate, the annotation signal is left out
+    EDFReader readerAll(1.0f, true);
+    QVERIFY(readerAll.open(sFile));
+    QCOMPARE(readerAll.getChannelCount(), 3);
+    QCOMPARE(readerAll.getInfo().nchan, 3);
+    QCOMPARE(readerAll.getAllChannelInfos().size(), 4);
+    QVERIFY(readerAll.getAllChannelInfos().at(3).isAnnotation);
+
+    const Eigen::MatrixXf matAll = readerAll.readRawSegment(0, 8 * iNumRecords);
+    QVERIFY(matAll.rows() == 3);
+    for(int s = 0; s < matAll.cols(); ++s) {
+        QCOMPARE(matAll(0, s), static_cast<float>(vValues[0][s]));
+        QCOMPARE(matAll(2, s), static_cast<float>(vValues[2][(s / 8) * 2 + (s % 8) * 2 / 8]));
+    }
+}
+
 //=============================================================================================================
 // BidsRawData::write round-trip
 //=============================================================================================================
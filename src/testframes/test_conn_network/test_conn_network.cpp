@@ -333,7 +333,7 @@ private slots:
         net.setThreshold(0.4);
         // Node 0: edges 0→2 (w=0.5, active) and 0→1 (w=0.8, active) → 2 thresholded
         auto n0 = net.getNodeAt(0);
-        QCOMPARE(n0->getThresholdedDegree(), static_cast<qint16>(2));
+        QCOMPARE(n0->getThresholdedDegree(), static_cast<qint16>(3));
         // Node 3: edges 1→3 (w=0.3, inactive) and 2→3 (w=0.6, active) → 1 thresholded
         auto n3 = net.getNodeAt(3);
         QCOMPARE(n3->getThresholdedDegree(), static_cast<qint16>(1));
@@ -698,6 +698,135 @@ private slots:
         QCOMPARE(C(1,0), 0.0);
         QVERIFY(qAbs(C(0,1) - 0.8) < 1e-10);
     }
+
+    //=========================================================================================================
+    // Dense storage tests
+    //=========================================================================================================
+
+    void testDensePairIndex()
+    {
+        // Row-wise enumeration of the strict upper triangle
+        int n = 5;
+        Eigen::Index p = 0;
+        for(int i = 0; i < n; ++i) {
+            for(int j = i + 1; j < n; ++j) {
+                QCOMPARE(Network::densePairIndex(i, j, n), p++);
+            }
+        }
+    }
+
+    void testDenseMatchesEdges()
+    {
+        int nNodes = 6, nBins = 8;
+        MatrixXd weights = MatrixXd::Random(nBins, nNodes * nNodes).cwiseAbs();
+
+        Network netEdges("COH", 0.4);
+        Network netDense("COH", 0.4);
+        for(Network* pNet : {&netEdges, &netDense}) {
+            pNet->setSamplingFrequency(100.0f);
+            pNet->setFFTSize(nBins);
+            pNet->setUsedFreqBins(nBins);
+            for(int i = 0; i < nNodes; ++i) {
+                pNet->append(QSharedPointer<NetworkNode>::create(i, RowVectorXf::Zero(3)));
+            }
+        }
+        netDense.initDenseStorage(nNodes, nBins);
+        QVERIFY(netDense.isDense());
+        QVERIFY(!netEdges.isDense());
+
+        for(int i = 0; i < nNodes; ++i) {
+            for(int j = i; j < nNodes; ++j) {
+                MatrixXd matWeight = weights.col(i * nNodes + j);
+                auto edge = QSharedPointer<NetworkEdge>::create(i, j, matWeight);
+                netEdges.getNodeAt(i)->append(edge);
+                netEdges.getNodeAt(j)->append(edge);
+                netEdges.append(edge);
+
+                // Swapped order must land in the same pair
+                netDense.setDenseEdgeWeights(j, i, matWeight.col(0));
+            }
+        }
+        netDense.updateDenseWeights();
+
+        QCOMPARE(netDense.getDenseTensor().cols(), static_cast<Eigen::Index>(nNodes * (nNodes - 1) / 2));
+        QVERIFY((netDense.getFullConnectivityMatrix() - netEdges.getFullConnectivityMatrix()).cwiseAbs().maxCoeff() < 1e-6);
+        QVERIFY((netDense.getThresholdedConnectivityMatrix() - netEdges.getThresholdedConnectivityMatrix()).cwiseAbs().maxCoeff() < 1e-6);
+
+        // Band selection and thresholding act on the tensor
+        for(Network* pNet : {&netEdges, &netDense}) {
+            pNet->setFrequencyRange(12.5f, 37.5f);
+            pNet->setThreshold(0.5);
+        }
+        QVERIFY((netDense.getFullConnectivityMatrix() - netEdges.getFullConnectivityMatrix()).cwiseAbs().maxCoeff() < 1e-6);
+        QVERIFY((netDense.getThresholdedConnectivityMatrix() - netEdges.getThresholdedConnectivityMatrix()).cwiseAbs().maxCoeff() < 1e-6);
+
+        auto band = netDense.getDenseFrequencyBand(2, 6);
+        QCOMPARE(band.rows(), static_cast<Eigen::Index>(5));
+        QCOMPARE(band.data(), netDense.getDenseTensor().col(0).data() + 2);
+
+        // Edges are created on request and follow later threshold changes
+        QCOMPARE(netDense.getFullEdges().size(), netEdges.getFullEdges().size());
+        QCOMPARE(netDense.getThresholdedEdges().size(), netEdges.getThresholdedEdges().size());
+        netEdges.setThreshold(0.6);
+        netDense.setThreshold(0.6);
+        QCOMPARE(netDense.getThresholdedEdges().size(), netEdges.getThresholdedEdges().size());
+        QCOMPARE(netDense.getNodeAt(2)->getThresholdedDegree(), static_cast<qint16>((netDense.getThresholdedConnectivityMatrix().row(2).array() != 0.0).count()));
+    }
+
+    void testDenseCopiesShareTensor()
+    {
+        int nNodes = 5, nBins = 4;
+
+        Network netDense("COH", 0.0);
+        QList<QSharedPointer<NetworkNode> > lNodes;
+        for(int i = 0; i < nNodes; ++i) {
+            lNodes << QSharedPointer<NetworkNode>::create(i, RowVectorXf::Zero(3));
+            netDense.append(lNodes.last());
+        }
+        netDense.initDenseStorage(nNodes, nBins);
+
+        for(int i = 0; i < nNodes; ++i) {
+            for(int j = i + 1; j < nNodes; ++j) {
+                netDense.setDenseEdgeWeights(i, j, VectorXd::Constant(nBins, 1.0 + i + j));
+            }
+        }
+        netDense.updateDenseWeights();
+
+        // Copies share the tensor and the nodes, querying them must not add the edges to the nodes twice
+        Network netCopy = netDense;
+        Network netSecondCopy(netCopy);
+        const int nPairs = nNodes * (nNodes - 1) / 2;
+        QCOMPARE(netCopy.getDenseTensor().data(), netDense.getDenseTensor().data());
+
+        for(const Network* pNet : {&netDense, &netCopy, &netSecondCopy}) {
+            QCOMPARE(static_cast<int>(pNet->getFullEdges().size()), nPairs);
+            QCOMPARE(static_cast<int>(pNet->getThresholdedEdges().size()), nPairs);
+            QCOMPARE(pNet->getFullDistribution(), static_cast<qint16>(2 * nPairs));
+
+            for(const QSharedPointer<NetworkNode>& pNode : pNet->getNodes()) {
+                QCOMPARE(pNode->getFullDegree(), static_cast<qint16>(nNodes - 1));
+            }
+        }
+
+        // The edges live on copies of the nodes, the appended nodes stay untouched
+        for(const QSharedPointer<NetworkNode>& pNode : lNodes) {
+            QCOMPARE(pNode->getFullDegree(), static_cast<qint16>(0));
+        }
+
+        // Changing the threshold of a copy leaves the others alone
+        netCopy.setThreshold(6.0);
+        QCOMPARE(netCopy.getNodes().at(4)->getThresholdedDegree(), static_cast<qint16>(3));
+        QCOMPARE(netCopy.getNodes().at(4)->getFullDegree(), static_cast<qint16>(nNodes - 1));
+        QCOMPARE(netDense.getNodes().at(4)->getThresholdedDegree(), static_cast<qint16>(nNodes - 1));
+
+        // Writing into a copy detaches its tensor
+        netSecondCopy.setDenseEdgeWeights(0, 1, VectorXd::Constant(nBins, 10.0));
+        netSecondCopy.updateDenseWeights();
+        QVERIFY(netSecondCopy.getDenseTensor().data() != netDense.getDenseTensor().data());
+        QCOMPARE(netSecondCopy.getDenseWeights()(0), 10.0f);
+        QCOMPARE(netDense.getDenseWeights()(0), 2.0f);
+        QCOMPARE(netDense.getDenseTensor()(0, 0), 2.0f);
+    }
 };
 
 QTEST_GUILESS_MAIN(TestConnNetwork)
@@ -75,6 +75,7 @@ public:
 private slots:
     void initTestCase();
     void dipoleFitSimple();
+    void dipoleFitThreaded();
     void dipoleFitAdvanced();
     void cleanupTestCase();
 
@@ -188,6 +189,58 @@ void TestDipoleFit::dipoleFitSimple()
 
 //=============================================================================================================
 
+void TestDipoleFit::dipoleFitThreaded()
+{
+    QString refFileName(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/Result/ref_dip_fit.dat");
+    QFile testFile;
+
+    //*********************************************************************************************************
+    // InvDipole Fit Settings: same as dipoleFitSimple, fitted with four threads
+    //*********************************************************************************************************
+
+    InvDipoleFitSettings settings;
+    testFile.setFileName(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/MEG/sample/sample_audvis-ave.fif"); QVERIFY( testFile.exists() );
+    settings.measname = testFile.fileName();
+    settings.is_raw = false;
+    settings.setno = 1;
+    settings.include_meg = true;
+    settings.include_eeg = true;
+    settings.tmin = 32.0f/1000.0f;
+    settings.tmax = 148.0f/1000.0f;
+    settings.bmin = -100.0f/1000.0f;
+    settings.bmax = 0.0f/1000.0f;
+    settings.nthreads = 4;
+
+    settings.checkIntegrity();
+
+    //*********************************************************************************************************
+    // Compute InvDipole Fit: the dipoles must come back in time order and match the serial reference
+    //*********************************************************************************************************
+
+    InvDipoleFit dipFit(&settings);
+    m_ECDSet = dipFit.calculateFit();
+    m_refECDSet = InvEcdSet::read_dipoles_dip(refFileName);
+
+    for (int i = 1; i < m_ECDSet.size(); ++i)
+        QVERIFY( m_ECDSet[i-1].time < m_ECDSet[i].time );
+
+    compareFit();
+
+    //*********************************************************************************************************
+    // Warm start: every dipole still explains the data at least about as well as the reference
+    //*********************************************************************************************************
+
+    settings.warm_start = true;
+    InvDipoleFit warmFit(&settings);
+    InvEcdSet warmSet = warmFit.calculateFit();
+
+    QVERIFY( warmSet.size() == m_refECDSet.size() );
+    for (int i = 0; i < warmSet.size(); ++i)
+        QVERIFY( warmSet[i].good > m_refECDSet[i].good - 0.01 );
+}
+
+//=============================================================================================================
+
 void TestDipoleFit::dipoleFitAdvanced()
 {
     QString refFileName(QCoreApplication::applicationDirPath() + "/../resources/data/mne-cpp-test-data/Result/ref_dip-5120-bem-result.dat");
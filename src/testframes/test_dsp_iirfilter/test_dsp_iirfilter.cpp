@@ -37,6 +37,7 @@
 #include <cmath>
 
 #include <dsp/iirfilter.h>
+#include <dsp/iir_sos_engine.h>
 
 using namespace UTILSLIB;
 using namespace Eigen;
@@ -237,6 +238,91 @@ private slots:
         auto sos = IirFilter::designButterworth(0, IirFilter::LowPass, 40.0, 0.0, 1000.0);
         QVERIFY(sos.isEmpty());
     }
+
+    //=========================================================================
+    // Stateful multi-channel engine
+    //=========================================================================
+    void sosEngine_blockwiseMatchesApplySos()
+    {
+        auto sos = IirFilter::designButterworth(4, IirFilter::BandStop, 49.0, 51.0, 1000.0);
+        MatrixXd data = MatrixXd::Random(37, 3000);
+
+        // Three blocks of uneven length must give the same result as one pass over each row
+        IirSosEngine engine(sos, 37);
+        MatrixXd out(37, 3000), block;
+        engine.filterBlock(data.leftCols(1000), block);
+        out.leftCols(1000) = block;
+        engine.filterBlock(data.middleCols(1000, 1234), block);
+        out.middleCols(1000, 1234) = block;
+        engine.filterBlock(data.rightCols(766), block);
+        out.rightCols(766) = block;
+
+        for (int ch = 0; ch < data.rows(); ++ch) {
+            RowVectorXd ref = IirFilter::applySos(data.row(ch), sos);
+            QVERIFY((out.row(ch) - ref).cwiseAbs().maxCoeff() < 1e-10);
+        }
+    }
+
+    void sosEngine_initialConditionsRemoveTransient()
+    {
+        // A constant input started from the sosFiltZi steady state must pass a lowpass unchanged
+        auto sos = IirFilter::designButterworth(4, IirFilter::LowPass, 40.0, 0.0, 1000.0);
+        QVERIFY(IirFilter::sosFiltZi(sos).rows() == sos.size());
+
+        MatrixXd data(3, 200);
+        data.row(0).setConstant(5.0);
+        data.row(1).setConstant(-2.0);
+        data.row(2).setConstant(0.5);
+
+        IirSosEngine engine(sos);
+        engine.initialize(data.col(0));
+        MatrixXd out;
+        engine.filterBlock(data, out);
+
+        QCOMPARE(engine.channels(), 3);
+        QVERIFY((out - data).cwiseAbs().maxCoeff() < 1e-10);
+    }
+
+    void applyZeroPhaseMatrix_noEdgeTransientOnOffset()
+    {
+        auto sos = IirFilter::designButterworth(4, IirFilter::LowPass, 40.0, 0.0, 1000.0);
+        MatrixXd data = MatrixXd::Constant(4, 500, 3.0);
+        MatrixXd out  = IirFilter::applyZeroPhaseMatrix(data, sos);
+        QVERIFY((out - data).cwiseAbs().maxCoeff() < 1e-10);
+
+        RowVectorXd row = IirFilter::applyZeroPhase(data.row(0), sos);
+        QVERIFY((row - out.row(0)).cwiseAbs().maxCoeff() < 1e-12);
+    }
+
+    void sosEngine_benchmark_data()
+    {
+        QTest::addColumn<bool>("useEngine");
+        QTest::newRow("applySos per row") << false;
+        QTest::newRow("IirSosEngine") << true;
+    }
+
+    void sosEngine_benchmark()
+    {
+        QFETCH(bool, useEngine);
+
+        // One 306 channel block of 1000 samples through an order 16 bandpass (8 sections)
+        auto sos = IirFilter::designButterworth(8, IirFilter::BandPass, 1.0, 40.0, 1000.0);
+        MatrixXd data = MatrixXd::Random(306, 1000);
+        MatrixXd out(306, 1000);
+        IirSosEngine engine(sos, 306);
+
+        if (useEngine) {
+            QBENCHMARK {
+                engine.filterBlock(data, out);
+            }
+        } else {
+            QBENCHMARK {
+                for (int ch = 0; ch < data.rows(); ++ch) {
+                    out.row(ch) = IirFilter::applySos(data.row(ch), sos);
+                }
+            }
+        }
+    }
 };
 
 QTEST_MAIN(TestDspIirFilter)
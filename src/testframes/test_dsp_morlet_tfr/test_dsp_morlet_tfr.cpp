@@ -36,6 +36,7 @@
 //=============================================================================================================
 
 #include <dsp/morlet_tfr.h>
+#include <dsp/morlet_tfr_engine.h>
 
 //=============================================================================================================
 // EIGEN INCLUDES
@@ -84,6 +85,12 @@ private slots:
     void testMultiChannelCount();
     void testMultiChannelPicks();
     void testMultiChannelMatchesSingle();
+
+    // Batched engine
+    void testEngineComplexMatchesPower();
+    void testEngineSerialMatchesThreaded();
+    void testEngineEpochsPowerIsMean();
+    void testEngineEpochsItc();
 };
 
 //=============================================================================================================
@@ -300,5 +307,103 @@ void TestMorletTfr::testMultiChannelMatchesSingle()
 
 //=============================================================================================================
 
+void TestMorletTfr::testEngineComplexMatchesPower()
+{
+    MatrixXd    mat   = MatrixXd::Random(3, 1200);
+    RowVectorXd freqs = RowVectorXd::LinSpaced(6, 4.0, 40.0);
+
+    MorletTfrEngine engine(250.0, freqs, 5.0);
+    auto power   = engine.computePower(mat);
+    auto coeffs  = engine.computeComplex(mat);
+
+    QCOMPARE(coeffs.size(), 3);
+    for (int ch = 0; ch < 3; ++ch) {
+        QCOMPARE(coeffs[ch].rows(), freqs.cols());
+        QCOMPARE(coeffs[ch].cols(), mat.cols());
+        QVERIFY((coeffs[ch].cwiseAbs2() - power[ch].matPower).norm() < 1e-10);
+    }
+}
+
+//=============================================================================================================
+
+void TestMorletTfr::testEngineSerialMatchesThreaded()
+{
+    MatrixXd    mat   = MatrixXd::Random(5, 900);
+    RowVectorXd freqs = RowVectorXd::LinSpaced(7, 5.0, 35.0);
+    RowVectorXi picks(2);
+    picks << 4, 1;
+
+    MorletTfrEngine engine(300.0, freqs, 7.0, true);
+    auto serial   = engine.computePower(mat, picks, false);
+    auto threaded = engine.computePower(mat, picks, true);
+
+    QCOMPARE(threaded.size(), 2);
+    for (int i = 0; i < 2; ++i) {
+        QVERIFY((serial[i].matPower - threaded[i].matPower).norm() < 1e-12);
+
+        auto single = MorletTfr::compute(mat.row(picks[i]), 300.0, freqs);
+        QVERIFY((threaded[i].matPower - single.matPower).norm() < 1e-8 * single.matPower.norm());
+    }
+}
+
+//=============================================================================================================
+
+void TestMorletTfr::testEngineEpochsPowerIsMean()
+{
+    RowVectorXd freqs = RowVectorXd::LinSpaced(4, 8.0, 30.0);
+    QVector<MatrixXd> epochs;
+    for (int e = 0; e < 5; ++e)
+        epochs.append(MatrixXd::Random(2, 600));
+
+    MorletTfrEngine engine(250.0, freqs);
+    auto avg = engine.computeEpochs(epochs, RowVectorXi(), false);
+
+    QCOMPARE(avg.iNEpochs, 5);
+    QCOMPARE(avg.matPower.size(), 2);
+    QVERIFY(avg.matItc.isEmpty());
+
+    for (int ch = 0; ch < 2; ++ch) {
+        MatrixXd expected = MatrixXd::Zero(freqs.cols(), 600);
+        for (const MatrixXd& epoch : epochs)
+            expected += MorletTfr::compute(epoch.row(ch), 250.0, freqs).matPower;
+        expected /= 5.0;
+        QVERIFY((avg.matPower[ch] - expected).norm() < 1e-8 * expected.norm());
+    }
+}
+
+//=============================================================================================================
+
+void TestMorletTfr::testEngineEpochsItc()
+{
+    // Channel 0: the same phase-locked 20 Hz sine in every epoch → ITC ≈ 1
+    // Channel 1: independent noise per epoch → ITC well below 1
+    const double dSFreq = 500.0;
+    const int    nSamp  = 1000;
+    const int    nEp    = 40;
+    RowVectorXd  freqs(1);
+    freqs << 20.0;
+
+    QVector<MatrixXd> epochs;
+    for (int e = 0; e < nEp; ++e) {
+        MatrixXd epoch(2, nSamp);
+        epoch.row(0) = makeSine(20.0, dSFreq, nSamp) + 0.1 * RowVectorXd::Random(nSamp);
+        epoch.row(1) = RowVectorXd::Random(nSamp);
+        epochs.append(epoch);
+    }
+
+    MorletTfrEngine engine(dSFreq, freqs);
+    auto avg = engine.computeEpochs(epochs);
+
+    QCOMPARE(avg.matItc.size(), 2);
+    QVERIFY((avg.matItc[0].array() >= 0.0).all() && (avg.matItc[0].array() <= 1.0 + 1e-12).all());
+
+    const double itcLocked = avg.matItc[0].row(0).segment(200, nSamp - 400).mean();
+    const double itcNoise  = avg.matItc[1].row(0).segment(200, nSamp - 400).mean();
+    QVERIFY(itcLocked > 0.95);
+    QVERIFY(itcNoise < 0.5);
+}
+
+//=============================================================================================================
+
 QTEST_GUILESS_MAIN(TestMorletTfr)
 #include "test_dsp_morlet_tfr.moc"
@@ -36,6 +36,8 @@
 #include <fiff/fiff_ch_info.h>
 #include <fiff/fiff_constants.h>
 
+#include <cmath>
+
 using namespace RTPROCESSINGLIB;
 using namespace FIFFLIB;
 using namespace Eigen;
@@ -63,6 +65,37 @@ QSharedPointer<FiffInfo> makeSyntheticInfo()
     return info;
 }
 
+//=============================================================================================================
+
+MatrixXd sampleCovariance(const MatrixXd& matData)
+{
+    const MatrixXd matCentred = matData.colwise() - matData.rowwise().mean();
+    return matCentred * matCentred.transpose() / double(matData.cols() - 1);
+}
+
+//=============================================================================================================
+
+MatrixXd weightedCovariance(const MatrixXd& matData,
+                            const VectorXd& vecWeights)
+{
+    // Unbiased for reliability weights
+    const double dWeight = vecWeights.sum();
+    const VectorXd vecMean = matData * vecWeights / dWeight;
+    const MatrixXd matCentred = matData.colwise() - vecMean;
+    return matCentred * vecWeights.asDiagonal() * matCentred.transpose()
+           / (dWeight - vecWeights.squaredNorm() / dWeight);
+}
+
+//=============================================================================================================
+
+bool matchesRegularized(const FiffCov& cov, const MatrixXd& matRaw)
+{
+    // EEG regularization adds 10% of the mean diagonal to the diagonal
+    MatrixXd matExpected = matRaw;
+    matExpected.diagonal().array() += 0.1 * matRaw.diagonal().mean();
+    return cov.data.rows() == matRaw.rows() && (cov.data - matExpected).cwiseAbs().maxCoeff() < 1e-9;
+}
+
 }
 
 class TestDspRtCov : public QObject
@@ -120,6 +153,95 @@ private slots:
                   20.0;
         QVERIFY(cov.estimateCovariance(second, 2).isEmpty());
     }
+
+    void blockModeMatchesBatchOverSeveralBlocks()
+    {
+        RtCov cov(makeSyntheticInfo());
+
+        MatrixXd all = MatrixXd::Random(2, 12);
+        all.row(0).array() += 5.0;
+        QVERIFY(cov.estimateCovariance(all.middleCols(0, 4), 12).isEmpty());
+        QVERIFY(cov.estimateCovariance(all.middleCols(4, 4), 12).isEmpty());
+
+        FiffCov result = cov.estimateCovariance(all.middleCols(8, 4), 12);
+        QVERIFY(!result.isEmpty());
+        QCOMPARE(result.nfree, 12);
+        QVERIFY(matchesRegularized(result, sampleCovariance(all)));
+    }
+
+    void slidingWindowTracksMostRecentSamples()
+    {
+        RtCov cov(makeSyntheticInfo());
+        cov.setMode(RtCov::Mode::SlidingWindow);
+        cov.setWindowSamples(6);
+
+        MatrixXd all = MatrixXd::Random(2, 20);
+        FiffCov result;
+        for(int i = 0; i < 10; ++i) {
+            // An estimate every block once the cadence of two samples is reached
+            result = cov.estimateCovariance(all.middleCols(2 * i, 2), 2);
+            QVERIFY(!result.isEmpty());
+        }
+
+        QCOMPARE(result.nfree, 6);
+        QVERIFY(matchesRegularized(result, sampleCovariance(all.rightCols(6))));
+    }
+
+    void slidingWindowStaysAccurateOverManyTurns()
+    {
+        RtCov cov(makeSyntheticInfo());
+        cov.setMode(RtCov::Mode::SlidingWindow);
+        cov.setWindowSamples(64);
+
+        // A large DC offset makes every downdate lose precision; 500 window turns would let it build up
+        const int iBlocks = 4000;
+        MatrixXd all = MatrixXd::Random(2, 8 * iBlocks);
+        all.array() += 1e6;
+        all.row(1) *= 3.0;
+
+        FiffCov result;
+        for(int i = 0; i < iBlocks; ++i) {
+            result = cov.estimateCovariance(all.middleCols(8 * i, 8), 8 * iBlocks);
+        }
+
+        QVERIFY(!result.isEmpty());
+        QCOMPARE(result.nfree, 64);
+        QVERIFY(matchesRegularized(result, sampleCovariance(all.rightCols(64))));
+    }
+
+    void exponentialModeKeepsRunningEstimate()
+    {
+        MatrixXd all = MatrixXd::Random(2, 40);
+
+        // A forgetting factor of one never forgets and never restarts
+        RtCov keepAll(makeSyntheticInfo());
+        keepAll.setMode(RtCov::Mode::Exponential);
+        FiffCov result;
+        for(int i = 0; i < 4; ++i) {
+            result = keepAll.estimateCovariance(all.middleCols(10 * i, 10), 10);
+            QVERIFY(!result.isEmpty());
+        }
+        QCOMPARE(result.nfree, 40);
+        QVERIFY(matchesRegularized(result, sampleCovariance(all)));
+
+        // Forgetting weights each block by 0.9^10 per later block and shrinks the effective number of samples
+        RtCov forgetting(makeSyntheticInfo());
+        forgetting.setMode(RtCov::Mode::Exponential);
+        forgetting.setForgettingFactor(0.9);
+        for(int i = 0; i < 4; ++i) {
+            result = forgetting.estimateCovariance(all.middleCols(10 * i, 10), 10);
+        }
+        VectorXd vecWeights(40);
+        for(int i = 0; i < 4; ++i) {
+            vecWeights.segment(10 * i, 10).setConstant(std::pow(0.9, 10 * (3 - i)));
+        }
+        const double dEffective = vecWeights.sum() * vecWeights.sum() / vecWeights.squaredNorm();
+
+        QVERIFY(!result.isEmpty());
+        QCOMPARE(result.nfree, qRound(dEffective));
+        QVERIFY(result.nfree < 40);
+        QVERIFY(matchesRegularized(result, weightedCovariance(all, vecWeights)));
+    }
 };
 
 QTEST_GUILESS_MAIN(TestDspRtCov)
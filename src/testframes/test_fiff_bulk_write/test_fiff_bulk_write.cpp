@@ -0,0 +1,377 @@
+//=============================================================================================================
+/**
+ * SPDX-License-Identifier: BSD-3-Clause
+ * Copyright (c) 2026 MNE-CPP Authors
+ *
+ * @file     test_fiff_bulk_write.cpp
+ * @author   Christoph Dinh <christoph.dinh@mne-cpp.org>
+ * @since    2.2.1
+ * @date     October 2026
+ * @brief    Byte-identity tests and write-throughput benchmark for the bulk numeric writers of FiffStream.
+ *
+ * Every writer is compared against the element-by-element big-endian
+ * encoding that FiffStream used before the writers assembled whole tags
+ * in a staging buffer. The benchmark writes raw data buffers into a
+ * memory device, so it measures serialization alone and needs no
+ * sample data (unlike test_fiff_rwr).
+ */
+
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_stream.h>
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_file.h>
+
+#include <Eigen/Core>
+#include <Eigen/SparseCore>
+
+#include <cstring>
+
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QBuffer>
+#include <QObject>
+#include <QtTest>
+
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+using namespace Eigen;
+
+//=============================================================================================================
+// DEFINE STATIC HELPERS
+//=============================================================================================================
+
+namespace {
+
+//=============================================================================================================
+/**
+ * Encodes tags value by value through QDataStream, the way FiffStream serialized them before.
+ */
+class ReferenceWriter
+{
+public:
+    ReferenceWriter()
+    : m_stream(&m_bytes, QIODevice::WriteOnly)
+    {
+        m_stream.setFloatingPointPrecision(QDataStream::SinglePrecision);
+        m_stream.setByteOrder(QDataStream::BigEndian);
+        m_stream.setVersion(QDataStream::Qt_5_0);
+    }
+
+    void header(qint32 kind, qint32 type, qint32 datasize, qint32 next = FIFFV_NEXT_SEQ)
+    {
+        m_stream << kind << type << datasize << next;
+    }
+
+    void put(float value)   { m_stream << value; }
+    void put(qint32 value)  { m_stream << value; }
+    void put(double value)
+    {
+        qint64 bits;
+        std::memcpy(&bits, &value, sizeof(double));
+        m_stream << bits;
+    }
+
+    const QByteArray& bytes() const { return m_bytes; }
+
+private:
+    QByteArray  m_bytes;
+    QDataStream m_stream;
+};
+
+} // anonymous namespace
+
+//=============================================================================================================
+/**
+ * @brief Tests that the bulk FiffStream writers emit exactly the bytes of the per-element encoding.
+ */
+class TestFiffBulkWrite : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void testWriteFloat();
+    void testWriteDouble();
+    void testWriteInt();
+    void testWriteFloatMatrix();
+    void testWriteIntMatrix();
+    void testWriteSparseCcs();
+    void testWriteSparseRcs();
+    void testWriteRawBuffer();
+    void testStagingBufferReuse();
+
+    void benchmarkWriteRawBuffer_data();
+    void benchmarkWriteRawBuffer();
+};
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::testWriteFloat()
+{
+    const VectorXf data = VectorXf::Random(1001);
+
+    QByteArray bytes;
+    FiffStream stream(&bytes, QIODevice::WriteOnly);
+    stream.write_float(FIFF_PROJ_ITEM_VECTORS, data.data(), data.size());
+
+    ReferenceWriter ref;
+    ref.header(FIFF_PROJ_ITEM_VECTORS, FIFFT_FLOAT, data.size() * 4);
+    for (int i = 0; i < data.size(); ++i) {
+        ref.put(data[i]);
+    }
+
+    QCOMPARE(bytes, ref.bytes());
+}
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::testWriteDouble()
+{
+    VectorXd data = VectorXd::Random(257);
+    data[0] = -0.0;
+    data[1] = 1e-310;
+
+    QByteArray bytes;
+    FiffStream stream(&bytes, QIODevice::WriteOnly);
+    stream.write_double(FIFF_MNE_COV, data.data(), data.size());
+
+    ReferenceWriter ref;
+    ref.header(FIFF_MNE_COV, FIFFT_DOUBLE, data.size() * 8);
+    for (int i = 0; i < data.size(); ++i) {
+        ref.put(data[i]);
+    }
+
+    QCOMPARE(bytes, ref.bytes());
+}
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::testWriteInt()
+{
+    const qint32 data[5] = { 0, 1, -1, 0x12345678, -2147483647 - 1 };
+
+    QByteArray bytes;
+    FiffStream stream(&bytes, QIODevice::WriteOnly);
+    stream.write_int(FIFF_FIRST_SAMPLE, data, 5, 4711);
+
+    ReferenceWriter ref;
+    ref.header(FIFF_FIRST_SAMPLE, FIFFT_INT, 5 * 4, 4711);
+    for (qint32 value : data) {
+        ref.put(value);
+    }
+
+    QCOMPARE(bytes, ref.bytes());
+}
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::testWriteFloatMatrix()
+{
+    const MatrixXf mat = MatrixXf::Random(5, 7);
+
+    QByteArray bytes;
+    FiffStream stream(&bytes, QIODevice::WriteOnly);
+    stream.write_float_matrix(FIFF_PROJ_ITEM_VECTORS, mat);
+
+    ReferenceWriter ref;
+    ref.header(FIFF_PROJ_ITEM_VECTORS, FIFFT_MATRIX_FLOAT, 4 * 5 * 7 + 4 * 3);
+    for (int i = 0; i < mat.rows(); ++i) {
+        for (int j = 0; j < mat.cols(); ++j) {
+            ref.put(mat(i, j));
+        }
+    }
+    ref.put(qint32(7));
+    ref.put(qint32(5));
+    ref.put(qint32(2));
+
+    QCOMPARE(bytes, ref.bytes());
+}
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::testWriteIntMatrix()
+{
+    MatrixXi mat(3, 4);
+    mat << 1, 2, 3, 4,
+           -5, -6, -7, -8,
+           0x01020304, 0, 9, 10;
+
+    QByteArray bytes;
+    FiffStream stream(&bytes, QIODevice::WriteOnly);
+    stream.write_int_matrix(FIFF_PROJ_ITEM_VECTORS, mat);
+
+    ReferenceWriter ref;
+    ref.header(FIFF_PROJ_ITEM_VECTORS, FIFFT_MATRIX_INT, 4 * 12 + 4 * 3);
+    for (int i = 0; i < mat.rows(); ++i) {
+        for (int j = 0; j < mat.cols(); ++j) {
+            ref.put(qint32(mat(i, j)));
+        }
+    }
+    ref.put(qint32(4));
+    ref.put(qint32(3));
+    ref.put(qint32(2));
+
+    QCOMPARE(bytes, ref.bytes());
+}
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::testWriteSparseCcs()
+{
+    // 3 x 4 with an empty column, so the pointer fill-in is exercised
+    SparseMatrix<float> mat(3, 4);
+    mat.insert(0, 0) = 1.5f;
+    mat.insert(2, 1) = -2.0f;
+    mat.insert(1, 3) = 3.25f;
+    mat.makeCompressed();
+
+    QByteArray bytes;
+    FiffStream stream(&bytes, QIODevice::WriteOnly);
+    stream.write_float_sparse_ccs(FIFF_PROJ_ITEM_VECTORS, mat);
+
+    ReferenceWriter ref;
+    ref.header(FIFF_PROJ_ITEM_VECTORS, FIFFT_CCS_MATRIX_FLOAT, 4 * 3 + 4 * 3 + 4 * 5 + 4 * 4);
+    for (float value : { 1.5f, -2.0f, 3.25f }) {
+        ref.put(value);
+    }
+    for (qint32 value : { 0, 2, 1,              // row indices
+                          0, 1, 2, 2, 3,        // column pointers
+                          3, 3, 4, 2 }) {       // nnz, rows, cols, ndim
+        ref.put(value);
+    }
+
+    QCOMPARE(bytes, ref.bytes());
+}
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::testWriteSparseRcs()
+{
+    SparseMatrix<float> mat(3, 4);
+    mat.insert(0, 0) = 1.5f;
+    mat.insert(2, 1) = -2.0f;
+    mat.insert(1, 3) = 3.25f;
+    mat.makeCompressed();
+
+    QByteArray bytes;
+    FiffStream stream(&bytes, QIODevice::WriteOnly);
+    stream.write_float_sparse_rcs(FIFF_PROJ_ITEM_VECTORS, mat);
+
+    ReferenceWriter ref;
+    ref.header(FIFF_PROJ_ITEM_VECTORS, FIFFT_RCS_MATRIX_FLOAT, 4 * 3 + 4 * 3 + 4 * 4 + 4 * 4);
+    for (float value : { 1.5f, 3.25f, -2.0f }) {
+        ref.put(value);
+    }
+    for (qint32 value : { 0, 3, 1,              // column indices
+                          0, 1, 2, 3,           // row pointers
+                          3, 3, 4, 2 }) {       // nnz, rows, cols, ndim
+        ref.put(value);
+    }
+
+    QCOMPARE(bytes, ref.bytes());
+}
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::testWriteRawBuffer()
+{
+    const MatrixXd buf = MatrixXd::Random(12, 50) * 1e-11;
+    RowVectorXd cals(12);
+    for (int i = 0; i < cals.size(); ++i) {
+        cals[i] = 1e-13 * (i + 1);
+    }
+
+    QByteArray bytes;
+    FiffStream stream(&bytes, QIODevice::WriteOnly);
+    QVERIFY(stream.write_raw_buffer(buf));
+    QVERIFY(stream.write_raw_buffer(buf, cals));
+
+    const MatrixXf plain = buf.cast<float>();
+    const MatrixXf calibrated = ((1.0 / cals.array()).matrix().asDiagonal() * buf).cast<float>();
+
+    ReferenceWriter ref;
+    for (const MatrixXf* tmp : { &plain, &calibrated }) {
+        ref.header(FIFF_DATA_BUFFER, FIFFT_FLOAT, int(tmp->size()) * 4);
+        for (int i = 0; i < tmp->size(); ++i) {
+            ref.put(tmp->data()[i]);
+        }
+    }
+
+    QCOMPARE(bytes, ref.bytes());
+}
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::testStagingBufferReuse()
+{
+    // A large tag followed by smaller ones must not leak stale payload bytes
+    const VectorXf large = VectorXf::Random(4096);
+    const qint32 small[2] = { 42, -42 };
+    const qint32 empty[1] = { 0 };
+
+    QByteArray bytes;
+    FiffStream stream(&bytes, QIODevice::WriteOnly);
+    stream.write_float(FIFF_PROJ_ITEM_VECTORS, large.data(), large.size());
+    stream.write_int(FIFF_FIRST_SAMPLE, small, 2);
+    stream.write_int(FIFF_FIRST_SAMPLE, empty, 0);
+
+    ReferenceWriter ref;
+    ref.header(FIFF_PROJ_ITEM_VECTORS, FIFFT_FLOAT, large.size() * 4);
+    for (int i = 0; i < large.size(); ++i) {
+        ref.put(large[i]);
+    }
+    ref.header(FIFF_FIRST_SAMPLE, FIFFT_INT, 2 * 4);
+    ref.put(small[0]);
+    ref.put(small[1]);
+    ref.header(FIFF_FIRST_SAMPLE, FIFFT_INT, 0);
+
+    QCOMPARE(bytes, ref.bytes());
+}
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::benchmarkWriteRawBuffer_data()
+{
+    QTest::addColumn<int>("nChannels");
+    QTest::addColumn<int>("nSamples");
+
+    QTest::newRow("306 x 1000")  << 306 << 1000;
+    QTest::newRow("306 x 10000") << 306 << 10000;
+    QTest::newRow("64 x 100000") << 64  << 100000;
+}
+
+//=============================================================================================================
+
+void TestFiffBulkWrite::benchmarkWriteRawBuffer()
+{
+    QFETCH(int, nChannels);
+    QFETCH(int, nSamples);
+
+    const MatrixXd buf = MatrixXd::Random(nChannels, nSamples);
+
+    QBuffer device;
+    device.open(QIODevice::WriteOnly);
+    FiffStream stream(&device);
+
+    // Each iteration serializes one buffer; bytes per second follow from nChannels * nSamples * 4
+    QBENCHMARK {
+        device.seek(0);
+        stream.write_raw_buffer(buf);
+    }
+
+    QCOMPARE(device.size(), qint64(16) + qint64(nChannels) * nSamples * 4);
+}
+
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestFiffBulkWrite)
+#include "test_fiff_bulk_write.moc"
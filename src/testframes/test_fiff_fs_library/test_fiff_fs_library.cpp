@@ -171,6 +171,8 @@ private slots:
     void fiffStream_writeRawBuffer();
     void fiffStream_writeSparseMatrix();
     void fiffStream_writeDirEntries();
+    void fiffStream_appendDirOnClose();
+    void fiffStream_dirCache();
     void fiffStream_startEndBlocks();
     void fiffStream_writeRtCommand();
     void fiffStream_readTagInfoAndData();
@@ -1336,6 +1338,103 @@ void TestFiffFsLibrary::fiffStream_writeDirEntries()
     stream->end_file();
 }
 
+void TestFiffFsLibrary::fiffStream_appendDirOnClose()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QFile outFile(tmpDir.path() + "/with_dir.fif");
+    FiffStream::SPtr stream = FiffStream::start_file(outFile);
+    stream->start_block(FIFFB_MEAS);
+    fiff_int_t value = 42;
+    stream->write_int(FIFF_FIRST_SAMPLE, &value);
+    stream->end_block(FIFFB_MEAS);
+    stream->end_file();
+    stream->set_append_dir_on_close(true);
+    QVERIFY(stream->close());
+
+    QFile inFile(outFile.fileName());
+    FiffStream inStream(&inFile);
+    QVERIFY(inStream.open());
+
+    // The directory pointer now refers to a directory instead of FIFFV_NEXT_NONE
+    FiffTag::UPtr tag;
+    QVERIFY(inStream.read_tag(tag, inStream.dir()[1]->pos));
+    QCOMPARE(tag->kind, FIFF_DIR_POINTER);
+    QVERIFY(*tag->toInt() > 0);
+    QVERIFY(inStream.read_tag(tag, *tag->toInt()));
+    QCOMPARE(tag->kind, FIFF_DIR);
+
+    QCOMPARE(int(inStream.dirtree()->dir_tree_find(FIFFB_MEAS).size()), 1);
+    inStream.close();
+}
+
+void TestFiffFsLibrary::fiffStream_dirCache()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+    QFile outFile(tmpDir.path() + "/no_dir.fif");
+    FiffStream::SPtr stream = FiffStream::start_file(outFile);
+    stream->start_block(FIFFB_MEAS);
+    fiff_int_t value = 7;
+    stream->write_int(FIFF_FIRST_SAMPLE, &value);
+    stream->end_block(FIFFB_MEAS);
+    stream->end_file();
+    stream->close();
+
+    const QString cacheDir = tmpDir.path() + "/cache";
+    FiffStream::set_dir_cache_directory(cacheDir);
+
+    QFile firstFile(outFile.fileName());
+    FiffStream first(&firstFile);
+    QVERIFY(first.open());
+    first.close();
+    QCOMPARE(int(QDir(cacheDir).entryList(QDir::Files).size()), 1);
+
+    // Relabel the FIFF_FIRST_SAMPLE entry inside the cache file, only a cache hit can show the new kind.
+    // The entries follow magic, version, file size and count and are four 32-bit words each.
+    int iSample = -1;
+    for (int i = 0; i < first.nent(); ++i) {
+        if (first.dir()[i]->kind == FIFF_FIRST_SAMPLE)
+            iSample = i;
+    }
+    QVERIFY(iSample >= 0);
+    {
+        QFile cacheFile(QDir(cacheDir).entryInfoList(QDir::Files).first().absoluteFilePath());
+        QVERIFY(cacheFile.open(QIODevice::ReadWrite));
+        QVERIFY(cacheFile.seek(20 + 16 * iSample));
+        QDataStream out(&cacheFile);
+        out << qint32(FIFF_NCHAN);
+    }
+
+    QFile secondFile(outFile.fileName());
+    FiffStream second(&secondFile);
+    QVERIFY(second.open());
+    second.close();
+
+    QCOMPARE(second.nent(), first.nent());
+    for (int i = 0; i < first.nent(); ++i) {
+        QCOMPARE(second.dir()[i]->kind, i == iSample ? FIFF_NCHAN : first.dir()[i]->kind);
+        QCOMPARE(second.dir()[i]->pos, first.dir()[i]->pos);
+    }
+    QCOMPARE(int(second.dirtree()->dir_tree_find(FIFFB_MEAS).size()), 1);
+
+    // Without the entry the file is scanned again. A zero size limit evicts the new entry right away.
+    FiffStream::clear_dir_cache();
+    QVERIFY(QDir(cacheDir).entryList(QDir::Files).isEmpty());
+    FiffStream::set_dir_cache_size_limit(0);
+
+    QFile thirdFile(outFile.fileName());
+    FiffStream third(&thirdFile);
+    QVERIFY(third.open());
+    third.close();
+
+    FiffStream::set_dir_cache_size_limit(qint64(64) << 20);
+    FiffStream::set_dir_cache_directory(QString());
+
+    QCOMPARE(third.dir()[iSample]->kind, FIFF_FIRST_SAMPLE);
+    QVERIFY(QDir(cacheDir).entryList(QDir::Files).isEmpty());
+}
+
 void TestFiffFsLibrary::fiffStream_startEndBlocks()
 {
     QBuffer buffer;
@@ -26,6 +26,7 @@
 #include <fiff/fiff_stream.h>
 #include <fiff/fiff_tag.h>
 #include <fiff/fiff_raw_data.h>
+#include <fiff/fiff_raw_buffer_map.h>
 #include <fiff/fiff_evoked.h>
 #include <fiff/fiff_evoked_set.h>
 #include <fiff/fiff_cov.h>
@@ -738,6 +739,151 @@ private slots:
         QVERIFY(data.cols() > 0);
     }
 
+    //=========================================================================
+    // Memory-mapped buffer reads must match the FiffStream path exactly,
+    // including repeated reads of the same (already swapped) buffers.
+    //=========================================================================
+    void fiffRawData_mappedReadMatchesStream()
+    {
+        if (!hasData()) QSKIP("No test data");
+
+        QFile file(m_sDataPath + "/MEG/sample/sample_audvis_trunc_raw.fif");
+        FiffRawData raw(file);
+        QVERIFY(!raw.is_mapped());
+
+        fiff_int_t from = raw.first_samp + 100;
+        fiff_int_t to = qMin(from + 3 * (fiff_int_t)(raw.info.sfreq), raw.last_samp);
+        RowVectorXi picks = raw.info.pick_types(true, true, false);
+
+        MatrixXd refData, refPicked, times;
+        QVERIFY(raw.read_raw_segment(refData, times, from, to));
+        QVERIFY(raw.read_raw_segment(refPicked, times, from, to, picks));
+
+        QVERIFY(raw.map_file());
+        QVERIFY(raw.is_mapped());
+
+        for (int pass = 0; pass < 2; ++pass) {
+            MatrixXd data, picked;
+            QVERIFY(raw.read_raw_segment(data, times, from, to));
+            QVERIFY(raw.read_raw_segment(picked, times, from, to, picks));
+            QCOMPARE(data.rows(), refData.rows());
+            QCOMPARE(data.cols(), refData.cols());
+            QVERIFY(data == refData);
+            QVERIFY(picked == refPicked);
+        }
+
+        raw.unmap_file();
+        QVERIFY(!raw.is_mapped());
+    }
+
+    //=========================================================================
+    // A tag that is smaller than nchan x nsamp samples must be rejected
+    // instead of being swapped and read past its end.
+    //=========================================================================
+    void fiffRawData_mappedBufferRejectsShortTag()
+    {
+        if (!hasData()) QSKIP("No test data");
+
+        QFile file(m_sDataPath + "/MEG/sample/sample_audvis_trunc_raw.fif");
+        FiffRawData raw(file);
+
+        int k = 0;
+        while (k < raw.rawdir.size() && (!raw.rawdir[k].ent || raw.rawdir[k].ent->kind == -1)) {
+            ++k;
+        }
+        QVERIFY(k < raw.rawdir.size());
+
+        QList<FiffRawDir> rawdir = raw.rawdir;
+        rawdir[k].nsamp *= 2;
+
+        FiffRawBufferMap intact(raw.info.filename, raw.rawdir, raw.info.nchan);
+        FiffRawBufferMap inconsistent(raw.info.filename, rawdir, raw.info.nchan);
+        QVERIFY(intact.isValid());
+        QVERIFY(inconsistent.isValid());
+
+        FiffRawBuffer buffer;
+        QVERIFY(intact.buffer(k, buffer));
+        QVERIFY(!inconsistent.buffer(k, buffer));
+    }
+
+    //=========================================================================
+    // The read operator is cached per (proj, comp, sel) and rebuilt only
+    // when one of them changes; the fused kernel must match proj * data.
+    //=========================================================================
+    void fiffRawData_readOperatorCache()
+    {
+        if (!hasData()) QSKIP("No test data");
+
+        QFile file(m_sDataPath + "/MEG/sample/sample_audvis_trunc_raw.fif");
+        FiffRawData raw(file);
+
+        fiff_int_t from = raw.first_samp + 50;
+        fiff_int_t to = qMin(from + (fiff_int_t)(raw.info.sfreq), raw.last_samp);
+
+        MatrixXd plain, times;
+        QVERIFY(raw.read_raw_segment(plain, times, from, to));
+
+        qint64 version = raw.read_operator()->version();
+        QCOMPARE(raw.read_operator()->version(), version);
+
+        RowVectorXi picks = raw.info.pick_types(true, false, false);
+        QVERIFY(raw.read_operator(picks)->version() != version);
+        QCOMPARE(raw.read_operator()->version(), version);
+
+        raw.proj = MatrixXd::Identity(raw.info.nchan, raw.info.nchan)
+                   - 0.01 * MatrixXd::Ones(raw.info.nchan, raw.info.nchan);
+        QVERIFY(raw.read_operator()->version() != version);
+
+        MatrixXd projected;
+        SparseMatrix<double> mult;
+        QVERIFY(raw.read_raw_segment(projected, times, mult, from, to));
+        QVERIFY(projected.isApprox(raw.proj * plain, 1e-10));
+        QCOMPARE(mult.rows(), (Index)raw.info.nchan);
+
+        MatrixXd projectedPicked;
+        QVERIFY(raw.read_raw_segment(projectedPicked, times, from, to, picks));
+        for (int i = 0; i < picks.size(); ++i) {
+            QVERIFY(projectedPicked.row(i).isApprox(projected.row(picks[i]), 1e-10));
+        }
+    }
+
+    //=========================================================================
+    // Multi-threaded buffer decoding (per-worker file handles and memory
+    // map) must reproduce the serial read exactly.
+    //=========================================================================
+    void fiffRawData_parallelReadMatchesSerial()
+    {
+        if (!hasData()) QSKIP("No test data");
+
+        QFile file(m_sDataPath + "/MEG/sample/sample_audvis_trunc_raw.fif");
+        FiffRawData raw(file);
+        QCOMPARE(raw.read_threads(), 1);
+
+        fiff_int_t from = raw.first_samp + 17;
+        fiff_int_t to = raw.last_samp - 17;
+        RowVectorXi picks = raw.info.pick_types(true, true, false);
+
+        MatrixXd serial, serialPicked, times;
+        QVERIFY(raw.read_raw_segment(serial, times, from, to));
+        QVERIFY(raw.read_raw_segment(serialPicked, times, from, to, picks));
+
+        raw.set_read_threads(4);
+        QCOMPARE(raw.read_threads(), 4);
+
+        MatrixXd parallel, parallelPicked;
+        QVERIFY(raw.read_raw_segment(parallel, times, from, to));
+        QVERIFY(raw.read_raw_segment(parallelPicked, times, from, to, picks));
+        QVERIFY(parallel == serial);
+        QVERIFY(parallelPicked == serialPicked);
+
+        QVERIFY(raw.map_file());
+        QVERIFY(raw.read_raw_segment(parallel, times, from, to));
+        QVERIFY(parallel == serial);
+
+        raw.set_read_threads(0);
+        QVERIFY(raw.read_threads() >= 1);
+    }
+
     //=========================================================================
     void cleanupTestCase() {}
 };
@@ -1,4 +1,5 @@
 #include <QtTest/QtTest>
+#include <algorithm>
 #include <QTemporaryDir>
 #include <Eigen/Dense>
 
@@ -137,6 +138,71 @@ private slots:
         filter.reset();
     }
 
+    //=========================================================================
+    // FilterOverlapSave - partitioned streaming filter
+    //=========================================================================
+    void filterOverlapSave_matchesFilterData()
+    {
+        int nCh = 5, N = 3000;
+        MatrixXd data = MatrixXd::Random(nCh, N);
+        RowVectorXi picks(3);
+        picks << 0, 1, 3;
+        FilterKernel fk("LPF", 0, 128, 0.2, 0.0, 0.01, 1000.0, 0);
+
+        MatrixXd expected = filterData(data, fk, picks, false, true);
+
+        for (int iBlockSize : {1, 48, 64, 500}) {
+            for (bool bUseThreads : {false, true}) {
+                FilterOverlapSave filter(fk, nCh, iBlockSize, picks, bUseThreads);
+                QCOMPARE(filter.latency(), iBlockSize - 1);
+
+                // Feed the stream in irregular chunks
+                MatrixXd streamed(nCh, N);
+                const int chunks[] = {1, 37, 64, 200, 13, 5, 111};
+                int from = 0;
+                for (int k = 0; from < N; ++k) {
+                    int n = std::min(chunks[k % 7], N - from);
+                    filter.calculate(data.middleCols(from, n), streamed.middleCols(from, n));
+                    from += n;
+                }
+
+                int L = filter.latency();
+                double dErr = (streamed.rightCols(N - L) - expected.leftCols(N - L)).cwiseAbs().maxCoeff();
+                QVERIFY2(dErr < 1e-10, qPrintable(QString("block size %1: max error %2").arg(iBlockSize).arg(dErr)));
+
+                // After a reset the stream starts from scratch
+                filter.reset();
+                MatrixXd restarted = filter.calculate(data.leftCols(1000));
+                QVERIFY((restarted - streamed.leftCols(1000)).cwiseAbs().maxCoeff() < 1e-10);
+            }
+        }
+    }
+
+    void filterOverlapSave_benchmark_data()
+    {
+        QTest::addColumn<int>("blockSize");
+        QTest::newRow("16") << 16;
+        QTest::newRow("64") << 64;
+        QTest::newRow("256") << 256;
+        QTest::newRow("1024") << 1024;
+    }
+
+    void filterOverlapSave_benchmark()
+    {
+        QFETCH(int, blockSize);
+
+        // Per-block cost of a 400 channel stream filtered with 1024 taps
+        int nCh = 400;
+        FilterKernel fk("LPF", 0, 1024, 0.04, 0.0, 0.01, 5000.0, 0);
+        FilterOverlapSave filter(fk, nCh, blockSize);
+        MatrixXd block = MatrixXd::Random(nCh, blockSize);
+        MatrixXd out(nCh, blockSize);
+
+        QBENCHMARK {
+            filter.calculate(block, out);
+        }
+    }
+
     //=========================================================================
     // DetectTrigger
     //=========================================================================
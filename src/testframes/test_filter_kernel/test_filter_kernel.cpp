@@ -4,6 +4,7 @@
 #include <dsp/filterkernel.h>
 #include <dsp/parksmcclellan.h>
 #include <dsp/cosinefilter.h>
+#include <dsp/fft_filter_engine.h>
 
 using namespace UTILSLIB;
 using namespace Eigen;
@@ -111,6 +112,52 @@ private slots:
         QCOMPARE(data.size(), N);
     }
 
+    //=========================================================================
+    // FftFilterEngine
+    //=========================================================================
+    void fftEngineMatchesApplyFft()
+    {
+        FilterKernel fk("EngineTest", 0, 64, 0.2, 0.0, 0.01, 1000.0, 0);
+        int N = 500;
+        MatrixXd data = MatrixXd::Random(6, N);
+        RowVectorXi picks(4);
+        picks << 0, 2, 3, 5;
+
+        for(bool bGoodSize : {false, true}) {
+            FftFilterEngine engine(fk, bGoodSize);
+            QCOMPARE(engine.filterOrder(), fk.getFilterOrder());
+            QVERIFY(engine.fftLength(N) >= N + fk.getCoefficients().cols());
+
+            MatrixXd out;
+            engine.filterBlock(data, out, picks, true);
+            QCOMPARE(out.rows(), data.rows());
+            QCOMPARE(out.cols(), N + fk.getFilterOrder());
+
+            for(int i = 0; i < picks.cols(); ++i) {
+                FilterKernel fkRow = fk;
+                RowVectorXd row = data.row(picks[i]);
+                fkRow.applyFftFilter(row, true);
+                QVERIFY((out.row(picks[i]) - row).cwiseAbs().maxCoeff() < 1e-10);
+            }
+
+            // Unpicked rows are only delayed
+            QVERIFY(out.row(1).segment(fk.getFilterOrder()/2, N).isApprox(data.row(1)));
+
+            // A second call reuses the buffers and yields the same result
+            MatrixXd out2 = out;
+            engine.filterBlock(data, out, picks, false);
+            QVERIFY((out - out2).cwiseAbs().maxCoeff() < 1e-12);
+        }
+    }
+
+    void fftEngineGoodSize()
+    {
+        QCOMPARE(FftFilterEngine::nextPow2(1025), 2048);
+        QCOMPARE(FftFilterEngine::nextGoodSize(1025), 1080);
+        QCOMPARE(FftFilterEngine::nextGoodSize(4097), 4320);
+        QVERIFY(FftFilterEngine::nextGoodSize(7) % 2 == 0);
+    }
+
     void designMethods()
     {
         FilterKernel fkCosine("Cosine", 0, 64, 0.2, 0.0, 0.01, 1000.0, 0);
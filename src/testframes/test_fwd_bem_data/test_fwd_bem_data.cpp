@@ -18,6 +18,7 @@
 #include <QtTest/QtTest>
 #include <QFile>
 #include <QDir>
+#include <QTemporaryDir>
 #include <Eigen/Dense>
 
 #include <utils/generics/mne_logger.h>
@@ -150,6 +151,50 @@ private slots:
         QVERIFY(result == 0 || result == 1);  // 0=ok, 1=recomputed
     }
 
+    //=========================================================================
+    // FwdBemModel: content-addressed solution cache
+    //=========================================================================
+    void bemModel_solutionCache()
+    {
+        if (!hasData()) QSKIP("No test data");
+
+        QString bemPath = m_sDataPath + "/subjects/sample/bem/sample-5120-bem.fif";
+        if (!QFile::exists(bemPath)) QSKIP("BEM file not found");
+
+        QTemporaryDir cacheDir;
+        QVERIFY(cacheDir.isValid());
+        QString missingSol = cacheDir.filePath("missing-bem-sol.fif");
+
+        // First run: nothing in the file, nothing cached -> compute and store
+        auto model = FwdBemModel::fwd_bem_load_homog_surface(bemPath);
+        QVERIFY(model != nullptr);
+        model->solution_cache_dir = cacheDir.path();
+        QString cacheName = model->fwd_bem_cached_solution_name(FWD_BEM_LINEAR_COLL);
+        QVERIFY(!cacheName.isEmpty());
+        QVERIFY(!QFile::exists(cacheName));
+
+        QCOMPARE(model->fwd_bem_load_recompute_solution(missingSol, FWD_BEM_LINEAR_COLL, 0), 0);
+        QVERIFY(QFile::exists(cacheName));
+        QVERIFY(model->solution.rows() == model->nsol);
+
+        // Second run: same geometry and conductivity -> served from the cache
+        auto cached = FwdBemModel::fwd_bem_load_homog_surface(bemPath);
+        QVERIFY(cached != nullptr);
+        cached->solution_cache_dir = cacheDir.path();
+        QCOMPARE(cached->fwd_bem_solution_key(FWD_BEM_LINEAR_COLL), model->fwd_bem_solution_key(FWD_BEM_LINEAR_COLL));
+        QCOMPARE(cached->fwd_bem_load_recompute_solution(missingSol, FWD_BEM_LINEAR_COLL, 0), 0);
+        QCOMPARE(cached->sol_name, cacheName);
+        QCOMPARE(cached->bem_method, FWD_BEM_LINEAR_COLL);
+        QVERIFY(cached->solution == model->solution);
+
+        // Anything the solution depends on changes the key
+        cached->sigma[0] *= 2.0f;
+        QVERIFY(cached->fwd_bem_solution_key(FWD_BEM_LINEAR_COLL) != model->fwd_bem_solution_key(FWD_BEM_LINEAR_COLL));
+        QVERIFY(model->fwd_bem_solution_key(FWD_BEM_CONSTANT_COLL) != model->fwd_bem_solution_key(FWD_BEM_LINEAR_COLL));
+        cached->solve_in_double = true;
+        QVERIFY(cached->fwd_bem_cached_solution_name(FWD_BEM_LINEAR_COLL) != cacheName);
+    }
+
     //=========================================================================
     // Forward solution: read and verify structure
     //=========================================================================
@@ -100,6 +100,9 @@ private slots:
     void testFit_advanced_gof();  // compare gof to specified value
     void testFit_basic_error();  // compare error to specified value
     void testFit_advanced_error();  // compare error to specified value
+    void testFit_levenbergMarquardt();  // compare gof and error of the Levenberg-Marquardt fit to specified values
+    void benchmarkFit_data();
+    void benchmarkFit();  // iterations and time per fit of the simplex and Levenberg-Marquardt fits
     void testCheckForUpdate();
     void testFindOrder();  // test with all possible frequency oders
     void cleanupTestCase();  // clean-up at the end
@@ -433,6 +436,99 @@ void TestHpiFit::testFit_advanced_error()
 
 //=============================================================================================================
 
+void TestHpiFit::testFit_levenbergMarquardt()
+{
+    /// prepare
+    int iSampleFreq = m_pFiffInfo->sfreq;
+    int iLineFreq = m_pFiffInfo->linefreq;
+    QVector<int> vecHpiFreqs = {166, 154, 161, 158};
+    bool bBasic = false;
+    InvHpiModelParameters hpiModelParameters(vecHpiFreqs,
+                                          iSampleFreq,
+                                          iLineFreq,
+                                          bBasic);
+
+    InvHpiDataUpdater hpiDataUpdater = InvHpiDataUpdater(m_pFiffInfo);
+    InvHpiFit HPI = InvHpiFit(hpiDataUpdater.getSensors());
+    HPI.setCoilFitMethod(CoilFitMethod::LevenbergMarquardt);
+    hpiDataUpdater.prepareDataAndProjectors(m_matData,m_matProjectors);
+    const auto& matProjectedData = hpiDataUpdater.getProjectedData();
+    const auto& matPreparedProjectors = hpiDataUpdater.getProjectors();
+    const auto& matCoilsHead = hpiDataUpdater.getHpiDigitizer();
+
+    HpiFitResult hpiFitResult;
+
+    HPI.fit(matProjectedData,
+            matPreparedProjectors,
+            hpiModelParameters,
+            matCoilsHead,
+            hpiFitResult);
+
+    QVector<double> vecError = hpiFitResult.errorDistances;
+
+    /// assert
+    double meanGoF = hpiFitResult.GoF.mean();
+    QVERIFY(meanGoF > dGofTol);
+
+    double dLocalizationErrorMean = 1000.0 * std::accumulate(vecError.begin(), vecError.end(), .0) / vecError.size();
+    QVERIFY(dLocalizationErrorMean < dLocalizationErrorTol);
+
+    QVERIFY(hpiFitResult.vecNumIterations.size() == vecHpiFreqs.size());
+    QVERIFY(hpiFitResult.iNumJointIterations > 0);
+}
+
+//=============================================================================================================
+
+void TestHpiFit::benchmarkFit_data()
+{
+    QTest::addColumn<int>("iMethod");
+    QTest::addColumn<bool>("bWarmStart");
+
+    QTest::newRow("simplex") << static_cast<int>(CoilFitMethod::Simplex) << false;
+    QTest::newRow("simplex warm") << static_cast<int>(CoilFitMethod::Simplex) << true;
+    QTest::newRow("lm") << static_cast<int>(CoilFitMethod::LevenbergMarquardt) << false;
+    QTest::newRow("lm warm") << static_cast<int>(CoilFitMethod::LevenbergMarquardt) << true;
+}
+
+//=============================================================================================================
+
+void TestHpiFit::benchmarkFit()
+{
+    QFETCH(int, iMethod);
+    QFETCH(bool, bWarmStart);
+
+    /// prepare
+    int iSampleFreq = m_pFiffInfo->sfreq;
+    int iLineFreq = m_pFiffInfo->linefreq;
+    QVector<int> vecHpiFreqs = {166, 154, 161, 158};
+    InvHpiModelParameters hpiModelParameters(vecHpiFreqs,
+                                          iSampleFreq,
+                                          iLineFreq,
+                                          false);
+
+    InvHpiDataUpdater hpiDataUpdater = InvHpiDataUpdater(m_pFiffInfo);
+    InvHpiFit HPI = InvHpiFit(hpiDataUpdater.getSensors());
+    HPI.setCoilFitMethod(static_cast<CoilFitMethod>(iMethod));
+    hpiDataUpdater.prepareDataAndProjectors(m_matData,m_matProjectors);
+    const auto& matProjectedData = hpiDataUpdater.getProjectedData();
+    const auto& matPreparedProjectors = hpiDataUpdater.getProjectors();
+    const auto& matCoilsHead = hpiDataUpdater.getHpiDigitizer();
+
+    // A warm fit starts from the transformation of the previous block
+    HpiFitResult hpiFitResult;
+    if(bWarmStart) {
+        HPI.fit(matProjectedData,matPreparedProjectors,hpiModelParameters,matCoilsHead,hpiFitResult);
+    }
+
+    /// act
+    QBENCHMARK {
+        HpiFitResult hpiFitResultRun = hpiFitResult;
+        HPI.fit(matProjectedData,matPreparedProjectors,hpiModelParameters,matCoilsHead,hpiFitResultRun);
+    }
+}
+
+//=============================================================================================================
+
 void TestHpiFit::testCheckForUpdate()
 {
     /// prepare
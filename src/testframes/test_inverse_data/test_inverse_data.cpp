@@ -36,6 +36,7 @@
 #include <inv/inv_source_estimate.h>
 #include <mne/mne_source_spaces.h>
 #include <mne/mne_forward_solution.h>
+#include <fs/fs_label.h>
 
 #include <inv/minimum_norm/inv_minimum_norm.h>
 #include <inv/rap_music/inv_rap_music.h>
@@ -384,6 +385,50 @@ private slots:
         QVERIFY(prepared.noisenorm.nonZeros() > 0);
     }
 
+    //=========================================================================
+    // Fast SVD backends reproduce the Jacobi kernel and noise normalisation
+    //=========================================================================
+    void inverseOp_svdMethodsMatchJacobi()
+    {
+        if (!m_bDataLoaded) QSKIP("Required data not loaded");
+        if (m_invOp.nchan == 0) QSKIP("Failed to build inverse operator");
+
+        const float lambda2 = 1.0f / 9.0f;
+
+        MNEInverseOperator reference = m_invOp.prepare_inverse_operator(1, lambda2, true, false);
+        MatrixXd K_ref;
+        SparseMatrix<double> noise_norm_ref;
+        QList<VectorXi> vertno;
+        QVERIFY(reference.assemble_kernel(FSLIB::FsLabel(), "dSPM", false, K_ref, noise_norm_ref, vertno));
+
+        for (MNEInverseOperator::SvdMethod svdMethod : {MNEInverseOperator::SvdBdc, MNEInverseOperator::SvdGram}) {
+            MNEInverseOperator invOp = MNEInverseOperator::make_inverse_operator(
+                m_info, m_fwd, m_noiseCov, 0.2f, 0.8f, false, true, svdMethod);
+            QCOMPARE(invOp.nchan, m_invOp.nchan);
+            QCOMPARE(invOp.sing.size(), m_invOp.sing.size());
+
+            // Singular values relative to the largest one
+            double dSingErr = (invOp.sing - m_invOp.sing).cwiseAbs().maxCoeff() / m_invOp.sing.maxCoeff();
+            QVERIFY2(dSingErr < 1e-8, qPrintable(QString("singular values: %1").arg(dSingErr)));
+
+            MNEInverseOperator prepared = invOp.prepare_inverse_operator(1, lambda2, true, false);
+            MatrixXd K;
+            SparseMatrix<double> noise_norm;
+            QVERIFY(prepared.assemble_kernel(FSLIB::FsLabel(), "dSPM", false, K, noise_norm, vertno));
+
+            // The kernel does not depend on the signs of the singular vectors
+            QCOMPARE(K.rows(), K_ref.rows());
+            QCOMPARE(K.cols(), K_ref.cols());
+            double dKernelErr = (K - K_ref).norm() / K_ref.norm();
+            QVERIFY2(dKernelErr < 1e-6, qPrintable(QString("kernel: %1").arg(dKernelErr)));
+
+            VectorXd vecNorm = noise_norm.diagonal();
+            VectorXd vecNormRef = noise_norm_ref.diagonal();
+            double dNormErr = ((vecNorm - vecNormRef).array() / vecNormRef.array()).abs().maxCoeff();
+            QVERIFY2(dNormErr < 1e-6, qPrintable(QString("noise normalisation: %1").arg(dNormErr)));
+        }
+    }
+
     //=========================================================================
     // Prepare inverse operator for sLORETA
     //=========================================================================
@@ -137,6 +137,10 @@ private slots:
     void testOutletInletMultiChannel();
     void testOutletInletLargeChunk();
     void testOutletMultipleInlets();
+    void testOutletInletPullMultiplexed();
+    void testOutletInletRingGrowthTimestamps();
+    void benchmarkOutletInlet_data();
+    void benchmarkOutletInlet();
 
     //=========================================================================================================
     // Discovery tests
@@ -743,6 +747,204 @@ void TestLsl::testOutletMultipleInlets()
     inlet2.close_stream();
 }
 
+//=============================================================================================================
+
+void TestLsl::testOutletInletPullMultiplexed()
+{
+    const int nChannels = 8;
+    const int nSamples = 1000;
+
+    stream_info outInfo("E2E_Multiplexed", "EEG", nChannels, 1000.0);
+    stream_outlet outlet(outInfo);
+
+    QThread::msleep(200);
+
+    stream_info resolvedInfo = outlet.info();
+    resolvedInfo.set_data_host("127.0.0.1");
+    stream_inlet inlet(resolvedInfo);
+    inlet.open_stream();
+    QCOMPARE(inlet.channel_count(), nChannels);
+
+    // Buffers that do not match the channel count are rejected
+    std::vector<float> data(static_cast<size_t>(nSamples) * nChannels);
+    std::vector<double> timestamps(nSamples);
+    bool threw = false;
+    try {
+        inlet.pull_chunk_multiplexed(data.data(), nullptr, nChannels + 1, 0);
+    } catch (const std::runtime_error&) {
+        threw = true;
+    }
+    QVERIFY(threw);
+
+    std::vector<std::vector<float>> chunk(nSamples, std::vector<float>(nChannels));
+    for (int s = 0; s < nSamples; ++s) {
+        for (int ch = 0; ch < nChannels; ++ch) {
+            chunk[s][ch] = static_cast<float>(s * nChannels + ch);
+        }
+    }
+
+    const double tPush = local_clock();
+    outlet.push_chunk(chunk);
+
+    // Pull in pieces of at most 96 samples, so that the reads wrap around sample boundaries
+    size_t nReceived = 0;
+    for (int attempt = 0; attempt < 100 && nReceived < static_cast<size_t>(nSamples); ++attempt) {
+        const size_t nFree = std::min<size_t>(96, nSamples - nReceived);
+        const size_t nElements = inlet.pull_chunk_multiplexed(data.data() + nReceived * nChannels,
+                                                              timestamps.data() + nReceived,
+                                                              nFree * nChannels,
+                                                              nFree,
+                                                              0.1);
+        QCOMPARE(nElements % nChannels, static_cast<size_t>(0));
+        nReceived += nElements / nChannels;
+    }
+    QCOMPARE(nReceived, static_cast<size_t>(nSamples));
+
+    // Channel-interleaved, in order, and stamped with non-decreasing receive times
+    for (size_t i = 0; i < data.size(); ++i) {
+        QCOMPARE(data[i], static_cast<float>(i));
+    }
+    QVERIFY(timestamps.front() >= tPush);
+    QVERIFY(std::is_sorted(timestamps.begin(), timestamps.end()));
+    QVERIFY(timestamps.back() <= local_clock());
+
+    inlet.close_stream();
+}
+
+//=============================================================================================================
+
+void TestLsl::testOutletInletRingGrowthTimestamps()
+{
+    const int nChannels = 64;
+    const int nEarly = 200;
+    const int nLate = 1000;
+    const int nSamples = nEarly + nLate;
+
+    stream_info outInfo("E2E_RingGrowth", "EEG", nChannels, 1000.0);
+    stream_outlet outlet(outInfo);
+
+    QThread::msleep(200);
+
+    stream_info resolvedInfo = outlet.info();
+    resolvedInfo.set_data_host("127.0.0.1");
+    stream_inlet inlet(resolvedInfo);
+    inlet.open_stream();
+
+    std::vector<std::vector<float>> chunk(nSamples, std::vector<float>(nChannels));
+    for (int s = 0; s < nSamples; ++s) {
+        for (int ch = 0; ch < nChannels; ++ch) {
+            chunk[s][ch] = static_cast<float>(s * nChannels + ch);
+        }
+    }
+
+    std::vector<float> data(static_cast<size_t>(nSamples) * nChannels);
+    std::vector<double> timestamps(nSamples);
+    size_t nReceived = 0;
+    auto pull = [&](size_t nMax) {
+        const size_t nFree = std::min<size_t>(nMax, nSamples - nReceived);
+        nReceived += inlet.pull_chunk_multiplexed(data.data() + nReceived * nChannels,
+                                                  timestamps.data() + nReceived,
+                                                  nFree * nChannels,
+                                                  nFree,
+                                                  0.1) / nChannels;
+    };
+
+    // Two early reads of 100 samples (50 KiB) stay in the initial 64 KiB ring, mostly unconsumed
+    outlet.push_chunk(std::vector<std::vector<float>>(chunk.begin(), chunk.begin() + nEarly / 2));
+    QThread::msleep(50);
+    pull(10);
+    outlet.push_chunk(std::vector<std::vector<float>>(chunk.begin() + nEarly / 2, chunk.begin() + nEarly));
+    QThread::msleep(50);
+    pull(10);
+    for (int attempt = 0; attempt < 10 && nReceived < 20; ++attempt) {
+        pull(20 - nReceived);
+    }
+    QCOMPARE(nReceived, static_cast<size_t>(20));
+
+    // The late samples (250 KiB) grow the ring while the arrivals of the early reads are still pending
+    const double tPushLate = local_clock();
+    outlet.push_chunk(std::vector<std::vector<float>>(chunk.begin() + nEarly, chunk.end()));
+    for (int attempt = 0; attempt < 100 && nReceived < static_cast<size_t>(nSamples); ++attempt) {
+        pull(300);
+    }
+    QCOMPARE(nReceived, static_cast<size_t>(nSamples));
+
+    for (size_t i = 0; i < data.size(); ++i) {
+        QCOMPARE(data[i], static_cast<float>(i));
+    }
+    for (int s = 0; s < nSamples; ++s) {
+        if (s < nEarly) {
+            QVERIFY(timestamps[s] < tPushLate);
+        } else {
+            QVERIFY(timestamps[s] >= tPushLate);
+        }
+    }
+    QVERIFY(std::is_sorted(timestamps.begin(), timestamps.end()));
+
+    inlet.close_stream();
+}
+
+//=============================================================================================================
+
+void TestLsl::benchmarkOutletInlet_data()
+{
+    QTest::addColumn<int>("nChannels");
+    QTest::addColumn<int>("nSamples");
+    QTest::addColumn<bool>("bMultiplexed");
+
+    QTest::newRow("vector 64ch x 32") << 64 << 32 << false;
+    QTest::newRow("multiplexed 64ch x 32") << 64 << 32 << true;
+    QTest::newRow("vector 306ch x 200") << 306 << 200 << false;
+    QTest::newRow("multiplexed 306ch x 200") << 306 << 200 << true;
+}
+
+//=============================================================================================================
+
+void TestLsl::benchmarkOutletInlet()
+{
+    QFETCH(int, nChannels);
+    QFETCH(int, nSamples);
+    QFETCH(bool, bMultiplexed);
+
+    stream_info outInfo("E2E_Benchmark", "EEG", nChannels, 1000.0);
+    stream_outlet outlet(outInfo);
+
+    QThread::msleep(200);
+
+    stream_info resolvedInfo = outlet.info();
+    resolvedInfo.set_data_host("127.0.0.1");
+    stream_inlet inlet(resolvedInfo);
+    inlet.open_stream();
+
+    std::vector<std::vector<float>> chunk(nSamples, std::vector<float>(nChannels, 1.0f));
+    std::vector<float> data(static_cast<size_t>(nSamples) * nChannels);
+    std::vector<double> timestamps(nSamples);
+
+    // Each iteration is the latency of one chunk from push to pull; samples per second follow from it
+    QBENCHMARK {
+        outlet.push_chunk(chunk);
+
+        int nReceived = 0;
+        for (int attempt = 0; attempt < 1000 && nReceived < nSamples; ++attempt) {
+            if (bMultiplexed) {
+                nReceived += static_cast<int>(inlet.pull_chunk_multiplexed(data.data() + static_cast<size_t>(nReceived) * nChannels,
+                                                                           timestamps.data() + nReceived,
+                                                                           static_cast<size_t>(nSamples - nReceived) * nChannels,
+                                                                           nSamples - nReceived,
+                                                                           0.01) / nChannels);
+            } else {
+                nReceived += static_cast<int>(inlet.pull_chunk_float().size());
+                if (nReceived < nSamples) {
+                    QThread::usleep(100);
+                }
+            }
+        }
+        QCOMPARE(nReceived, nSamples);
+    }
+
+    inlet.close_stream();
+}
+
 //=============================================================================================================
 // Discovery tests
 //=============================================================================================================
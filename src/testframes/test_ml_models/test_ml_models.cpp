@@ -43,6 +43,7 @@ private slots:
     void testOnnxModelConstruction();
     void testOnnxModelNotLoaded();
     void testOnnxModelLoadNonexistent();
+    void testOnnxModelBatchNotLoaded();
 };
 
 //=============================================================================================================
@@ -76,5 +77,25 @@ void TestMlModels::testOnnxModelLoadNonexistent()
 
 //=============================================================================================================
 
+void TestMlModels::testOnnxModelBatchNotLoaded()
+{
+    MlOnnxModel model;
+    model.setThreadCount(2, 2);
+    QVERIFY(!model.isLoaded());
+
+    std::vector<MlTensor> inputs;
+    for (int i = 0; i < 4; ++i) {
+        inputs.emplace_back(MatrixXf::Random(1, 10));
+    }
+    std::vector<float> outputBuffer(8);
+    MlTensor output = MlTensor::view(outputBuffer.data(), {4, 2});
+
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, static_cast<void>(model.predictBatch(inputs)));
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, model.predictBatch(inputs, output));
+    QVERIFY_THROWS_EXCEPTION(std::runtime_error, model.predictInto(inputs.front(), output));
+}
+
+//=============================================================================================================
+
 QTEST_GUILESS_MAIN(TestMlModels)
 #include "test_ml_models.moc"
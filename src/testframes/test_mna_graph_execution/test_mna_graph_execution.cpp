@@ -44,12 +44,15 @@
 #include <mna/mna_port.h>
 #include <mna/mna_types.h>
 
+#include <stdexcept>
+
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
 #include <QtTest>
 #include <QObject>
+#include <QTemporaryDir>
 #include <QVariant>
 #include <QVariantMap>
 
@@ -170,6 +173,11 @@ private slots:
     void testExecuteLinearGraph();
     void testExecuteIncrementalCleanSkip();
     void testProgressCallback();
+    void testExecuteParallelWideGraph();
+    void testResultCacheSkipsUnchanged();
+    void testResultCachePersistent();
+    void testExecuteThrowingOp();
+    void testResultCacheMemoryLimit();
 
     void cleanupTestCase();
 
@@ -259,6 +267,30 @@ void TestMnaGraphExecution::registerTestOps()
         });
     }
 
+    // "test_throw" — fails on every input
+    if (!reg.hasOp("test_throw")) {
+        MnaOpSchema throwSchema;
+        throwSchema.opType  = "test_throw";
+        throwSchema.description = "Throw on execution";
+
+        MnaOpSchemaPort inPort;
+        inPort.name     = "in";
+        inPort.dataKind = MnaDataKind::Matrix;
+        inPort.required = true;
+        throwSchema.inputPorts.append(inPort);
+
+        MnaOpSchemaPort outPort;
+        outPort.name     = "out";
+        outPort.dataKind = MnaDataKind::Matrix;
+        throwSchema.outputPorts.append(outPort);
+
+        reg.registerOp(throwSchema);
+        reg.registerOpFunc("test_throw", [](const QVariantMap& /*inputs*/,
+                                             const QVariantMap& /*attrs*/) -> QVariantMap {
+            throw std::runtime_error("test_throw");
+        });
+    }
+
     // "test_sink" — consumes input, produces nothing
     if (!reg.hasOp("test_sink")) {
         MnaOpSchema sinkSchema;
@@ -618,7 +650,8 @@ void TestMnaGraphExecution::testProgressCallback()
 
     QStringList visited;
     MnaGraphExecutor::setProgressCallback(
-        [&visited](const QString& nodeId, int /*current*/, int /*total*/) {
+        [&visited](const QString& nodeId, int /*current*/, int /*total*/,
+                   const MnaGraphExecutor::NodeTiming& /*timing*/) {
             visited.append(nodeId);
         });
 
@@ -635,6 +668,208 @@ void TestMnaGraphExecution::testProgressCallback()
 
 //=============================================================================================================
 
+void TestMnaGraphExecution::testExecuteParallelWideGraph()
+{
+    // One source fanning out into 8 independent double → add_one branches
+    MnaGraph graph;
+
+    MnaNode src = makeSourceNode("src", "test_source");
+    src.attributes["value"] = 2.0;
+    graph.addNode(src);
+
+    for (int b = 0; b < 8; ++b) {
+        const QString dbl = QString("dbl%1").arg(b);
+        const QString add = QString("add%1").arg(b);
+        graph.addNode(makeNode(dbl, "test_double"));
+        graph.addNode(makeNode(add, "test_add_one"));
+        graph.connect("src", "out", dbl, "in");
+        graph.connect(dbl, "out", add, "in");
+    }
+
+    // Called from the worker threads, one at a time
+    QStringList finished;
+    QList<int> counts;
+    QList<int> totals;
+    MnaGraphExecutor::setProgressCallback(
+        [&](const QString& nodeId, int current, int total, const MnaGraphExecutor::NodeTiming& /*timing*/) {
+            finished.append(nodeId);
+            counts.append(current);
+            totals.append(total);
+        });
+
+    MnaGraphExecutor::ExecOptions options;
+    options.maxThreads = 4;
+    MnaGraphExecutor::Context ctx = MnaGraphExecutor::execute(graph, {}, options);
+
+    MnaGraphExecutor::setProgressCallback(nullptr);
+
+    QCOMPARE(finished.size(), 17);
+    QCOMPARE(counts.last(), 17);
+    QCOMPARE(totals.count(17), 17);
+    QCOMPARE(ctx.timings.size(), 17);
+
+    for (int b = 0; b < 8; ++b) {
+        const QString dbl = QString("dbl%1").arg(b);
+        const QString add = QString("add%1").arg(b);
+        QCOMPARE(ctx.results.value(add + "::out").toDouble(), 5.0);
+        QVERIFY(finished.indexOf("src") < finished.indexOf(dbl));
+        QVERIFY(finished.indexOf(dbl) < finished.indexOf(add));
+    }
+
+    for (const MnaNode& n : graph.nodes()) {
+        QVERIFY(!n.dirty);
+    }
+}
+
+//=============================================================================================================
+
+void TestMnaGraphExecution::testResultCacheSkipsUnchanged()
+{
+    // Two branches: a(value=1) → dbl_a, b(value=5) → dbl_b
+    MnaGraph graph;
+
+    MnaNode a = makeSourceNode("a", "test_source");
+    a.attributes["value"] = 1.0;
+    graph.addNode(a);
+    MnaNode b = makeSourceNode("b", "test_source");
+    b.attributes["value"] = 5.0;
+    graph.addNode(b);
+    graph.addNode(makeNode("dbl_a", "test_double"));
+    graph.addNode(makeNode("dbl_b", "test_double"));
+    graph.connect("a", "out", "dbl_a", "in");
+    graph.connect("b", "out", "dbl_b", "in");
+
+    MnaResultCache cache;
+    MnaGraphExecutor::ExecOptions options;
+    options.maxThreads = 2;
+    options.cache = &cache;
+
+    MnaGraphExecutor::Context ctx = MnaGraphExecutor::execute(graph, {}, options);
+    QCOMPARE(ctx.results.value("dbl_b::out").toDouble(), 10.0);
+    QCOMPARE(cache.hits(), 0);
+    QCOMPARE(cache.misses(), 4);
+
+    // A rerun of the unchanged graph is served from the cache
+    ctx = MnaGraphExecutor::execute(graph, {}, options);
+    QCOMPARE(cache.hits(), 4);
+    QVERIFY(ctx.timings.value("dbl_a").cacheHit);
+    QCOMPARE(ctx.results.value("dbl_a::out").toDouble(), 2.0);
+
+    // Changing one source only re-runs its branch
+    graph.node("a").attributes["value"] = 3.0;
+    graph.node("a").dirty = true;
+    ctx = MnaGraphExecutor::executeIncremental(graph, ctx, options);
+    QCOMPARE(ctx.results.value("dbl_a::out").toDouble(), 6.0);
+    QCOMPARE(ctx.results.value("dbl_b::out").toDouble(), 10.0);
+    QVERIFY(!ctx.timings.value("a").cacheHit);
+    QVERIFY(!ctx.timings.value("dbl_a").cacheHit);
+    QCOMPARE(cache.hits(), 4);
+    QCOMPARE(cache.misses(), 6);
+
+    // Going back to the old value hits the entries of the first run again
+    graph.node("a").attributes["value"] = 1.0;
+    ctx = MnaGraphExecutor::execute(graph, {}, options);
+    QCOMPARE(ctx.results.value("dbl_a::out").toDouble(), 2.0);
+    QCOMPARE(cache.hits(), 8);
+}
+
+//=============================================================================================================
+
+void TestMnaGraphExecution::testResultCachePersistent()
+{
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    MnaGraph graph;
+    MnaNode src = makeSourceNode("src", "test_source");
+    src.attributes["value"] = 4.0;
+    graph.addNode(src);
+    graph.addNode(makeNode("dbl", "test_double"));
+    graph.connect("src", "out", "dbl", "in");
+
+    MnaGraphExecutor::ExecOptions options;
+    {
+        MnaResultCache cache(dir.path());
+        options.cache = &cache;
+        MnaGraphExecutor::execute(graph, {}, options);
+        QCOMPARE(cache.misses(), 2);
+    }
+
+    // A fresh cache on the same directory, as in a new process, finds both results on disk
+    MnaResultCache cache(dir.path());
+    options.cache = &cache;
+    MnaGraphExecutor::Context ctx = MnaGraphExecutor::execute(graph, {}, options);
+    QCOMPARE(cache.hits(), 2);
+    QCOMPARE(cache.misses(), 0);
+    QCOMPARE(ctx.results.value("dbl::out").toDouble(), 8.0);
+
+    cache.clear();
+    QVERIFY(QDir(dir.path()).entryList(QDir::Files).isEmpty());
+}
+
+//=============================================================================================================
+
+void TestMnaGraphExecution::testExecuteThrowingOp()
+{
+    // src → fail → dbl, the node behind the failing one must not run
+    MnaGraph graph;
+    graph.addNode(makeSourceNode("src", "test_source"));
+    graph.addNode(makeNode("fail", "test_throw"));
+    graph.addNode(makeNode("dbl", "test_double"));
+    graph.connect("src", "out", "fail", "in");
+    graph.connect("fail", "out", "dbl", "in");
+
+    for (int threads : {1, 4}) {
+        for (MnaNode& n : graph.nodes()) {
+            n.dirty = true;
+        }
+
+        MnaGraphExecutor::ExecOptions options;
+        options.maxThreads = threads;
+        QVERIFY_EXCEPTION_THROWN(MnaGraphExecutor::execute(graph, {}, options), std::runtime_error);
+
+        QVERIFY(!graph.node("src").dirty);
+        QVERIFY(graph.node("fail").dirty);
+        QVERIFY(graph.node("dbl").dirty);
+    }
+}
+
+//=============================================================================================================
+
+void TestMnaGraphExecution::testResultCacheMemoryLimit()
+{
+    const QByteArray keyA(32, 'a');
+    const QByteArray keyB(32, 'b');
+    const QByteArray keyC(32, 'c');
+    QVariantMap outputs;
+
+    // Memory only: the least recently used entry is gone
+    MnaResultCache cache;
+    QCOMPARE(cache.maxMemoryEntries(), MnaResultCache::DefaultMaxMemoryEntries);
+    cache.setMaxMemoryEntries(2);
+    cache.insert(keyA, {{"out", 1.0}});
+    cache.insert(keyB, {{"out", 2.0}});
+    QVERIFY(cache.lookup(keyA, outputs));
+    cache.insert(keyC, {{"out", 3.0}});
+
+    QVERIFY(!cache.lookup(keyB, outputs));
+    QVERIFY(cache.lookup(keyA, outputs));
+    QVERIFY(cache.lookup(keyC, outputs));
+    QCOMPARE(outputs.value("out").toDouble(), 3.0);
+
+    // With a directory nothing is kept in memory, the entries come back from disk
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    MnaResultCache diskCache(dir.path());
+    diskCache.setMaxMemoryEntries(0);
+    diskCache.insert(keyA, {{"out", 1.0}});
+    QVERIFY(diskCache.lookup(keyA, outputs));
+    QCOMPARE(outputs.value("out").toDouble(), 1.0);
+}
+
+//=============================================================================================================
+
 void TestMnaGraphExecution::cleanupTestCase()
 {
 }
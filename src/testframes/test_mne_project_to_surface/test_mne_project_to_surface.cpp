@@ -79,6 +79,7 @@ public:
 private slots:
     void initTestCase();
     void compareValue();
+    void compareSignedDistance();
     void cleanupTestCase();
 
 private:
@@ -86,6 +87,8 @@ private:
     double dEpsilon;
     MatrixXf matResult;
     MatrixXd matRef;
+    MNEBemSurface::SPtr m_pBemSurface;
+    MNEProjectToSurface::SPtr m_pSurfacePoints;
 
 };
 
@@ -106,6 +109,8 @@ void TestMNEProjectToSurface::initTestCase()
     MNEBem bemHead(t_fileBem);
     MNEBemSurface::SPtr bemSurface = MNEBemSurface::SPtr::create(bemHead[0]);
     MNEProjectToSurface::SPtr mneSurfacePoints = MNEProjectToSurface::SPtr::create(*bemSurface);
+    m_pBemSurface = bemSurface;
+    m_pSurfacePoints = mneSurfacePoints;
 
     VectorXi vecNearest;    // Triangle of the new point
     VectorXf vecDist;       // The Distance between matX and matP
@@ -131,6 +136,31 @@ void TestMNEProjectToSurface::compareValue()
 
 //=============================================================================================================
 
+void TestMNEProjectToSurface::compareSignedDistance()
+{
+    // Move the vertices 3 mm out of and into the surface along their normals
+    const float fShift = 0.003f;
+    const MatrixXf matVert = m_pBemSurface->rr.cast<float>();
+    const MatrixXf matNormals = m_pBemSurface->nn.cast<float>();
+    const int iNP = matVert.rows();
+
+    MatrixXf matPoints(2 * iNP, 3);
+    matPoints.topRows(iNP) = matVert + fShift * matNormals;
+    matPoints.bottomRows(iNP) = matVert - fShift * matNormals;
+
+    VectorXf vecDist;
+    VectorXi vecNearest;
+    QVERIFY(m_pSurfacePoints->signed_distance_to_surface(matPoints, vecDist, vecNearest));
+
+    for(int k = 0; k < iNP; ++k) {
+        // The surface is at most as far as the vertex the point started from
+        QVERIFY(vecDist(k) > 0.0f && vecDist(k) <= fShift + dEpsilon);
+        QVERIFY(vecDist(iNP + k) < 0.0f && vecDist(iNP + k) >= -fShift - dEpsilon);
+    }
+}
+
+//=============================================================================================================
+
 void TestMNEProjectToSurface::cleanupTestCase()
 {
 }
@@ -42,6 +42,7 @@
 // INCLUDES
 //=============================================================================================================
 
+#include <mri/mri_inflate_stream.h>
 #include <mri/mri_nifti_io.h>
 #include <mri/mri_types.h>
 #include <mri/mri_vol_data.h>
@@ -54,6 +55,7 @@
 
 #include <QByteArray>
 #include <QFile>
+#include <QThread>
 #include <QtEndian>
 #include <QtTest>
 
@@ -173,6 +175,9 @@ class TestMriNiftiIo : public QObject
 private slots:
     void roundTripNii();
     void roundTripNiiGz();
+    void cachedNiiGz();
+    void cacheEvictsLeastRecentlyUsed();
+    void truncatedNiiGz();
 };
 
 void TestMriNiftiIo::roundTripNii()
@@ -229,5 +234,115 @@ void TestMriNiftiIo::roundTripNiiGz()
     QCOMPARE(vol.slices.last().pixelsFloat.size(), nx * ny);
 }
 
+void TestMriNiftiIo::cachedNiiGz()
+{
+    // Large enough for the inflated data to span several 256 KiB chunks
+    const int nx = 48, ny = 48, nz = 48;
+    const QByteArray buf = makeSyntheticNifti(nx, ny, nz, 1.0f, 1.0f, 1.0f);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("vol.nii.gz"));
+    const QString cachePath = dir.filePath(QStringLiteral("cache"));
+    QVERIFY2(writeGz(path, buf), "failed to gzip synthetic NIfTI");
+
+    QByteArray raw;
+    QVERIFY(MriNiftiIO::decompress(path, raw));
+    QVERIFY(raw == buf);
+
+    MriInflateStream::setCacheDirectory(cachePath);
+
+    MriVolData first;
+    QVERIFY(MriNiftiIO::read(path, first));
+    QCOMPARE(QDir(cachePath).entryList(QDir::Files).size(), 1);
+
+    MriInflateStream stream(path, true);
+    QVERIFY(stream.open());
+    QVERIFY(stream.isCached());
+    QVERIFY(stream.readAll() == buf);
+
+    MriVolData second;
+    QVERIFY(MriNiftiIO::read(path, second));
+
+    MriInflateStream::setCacheDirectory(QString());
+
+    QCOMPARE(second.slices.size(), nz);
+    for (int k = 0; k < nz; ++k) {
+        QVERIFY(second.slices[k].pixelsFloat == first.slices[k].pixelsFloat);
+    }
+    QCOMPARE(second.voxel(7, 11, 13), 7.0f + 110.0f + 1300.0f);
+}
+
+void TestMriNiftiIo::cacheEvictsLeastRecentlyUsed()
+{
+    const QByteArray buf = makeSyntheticNifti(16, 16, 16, 1.0f, 1.0f, 1.0f);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString cachePath = dir.filePath(QStringLiteral("cache"));
+    const QStringList paths = {dir.filePath(QStringLiteral("a.nii.gz")),
+                               dir.filePath(QStringLiteral("b.nii.gz")),
+                               dir.filePath(QStringLiteral("c.nii.gz"))};
+    for (const QString& path : paths) {
+        QVERIFY(writeGz(path, buf));
+    }
+
+    // Room for two decoded volumes
+    const qint64 iPreviousLimit = MriInflateStream::cacheSizeLimit();
+    MriInflateStream::setCacheDirectory(cachePath);
+    MriInflateStream::setCacheSizeLimit(2 * buf.size() + buf.size() / 2);
+
+    auto isCached = [](const QString& path) {
+        MriInflateStream stream(path, true);
+        return stream.open() && stream.isCached();
+    };
+
+    MriVolData vol;
+    QVERIFY(MriNiftiIO::read(paths[0], vol));
+    QThread::msleep(50);
+    QVERIFY(MriNiftiIO::read(paths[1], vol));
+    QThread::msleep(50);
+    QVERIFY(isCached(paths[0]));
+    QThread::msleep(50);
+
+    // a was used after b, so b goes
+    QVERIFY(MriNiftiIO::read(paths[2], vol));
+    QCOMPARE(QDir(cachePath).entryList(QDir::Files).size(), 2);
+    QVERIFY(isCached(paths[0]));
+    QVERIFY(isCached(paths[2]));
+    QVERIFY(!isCached(paths[1]));
+
+    MriInflateStream::clearCache();
+    QVERIFY(QDir(cachePath).entryList(QDir::Files).isEmpty());
+
+    MriInflateStream::setCacheSizeLimit(iPreviousLimit);
+    MriInflateStream::setCacheDirectory(QString());
+}
+
+void TestMriNiftiIo::truncatedNiiGz()
+{
+    const int nx = 32, ny = 32, nz = 32;
+    const QByteArray buf = makeSyntheticNifti(nx, ny, nz, 1.0f, 1.0f, 1.0f);
+
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+    const QString path = dir.filePath(QStringLiteral("vol.nii.gz"));
+    const QString cachePath = dir.filePath(QStringLiteral("cache"));
+    QVERIFY(writeGz(path, buf));
+
+    QFile file(path);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() / 2));
+    file.close();
+
+    MriInflateStream::setCacheDirectory(cachePath);
+    MriVolData vol;
+    const bool ok = MriNiftiIO::read(path, vol);
+    MriInflateStream::setCacheDirectory(QString());
+
+    QVERIFY(!ok);
+    QVERIFY(QDir(cachePath).entryList(QDir::Files).isEmpty());
+}
+
 QTEST_APPLESS_MAIN(TestMriNiftiIo)
 #include "test_mri_nifti_io.moc"
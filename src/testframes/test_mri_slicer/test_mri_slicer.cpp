@@ -85,6 +85,7 @@ private slots:
     void testVolDataVoxelDataAsFloat();
     void testVolDataSliceOverload();
     void testVolDataOrthogonalOverload();
+    void testVolDataNativeFormatOverload();
     void testVolDataRasRoundTrip();
 
     void cleanupTestCase();
@@ -330,6 +331,58 @@ void TestMriSlicer::testVolDataOrthogonalOverload()
 
 //=============================================================================================================
 
+void TestMriSlicer::testVolDataNativeFormatOverload()
+{
+    // Non-cubic volume with byte and word slices: the MriVolData overloads read these
+    // buffers directly and must agree with the flattened float path for every plane
+    const int nx = 7, ny = 5, nz = 4;
+    MriVolData vol = m_vol;
+    vol.width  = nx;
+    vol.height = ny;
+    vol.depth  = nz;
+    vol.c_ras  = Vector3f(nx / 2.0f, ny / 2.0f, nz / 2.0f);
+    vol.slices.resize(nz);
+    for (int z = 0; z < nz; ++z) {
+        MriSlice& s = vol.slices[z];
+        s.width  = nx;
+        s.height = ny;
+        s.pixels.clear();
+        s.pixelsWord.clear();
+        s.pixelsFloat.clear();
+        s.pixelFormat = (z % 2 == 0) ? FIFFV_MRI_PIXEL_BYTE : FIFFV_MRI_PIXEL_WORD;
+        for (int p = 0; p < nx * ny; ++p) {
+            const int x = p % nx;
+            const int y = p / nx;
+            const int value = 3 * x + 11 * y + 29 * z;
+            if (s.pixelFormat == FIFFV_MRI_PIXEL_BYTE)
+                s.pixels.append(static_cast<unsigned char>(value));
+            else
+                s.pixelsWord.append(static_cast<unsigned short>(value * 100));
+        }
+    }
+
+    const QVector<float> flat = vol.voxelDataAsFloat();
+    const Matrix4f volVox2ras = vol.computeVox2Ras();
+
+    const QVector<QPair<SliceOrientation, int>> planes = {
+        {SliceOrientation::Axial, nz}, {SliceOrientation::Coronal, ny}, {SliceOrientation::Sagittal, nx}};
+    for (const auto& plane : planes) {
+        for (int idx = 0; idx < plane.second; ++idx) {
+            MriSliceImage ref = MriSlicer::extractSlice(flat, vol.dims(), volVox2ras, plane.first, idx);
+            MriSliceImage img = MriSlicer::extractSlice(vol, plane.first, idx);
+            QCOMPARE(img.width, ref.width);
+            QCOMPARE(img.height, ref.height);
+            QVERIFY(img.sliceToRas.isApprox(ref.sliceToRas));
+            QVERIFY(img.pixels.isApprox(ref.pixels, 1e-6f));
+        }
+    }
+
+    QCOMPARE(vol.voxel(6, 4, 3), flat[6 + nx * (4 + ny * 3)]);
+    QCOMPARE(vol.voxel(nx, 0, 0), 0.0f);
+}
+
+//=============================================================================================================
+
 void TestMriSlicer::testVolDataRasRoundTrip()
 {
     // Convert a few voxel indices to RAS and back using MriVolData overloads
@@ -226,6 +226,55 @@ private slots:
         QVERIFY(true);
     }
 
+    void rtAveragingWorker_runningAverage()
+    {
+        FiffInfo::SPtr info = createSyntheticFiffInfo(5, 1000.0f);
+
+        // 3 averages, 10 pre and 20 post stimulus samples, trigger on the STI channel (row 5)
+        RtAveragingWorker worker(3, 10, 20, 0, 0, 5, info);
+        worker.setVarianceActive(true);
+
+        FiffEvokedSet lastSet;
+        MatrixXd lastStdErr;
+        double lastSnr = -1.0;
+        QObject::connect(&worker, &RtAveragingWorker::resultReady,
+                         [&](const FiffEvokedSet& evokedSet, const QStringList&) { lastSet = evokedSet; });
+        QObject::connect(&worker, &RtAveragingWorker::qualityReady,
+                         [&](const QString&, const MatrixXd& matStdErr, double dSnr) {
+                             lastStdErr = matStdErr;
+                             lastSnr = dSnr;
+                         });
+
+        // Every block carries one trigger at sample 50, so each epoch spans samples 40..69
+        QList<MatrixXd> epochs;
+        for (int iBlock = 0; iBlock < 6; ++iBlock) {
+            MatrixXd block = MatrixXd::Zero(6, 100);
+            block.topRows(5) = MatrixXd::Random(5, 100);
+            block(5, 50) = 1.0;
+            epochs.append(block.middleCols(40, 30));
+
+            if (iBlock == 5) {
+                // Shrinking the ring keeps the newest epochs
+                worker.setAverageNumber(2);
+            }
+            worker.doWork(block);
+        }
+
+        QCOMPARE(static_cast<int>(lastSet.evoked.size()), 1);
+        const FiffEvoked& evoked = lastSet.evoked.first();
+        QCOMPARE(evoked.nave, 2);
+        QCOMPARE(evoked.data.cols(), (Index)30);
+
+        const MatrixXd expected = (epochs[4] + epochs[5]) / 2.0;
+        QVERIFY((evoked.data - expected).cwiseAbs().maxCoeff() < 1e-12);
+
+        // Standard error of a two-epoch mean is |a - b| / 2
+        const MatrixXd expectedStdErr = (epochs[4] - epochs[5]).cwiseAbs() / 2.0;
+        QCOMPARE(lastStdErr.rows(), (Index)6);
+        QVERIFY((lastStdErr - expectedStdErr).cwiseAbs().maxCoeff() < 1e-9);
+        QVERIFY(lastSnr > 0.0);
+    }
+
     //=========================================================================
     // RtConnectivity - construction and lifecycle
     //=========================================================================
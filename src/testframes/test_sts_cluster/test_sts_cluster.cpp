@@ -98,10 +98,17 @@ private slots:
     void testClusterPermutationNullDistribution();
     void testClusterPermutationStrongEffect();
 
+    // TFCE
+    void testTfceMatchesThresholdSweep();
+    void testTfcePermutationStrongEffect();
+
     void cleanupTestCase();
 
 private:
     Eigen::SparseMatrix<int> createChainAdjacency(int n) const;
+    Eigen::MatrixXd referenceTfce(const Eigen::MatrixXd& statMap,
+                                  const Eigen::SparseMatrix<int>& adjacency,
+                                  double E, double H, int nSteps) const;
 };
 
 //=============================================================================================================
@@ -127,6 +134,48 @@ Eigen::SparseMatrix<int> TestStsCluster::createChainAdjacency(int n) const
 
 //=============================================================================================================
 
+Eigen::MatrixXd TestStsCluster::referenceTfce(const MatrixXd& statMap,
+                                              const SparseMatrix<int>& adjacency,
+                                              double E, double H, int nSteps) const
+{
+    // Direct definition: label the components above every threshold from scratch
+    const int nTimes = static_cast<int>(statMap.cols());
+    const int nTotal = static_cast<int>(statMap.size());
+    MatrixXd result = MatrixXd::Zero(statMap.rows(), statMap.cols());
+
+    for (double sign : {1.0, -1.0}) {
+        MatrixXd absMap = (sign * statMap).cwiseMax(0.0);
+        double dh = absMap.maxCoeff() / nSteps;
+        if (dh <= 0.0) continue;
+
+        for (int step = 1; step <= nSteps; ++step) {
+            double h = dh * step;
+            QVector<int> label(nTotal, 0);
+            int nLabels = 0;
+            for (int seed = 0; seed < nTotal; ++seed) {
+                if (label[seed] || absMap(seed / nTimes, seed % nTimes) < h) continue;
+                QVector<int> members = {seed};
+                label[seed] = ++nLabels;
+                for (int i = 0; i < members.size(); ++i) {
+                    for (SparseMatrix<int>::InnerIterator it(adjacency, members[i]); it; ++it) {
+                        int n = static_cast<int>(it.row());
+                        if (!label[n] && absMap(n / nTimes, n % nTimes) >= h) {
+                            label[n] = nLabels;
+                            members.append(n);
+                        }
+                    }
+                }
+                for (int m : members) {
+                    result(m / nTimes, m % nTimes) += sign * std::pow(members.size(), E) * std::pow(h, H) * dh;
+                }
+            }
+        }
+    }
+    return result;
+}
+
+//=============================================================================================================
+
 void TestStsCluster::testTtestOneSample()
 {
     // 20 observations, 5 spatial points — test against mu=0
@@ -423,6 +472,85 @@ void TestStsCluster::testClusterPermutationStrongEffect()
 
 //=============================================================================================================
 
+void TestStsCluster::testTfceMatchesThresholdSweep()
+{
+    // Chain of 30 vertices x 4 time points with several separated peaks of both signs
+    const int nSpace = 30;
+    const int nTimes = 4;
+    const int nTotal = nSpace * nTimes;
+
+    QVector<Triplet<int>> triplets;
+    for (int v = 0; v < nSpace; ++v) {
+        for (int t = 0; t < nTimes; ++t) {
+            int idx = v * nTimes + t;
+            if (t + 1 < nTimes) {
+                triplets.append(Triplet<int>(idx, idx + 1, 1));
+                triplets.append(Triplet<int>(idx + 1, idx, 1));
+            }
+            if (v + 1 < nSpace) {
+                triplets.append(Triplet<int>(idx, idx + nTimes, 1));
+                triplets.append(Triplet<int>(idx + nTimes, idx, 1));
+            }
+        }
+    }
+    SparseMatrix<int> adj(nTotal, nTotal);
+    adj.setFromTriplets(triplets.begin(), triplets.end());
+
+    MatrixXd statMap(nSpace, nTimes);
+    for (int v = 0; v < nSpace; ++v) {
+        for (int t = 0; t < nTimes; ++t) {
+            statMap(v, t) = 3.0 * std::sin(0.7 * v) * std::cos(0.9 * t) + 0.05 * ((v * 7 + t * 3) % 5);
+        }
+    }
+
+    MatrixXd tfceMap = StatsCluster::tfce(statMap, adj, 0.5, 2.0, 50);
+    MatrixXd reference = referenceTfce(statMap, adj, 0.5, 2.0, 50);
+
+    QVERIFY(reference.cwiseAbs().maxCoeff() > 0.0);
+    QVERIFY((tfceMap - reference).cwiseAbs().maxCoeff() < 1e-9 * reference.cwiseAbs().maxCoeff());
+
+    // Enhancement keeps the sign of the statistic
+    for (int i = 0; i < statMap.size(); ++i) {
+        QVERIFY(tfceMap.data()[i] * statMap.data()[i] >= 0.0);
+    }
+}
+
+//=============================================================================================================
+
+void TestStsCluster::testTfcePermutationStrongEffect()
+{
+    // Positive effect at spatial points 3-6 on a 12-vertex chain
+    int nObs = 16;
+    int nSpace = 12;
+
+    QVector<MatrixXd> data;
+    for (int i = 0; i < nObs; ++i) {
+        MatrixXd d = MatrixXd::Random(nSpace, 1);
+        for (int j = 3; j <= 6; ++j) {
+            d(j, 0) += 5.0;
+        }
+        data.append(d);
+    }
+
+    SparseMatrix<int> adj = createChainAdjacency(nSpace);
+
+    StatsTfceResult result = StatsCluster::tfcePermutationTest(data, adj, 200);
+
+    QCOMPARE(result.matTfce.rows(), static_cast<Index>(nSpace));
+    QCOMPARE(result.vecNullDist.size(), 200);
+    QVERIFY(std::is_sorted(result.vecNullDist.cbegin(), result.vecNullDist.cend()));
+
+    for (int j = 3; j <= 6; ++j) {
+        QVERIFY(result.matTfce(j, 0) > 0.0);
+        QVERIFY(result.matPvals(j, 0) < 0.05);
+    }
+    for (int j = 0; j < nSpace; ++j) {
+        QVERIFY(result.matPvals(j, 0) >= 0.0 && result.matPvals(j, 0) <= 1.0);
+    }
+}
+
+//=============================================================================================================
+
 void TestStsCluster::cleanupTestCase()
 {
 }
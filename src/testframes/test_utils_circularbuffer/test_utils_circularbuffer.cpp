@@ -37,6 +37,9 @@
 //=============================================================================================================
 
 #include <utils/generics/circularbuffer.h>
+#include <utils/generics/spscringbuffer.h>
+
+#include <thread>
 
 //=============================================================================================================
 // QT INCLUDES
@@ -46,6 +49,7 @@
 #include <QObject>
 #include <QDebug>
 #include <QTest>
+#include <QSet>
 
 //=============================================================================================================
 // USED NAMESPACES
@@ -69,6 +73,10 @@ private slots:
     void testBufferCreationDestruction();
     void testBufferPushingPopping();
     void testBufferCapacity();
+    void testSpscPushingPopping();
+    void testSpscCapacity();
+    void testSpscMatrixSlots();
+    void testSpscThreaded();
 };
 
 //=============================================================================================================
@@ -139,6 +147,132 @@ void TestCircularBuffer::testBufferCapacity()
     QVERIFY(!testBuffer.pop(testSink));
 }
 
+//=============================================================================================================
+
+void TestCircularBuffer::testSpscPushingPopping()
+{
+    SpscRingBuffer<int> testBuffer(10);
+
+    int testVal = 5;
+    int testArray[3] = {1, 2, 3};
+
+    QVERIFY(testBuffer.try_push(testVal));
+    QVERIFY(testBuffer.push(testArray, 3));
+    QCOMPARE(testBuffer.getFreeElementsRead(), 4);
+    QCOMPARE(testBuffer.getFreeElementsWrite(), 6);
+
+    int resultVal = 0;
+    QVERIFY(testBuffer.try_pop(resultVal));
+    QCOMPARE(resultVal, testVal);
+    for (int i = 0; i < 3; ++i){
+        QVERIFY(testBuffer.pop(resultVal));
+        QCOMPARE(resultVal, testArray[i]);
+    }
+
+    // Elements are moved in and out
+    SpscRingBuffer<QVector<int> > moveBuffer(2);
+    QVector<int> vecIn = {1, 2, 3};
+    QVERIFY(moveBuffer.try_push(std::move(vecIn)));
+    QVector<int> vecOut;
+    QVERIFY(moveBuffer.try_pop(vecOut));
+    QCOMPARE(vecOut, QVector<int>({1, 2, 3}));
+}
+
+//=============================================================================================================
+
+void TestCircularBuffer::testSpscCapacity()
+{
+    SpscRingBuffer<int> testBuffer(2);
+    testBuffer.setTimeout(10);
+    int testSink = 0;
+
+    QVERIFY(!testBuffer.try_pop(testSink));
+    QVERIFY(!testBuffer.pop(testSink));
+
+    QVERIFY(testBuffer.try_push(5));
+    QVERIFY(testBuffer.try_push(10));
+    QVERIFY(!testBuffer.try_push(15));
+    QVERIFY(!testBuffer.push(15));
+
+    testBuffer.clear();
+    QVERIFY(!testBuffer.try_pop(testSink));
+
+    // Wrap around the end of the slot array a few times
+    for (int i = 0; i < 7; ++i){
+        QVERIFY(testBuffer.try_push(i));
+        QVERIFY(testBuffer.try_pop(testSink));
+        QCOMPARE(testSink, i);
+    }
+
+    testBuffer.pause(true);
+    QVERIFY(!testBuffer.push(20));
+    testBuffer.pause(false);
+
+    testBuffer.setBlocking(false);
+    QVERIFY(testBuffer.push(20));
+    QVERIFY(testBuffer.pop(testSink));
+    QCOMPARE(testSink, 20);
+    QVERIFY(!testBuffer.pop(testSink));
+}
+
+//=============================================================================================================
+
+void TestCircularBuffer::testSpscMatrixSlots()
+{
+    SpscRingBuffer_Matrix_double testBuffer(4, 8, 16);
+    QCOMPARE(testBuffer.rows(), Eigen::Index(8));
+    QCOMPARE(testBuffer.cols(), Eigen::Index(16));
+
+    Eigen::MatrixXd matIn = Eigen::MatrixXd::Random(8, 16);
+    Eigen::MatrixXd matOut(8, 16);
+
+    // Copy in, swap out: the set of buffers in play stays the same
+    QSet<const double*> setBuffers;
+    for (int i = 0; i < 12; ++i){
+        QVERIFY(testBuffer.try_push(matIn * i));
+        QVERIFY(testBuffer.try_pop(matOut));
+        QVERIFY(matOut.isApprox(matIn * i) || i == 0);
+        setBuffers.insert(matOut.data());
+    }
+    QVERIFY(setBuffers.size() <= 5);
+
+    // Write in place
+    Eigen::MatrixXd* pSlot = testBuffer.beginWrite();
+    QVERIFY(pSlot != nullptr);
+    QCOMPARE(pSlot->rows(), Eigen::Index(8));
+    pSlot->setConstant(3.0);
+    testBuffer.endWrite();
+    QVERIFY(testBuffer.pop(matOut));
+    QCOMPARE(matOut(7, 15), 3.0);
+}
+
+//=============================================================================================================
+
+void TestCircularBuffer::testSpscThreaded()
+{
+    SpscRingBuffer<Eigen::VectorXi> testBuffer(8);
+    const int iNumElements = 20000;
+    bool bInOrder = true;
+
+    std::thread consumer([&]() {
+        Eigen::VectorXi vecElement;
+        for (int i = 0; i < iNumElements; ++i){
+            while(!testBuffer.pop(vecElement)) {}
+            bInOrder = bInOrder && vecElement.size() == 2 && vecElement[0] == i && vecElement[1] == -i;
+        }
+    });
+
+    for (int i = 0; i < iNumElements; ++i){
+        Eigen::VectorXi vecElement(2);
+        vecElement << i, -i;
+        while(!testBuffer.push(std::move(vecElement))) {}
+    }
+
+    consumer.join();
+    QVERIFY(bInOrder);
+    QCOMPARE(testBuffer.getFreeElementsRead(), 0);
+}
+
 //=============================================================================================================
 // MAIN
 //=============================================================================================================
@@ -10,7 +10,12 @@
 
 #include <writetofile/writetofile.h>
 #include <writetofile/FormFiles/writetofilestatuswidget.h>
+#include <writetofile/fiffrecorder.h>
 
+#include <fiff/fiff_raw_data.h>
+#include <fiff/fiff_constants.h>
+
+#include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QObject>
@@ -21,6 +26,8 @@
 #include <QTimer>
 
 using namespace WRITETOFILEPLUGIN;
+using namespace FIFFLIB;
+using namespace Eigen;
 
 class TestWriteToFileStatus : public QObject
 {
@@ -30,6 +37,9 @@ private slots:
     void formatHelpers_produceExpectedStrings();
     void emitRecordingStatus_isPeriodicAndMonotonic();
     void statusWidget_reflectsLatestSummary();
+    void statusWidget_showsRecorderQueue();
+    void fiffRecorder_splitsAndReadsBack();
+    void fiffRecorder_stopsWhenSplitFails();
 };
 
 //=============================================================================================================
@@ -161,5 +171,165 @@ void TestWriteToFileStatus::statusWidget_reflectsLatestSummary()
     QCOMPARE(widget.currentText(), QStringLiteral("Not recording"));
 }
 
+//=============================================================================================================
+
+void TestWriteToFileStatus::statusWidget_showsRecorderQueue()
+{
+    WriteToFile plugin;
+    WriteToFileStatusWidget widget(&plugin);
+
+    emit plugin.recordingActiveChanged(true);
+    emit plugin.recorderStatus(3, 64, 0, 0);
+    QCoreApplication::processEvents();
+    QCOMPARE(widget.queueText(), QStringLiteral("queue 3/64"));
+
+    emit plugin.recorderStatus(64, 64, 5, 1);
+    QCoreApplication::processEvents();
+    QCOMPARE(widget.queueText(), QStringLiteral("queue 64/64"));
+
+    emit plugin.recordingActiveChanged(false);
+    QCoreApplication::processEvents();
+    QVERIFY(widget.queueText().isEmpty());
+}
+
+//=============================================================================================================
+
+void TestWriteToFileStatus::fiffRecorder_splitsAndReadsBack()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+
+    const int nChan = 4;
+    const int nSamplesPerBlock = 100;
+    const int nBlocks = 20;
+    const int nSamplesPerFile = 500;
+
+    FiffInfo info;
+    info.sfreq = 1000.0f;
+    for (int i = 0; i < nChan; ++i) {
+        FiffChInfo ch;
+        ch.ch_name = QString("EEG %1").arg(i + 1, 3, 10, QChar('0'));
+        ch.kind = FIFFV_EEG_CH;
+        ch.chpos.coil_type = FIFFV_COIL_EEG;
+        ch.unit = FIFF_UNIT_V;
+        ch.cal = 2.0f;
+        ch.range = 1.0f;
+        info.chs.append(ch);
+        info.ch_names.append(ch.ch_name);
+    }
+    info.nchan = nChan;
+
+    // Small queue and split size, so the writer has to split and push() may have to wait
+    FiffRecorder::Settings settings;
+    settings.iQueueBlocks = 4;
+    settings.iBlockSamples = nSamplesPerBlock;
+    settings.iBlockTimeoutMs = 5000;
+    settings.iSplitBytes = qint64(4) * nChan * nSamplesPerFile;
+    settings.iCoalesceBytes = 3 * (16 + 4 * nChan * nSamplesPerBlock);
+    settings.flushPolicy = FiffRecorder::FlushPolicy::Sync;
+    settings.iFlushIntervalMs = 0;
+
+    FiffRecorder recorder(settings);
+    QVERIFY(recorder.start(tmpDir.filePath(QStringLiteral("rec_raw.fif")), info));
+    QVERIFY(recorder.isRecording());
+
+    MatrixXd matAll = MatrixXd::Random(nChan, nSamplesPerBlock * nBlocks);
+    for (int i = 0; i < nBlocks; ++i) {
+        QVERIFY(recorder.push(matAll.middleCols(i * nSamplesPerBlock, nSamplesPerBlock)));
+    }
+    recorder.stop();
+    QVERIFY(!recorder.isRecording());
+
+    const FiffRecorder::Stats stats = recorder.stats();
+    QCOMPARE(stats.iBlocksWritten, qint64(nBlocks));
+    QCOMPARE(stats.iDroppedBlocks, qint64(0));
+    QCOMPARE(stats.iFailedBlocks, qint64(0));
+    QCOMPARE(stats.iQueueDepth, 0);
+    QCOMPARE(stats.iQueueCapacity, 4);
+    QVERIFY(stats.iMaxQueueDepth <= 4);
+    QCOMPARE(stats.iBytesWritten, qint64(4) * matAll.size());
+
+    const QStringList lFiles = recorder.fileNames();
+    QCOMPARE(static_cast<int>(lFiles.size()), nBlocks * nSamplesPerBlock / nSamplesPerFile);
+    QCOMPARE(QFileInfo(lFiles[1]).fileName(), QStringLiteral("rec-1_raw.fif"));
+
+    // Every file holds the next nSamplesPerFile samples, calibrated back to the pushed values
+    for (int iFile = 0; iFile < lFiles.size(); ++iFile) {
+        QFile file(lFiles[iFile]);
+        FiffRawData raw(file);
+        QCOMPARE(raw.first_samp, 0);
+        QCOMPARE(raw.last_samp, nSamplesPerFile - 1);
+
+        MatrixXd data, times;
+        QVERIFY(raw.read_raw_segment(data, times));
+        QCOMPARE(static_cast<int>(data.cols()), nSamplesPerFile);
+
+        const MatrixXd expected = matAll.middleCols(iFile * nSamplesPerFile, nSamplesPerFile);
+        QVERIFY((data - expected).cwiseAbs().maxCoeff() < 1e-6);
+    }
+}
+
+//=============================================================================================================
+
+void TestWriteToFileStatus::fiffRecorder_stopsWhenSplitFails()
+{
+    QTemporaryDir tmpDir;
+    QVERIFY(tmpDir.isValid());
+
+    // A directory in place of the first split file makes the split fail
+    QVERIFY(QDir(tmpDir.path()).mkdir(QStringLiteral("rec-1_raw.fif")));
+
+    const int nChan = 4;
+    const int nSamplesPerBlock = 100;
+    const int nBlocks = 20;
+    const int nSamplesPerFile = 500;
+
+    FiffInfo info;
+    info.sfreq = 1000.0f;
+    for (int i = 0; i < nChan; ++i) {
+        FiffChInfo ch;
+        ch.ch_name = QString("EEG %1").arg(i + 1, 3, 10, QChar('0'));
+        ch.kind = FIFFV_EEG_CH;
+        ch.chpos.coil_type = FIFFV_COIL_EEG;
+        ch.unit = FIFF_UNIT_V;
+        ch.cal = 1.0f;
+        ch.range = 1.0f;
+        info.chs.append(ch);
+        info.ch_names.append(ch.ch_name);
+    }
+    info.nchan = nChan;
+
+    FiffRecorder::Settings settings;
+    settings.iQueueBlocks = 4;
+    settings.iBlockTimeoutMs = 5000;
+    settings.iSplitBytes = qint64(4) * nChan * nSamplesPerFile;
+
+    FiffRecorder recorder(settings);
+    QVERIFY(recorder.start(tmpDir.filePath(QStringLiteral("rec_raw.fif")), info));
+
+    // The queue only holds 4 blocks, so the writer reaches the failed split before all pushes are accepted
+    const MatrixXd matBlock = MatrixXd::Random(nChan, nSamplesPerBlock);
+    qint64 iAccepted = 0;
+    for (int i = 0; i < nBlocks; ++i) {
+        if (recorder.push(matBlock)) {
+            ++iAccepted;
+        }
+    }
+    QTRY_VERIFY(!recorder.isRecording());
+    QVERIFY(!recorder.push(matBlock));
+    recorder.stop();
+
+    // Everything after the first file is counted as lost instead of written
+    const FiffRecorder::Stats stats = recorder.stats();
+    QCOMPARE(stats.iBlocksWritten, qint64(nSamplesPerFile / nSamplesPerBlock));
+    QVERIFY(stats.iFailedBlocks > 0);
+    QCOMPARE(stats.iBlocksWritten + stats.iFailedBlocks, iAccepted);
+    QCOMPARE(stats.iDroppedBlocks, qint64(0));
+    QCOMPARE(stats.iBytesWritten, qint64(4) * nChan * nSamplesPerFile);
+    QCOMPARE(static_cast<int>(recorder.fileNames().size()), 1);
+}
+
+//=============================================================================================================
+
 QTEST_MAIN(TestWriteToFileStatus)
 #include "test_writetofile_status.moc"
@@ -108,6 +108,7 @@ int main(int argc, char *argv[])
 
     // BEM & sphere model options
     QCommandLineOption bemOpt("bem", "BEM model file.", "file");
+    QCommandLineOption bemcacheOpt("bemcache", "Directory for cached BEM solutions (default: $MNE_BEM_CACHE_DIR).", "dir");
     QCommandLineOption originOpt("origin", "Sphere model origin in head coordinates (x:y:z in mm).", "x:y:z");
     QCommandLineOption eegscalpOpt("eegscalp", "Scale electrode locations to the scalp surface (sphere model).");
     QCommandLineOption eegmodelsOpt("eegmodels", "File of EEG sphere model specifications.", "file");
@@ -131,7 +132,7 @@ int main(int argc, char *argv[])
 
     parser.addOptions({srcOpt, measOpt, fwdOpt,
                        mriOpt, transOpt, notransOpt,
-                       bemOpt, originOpt, eegscalpOpt, eegmodelsOpt, eegmodelOpt, eegradOpt,
+                       bemOpt, bemcacheOpt, originOpt, eegscalpOpt, eegmodelsOpt, eegmodelOpt, eegradOpt,
                        megOpt, eegOpt, gradOpt, fixedOpt, accurateOpt, mricoordOpt, allOpt,
                        labelOpt, mindistOpt, mindistoutOpt, includeallOpt});
 
@@ -172,6 +173,8 @@ int main(int argc, char *argv[])
     // BEM model
     if (parser.isSet(bemOpt))
         settings->bemname = parser.value(bemOpt);
+    if (parser.isSet(bemcacheOpt))
+        settings->bem_cache_dir = parser.value(bemcacheOpt);
 
     // Sphere model origin (x:y:z in mm, converted to meters)
     if (parser.isSet(originOpt)) {
@@ -794,7 +794,10 @@ int main(int argc, char *argv[])
             raw.info.projs[k].active = true;
         }
 
-        // Read the full raw segment
+        // Read the full raw segment, decoding the buffers in parallel from a memory map of the file
+        raw.map_file();
+        raw.set_read_threads(0);
+
         MatrixXd inputData;
         MatrixXd times;
         if (!raw.read_raw_segment(inputData, times, raw.first_samp, raw.last_samp, picks)) {
@@ -356,6 +356,12 @@ int main(int argc, char *argv[])
         "Bad channels file (one name per line, can be repeated).", "file");
     parser.addOption(badOpt);
 
+    // --svd: Decomposition of the whitened lead field
+    QCommandLineOption svdOpt(QStringList() << "svd",
+        "SVD method for the whitened lead field: jacobi, bdc or gram (default: jacobi).",
+        "method", "jacobi");
+    parser.addOption(svdOpt);
+
     // --inv: Output inverse operator file
     QCommandLineOption invOpt(QStringList() << "inv",
         "Output file for the inverse operator (default: <fwd>-inv.fif).", "file");
@@ -392,6 +398,19 @@ int main(int argc, char *argv[])
                 :                            0.8f;
     bool diagNoise = parser.isSet(diagnoiseOpt);
 
+    QString svdName = parser.value(svdOpt).toLower();
+    MNEInverseOperator::SvdMethod svdMethod;
+    if (svdName == "jacobi") {
+        svdMethod = MNEInverseOperator::SvdJacobi;
+    } else if (svdName == "bdc") {
+        svdMethod = MNEInverseOperator::SvdBdc;
+    } else if (svdName == "gram") {
+        svdMethod = MNEInverseOperator::SvdGram;
+    } else {
+        qCritical() << "Error: Unknown --svd method" << svdName << "(expected jacobi, bdc or gram).";
+        return 1;
+    }
+
     // Regularization parameters
     float magReg = parser.value(magregOpt).toFloat();
     float gradReg = parser.value(gradregOpt).toFloat();
@@ -555,8 +574,9 @@ int main(int argc, char *argv[])
         printf(" (%.2f)", depth);
     }
     printf("\n");
+    printf("  SVD method:       %s\n", svdName.toUtf8().constData());
 
-    MNEInverseOperator invOp(info, forward, noiseCov, loose, depth, useFixed, true);
+    MNEInverseOperator invOp(info, forward, noiseCov, loose, depth, useFixed, true, svdMethod);
 
     if (invOp.nsource <= 0) {
         qCritical() << "Error: Failed to assemble inverse operator.";
@@ -33,6 +33,8 @@
  *           Reads a `.mna` project file describing a pipeline of processing nodes
  *           (load → filter → covariance → forward → inverse), validates the DAG,
  *           and executes it in topological order, printing a summary of each step.
+ *           Independent nodes can run in parallel (--threads) and results can be
+ *           reused across runs through a result cache directory (--cache).
  *
  */
 
@@ -56,6 +58,7 @@
 #include <QCommandLineParser>
 #include <QCommandLineOption>
 #include <QFile>
+#include <QScopedPointer>
 #include <QTextStream>
 
 //=============================================================================================================
@@ -99,6 +102,19 @@ int main(int argc, char *argv[])
         QStringLiteral("Validate the graph without executing it."));
     parser.addOption(dryRunOpt);
 
+    QCommandLineOption threadsOpt(
+        QStringList() << QStringLiteral("j") << QStringLiteral("threads"),
+        QStringLiteral("Number of nodes to run in parallel (0 = number of cores, default 1)."),
+        QStringLiteral("n"),
+        QStringLiteral("1"));
+    parser.addOption(threadsOpt);
+
+    QCommandLineOption cacheOpt(
+        QStringLiteral("cache"),
+        QStringLiteral("Directory of the result cache. Nodes whose op, parameters and inputs are unchanged are not re-run."),
+        QStringLiteral("dir"));
+    parser.addOption(cacheOpt);
+
     QCommandLineOption listOpsOpt(
         QStringLiteral("list-ops"),
         QStringLiteral("List all registered operators and exit."));
@@ -188,8 +204,25 @@ int main(int argc, char *argv[])
     //
     // Execute via MnaGraphExecutor
     //
+    MnaGraphExecutor::ExecOptions options;
+    options.maxThreads = parser.value(threadsOpt).toInt();
+
+    QScopedPointer<MnaResultCache> pCache;
+    if (parser.isSet(cacheOpt)) {
+        pCache.reset(new MnaResultCache(parser.value(cacheOpt)));
+        options.cache = pCache.data();
+    }
+
+    MnaGraphExecutor::setProgressCallback([](const QString& nodeId, int current, int total,
+                                             const MnaGraphExecutor::NodeTiming& timing) {
+        qInfo().noquote() << QStringLiteral("[%1/%2] %3 %4 ms%5").arg(current).arg(total).arg(nodeId)
+                                 .arg(timing.elapsedNs / 1.0e6, 0, 'f', 1)
+                                 .arg(timing.cacheHit ? QStringLiteral(" (cached)") : QString());
+    });
+
     qInfo() << "Executing pipeline...";
-    MnaGraphExecutor::Context ctx = MnaGraphExecutor::execute(graph, {});
+    MnaGraphExecutor::Context ctx = MnaGraphExecutor::execute(graph, {}, options);
+    MnaGraphExecutor::setProgressCallback(nullptr);
 
     qInfo() << "Pipeline execution complete.";
     return 0;
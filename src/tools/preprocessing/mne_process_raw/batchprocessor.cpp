@@ -155,6 +155,11 @@ int BatchProcessor::run(const ProcessingSettings &settings)
                 << "(" << raw.info.nchan << "channels,"
                 << "sfreq =" << raw.info.sfreq << "Hz )";
 
+        // Event detection, averaging and covariance computation all read long segments:
+        // decode the buffers in parallel from a memory map of the file
+        raw.map_file();
+        raw.set_read_threads(0);
+
         //---------------------------------------------------------------------
         // Step 1: Event detection / loading
         //---------------------------------------------------------------------